@@ -7,31 +7,43 @@ ROOT_PATH := ../..
 ANIMATION_CPP := \
      $(ROOT_PATH)/core/src/animation/Animation.cpp      		\
      $(ROOT_PATH)/core/src/animation/AnimationComponent.cpp   	\
+     $(ROOT_PATH)/core/src/animation/AnimationPool.cpp		\
      $(ROOT_PATH)/core/src/animation/AnimationSystem.cpp		\
      $(ROOT_PATH)/core/src/animation/RotationAnimation.cpp		\
      $(ROOT_PATH)/core/src/animation/SlerpAnimation.cpp       	\
      $(ROOT_PATH)/core/src/animation/TranslationAnimation.cpp 	
 
 COMMON_CPP := \
+    $(ROOT_PATH)/core/src/common/FrameAllocator.cpp \
+    $(ROOT_PATH)/core/src/common/Sid.cpp \
     $(ROOT_PATH)/core/src/common/Timer.cpp
 
 ENGINE_CPP :=  \
     $(ROOT_PATH)/core/src/engine/Engine.cpp                \
     $(ROOT_PATH)/core/src/engine/Entity.cpp                \
+    $(ROOT_PATH)/core/src/engine/FrameGovernor.cpp         \
     $(ROOT_PATH)/core/src/engine/Scene.cpp                 \
     $(ROOT_PATH)/core/src/engine/TransformComponent.cpp
 
 GEO_ENGINE_CPP := \
+    $(ROOT_PATH)/core/src/engine/geo/ElevationTile.cpp      \
     $(ROOT_PATH)/core/src/engine/geo/GeoEngine.cpp          \
     $(ROOT_PATH)/core/src/engine/geo/GeoEngineCallbacks.cpp \
     $(ROOT_PATH)/core/src/engine/geo/Poi.cpp				\
+    $(ROOT_PATH)/core/src/engine/geo/PoiClusterer.cpp       \
     $(ROOT_PATH)/core/src/engine/geo/PoiFactory.cpp         \
+    $(ROOT_PATH)/core/src/engine/geo/PoiSnapshot.cpp        \
     $(ROOT_PATH)/core/src/engine/geo/GeoSceneManager.cpp    \
     $(ROOT_PATH)/core/src/engine/geo/Tile.cpp               \
-    $(ROOT_PATH)/core/src/engine/geo/TileMap.cpp
+    $(ROOT_PATH)/core/src/engine/geo/TileMap.cpp            \
+    $(ROOT_PATH)/core/src/engine/geo/VectorStyle.cpp        \
+    $(ROOT_PATH)/core/src/engine/geo/VectorTile.cpp         \
+    $(ROOT_PATH)/core/src/engine/geo/VectorTileBuilder.cpp
 
 ASYNC_CPP := \
-    $(ROOT_PATH)/core/src/async/TaskScheduler.cpp
+    $(ROOT_PATH)/core/src/async/TaskScheduler.cpp \
+    $(ROOT_PATH)/core/src/async/ThreadPool.cpp    \
+    $(ROOT_PATH)/core/src/async/Worker.cpp
 
 RENDERING_CPP := \
     $(ROOT_PATH)/core/src/rendering/BoundingSphere.cpp  \
@@ -41,32 +53,47 @@ RENDERING_CPP := \
     $(ROOT_PATH)/core/src/rendering/HUDSystem.cpp               \
     $(ROOT_PATH)/core/src/rendering/HUDElement.cpp              \
     $(ROOT_PATH)/core/src/rendering/IndexBuffer.cpp       		\
+    $(ROOT_PATH)/core/src/rendering/Label.cpp                   \
+    $(ROOT_PATH)/core/src/rendering/LabelSystem.cpp             \
     $(ROOT_PATH)/core/src/rendering/Plane.cpp             		\
     $(ROOT_PATH)/core/src/rendering/RenderingComponent.cpp    	\
     $(ROOT_PATH)/core/src/rendering/RenderingEngine.cpp   		\
     $(ROOT_PATH)/core/src/rendering/RenderingPackage.cpp  		\
+    $(ROOT_PATH)/core/src/rendering/RenderQueue.cpp             \
     $(ROOT_PATH)/core/src/rendering/SkyBox.cpp  		        \
+    $(ROOT_PATH)/core/src/rendering/SpriteAtlas.cpp             \
     $(ROOT_PATH)/core/src/rendering/Vertex.cpp            		\
+    $(ROOT_PATH)/core/src/rendering/VertexArray.cpp       		\
     $(ROOT_PATH)/core/src/rendering/VertexBuffer.cpp
 
 
 RESOURCE_CPP :=  \
+   $(ROOT_PATH)/core/src/resource/AssetPack.cpp       \
    $(ROOT_PATH)/core/src/resource/CubeMap.cpp         \
    $(ROOT_PATH)/core/src/resource/CubeMapManager.cpp  \
+   $(ROOT_PATH)/core/src/resource/Font.cpp            \
+   $(ROOT_PATH)/core/src/resource/FontManager.cpp     \
+   $(ROOT_PATH)/core/src/resource/GeneratedMesh.cpp   \
    $(ROOT_PATH)/core/src/resource/Image.cpp           \
    $(ROOT_PATH)/core/src/resource/Map.cpp             \
    $(ROOT_PATH)/core/src/resource/Material.cpp        \
+   $(ROOT_PATH)/core/src/resource/MaterialInstance.cpp \
    $(ROOT_PATH)/core/src/resource/MaterialManager.cpp \
+   $(ROOT_PATH)/core/src/resource/MemoryReport.cpp    \
    $(ROOT_PATH)/core/src/resource/Mesh.cpp            \
    $(ROOT_PATH)/core/src/resource/MeshManager.cpp     \
    $(ROOT_PATH)/core/src/resource/Pass.cpp            \
    $(ROOT_PATH)/core/src/resource/Quad.cpp            \
    $(ROOT_PATH)/core/src/resource/QuadFactory.cpp     \
+   $(ROOT_PATH)/core/src/resource/ResourceIndex.cpp   \
    $(ROOT_PATH)/core/src/resource/ResourceManager.cpp \
    $(ROOT_PATH)/core/src/resource/ShaderManager.cpp   \
    $(ROOT_PATH)/core/src/resource/ShaderProgram.cpp   \
+   $(ROOT_PATH)/core/src/resource/SpillCache.cpp      \
    $(ROOT_PATH)/core/src/resource/Texture.cpp         \
    $(ROOT_PATH)/core/src/resource/MapManager.cpp      \
+   $(ROOT_PATH)/core/src/resource/TerrainMesh.cpp     \
+   $(ROOT_PATH)/core/src/resource/VectorMesh.cpp      \
    $(ROOT_PATH)/core/src/resource/Watermark.cpp
 
 
@@ -74,9 +101,13 @@ UTILS_CPP := \
    $(ROOT_PATH)/core/src/utils/GeoUtils.cpp             \
    $(ROOT_PATH)/core/src/utils/GeoSceneReader.cpp 		\
    $(ROOT_PATH)/core/src/utils/GLUtils.cpp 				\
+   $(ROOT_PATH)/core/src/utils/LogSink.cpp 			\
    $(ROOT_PATH)/core/src/utils/MaterialReader.cpp 		\
+   $(ROOT_PATH)/core/src/utils/MvtReader.cpp 			\
    $(ROOT_PATH)/core/src/utils/ObjReader.cpp 			\
+   $(ROOT_PATH)/core/src/utils/Triangulator.cpp 		\
    $(ROOT_PATH)/core/src/utils/Utils.cpp 				\
+   utils/GLProcAddress.cpp 								\
    utils/Log.cpp
 
 
@@ -94,7 +125,7 @@ $(LOCAL_PATH)/$(ROOT_PATH)/third/rapidjson \
 $(LOCAL_PATH)/ndk-modules
 
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_C_INCLUDES)
-LOCAL_LDLIBS    := -llog -lGLESv2 -lz
+LOCAL_LDLIBS    := -llog -landroid -lEGL -lGLESv2 -lz
 LOCAL_STATIC_LIBRARIES := png
 
 LOCAL_SRC_FILES :=   \
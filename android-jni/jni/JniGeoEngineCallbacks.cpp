@@ -28,11 +28,13 @@ namespace dma {
         //-----------------------------------------------------------------------------------------------
         JniGeoEngineCallbacks::JniGeoEngineCallbacks(JavaVM* javaVM, jobject listener,
                                                      jmethodID onTileRequest,
+                                                     jmethodID onElevationTileRequest,
                                                      jmethodID onPoiSelected,
                                                      jmethodID onPoiDeselected) :
                 mJavaVM(javaVM),
                 mListener(listener),
                 mOnTileRequest(onTileRequest),
+                mOnElevationTileRequest(onElevationTileRequest),
                 mOnPoiSelected(onPoiSelected),
                 mOnPoiDeselected(onPoiDeselected)
         {
@@ -60,6 +62,23 @@ namespace dma {
         }
 
 
+        //-----------------------------------------------------------------------------------------------
+        void JniGeoEngineCallbacks::onElevationTileRequest(int x, int y, int z) {
+
+            JNIEnv* env;
+            mJavaVM->GetEnv((void**)&env, JNI_VERSION_1_6);
+            assert(env != nullptr); // should be called from the already attached OpenGL thread
+
+            env->CallVoidMethod(mListener, mOnElevationTileRequest, x, y, z);
+
+            // a pending exception would fail the next JNI call of the GL thread.
+            if (env->ExceptionCheck()) {
+                env->ExceptionDescribe();
+                env->ExceptionClear();
+            }
+        }
+
+
         //-----------------------------------------------------------------------------------------------
         void JniGeoEngineCallbacks::onPoiSelected(const std::string &sid) {
 
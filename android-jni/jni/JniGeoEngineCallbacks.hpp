@@ -12,6 +12,7 @@ namespace dma {
         public:
             JniGeoEngineCallbacks(JavaVM* javaVM, jobject listener,
                                   jmethodID onTileRequest,
+                                  jmethodID onElevationTileRequest,
                                   jmethodID onPoiSelected,
                                   jmethodID onPoiDeselected);
             virtual ~JniGeoEngineCallbacks();
@@ -20,6 +21,7 @@ namespace dma {
             void operator=(const JniGeoEngineCallbacks&) = delete;
 
             void onTileRequest(int x, int y, int z) override;
+            void onElevationTileRequest(int x, int y, int z) override;
             void onPoiSelected(const std::string& sid) override;
             void onPoiDeselected(const std::string& sid) override;
 
@@ -27,6 +29,7 @@ namespace dma {
             JavaVM* mJavaVM;
             jobject mListener;
             jmethodID mOnTileRequest;
+            jmethodID mOnElevationTileRequest;
             jmethodID mOnPoiSelected;
             jmethodID mOnPoiDeselected;
         };
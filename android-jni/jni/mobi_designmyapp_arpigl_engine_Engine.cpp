@@ -1,5 +1,9 @@
+#include <android/asset_manager_jni.h>
+#include <unistd.h>
+
 #include "mobi_designmyapp_arpigl_engine_Engine.h"
 #include "engine/geo/GeoEngine.hpp"
+#include "utils/Log.hpp"
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,6 +14,8 @@ using namespace dma::geo;
 
 #define ENGINE(addr) ((GeoEngine*) addr)
 
+constexpr auto TAG = "Engine";
+
 
 //------------------------------------------------------------------------------------
 JNIEXPORT jlong JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_newEngine
@@ -65,10 +71,10 @@ JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_wipe
 
 
 //------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_step
+JNIEXPORT jboolean JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_step
         (JNIEnv* env, jobject caller, jlong addr)
 {
-    ENGINE(addr)->step();
+    return (jboolean) ENGINE(addr)->step();
 }
 
 
@@ -369,16 +375,66 @@ JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_updateTileDiff
 
 
 //------------------------------------------------------------------------------------
-JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_selectPoi
+JNIEXPORT jstring JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_selectPoi
     (JNIEnv* env, jobject caller, jlong addr, jint jx, jint jy)
 {
     int x = (int) jx;
     int y = (int) jy;
     GeoEngine* engine = ENGINE(addr);
-    GeoSceneManager& geoSceneManager = engine->getGeoSceneManager();
-    engine->post([&geoSceneManager, x, y]() {
-        geoSceneManager.pick(x, y);
-    });
+    // picked on the caller thread, selected on the next step.
+    const std::string sid = engine->pick(x, y);
+    return sid.empty() ? nullptr : env->NewStringUTF(sid.c_str());
+}
+
+
+//------------------------------------------------------------------------------------
+JNIEXPORT jlongArray JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_getMemoryReport
+    (JNIEnv* env, jobject caller, jlong addr)
+{
+    const MemoryReport report = ENGINE(addr)->getMemoryReport();
+    // count, cpu & gpu bytes, then their peaks, per category: see Engine.MEMORY_FIELDS
+    jlong values[MemoryReport::size * 6];
+    for (U8 i = 0; i < MemoryReport::size; ++i) {
+        const MemoryUsage& usage = report.get((MemoryReport::Category) i);
+        const MemoryUsage& peak = report.getPeak((MemoryReport::Category) i);
+        jlong* v = values + i * 6;
+        v[0] = usage.count;
+        v[1] = usage.cpuBytes;
+        v[2] = usage.gpuBytes;
+        v[3] = peak.count;
+        v[4] = peak.cpuBytes;
+        v[5] = peak.gpuBytes;
+    }
+    jlongArray array = env->NewLongArray(MemoryReport::size * 6);
+    env->SetLongArrayRegion(array, 0, MemoryReport::size * 6, values);
+    return array;
+}
+
+
+//------------------------------------------------------------------------------------
+JNIEXPORT jboolean JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_setAssetPack
+    (JNIEnv* env, jobject caller, jlong addr, jobject assetManager, jstring name)
+{
+    const char* nativeString = env->GetStringUTFChars(name, 0);
+    AAsset* asset = AAssetManager_open(AAssetManager_fromJava(env, assetManager), nativeString, AASSET_MODE_UNKNOWN);
+    if (asset == nullptr) {
+        env->ReleaseStringUTFChars(name, nativeString);
+        return false;
+    }
+    off_t start, length;
+    // fails if the asset is compressed in the APK.
+    int fd = AAsset_openFileDescriptor(asset, &start, &length);
+    AAsset_close(asset);
+    if (fd < 0) {
+        LOG_WARN(TAG, "Asset %s is compressed: cannot map it from the APK", nativeString);
+        env->ReleaseStringUTFChars(name, nativeString);
+        return false;
+    }
+    env->ReleaseStringUTFChars(name, nativeString);
+    ENGINE(addr)->setPackFile(fd, (U64) start, (U64) length);
+    // the index keeps its own descriptor.
+    close(fd);
+    return true;
 }
 
 #ifdef __cplusplus
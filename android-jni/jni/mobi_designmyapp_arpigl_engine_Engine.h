@@ -60,9 +60,9 @@ JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_wipe
 /*
  * Class:     mobi_designmyapp_arpigl_engine_Engine
  * Method:    step
- * Signature: (J)V
+ * Signature: (J)Z
  */
-JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_step
+JNIEXPORT jboolean JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_step
   (JNIEnv *, jobject, jlong);
 
 /*
@@ -220,11 +220,27 @@ JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_updateTileDiff
 /*
  * Class:     mobi_designmyapp_arpigl_engine_Engine
  * Method:    selectPoi
- * Signature: (JII)V
+ * Signature: (JII)Ljava/lang/String;
  */
-JNIEXPORT void JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_selectPoi
+JNIEXPORT jstring JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_selectPoi
   (JNIEnv *, jobject, jlong, jint, jint);
 
+/*
+ * Class:     mobi_designmyapp_arpigl_engine_Engine
+ * Method:    getMemoryReport
+ * Signature: (J)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_getMemoryReport
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     mobi_designmyapp_arpigl_engine_Engine
+ * Method:    setAssetPack
+ * Signature: (JLandroid/content/res/AssetManager;Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_mobi_designmyapp_arpigl_engine_Engine_setAssetPack
+  (JNIEnv *, jobject, jlong, jobject, jstring);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "utils/Log.hpp"
+#include "utils/LogSink.hpp"
 #include <cstdarg>
 #include <android/log.h>
 /*
@@ -21,62 +22,59 @@
  */
 namespace dma {
 
-    void Log::error(const std::string& tag, const std::string& message, ...) {
-        char buffer[256];
+    void Log::error(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, 256, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_ERROR, tag, message, args);
         va_end(args);
-        __android_log_print(ANDROID_LOG_ERROR, tag.c_str(), "%s", buffer);
-        fflush(stdout);
-        fflush(stderr);
+        // the process may be about to crash.
+        LogSink::getInstance().flush();
     }
 
-    void Log::warn(const std::string& tag, const std::string& message, ...) {
-        char buffer[256];
+#if LOG_LEVEL >= 1
+    void Log::warn(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, 256, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_WARN, tag, message, args);
         va_end(args);
-        __android_log_print(ANDROID_LOG_WARN, tag.c_str(), "%s", buffer);
-        fflush(stdout);
-        fflush(stderr);
     }
+#endif
 
-    void Log::info(const std::string& tag, const std::string& message, ...) {
-        char buffer[256];
+#if LOG_LEVEL >= 2
+    void Log::info(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, 256, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_INFO, tag, message, args);
         va_end(args);
-        __android_log_print(ANDROID_LOG_INFO, tag.c_str(), "%s", buffer);
-        fflush(stdout);
-        fflush(stderr);
     }
+#endif
 
-#ifdef DEBUG
-    void Log::debug(const std::string& tag, const std::string& message, ...) {
-        char buffer[256];
+#if LOG_LEVEL >= 3
+    void Log::debug(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, 256, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_DEBUG, tag, message, args);
         va_end(args);
-        __android_log_print(ANDROID_LOG_DEBUG, tag.c_str(), "%s", buffer);
-        fflush(stdout);
-        fflush(stderr);
     }
+#endif
 
-#ifdef TRACE
-    void Log::trace(const std::string& tag, const std::string& message, ...) {
-        char buffer[256];
+#if LOG_LEVEL >= 4
+    void Log::trace(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, 256, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_TRACE, tag, message, args);
         va_end(args);
-        __android_log_print(ANDROID_LOG_VERBOSE, tag.c_str(), "%s", buffer);
-        fflush(stdout);
-        fflush(stderr);
     }
-#endif  // TRACE
-#endif  // DEBUG
+#endif
+
+    void Log::write(Level level, const char* tag, const char* message) {
+        static const int PRIORITIES[] = {
+                ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG, ANDROID_LOG_VERBOSE
+        };
+        __android_log_write(PRIORITIES[level], tag, message);
+    }
+
+    void Log::sync() {
+        // logcat is not buffered.
+    }
 }
@@ -95,6 +95,11 @@ public final class ArpiGlInstaller {
      */
     public static final String EXTRA_INSTALL_DIR = INSTALLATION_DIR;
     public static final String POIS_DIR = INSTALLATION_DIR + File.separator + "pois";
+    /**
+     * Asset pack, mapped by the engine straight from the APK when stored uncompressed
+     * (aaptOptions { noCompress 'pack' }): it is then not copied.
+     */
+    public static final String PACK_ASSET = INSTALLATION_DIR + File.separator + "arpigl.pack";
 
 
     /**
@@ -491,6 +496,19 @@ public final class ArpiGlInstaller {
         }
     }
 
+    /**
+     * @param path The asset to check.
+     * @return true if the asset is stored uncompressed in the APK, so that it can be mapped in place.
+     */
+    private boolean isUncompressed(String path) {
+        try {
+            mContext.getAssets().openFd(path).close();
+            return true;
+        } catch (final IOException e) {
+            return false;
+        }
+    }
+
     /**
      * List the files recursively in all folders & subfolders of assets.
      *
@@ -512,7 +530,7 @@ public final class ArpiGlInstaller {
                 }
                 sizeInBytes += currentSize;
             }
-        } else {
+        } else if (!PACK_ASSET.equals(path) || !isUncompressed(path)) {
             fileList.add(path);
             final InputStream is = mContext.getAssets().open(path);
             sizeInBytes = is.available();
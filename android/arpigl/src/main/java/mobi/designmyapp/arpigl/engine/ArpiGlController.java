@@ -39,6 +39,7 @@ import java.util.List;
 
 import mobi.designmyapp.arpigl.event.PoiEvent;
 import mobi.designmyapp.arpigl.event.TileEvent;
+import mobi.designmyapp.arpigl.listener.ElevationTileListener;
 import mobi.designmyapp.arpigl.listener.EngineListener;
 import mobi.designmyapp.arpigl.listener.OrientationListener;
 import mobi.designmyapp.arpigl.listener.PoiEventListener;
@@ -498,7 +499,7 @@ public final class ArpiGlController implements Controller {
      *
      * @author Nicolas THIERION
      */
-    private class ControllerEngineListener implements EngineListener {
+    private class ControllerEngineListener implements EngineListener, ElevationTileListener {
 
         @Override
         public void onTileRequest(int x, int y, int z) {
@@ -509,6 +510,12 @@ public final class ArpiGlController implements Controller {
             }
         }
 
+        @Override
+        public void onElevationTileRequest(int x, int y, int z) {
+            // terrain is not enabled from the java side yet
+            Log.w(TAG, "elevation tile requested, but no elevation tile provider exists.");
+        }
+
         @Override
         public void onPoiSelected(final String sid) {
             synchronized (mLock) {
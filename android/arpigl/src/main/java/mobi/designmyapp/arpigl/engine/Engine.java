@@ -17,6 +17,7 @@
 package mobi.designmyapp.arpigl.engine;
 
 import android.content.Context;
+import android.content.res.AssetManager;
 import android.graphics.Color;
 import android.opengl.GLSurfaceView;
 import android.os.Handler;
@@ -27,6 +28,7 @@ import javax.microedition.khronos.opengles.GL10;
 
 import mobi.designmyapp.arpigl.ArpiGlInstaller;
 import mobi.designmyapp.arpigl.BuildConfig;
+import mobi.designmyapp.arpigl.listener.ElevationTileListener;
 import mobi.designmyapp.arpigl.listener.EngineListener;
 import mobi.designmyapp.arpigl.model.Poi;
 
@@ -50,6 +52,18 @@ public final class Engine implements Controller {
 
     private static final double DEFAULT_CAMERA_ALTITUDE = 5.0;
 
+    /**
+     * Resource types of {@link #getMemoryReport()}, in order.
+     */
+    public static final String[] MEMORY_CATEGORIES = {
+        "meshes", "maps", "cubemaps", "fonts", "vector tiles", "terrain"
+    };
+    /**
+     * Values of {@link #getMemoryReport()} per resource type: count, CPU bytes &
+     * GPU bytes, then the high-water marks of the same three.
+     */
+    public static final int MEMORY_FIELDS = 6;
+
     /**
      * Native .so library name.
      */
@@ -120,6 +134,10 @@ public final class Engine implements Controller {
         mInstallationDir = filesDirBuilder.toString();
 
         mNativeInstanceAddr = newEngine(mInstallationDir);
+        // map the asset pack from the APK if it ships one, uncompressed.
+        if (!setAssetPack(mNativeInstanceAddr, context.getAssets(), ArpiGlInstaller.PACK_ASSET)) {
+            Log.v(TAG, "No mappable asset pack in the APK");
+        }
         mRenderer = new Renderer(this);
         // register native callbacks
         setEngineListener(mNativeInstanceAddr, mNativeListener.getNativeAddr());
@@ -244,9 +262,10 @@ public final class Engine implements Controller {
      * Selects the closest poi from the camera at the screen coordinate (x, y)
      * @param x the x screen coordinate
      * @param y the y screen coordinate
+     * @return the sid of the selected poi, or null if there is no poi at (x, y)
      */
-    public void selectPoi(int x, int y) {
-        selectPoi(mNativeInstanceAddr, x, y);
+    public String selectPoi(int x, int y) {
+        return selectPoi(mNativeInstanceAddr, x, y);
     }
 
     /* ***
@@ -276,6 +295,17 @@ public final class Engine implements Controller {
         return isAbleToDraw(mNativeInstanceAddr);
     }
 
+    /**
+     * Measures the memory held by the engine resources. Must be called on the
+     * OpenGL thread, like {@link #step()}.
+     *
+     * @return {@link #MEMORY_FIELDS} values for each of the
+     * {@link #MEMORY_CATEGORIES}.
+     */
+    public long[] getMemoryReport() {
+        return getMemoryReport(mNativeInstanceAddr);
+    }
+
     /**
      * Checks for poi.
      *
@@ -314,7 +344,8 @@ public final class Engine implements Controller {
 
     /**
      * Sets the {@link EngineListener} to be notified on engine event
-     * thrown by native implementation.
+     * thrown by native implementation. If it also implements
+     * {@link ElevationTileListener}, it is notified of elevation tile requests.
      *
      * @param callbacks the engine callback
      */
@@ -368,9 +399,11 @@ public final class Engine implements Controller {
 
     /**
      * Steps the engine.
+     *
+     * @return true if a frame has been drawn, false if nothing changed since the last one.
      */
-    public void step() {
-        step(mNativeInstanceAddr);
+    public boolean step() {
+        return step(mNativeInstanceAddr);
     }
 
     public void updateTileDiffuseMaps() {
@@ -463,7 +496,7 @@ public final class Engine implements Controller {
     /**
      * This class will be passed to the C++ engine to request tiles
      */
-    private class NativeFallthroughEngineListener implements EngineListener {
+    private class NativeFallthroughEngineListener implements EngineListener, ElevationTileListener {
 
         /**
          * address of the native c++ object.
@@ -513,6 +546,21 @@ public final class Engine implements Controller {
             mainHandler.post(runnable);
         }
 
+        @Override
+        public void onElevationTileRequest(final int x, final int y, final int z) {
+            // MAY DEADLOCK IF RUN IN THE NATIVE THREAD
+            final Handler mainHandler = new Handler(mContext.getMainLooper());
+            Runnable runnable = new Runnable() {
+                @Override
+                public void run() {
+                    if (mEngineListener instanceof ElevationTileListener) {
+                        ((ElevationTileListener) mEngineListener).onElevationTileRequest(x, y, z);
+                    }
+                }
+            };
+            mainHandler.post(runnable);
+        }
+
         @Override
         public void onPoiSelected(final String sid) {
             // MAY DEADLOCK IF RUN IN THE NATIVE THREAD
@@ -567,7 +615,7 @@ public final class Engine implements Controller {
 
     private native void wipe(long nativeInstanceAddr);
 
-    private native void step(long nativeInstanceAddr);
+    private native boolean step(long nativeInstanceAddr);
 
     private native void addPoi(long nativeInstanceAddr, String sid, String shape, String icon, float r, float g, float b, double lat, double lng, double alt);
 
@@ -607,6 +655,10 @@ public final class Engine implements Controller {
 
     private native void updateTileDiffuseMaps(long nativeInstanceAddr);
 
-    private native void selectPoi(long nativeInstanceAddr, int x, int y);
+    private native String selectPoi(long nativeInstanceAddr, int x, int y);
+
+    private native long[] getMemoryReport(long nativeInstanceAddr);
+
+    private native boolean setAssetPack(long nativeInstanceAddr, AssetManager assetManager, String name);
 
 }
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+package mobi.designmyapp.arpigl.listener;
+
+/**
+ * Optional {@link EngineListener} extension: a listener set with
+ * Engine.setNativeEngineListener() that also implements this interface is
+ * notified of elevation tile requests.
+ */
+public interface ElevationTileListener {
+
+    /**
+     * Called each time the engine is missing the elevation tile (a terrain-RGB
+     * png) of an area, while terrain is enabled.
+     *
+     * @param x coord of the requested elevation tile.
+     * @param y coord of the requested elevation tile.
+     * @param z coord of the requested elevation tile.
+     */
+    void onElevationTileRequest(int x, int y, int z);
+
+}
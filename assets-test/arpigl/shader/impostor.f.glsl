@@ -0,0 +1,36 @@
+#ifdef GL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+uniform sampler2D u_diffuse_map;
+uniform bool u_diffuse_map_enabled;
+
+varying vec2 v_corner;
+varying vec2 v_uv;
+varying vec3 v_color;
+
+/** billboard radius ratio where the silhouette starts */
+const float OUTLINE = 0.85;
+
+
+// a shaded disc with a dark outline, as the POI mesh seen from afar.
+void main() {
+    float r2 = dot(v_corner, v_corner);
+    if (r2 > 1.0) {
+        discard;
+    }
+
+    vec3 color = v_color * (0.6 + 0.4 * sqrt(1.0 - r2));
+    if (u_diffuse_map_enabled) {
+        vec4 texel = texture2D(u_diffuse_map, v_uv);
+        color = mix(color, texel.rgb, texel.a);
+    }
+    if (r2 > OUTLINE * OUTLINE) {
+        color = vec3(0.0);
+    }
+    gl_FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,23 @@
+attribute vec3 a_position;
+attribute vec2 a_uv;
+attribute vec4 a_color;
+
+uniform mat4 u_MVP, u_MV;
+
+varying vec2 v_corner;
+varying vec2 v_uv;
+varying vec3 v_color;
+
+
+// billboards face the camera: their corners are offset along the view right & up axes.
+void main() {
+    vec3 right = vec3(u_MV[0][0], u_MV[1][0], u_MV[2][0]);
+    vec3 up = vec3(u_MV[0][1], u_MV[1][1], u_MV[2][1]);
+    vec3 position = a_position + (right * a_uv.x + up * a_uv.y) * a_color.a;
+    gl_Position = u_MVP * vec4(position, 1.0);
+
+    v_corner = a_uv;
+    // images are stored bottom row first.
+    v_uv = 0.5 + 0.5 * a_uv;
+    v_color = a_color.rgb;
+}
@@ -0,0 +1,30 @@
+#ifdef GL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+uniform sampler2D u_diffuse_map;
+
+varying vec2 v_uv;
+varying vec4 v_color;
+varying float v_smoothing;
+
+/** distance where the halo around the glyphs ends. The glyph outline is at 0.5. */
+const float HALO = 0.3;
+const vec4 HALO_COLOR = vec4(0.0, 0.0, 0.0, 0.75);
+
+
+// signed distance field text, with a dark halo to stay readable over the camera image.
+void main() {
+    float distance = texture2D(u_diffuse_map, v_uv).r;
+    float fill = smoothstep(0.5 - v_smoothing, 0.5 + v_smoothing, distance);
+    float halo = smoothstep(HALO - v_smoothing, HALO + v_smoothing, distance);
+    vec4 color = mix(vec4(HALO_COLOR.rgb, HALO_COLOR.a * halo), v_color, fill);
+    if (color.a <= 0.0) {
+        discard;
+    }
+    gl_FragColor = color;
+}
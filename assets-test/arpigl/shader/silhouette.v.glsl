@@ -4,9 +4,40 @@ attribute vec3 a_normal;
 uniform mat4 u_MVP;
 uniform mat3 u_N;
 uniform vec3 u_diffuse_color;
+// stored positions to model space, as positions may be quantized
+uniform mat4 u_position_decode;
+
+// idle animation, evaluated from the time: bob along u_idle_bob.xyz and spin around u_idle_axis,
+// both in model space, shifted in time by u_idle_bob.w. Null vectors leave the mesh static.
+uniform float u_time;
+uniform vec4 u_idle_bob;
+uniform vec3 u_idle_axis;
+
+const float IDLE_BOB_PERIOD = 3.0;
+const float IDLE_SPIN_PERIOD = 4.0;
+const float TWO_PI = 6.2831853;
+
+// mirrored ease in [0, 1], as a mirrored EASE TranslationAnimation
+float idleBob(float t) {
+    float x = 2.0 * fract(t / IDLE_BOB_PERIOD);
+    if (x > 1.0) {
+        x = 2.0 - x;
+    }
+    float a = x * x;
+    float b = (1.0 - x) * (1.0 - x);
+    return a / (a + b);
+}
+
+// Rodrigues rotation around u_idle_axis
+vec3 idleRotate(vec3 v, float angle) {
+    vec3 kv = cross(u_idle_axis, v);
+    return v + sin(angle) * kv + (1.0 - cos(angle)) * cross(u_idle_axis, kv);
+}
 
 void main() {
-  vec3 normal = a_normal * 0.07;
-    vec4 pos = vec4(a_position + normal, 1.0);
-    gl_Position = u_MVP * pos;
+    float t = u_time + u_idle_bob.w;
+    float angle = TWO_PI * fract(t / IDLE_SPIN_PERIOD);
+    vec3 pos = (u_position_decode * vec4(a_position, 1.0)).xyz + a_normal * 0.07;
+    pos = idleRotate(pos, angle) + idleBob(t) * u_idle_bob.xyz;
+    gl_Position = u_MVP * vec4(pos, 1.0);
 }
\ No newline at end of file
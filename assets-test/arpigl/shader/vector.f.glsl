@@ -0,0 +1,26 @@
+#ifdef GL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+uniform mat4 u_MV;
+uniform vec3 u_diffuse_color;
+
+varying vec3 v_normal;
+
+// in eye coords: the light comes from above, behind the viewer.
+const vec3 LIGHT_DIRECTION = vec3(0.3, 0.8, 0.5);
+const float AMBIENT = 0.6;
+
+
+void main() {
+    // the up axis, in eye coords: ground faces stay lit whatever the camera pitch.
+    vec3 up = normalize(vec3(u_MV[1]));
+    vec3 normal = normalize(v_normal);
+    float diffuse = max(dot(normal, normalize(LIGHT_DIRECTION)), 0.0) * 0.2
+                    + max(dot(normal, up), 0.0) * 0.2;
+    gl_FragColor = vec4(u_diffuse_color * (AMBIENT + diffuse), 1.0);
+}
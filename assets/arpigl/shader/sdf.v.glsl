@@ -0,0 +1,18 @@
+attribute vec3 a_position;
+attribute vec2 a_uv;
+attribute vec4 a_color;
+
+uniform mat4 u_MVP;
+
+varying vec2 v_uv;
+varying vec4 v_color;
+varying float v_smoothing;
+
+
+// label glyphs, in screen pixels. z holds half the width of the antialiased outline, in distance units.
+void main() {
+    gl_Position = u_MVP * vec4(a_position.xy, 0.0, 1.0);
+    v_uv = a_uv;
+    v_color = a_color;
+    v_smoothing = a_position.z;
+}
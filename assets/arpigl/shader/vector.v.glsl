@@ -0,0 +1,13 @@
+attribute vec3 a_position;
+attribute vec3 a_normal;
+
+uniform mat4 u_MVP;
+uniform mat3 u_N;
+
+varying vec3 v_normal;
+
+
+void main() {
+    v_normal = normalize(u_N * a_normal);
+    gl_Position = u_MVP * vec4(a_position, 1.0);
+}
@@ -63,8 +63,9 @@ namespace dma {
 
         /**
          * Updates all bound animations
+         * @return true if at least one animation was running.
          */
-        void update(float dt);
+        bool update(float dt);
 
 
     private:
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_ANIMATIONPOOL_HPP_
+#define _DMA_ANIMATIONPOOL_HPP_
+
+#include <vector>
+
+#define GLM_FORCE_CXX98
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "common/HandleTable.hpp"
+#include "common/Types.hpp"
+#include "engine/TransformComponent.hpp"
+#include "animation/TranslationAnimation.hpp"
+
+namespace dma {
+
+    /**
+     * Stores animation tracks in contiguous pools, one per animation type, and evaluates
+     * each pool in a single batched loop, without virtual calls.
+     *
+     * Tracks are referenced with the generational handles of a HandleTable, which maps them to their
+     * place in their pool: removing a track swaps the last track of its pool into the freed place,
+     * and its slot is reused by the next added track, so that no allocation happens once the pool
+     * capacity is reached.
+     */
+    class AnimationPool {
+
+    public:
+        enum Type {
+            TRANSLATION = 0,
+            ROTATION = 1,
+            SLERP = 2
+        };
+
+        /**
+         * Handle to a track. A default Track refers to nothing.
+         */
+        struct Track {
+            Handle<Track> handle;
+            Type type;
+
+            Track() : type(TRANSLATION) {}
+            inline bool isValid() const { return !handle.isNull(); }
+        };
+
+        AnimationPool();
+        AnimationPool(const AnimationPool&) = delete;
+        AnimationPool& operator=(const AnimationPool&) = delete;
+        virtual ~AnimationPool();
+
+        /**
+         * Reserves room for 'count' tracks of each type.
+         */
+        void reserve(U32 count);
+
+        Track addTranslation(TransformComponent& target,
+                             const glm::vec3& from, const glm::vec3& to,
+                             float duration, TranslationAnimation::Function func,
+                             bool loop, bool mirror);
+
+        Track addRotation(TransformComponent& target,
+                          float duration, bool loop,
+                          float angle, const glm::vec3& axis);
+
+        Track addSlerp(TransformComponent& target,
+                       const glm::quat& from, const glm::quat& to,
+                       float duration, bool loop);
+
+        /**
+         * Restarts a running translation track with new bounds, in place.
+         * @return false if the track is not running anymore.
+         */
+        bool refreshTranslation(const Track& track, const glm::vec3& from, const glm::vec3& to, float duration);
+
+        /**
+         * @return true if the track has not been removed, and has not finished.
+         */
+        bool isRunning(const Track& track) const;
+
+        /**
+         * Removes the track if it is running, and resets the handle.
+         */
+        void remove(Track& track);
+
+        void clear();
+
+        /**
+         * Tracks are evaluated once every 'interval' steps, with the accumulated elapsed time.
+         */
+        inline void setInterval(U32 interval) {
+            mInterval = interval > 0 ? interval : 1;
+        }
+
+        inline U32 getInterval() const {
+            return mInterval;
+        }
+
+        /**
+         * Advances and applies all tracks. Finished tracks, which do not loop, are removed.
+         * @return true if tracks were evaluated during this step.
+         */
+        bool step(float dt);
+
+        inline U32 getTrackCount() const {
+            return (U32) (mTranslations.targets.size() + mRotations.targets.size() + mSlerps.targets.size());
+        }
+
+    private:
+        /**
+         * Columns shared by all track types. The i-th track of a pool is made of the i-th element of each column.
+         */
+        struct Columns {
+            std::vector<TransformComponent*> targets;
+            std::vector<float> times;
+            std::vector<float> durations;
+            std::vector<U8> loops;
+            /** handle of each track, to update the track table when a track moves. */
+            std::vector<Handle<Track>> handles;
+        };
+
+        Track mPush(Type type, Columns& columns, TransformComponent& target, float duration, bool loop);
+        void mRemoveAt(Type type, U32 index);
+        void mAdvance(Columns& columns, float dt);
+        void mStepTranslations();
+        void mStepRotations();
+        void mStepSlerps();
+        void mRemoveFinished(Type type, const Columns& columns);
+
+        /** index of each track in the columns of its pool */
+        HandleTable<Track, U32> mTracks;
+
+        Columns mTranslations;
+        std::vector<glm::vec3> mTranslationFrom;
+        std::vector<glm::vec3> mTranslationTo;
+        std::vector<U8> mTranslationFuncs;
+        std::vector<U8> mTranslationMirrors;
+
+        Columns mRotations;
+        std::vector<float> mRotationAngles;
+        std::vector<float> mRotationCurrentAngles;
+        std::vector<glm::vec3> mRotationAxes;
+
+        Columns mSlerps;
+        std::vector<glm::quat> mSlerpFrom;
+        std::vector<glm::quat> mSlerpTo;
+
+        /** interpolants of the pool being evaluated. */
+        std::vector<float> mInterpolants;
+
+        U32 mInterval;
+        U32 mFrame;
+        float mElapsed;
+    };
+}
+
+#endif //_DMA_ANIMATIONPOOL_HPP_
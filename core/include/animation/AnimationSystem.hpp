@@ -19,14 +19,15 @@
 #define _DMA_ANIMATIONSYSTEM_HPP_
 
 #include "common/Timer.hpp"
-#include "animation/AnimationComponent.hpp"
-#include "animation/Animation.hpp"
-#include "animation/SlerpAnimation.hpp"
-#include "animation/TranslationAnimation.hpp"
+#include "animation/AnimationPool.hpp"
 
-#include <list>
+#include <vector>
 
 namespace dma {
+
+    /**
+     * Steps the subscribed animation pools, once per scene step, before entities are updated.
+     */
     class AnimationSystem {
 
 
@@ -35,14 +36,16 @@ namespace dma {
 
         void unload();
 
-        void subscribe(AnimationComponent& animationComponent);
-        void unsubscribe(AnimationComponent& animationComponent);
+        void subscribe(AnimationPool& animationPool);
+        void unsubscribe(AnimationPool& animationPool);
 
-        void step(float dt);
+        /**
+         * @return true if at least one pool evaluated its tracks.
+         */
+        bool step(float dt);
 
     private:
-        std::list<Animation*> mAnimations;
-        std::list<AnimationComponent*> mAnimationComponents;
+        std::vector<AnimationPool*> mAnimationPools;
     };
 }
 
@@ -24,6 +24,14 @@
 
 namespace dma {
 
+    /**
+     * Easing functions, from x in [0, 1] to an interpolant in [0, 1].
+     * A mirrored function goes back to 0 in the second half.
+     */
+    float linear(float x, bool mirror);
+    float ease(float x, bool mirror);
+    float easeOut(float x, bool mirror);
+
     class TranslationAnimation : public Animation {
 
     public:
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_THREADPOOL_HPP_
+#define _DMA_THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Threads running queued tasks in the background, in submission order.
+     * Unlike Worker, nobody waits for a task: results are handed back by the tasks themselves,
+     * typically through a TaskScheduler flushed by the engine thread.
+     */
+    class ThreadPool {
+
+    public:
+        ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        void operator=(const ThreadPool&) = delete;
+        virtual ~ThreadPool();
+
+        /**
+         * @param threadCount number of threads, 0 for one less than the number of cores (at least one).
+         */
+        void start(U32 threadCount = 0);
+
+        /**
+         * Drops the pending tasks, waits for the running ones, and stops the threads.
+         */
+        void stop();
+
+        inline bool isRunning() const {
+            return !mThreads.empty();
+        }
+
+        inline U32 getThreadCount() const {
+            return (U32) mThreads.size();
+        }
+
+        void post(std::function<void()> task);
+
+        /**
+         * Drops the pending tasks. Running ones are not interrupted.
+         * @return the number of dropped tasks.
+         */
+        U32 cancelAll();
+
+        /**
+         * Waits until all queued tasks are done.
+         */
+        void wait();
+
+    private:
+        void mLoop();
+
+        std::vector<std::thread> mThreads;
+        std::mutex mLock;
+        std::condition_variable mCondition;
+        std::condition_variable mIdleCondition;
+        std::deque<std::function<void()>> mTasks;
+        U32 mRunningCount;
+        bool mExit;
+    };
+}
+
+#endif //_DMA_THREADPOOL_HPP_
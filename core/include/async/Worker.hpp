@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_WORKER_HPP_
+#define _DMA_WORKER_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace dma {
+
+    /**
+     * A thread running one task at a time, handed over by another thread which then waits for its completion.
+     */
+    class Worker {
+
+    public:
+        Worker();
+        Worker(const Worker&) = delete;
+        void operator=(const Worker&) = delete;
+        virtual ~Worker();
+
+        void start();
+
+        /**
+         * Waits for the current task, and stops the thread.
+         */
+        void stop();
+
+        inline bool isRunning() const {
+            return mThread.joinable();
+        }
+
+        /**
+         * Runs the task on the worker thread. The previous task must have been waited for.
+         */
+        void run(std::function<void()> task);
+
+        /**
+         * Waits for the current task to complete, if any.
+         */
+        void wait();
+
+    private:
+        void mLoop();
+
+        std::thread mThread;
+        std::mutex mLock;
+        std::condition_variable mCondition;
+        std::function<void()> mTask;
+        bool mBusy;
+        bool mExit;
+    };
+}
+
+#endif //_DMA_WORKER_HPP_
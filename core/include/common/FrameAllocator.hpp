@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_FRAMEALLOCATOR_HPP_
+#define _DMA_FRAMEALLOCATOR_HPP_
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Linear allocator for data living a single frame: allocating bumps an offset in a block,
+     * and everything is released at once by reset(). Nothing is destroyed on reset, so only
+     * trivially destructible types may be allocated.
+     *
+     * When the block is full, it is replaced by a block twice as large, and the full one is kept
+     * until the next reset. The block only grows: once it fits the largest frame, no more heap
+     * allocation happens.
+     */
+    class FrameAllocator {
+
+    public:
+        /**
+         * @param capacity initial block size, in bytes. The block is allocated by the first allocation.
+         */
+        FrameAllocator(U32 capacity = 0);
+        FrameAllocator(const FrameAllocator&) = delete;
+        void operator=(const FrameAllocator&) = delete;
+        virtual ~FrameAllocator();
+
+        /**
+         * @return room for 'count' uninitialized T, valid until the next reset.
+         */
+        template<typename T>
+        T* allocate(U32 count) {
+            static_assert(std::is_trivially_destructible<T>::value, "frame allocations are never destroyed");
+            return static_cast<T*>(mAllocate(count * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * Releases all allocations.
+         */
+        void reset();
+
+        /**
+         * @return the size of the block, in bytes.
+         */
+        inline U32 getCapacity() const {
+            return (U32) mCapacity;
+        }
+
+        /**
+         * @return the bytes allocated since the last reset, alignment included.
+         */
+        inline U32 getUsed() const {
+            return (U32) (mOffset + mRetiredBytes);
+        }
+
+    private:
+        void* mAllocate(size_t size, size_t alignment);
+
+        BYTE* mBlock;
+        size_t mCapacity;
+        size_t mOffset;
+        /** blocks replaced since the last reset, still holding allocations */
+        std::vector<BYTE*> mRetired;
+        /** bytes allocated in the retired blocks */
+        size_t mRetiredBytes;
+    };
+}
+
+#endif //_DMA_FRAMEALLOCATOR_HPP_
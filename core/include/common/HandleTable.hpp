@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_HANDLETABLE_HPP_
+#define _DMA_HANDLETABLE_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Typed reference to a resource of a HandleTable.
+     * Once the resource is removed, the handle becomes stale: its generation no longer
+     * matches the slot one, even if the slot is reused.
+     */
+    template<typename T>
+    struct Handle {
+        U32 index = 0;
+        /** 0 for null handles */
+        U32 generation = 0;
+
+        inline bool isNull() const { return generation == 0; }
+        inline bool operator==(const Handle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+        inline bool operator!=(const Handle& other) const { return !(*this == other); }
+    };
+
+
+    /**
+     * Dense table of resources, addressed by generational handles.
+     * Lookups are O(1) and do not touch the reference counts.
+     *
+     * Slots store a shared resource by default. Any other copyable value may be stored instead,
+     * eg. an index into arrays owned by the caller, then read with find().
+     */
+    template<typename T, typename V = std::shared_ptr<T>>
+    class HandleTable {
+
+    public:
+        HandleTable() {}
+        HandleTable(const HandleTable&) = delete;
+        void operator=(const HandleTable&) = delete;
+
+        /**
+         * Reserves room for 'count' values, so that adding them does not allocate.
+         */
+        void reserve(U32 count) {
+            mSlots.reserve(count);
+            mFreeSlots.reserve(count);
+        }
+
+        /**
+         * Stores the value, in a free slot if any. Resources must not be null.
+         */
+        Handle<T> add(const V& resource) {
+            U32 index;
+            if (!mFreeSlots.empty()) {
+                index = mFreeSlots.back();
+                mFreeSlots.pop_back();
+            } else {
+                index = (U32) mSlots.size();
+                mSlots.push_back(Slot());
+            }
+            Slot& slot = mSlots[index];
+            slot.resource = resource;
+            slot.used = true;
+            // generation 0 is reserved for null handles.
+            if (++slot.generation == 0) {
+                slot.generation = 1;
+            }
+            Handle<T> handle;
+            handle.index = index;
+            handle.generation = slot.generation;
+            return handle;
+        }
+
+        /**
+         * Releases the resource: its handles become stale.
+         */
+        void remove(Handle<T> handle) {
+            if (!isValid(handle)) {
+                return;
+            }
+            Slot& slot = mSlots[handle.index];
+            slot.resource = V();
+            slot.used = false;
+            ++slot.generation;
+            mFreeSlots.push_back(handle.index);
+        }
+
+        inline bool isValid(Handle<T> handle) const {
+            return handle.generation != 0
+                   && handle.index < mSlots.size()
+                   && mSlots[handle.index].generation == handle.generation
+                   && mSlots[handle.index].used;
+        }
+
+        /**
+         * @return the stored value, or nullptr if the handle is stale.
+         */
+        inline V* find(Handle<T> handle) {
+            return isValid(handle) ? &mSlots[handle.index].resource : nullptr;
+        }
+
+        inline const V* find(Handle<T> handle) const {
+            return isValid(handle) ? &mSlots[handle.index].resource : nullptr;
+        }
+
+        /**
+         * @return the resource, or nullptr if the handle is stale.
+         */
+        inline T* get(Handle<T> handle) const {
+            return isValid(handle) ? mSlots[handle.index].resource.get() : nullptr;
+        }
+
+        /**
+         * @return the shared resource, to be kept by the caller. Empty if the handle is stale.
+         */
+        inline const V& getShared(Handle<T> handle) const {
+            static const V none;
+            return isValid(handle) ? mSlots[handle.index].resource : none;
+        }
+
+        /**
+         * Calls fn(handle, value) for every stored value. Values may be removed meanwhile.
+         */
+        template<typename Fn>
+        void forEach(Fn fn) {
+            for (U32 i = 0; i < mSlots.size(); ++i) {
+                if (mSlots[i].used) {
+                    fn(handleAt(i), mSlots[i].resource);
+                }
+            }
+        }
+
+        template<typename Fn>
+        void forEach(Fn fn) const {
+            for (U32 i = 0; i < mSlots.size(); ++i) {
+                if (mSlots[i].used) {
+                    fn(handleAt(i), mSlots[i].resource);
+                }
+            }
+        }
+
+        inline U32 size() const {
+            return (U32) (mSlots.size() - mFreeSlots.size());
+        }
+
+        void clear() {
+            for (U32 i = 0; i < mSlots.size(); ++i) {
+                if (mSlots[i].used) {
+                    remove(handleAt(i));
+                }
+            }
+        }
+
+    private:
+        struct Slot {
+            V resource = V();
+            U32 generation = 0;
+            bool used = false;
+        };
+
+        inline Handle<T> handleAt(U32 index) const {
+            Handle<T> handle;
+            handle.index = index;
+            handle.generation = mSlots[index].generation;
+            return handle;
+        }
+
+        std::vector<Slot> mSlots;
+        std::vector<U32> mFreeSlots;
+    };
+}
+
+#endif //_DMA_HANDLETABLE_HPP_
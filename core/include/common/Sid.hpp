@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_SID_HPP_
+#define _DMA_SID_HPP_
+
+#include <string>
+#include <cstddef>
+
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Interned string identifier: equal strings get the same 32-bit id, for the whole run.
+     * Ids are compared and hashed in O(1), and the string remains available for file names & logs.
+     * Interning locks a global table: build Sids once, out of the hot paths.
+     * Interned strings are never freed: intern resource names, not transient keys such as tile paths.
+     */
+    class Sid {
+
+    public:
+        /** hash functor, for unordered containers */
+        struct Hash {
+            inline std::size_t operator()(const Sid& sid) const {
+                return sid.mId;
+            }
+        };
+
+        /**
+         * The empty Sid, whose id is 0.
+         */
+        Sid() : mId(0) {}
+        explicit Sid(const std::string& str);
+        explicit Sid(const char* str);
+
+        inline U32 getId() const {
+            return mId;
+        }
+
+        inline bool isEmpty() const {
+            return mId == 0;
+        }
+
+        /**
+         * @return the interned string. Lock-free.
+         */
+        const std::string& str() const;
+
+        inline bool operator==(const Sid& other) const { return mId == other.mId; }
+        inline bool operator!=(const Sid& other) const { return mId != other.mId; }
+        inline bool operator<(const Sid& other) const { return mId < other.mId; }
+
+    private:
+        U32 mId;
+    };
+}
+
+#endif //_DMA_SID_HPP_
@@ -34,7 +34,9 @@
 
 //Dma
 #include "utils/ExceptionHandler.hpp"
+#include "async/Worker.hpp"
 #include "common/Timer.hpp"
+#include "engine/FrameGovernor.hpp"
 #include "resource/ResourceManager.hpp"
 #include "rendering/RenderingEngine.hpp"
 #include "engine/Entity.hpp"
@@ -57,6 +59,8 @@ namespace dma {
 #ifndef FPS_PRINT_RATE
         static constexpr float FPS_PRINT_RATE =  -2.0f;             // NEGATIVE TO DISABLE
 #endif
+        /** default time spent per frame restoring resources after a progressive refresh, in seconds. */
+        static constexpr float RESTORE_BUDGET = 0.004f;
         /* ***
          * CONSTRUCTORS
          */
@@ -83,7 +87,19 @@ namespace dma {
 
         virtual void reload();
 
-        virtual void step();
+        /**
+         * Updates the scene and draws a frame.
+         * If idle frame skipping is enabled and nothing changed since the last drawn frame,
+         * the frame is not drawn: the host should not swap its buffers then.
+         * @return true if a frame has been drawn.
+         */
+        virtual bool step();
+
+        /**
+         * Starts measuring the frame of the next step(), for hosts updating their own scene before it.
+         * step() starts it itself otherwise.
+         */
+        void beginFrame();
 
         /* ***
          * OVERRIDDEN GETTERS
@@ -97,14 +113,100 @@ namespace dma {
             return isInit() && GLUtils::hasGlContext();
         }
 
+        inline bool isIdleFrameSkippingEnabled() const {
+            return mIdleFrameSkipping;
+        }
+
+        inline bool isPipelinedEnabled() const {
+            return mPipelined;
+        }
+
+        /**
+         * @return the number of frames not drawn because nothing changed.
+         */
+        inline U64 getSkippedFrameCount() const {
+            return mSkippedFrameCount;
+        }
+
+        /**
+         * @return the number of filesystem calls made between the last two calls to step().
+         */
+        inline U32 getFileSyscallCount() const {
+            return mFileSyscallCount;
+        }
+
         virtual void addHUDElement(std::shared_ptr<HUDElement> hudElement);
 
+        /**
+         * Overlapping labels are dropped if enabled, the default.
+         */
+        inline void setLabelCollisionEnabled(bool enabled) {
+            mRenderingEngine->setLabelCollisionEnabled(enabled);
+        }
+
+        /**
+         * @return the label counts of the last frame drawn, and the memory used by labels.
+         */
+        inline LabelSystem::Stats getLabelStats() const {
+            return mRenderingEngine->getLabelStats();
+        }
+
+        /**
+         * @return the memory held by the resources, per type, and its high-water marks.
+         * @see ResourceManager::sampleMemory
+         */
+        inline MemoryReport getMemoryReport() const {
+            return mResourceManager->sampleMemory();
+        }
+
+        /**
+         * Sets what becomes of the CPU copy of the resources of the given type once uploaded.
+         * @see ResourceManager::setRetention
+         */
+        inline void setRetention(ResourceManager::ResourceType type, Retention retention) {
+            mResourceManager->setRetention(type, retention);
+        }
+
+        /**
+         * Redraws an element already added, after its position, size or texture changed.
+         */
+        virtual void updateHUDElement(const HUDElement& hudElement);
+
+        virtual void removeHUDElement(const std::shared_ptr<HUDElement>& hudElement);
+
         /* ***
          * PUBLIC SETTERS
          */
 
         virtual void setSurfaceSize(U32, U32);
 
+        /**
+         * Sets how resources are restored on refresh().
+         * In progressive mode, resources that are not drawn right away are restored
+         * over the next frames, spending at most 'budget' seconds per frame.
+         */
+        void setRestoreMode(ResourceManager::RestoreMode mode, float budget = RESTORE_BUDGET);
+
+        /**
+         * Enables or disables idle frame skipping. Disabled by default, as it requires the host
+         * to preserve the last drawn frame, by not swapping buffers when step() returns false.
+         */
+        void setIdleFrameSkippingEnabled(bool enabled);
+
+        /**
+         * Enables or disables pipelining. When enabled, the scene of the next frame is updated on an update thread
+         * while the current frame is drawn: frame time gets close to max(update, draw) instead of their sum,
+         * at the cost of one frame of latency. Disabled by default.
+         * The scene is only updated during step(): it may still be modified from the GL thread between steps.
+         */
+        void setPipelinedEnabled(bool enabled);
+
+        /**
+         * Forces the next frame to be drawn.
+         * To be called after changes the engine cannot track, such as a material color change.
+         */
+        void invalidate();
+
         /* ***
          * PUBLIC GETTERS
          */
@@ -124,15 +226,36 @@ namespace dma {
             return *mGlobalTimer;
         }
 
+        //--------------------------------------------------------------------------
+        inline RenderingEngine& getRenderingEngine() const {
+            return *mRenderingEngine;
+        }
+
         //--------------------------------------------------------------------------
         inline Scene &getScene() const {
             return *mScene;
         }
 
+        //--------------------------------------------------------------------------
+        inline FrameGovernor& getFrameGovernor() const {
+            return *mFrameGovernor;
+        }
+
     private:
 
         void mUpdateFPS();
 
+        /**
+         * Draws the scene updated by the previous step, while the scene of the next one is updated by the worker.
+         * @return true if a frame has been drawn.
+         */
+        bool mStepPipelined();
+
+        /**
+         * Applies the quality knobs owned by the engine, if the frame governor changed its quality level.
+         */
+        void mApplyQuality();
+
         /* ***
          * ATTRIBUTES
          */
@@ -148,6 +271,23 @@ namespace dma {
         Scene *mScene;
         /** The animation system */
         AnimationSystem* mAnimationSystem;
+        /** Measures frame times & picks the quality level */
+        FrameGovernor* mFrameGovernor;
+        /** quality level the engine knobs are currently set to */
+        U32 mQualityLevel;
+        /** time spent per frame restoring resources, in seconds. */
+        float mRestoreBudget;
+        /** if true, frames are not drawn when nothing changed */
+        bool mIdleFrameSkipping;
+        /** if true, the scene is updated on mUpdateWorker one frame ahead of the draw */
+        bool mPipelined;
+        /** if true, beginFrame() was called for the next step */
+        bool mFrameBegun;
+        Worker mUpdateWorker;
+        /** result of the last scene step run by mUpdateWorker */
+        bool mUpdateChanged;
+        U64 mSkippedFrameCount;
+        U32 mFileSyscallCount;
         /** is engine properly initialized. */
         bool mIsInit;
 
@@ -53,7 +53,7 @@ namespace dma {
              * The Entity will be renderable, and its shape is defined by the given Mesh parameter.
              * @param const Mesh& -
              *              shape of this entity.
-             * @param const Material& -
+             * @param const MaterialInstance& -
              *              Material used by the mesh.
              * @param float -
              *              X position of this entity.
@@ -62,21 +62,21 @@ namespace dma {
              * @param float -
              *              Z position of this entity.
              */
-            Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, float x, float y, float z);
+            Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material, float x, float y, float z);
 
             /**
              * Create a new entity given its position.
              * The Entity will be renderable, and its shape is defined by the given Mesh parameter.
              * @param const Mesh& -
              *              shape of this entity.
-             * @param const Material& -
+             * @param const MaterialInstance& -
              *              Material used by the mesh.
              * @param const glm::vec3& -
              *              position of this entity.
              */
-            Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::vec3& pos);
+            Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material, const glm::vec3& pos);
 
-            Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material);
+            Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material);
 
             /* ***
              * PUBLIC METHODS
@@ -176,6 +176,13 @@ namespace dma {
                 return mRenderingComponent != nullptr;
             }
 
+            /**
+             * @return false if this entity has been hidden: it is still updated, but not drawn.
+             */
+            inline bool isVisible() const {
+                return mVisible;
+            }
+
             inline bool isAnimable() const {
                 return mAnimationComponent != nullptr;
             }
@@ -210,6 +217,28 @@ namespace dma {
                 mTransformComponent->setPosition(position);
             }
 
+            inline void setVisible(bool visible) {
+                mChanged |= visible != mVisible;
+                mVisible = visible;
+            }
+
+            /**
+             * Forces the next update to report a change.
+             * To be called on changes the entity cannot track, such as a material color change.
+             */
+            inline void invalidate() {
+                mChanged = true;
+            }
+
+            /**
+             * Sets the label drawn over the entity, or nullptr.
+             * Changes made to the label afterwards are drawn once the entity is invalidated.
+             */
+            inline void setLabel(const std::shared_ptr<Label>& label) {
+                mRenderingComponent->setLabel(label);
+                mChanged = true;
+            }
+
             inline void setOrientation(const glm::mat4& rotationMatrix) {
                 mTransformComponent->setOrientation(rotationMatrix);
             }
@@ -220,9 +249,9 @@ namespace dma {
             void setMesh(std::shared_ptr<Mesh> mesh);
 
             /**
-             * @param const Material& the material to be used by this mesh's entity.
+             * @param const MaterialInstance& the material to be used by this mesh's entity.
              */
-            void setMaterial(std::shared_ptr<Material>);
+            void setMaterial(std::shared_ptr<MaterialInstance>);
 
 
             TransformComponent& getTransformComponent() { return *mTransformComponent; }
@@ -231,13 +260,17 @@ namespace dma {
             void addAnimationComponent();
             /**
              * Updates entity components
+             * @return true if the entity changed since the last update, and needs to be redrawn.
              */
-            virtual void update(float dt);
+            virtual bool update(float dt);
 
         protected:
             TransformComponent* mTransformComponent;
             RenderingComponent* mRenderingComponent;
             AnimationComponent* mAnimationComponent;
+            bool mVisible;
+            /** true if the entity changed outside of its components since the last update */
+            bool mChanged;
         };
 
 } /* namespace dma */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_FRAMEGOVERNOR_HPP_
+#define _DMA_FRAMEGOVERNOR_HPP_
+
+#include <deque>
+
+#include "utils/GLES2Logger.hpp"
+#include "common/Types.hpp"
+#include "common/Timer.hpp"
+
+namespace dma {
+
+    /**
+     * Measures how long each frame takes, CPU side with a Timer and GPU side with
+     * timer queries (GL_EXT_disjoint_timer_query) when the platform supports them,
+     * and lowers or raises a quality level to keep the target frame rate.
+     *
+     * The governor only decides the level: the engine layers apply the matching
+     * Quality knobs they own.
+     */
+    class FrameGovernor {
+
+    public:
+        /* ***
+         * CONSTANTS
+         */
+        static constexpr U32 QUALITY_LEVEL_COUNT = 4;
+        static constexpr U32 HISTORY_SIZE = 120;
+        static constexpr F32 DEFAULT_TARGET_FRAME_RATE = 30.0f;
+
+        /**
+         * Quality knobs, from the lowest level (0) to the highest one.
+         */
+        struct Quality {
+            /** number of tiles drawn around the camera tile, in each direction. */
+            int tileWindowRadius;
+            /** max texture anisotropy. 1.0 disables anisotropic filtering. */
+            F32 anisotropy;
+            /** whether the skybox may be drawn. */
+            bool skyBox;
+            /** POI animations are evaluated every 'poiAnimationInterval' frames. */
+            U32 poiAnimationInterval;
+        };
+
+        struct Sample {
+            /** engine CPU time, in seconds. */
+            F32 cpuTime;
+            /** GPU time, in seconds. Negative if not measured. */
+            F32 gpuTime;
+            /** time from the start of the step which updated the drawn scene to the end of the frame, in seconds. */
+            F32 latency;
+            U32 qualityLevel;
+        };
+
+        /* ***
+         * CONSTRUCTORS
+         */
+        FrameGovernor();
+        virtual ~FrameGovernor();
+        FrameGovernor(const FrameGovernor&) = delete;
+        void operator=(const FrameGovernor&) = delete;
+
+        /**
+         * Creates the GPU timer queries, if supported. Requires an OpenGL context.
+         */
+        void init();
+
+        /**
+         * Clean all GPU resources
+         */
+        void wipe();
+
+        void beginFrame();
+        void endFrame();
+
+        /**
+         * Ends a frame that was not drawn: it is not measured, and does not affect the quality level.
+         */
+        void skipFrame();
+
+        /* ***
+         * GETTERS & SETTERS
+         */
+        inline bool isEnabled() const {
+            return mEnabled;
+        }
+
+        inline void setEnabled(bool enabled) {
+            mEnabled = enabled;
+        }
+
+        inline F32 getTargetFrameRate() const {
+            return 1.0f / mTargetFrameTime;
+        }
+
+        void setTargetFrameRate(F32 fps);
+
+        inline U32 getQualityLevel() const {
+            return mQualityLevel;
+        }
+
+        inline const Quality& getQuality() const {
+            return getQuality(mQualityLevel);
+        }
+
+        static const Quality& getQuality(U32 level);
+
+        /**
+         * Sets how many steps the drawn scene lags behind: 0 when the scene is updated and drawn in the same step,
+         * 1 when it is updated one step ahead of the draw.
+         */
+        inline void setLatencyFrames(U32 frames) {
+            mLatencyFrames = frames;
+        }
+
+        /**
+         * @return true if GPU times are measured.
+         */
+        inline bool hasGpuTimer() const {
+            return mGpuTimerSupported;
+        }
+
+        /**
+         * @return the last HISTORY_SIZE frames, oldest first.
+         */
+        inline const std::deque<Sample>& getHistory() const {
+            return mHistory;
+        }
+
+    private:
+        static constexpr U32 QUERY_COUNT = 4;
+
+        void mPollGpuTimer();
+        void mAdapt(F32 frameTime);
+
+        bool mEnabled;
+        F32 mTargetFrameTime;
+        U32 mQualityLevel;
+        /** smoothed frame time, in seconds. */
+        F32 mAverageFrameTime;
+        U32 mFramesSinceChange;
+        Timer mTimer;
+        double mFrameStart;
+        double mPreviousFrameStart;
+        U32 mLatencyFrames;
+        std::deque<Sample> mHistory;
+
+        bool mGpuTimerSupported;
+        GLuint mQueries[QUERY_COUNT];
+        /** true for the queries issued on skipped frames, whose results are ignored. */
+        bool mQuerySkipped[QUERY_COUNT];
+        /** CPU time each query was issued at: a GPU time longer than the time since then is bogus. */
+        double mQueryStart[QUERY_COUNT];
+        /** queries are issued at mQueryHead, and read back from mQueryTail. */
+        U32 mQueryHead;
+        U32 mQueryTail;
+        F32 mLastGpuTime;
+    };
+}
+
+#endif //_DMA_FRAMEGOVERNOR_HPP_
@@ -53,6 +53,11 @@ namespace dma {
          */
         inline Camera& getCamera() { return *mCamera; }
 
+        /**
+         * Gets the animation system, stepped before the entities are updated
+         */
+        inline AnimationSystem& getAnimationSystem() { return *mAnimationSystem; }
+
         /**
          * Sets the scene camera
          */
@@ -68,15 +73,52 @@ namespace dma {
 
         glm::vec3 castRay(int screenX, int screenY);
 
-        float distanceFromCamera(std::shared_ptr<Entity> entity);
+        inline U32 getViewportWidth() const { return mRenderingEngine->getViewportWidth(); }
+
+        inline U32 getViewportHeight() const { return mRenderingEngine->getViewportHeight(); }
+
+        float distanceFromCamera(const std::shared_ptr<Entity>& entity);
+
+        /**
+         * Same as distanceFromCamera, squared: without a square root, to compare distances.
+         */
+        float squaredDistanceFromCamera(const std::shared_ptr<Entity>& entity);
+
+        /**
+         * Entities allowing it are drawn as billboards when their bounding sphere gets smaller than
+         * the given diameter on screen. 0 disables billboards, the default.
+         * @param pixels on-screen diameter under which billboards are drawn.
+         * @see RenderingComponent::setImpostorPass
+         */
+        inline void setImpostorSize(F32 pixels) {
+            mImpostorSize = pixels;
+            mChanged = true;
+        }
+
+        inline F32 getImpostorSize() const {
+            return mImpostorSize;
+        }
 
         /**
          * 1. Checks if an origin shift is necessary. (TODO)
          *
-         * 2. Determines whether an entity is potentially displayable
-         *    and if so supplies it's rendering packages to the rendering engine. (TODO)
+         * 2. Updates the camera and the entities.
+         *
+         * 3. If anything changed, determines whether an entity is potentially displayable
+         *    and if so supplies it's rendering packages to the rendering engine.
+         *
+         * @return true if the scene changed and rendering packages were supplied,
+         *         false if the last drawn frame is still up to date.
+         */
+        bool step(float dt);
+
+        /**
+         * Forces the next step to supply the rendering packages, even if nothing moved.
+         * To be called on changes the scene cannot track (materials, textures, etc...).
          */
-        void step(float dt);
+        inline void invalidate() {
+            mChanged = true;
+        }
 
         /**
          * Adds an Entity to the scene.
@@ -113,6 +155,10 @@ namespace dma {
         std::set<std::shared_ptr<Entity>> mEntities;
         std::string mCurrentSkyboxSid = "default";
         bool mSkyboxEnabled = false;
+        /** true if the scene changed since the last step */
+        bool mChanged = true;
+        /** on-screen diameter under which billboards are drawn, in pixels */
+        F32 mImpostorSize = 0.0f;
     };
 }
 
@@ -22,6 +22,7 @@
 #include "glm/glm.hpp"
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtc/matrix_transform.hpp"
+#include "common/Types.hpp"
 
 namespace dma {
 
@@ -85,8 +86,14 @@ namespace dma {
              * Updates the M matrix:
              * => T * R * S if reverse is false
              * => S * R * T otherwise
+             * @return true if the matrix changed.
              */
-            void update(const bool reverse = false);
+            bool update(const bool reverse = false);
+
+            /**
+             * @return a number incremented each time the M matrix changes.
+             */
+            inline U32 getRevision() const { return mRevision; }
 
             inline bool isDirty() { return mDirty; }
             inline void setDirty(bool dirty) { mDirty = dirty; }
@@ -102,6 +109,7 @@ namespace dma {
             glm::mat4 mM;
             /** indicates if we need to recalculate the matrix */
             bool mDirty;
+            U32 mRevision;
         };
 }
 
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_GEO_ELEVATIONTILE_HPP_
+#define _DMA_GEO_ELEVATIONTILE_HPP_
+
+#include <vector>
+
+#include "common/Types.hpp"
+#include "resource/Image.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * The elevation samples of a digital elevation model (DEM) tile, in meters above sea level.
+         * Samples are decoded from terrain-RGB images: elevation = -10000 + (R * 256 * 256 + G * 256 + B) * 0.1
+         * Read-only once decoded: it may then be sampled from any thread.
+         */
+        class ElevationTile {
+
+            friend class TileMap;
+
+        public:
+            enum State {
+                /** waiting for its file */
+                REQUESTED,
+                /** decoded in the background */
+                DECODING,
+                READY,
+                FAILED
+            };
+
+            ElevationTile(int x, int y, int z);
+            ElevationTile(const ElevationTile&) = delete;
+            void operator=(const ElevationTile&) = delete;
+            virtual ~ElevationTile();
+
+            /**
+             * Decodes the samples out of a terrain-RGB image.
+             */
+            Status decode(Image& image);
+
+            /**
+             * @return the elevation at (u, v), bilinearly interpolated.
+             * u goes east and v south, in [0, 1] over the tile.
+             */
+            F32 getElevation(F32 u, F32 v) const;
+
+            inline State getState() const {
+                return mState;
+            }
+
+            inline F32 getMinElevation() const {
+                return mMin;
+            }
+
+            inline F32 getMaxElevation() const {
+                return mMax;
+            }
+
+        private:
+            int x;
+            int y;
+            int z;
+            State mState;
+            /** TileMap update the tile was last needed by */
+            U32 mLastUse;
+            U32 mWidth;
+            U32 mHeight;
+            F32 mMin;
+            F32 mMax;
+            /** row by row, from the north-west corner */
+            std::vector<F32> mSamples;
+        };
+    }
+}
+
+#endif //_DMA_GEO_ELEVATIONTILE_HPP_
@@ -66,10 +66,21 @@ namespace dma {
 
             virtual void wipe();
 
-            virtual void step();
+            /**
+             * @see Engine::step
+             * @return true if a frame has been drawn.
+             */
+            virtual bool step();
 
             void post(std::function<void()> message);
 
+            /**
+             * Picks the POI under the given screen point, from the POI snapshot of the last drawn frame.
+             * Thread safe: it does not wait for a step. The selection is applied on the next step.
+             * @return the SID of the picked POI, empty if none.
+             */
+            std::string pick(int screenX, int screenY);
+
             /* ***
              * GETTERS
              */
@@ -82,6 +93,13 @@ namespace dma {
                 return mEngine.isAbleToDraw();
             }
 
+            /**
+             * @see Engine::getSkippedFrameCount
+             */
+            inline U64 getSkippedFrameCount() const {
+                return mEngine.getSkippedFrameCount();
+            }
+
 
             inline PoiFactory& getPoiFactory() {
                 return mPoiFactory;
@@ -91,6 +109,13 @@ namespace dma {
                 return mGeoSceneManager;
             }
 
+            /**
+             * @return the frame governor, holding the current quality level and the frame time history.
+             */
+            inline FrameGovernor& getFrameGovernor() {
+                return mEngine.getFrameGovernor();
+            }
+
             /* ***
              * SETTERS
              */
@@ -98,6 +123,104 @@ namespace dma {
                 mEngine.setSurfaceSize(width, height);
             }
 
+            /**
+             * @see Engine::setIdleFrameSkippingEnabled
+             */
+            inline void setIdleFrameSkippingEnabled(bool enabled) {
+                mEngine.setIdleFrameSkippingEnabled(enabled);
+            }
+
+            /**
+             * @see Engine::setPipelinedEnabled
+             */
+            inline void setPipelinedEnabled(bool enabled) {
+                mEngine.setPipelinedEnabled(enabled);
+            }
+
+            inline bool isPipelinedEnabled() const {
+                return mEngine.isPipelinedEnabled();
+            }
+
+            /**
+             * @see Engine::setLabelCollisionEnabled
+             */
+            inline void setLabelCollisionEnabled(bool enabled) {
+                mEngine.setLabelCollisionEnabled(enabled);
+            }
+
+            /**
+             * @see Engine::getLabelStats
+             */
+            inline LabelSystem::Stats getLabelStats() const {
+                return mEngine.getLabelStats();
+            }
+
+            /**
+             * @see GeoSceneManager::setPoiImpostorSize
+             */
+            inline void setPoiImpostorSize(F32 pixels) {
+                mGeoSceneManager.setPoiImpostorSize(pixels);
+            }
+
+            /**
+             * @see GeoSceneManager::setPoiClusteringEnabled
+             */
+            inline void setPoiClusteringEnabled(bool enabled) {
+                mGeoSceneManager.setPoiClusteringEnabled(enabled);
+            }
+
+            /**
+             * @see TileMap::setVectorEnabled
+             */
+            inline void setVectorTilesEnabled(bool enabled) {
+                mGeoSceneManager.setVectorTilesEnabled(enabled);
+            }
+
+            inline TileMap::VectorStats getVectorTileStats() const {
+                return mGeoSceneManager.getVectorTileStats();
+            }
+
+            /**
+             * @see GeoSceneManager::setTerrainEnabled
+             */
+            inline void setTerrainEnabled(bool enabled) {
+                mGeoSceneManager.setTerrainEnabled(enabled);
+            }
+
+            inline TileMap::TerrainStats getTerrainStats() const {
+                return mGeoSceneManager.getTerrainStats();
+            }
+
+            /**
+             * @see Engine::getMemoryReport
+             * Vector tiles & terrain meshes are accounted for as well.
+             */
+            inline MemoryReport getMemoryReport() const {
+                return mEngine.getMemoryReport();
+            }
+
+            /**
+             * @see Engine::setRetention
+             */
+            inline void setRetention(ResourceManager::ResourceType type, Retention retention) {
+                mEngine.setRetention(type, retention);
+            }
+
+            /**
+             * To be called before init().
+             * @see ResourceManager::setPackFile
+             */
+            inline void setPackFile(int fd, U64 offset, U64 length) {
+                mEngine.getResourceManager().setPackFile(fd, offset, length);
+            }
+
+            /**
+             * @see GeoSceneManager::setPoiShaderAnimationEnabled
+             */
+            inline void setPoiShaderAnimationEnabled(bool enabled) {
+                mGeoSceneManager.setPoiShaderAnimationEnabled(enabled);
+            }
+
             virtual inline void setSkyBox(const std::string& sid) {
                 mGeoSceneManager.getScene().setSkyBox(sid);
             }
@@ -108,8 +231,20 @@ namespace dma {
 
             virtual void setCallback(GeoEngineCallbacks* callbacks);
 
+            /**
+             * @see Engine::setRestoreMode
+             */
+            inline void setRestoreMode(ResourceManager::RestoreMode mode, float budget = Engine::RESTORE_BUDGET) {
+                mEngine.setRestoreMode(mode, budget);
+            }
+
 
         private:
+            /**
+             * Applies the quality knobs owned by the geo layer, if the frame governor changed its quality level.
+             */
+            void mApplyQuality();
+
             /* ***
              * ATTRIBUTES
              */
@@ -121,6 +256,8 @@ namespace dma {
             GeoSceneManager                                 mGeoSceneManager;
             GeoEngineCallbacks                              *mDefaultCallbacks, *mCallbacks;
             TaskScheduler mMessageQueue;
+            /** quality level the geo knobs are currently set to */
+            U32 mQualityLevel;
         };
 
     } /* namespace geo */
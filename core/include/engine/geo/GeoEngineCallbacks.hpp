@@ -73,6 +73,21 @@ namespace dma {
                 Log::error(TAG, "Not implemented tile request (tile (%d, %d, %d))", x, y, z);
             }
 
+            /**
+             * Called each time the engine is missing the elevation tile (a terrain-RGB png) of an area,
+             * while terrain is enabled.
+             *
+             * @param int
+             *          x coord of the requested elevation tile.
+             * @param int
+             *          y coord of the requested elevation tile.
+             * @param int
+             *          z coord of the requested elevation tile.
+             */
+            virtual inline void onElevationTileRequest(int x, int y, int z) {
+                LOG_WARN(TAG, "Not implemented elevation tile request (tile (%d, %d, %d))", x, y, z);
+            }
+
             /**
              * Called each time the engine displays a tile.
              * This happens for example each time the position moves on an new area.
@@ -85,15 +100,15 @@ namespace dma {
              *          z coord of the requested tile.
              */
             virtual inline void onTileDiplayed(int x, int y, int z) {
-                Log::warn(TAG, "Not implemented tile update (tile (%d, %d, %d))", x, y, z);
+                LOG_WARN(TAG, "Not implemented tile update (tile (%d, %d, %d))", x, y, z);
             }
 
             virtual inline void onPoiSelected(const std::string& sid) {
-                Log::warn(TAG, "Not implemented on poi selected");
+                LOG_WARN(TAG, "Not implemented on poi selected");
             }
 
             virtual inline void onPoiDeselected(const std::string& sid) {
-                Log::warn(TAG, "Not implemented on poi deselected");
+                LOG_WARN(TAG, "Not implemented on poi deselected");
             }
 
         };
@@ -26,6 +26,8 @@
 #include "glm/glm.hpp"
 #include "engine/Scene.hpp"
 #include "engine/geo/Poi.hpp"
+#include "engine/geo/PoiClusterer.hpp"
+#include "engine/geo/PoiSnapshot.hpp"
 #include "engine/geo/TileMap.hpp"
 #include "engine/geo/PoiParams.hpp"
 #include "engine/geo/LatLng.hpp"
@@ -62,6 +64,16 @@ namespace dma {
 
             void step();
 
+            /**
+             * Uploads the GPU resources owned by the geo scene again.
+             */
+            void refresh();
+
+            /**
+             * Releases the GPU resources owned by the geo scene.
+             */
+            void wipe();
+
             /**
              * Convert world coordinates to openGL coordinates.
              */
@@ -108,6 +120,22 @@ namespace dma {
 
             std::shared_ptr<Poi> pick(int screenX, int screenY);
 
+            /**
+             * Highlights the POI with the given SID and notifies the callbacks.
+             * An empty or unknown SID deselects the current POI.
+             */
+            void select(const std::string& sid);
+
+            /**
+             * Publishes the POI bounds and the camera of the frame just drawn, for picking from other threads.
+             * @param changed false if the scene did not change since the last call.
+             */
+            void publishSnapshot(bool changed);
+
+            inline const PoiSnapshot& getPoiSnapshot() const {
+                return mPoiSnapshot;
+            }
+
             /* ***
              * TILEMAP-PASSTHROUGHT
              */
@@ -117,12 +145,89 @@ namespace dma {
              */
             Status notifyTileAvailable(int x, int y, int z);
 
+            inline Status notifyElevationTileAvailable(int x, int y, int z) {
+                return mTileMap.notifyElevationTileAvailable(x, y, z);
+            }
+
             void setCallbacks(GeoEngineCallbacks* callbacks);
 
             void setTileNamespace(const std::string& ns);
 
             void updateTileDiffuseMaps();
 
+            inline void setTileWindowRadius(int radius) {
+                mTileMap.setWindowRadius(radius);
+            }
+
+            /**
+             * @see TileMap::setVectorEnabled
+             */
+            inline void setVectorTilesEnabled(bool enabled) {
+                mTileMap.setVectorEnabled(enabled);
+            }
+
+            inline bool isVectorTilesEnabled() const {
+                return mTileMap.isVectorEnabled();
+            }
+
+            inline TileMap::VectorStats getVectorTileStats() const {
+                return mTileMap.getVectorStats();
+            }
+
+            /**
+             * If enabled, POIs and the camera stand on the terrain: their altitude is relative to the ground.
+             * @see TileMap::setTerrainEnabled
+             */
+            void setTerrainEnabled(bool enabled);
+
+            inline bool isTerrainEnabled() const {
+                return mTileMap.isTerrainEnabled();
+            }
+
+            inline TileMap::TerrainStats getTerrainStats() const {
+                return mTileMap.getTerrainStats();
+            }
+
+            /**
+             * @see AnimationPool::setInterval
+             */
+            void setPoiAnimationInterval(U32 interval);
+
+            /**
+             * If enabled, POI animations are evaluated by their vertex shader instead of the animation pool.
+             * Disabled by default: the POI shaders must declare the idle animation uniforms.
+             * @see Poi::animateInShader
+             */
+            void setPoiShaderAnimationEnabled(bool enabled);
+
+            inline bool isPoiShaderAnimationEnabled() const {
+                return mPoiShaderAnimation;
+            }
+
+            /**
+             * POIs smaller than 'pixels' on screen are drawn as billboards instead of their mesh.
+             * 0 disables billboards, the default.
+             * @see Scene::setImpostorSize
+             */
+            inline void setPoiImpostorSize(F32 pixels) {
+                mScene.setImpostorSize(pixels);
+            }
+
+            /**
+             * If enabled, POIs that would overlap on screen are replaced by cluster markers.
+             * Disabled by default. Clustered POIs can not be picked.
+             * @see PoiClusterer
+             */
+            void setPoiClusteringEnabled(bool enabled);
+
+            inline bool isPoiClusteringEnabled() const {
+                return mPoiClusterer.isEnabled();
+            }
+
+            inline PoiClusterer& getPoiClusterer() {
+                return mPoiClusterer;
+            }
+
         private:
             friend class GeoEngine;
             friend class GeoEngineAsync;
@@ -135,6 +240,11 @@ namespace dma {
              */
             glm::vec3 destinationPoint(double bearing, double distance) const;
 
+            /**
+             * Moves POIs and the camera onto the ground again, if the terrain changed since the last call.
+             */
+            void mUpdateGround();
+
 
             /* ***
              * ATTRIBUTES
@@ -147,6 +257,15 @@ namespace dma {
             int mLastX;
             int mLastY;
             std::shared_ptr<Poi> mSelected;
+            /** animations of all POIs, stepped by the scene animation system. */
+            AnimationPool mPoiAnimations;
+            bool mPoiShaderAnimation;
+            PoiClusterer mPoiClusterer;
+            PoiSnapshot mPoiSnapshot;
+            /** true if the last publication was skipped */
+            bool mSnapshotPending;
+            /** TileMap ground revision POIs and the camera stand on */
+            U32 mGroundRevision;
         };
     }
 }
@@ -25,7 +25,7 @@
 #include <rendering/Selectable.hpp>
 #include <glm/gtc/type_ptr.hpp>     // make_mat4
 #include "engine/Entity.hpp"
-#include "animation/RotationAnimation.hpp"
+#include "animation/AnimationPool.hpp"
 #include "LatLngAlt.hpp"
 
 namespace dma {
@@ -42,7 +42,7 @@ namespace dma {
         class Poi : public Entity, public Selectable {
 
         public:
-            Poi(const std::string& sid, std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material);
+            Poi(const std::string& sid, std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material);
             Poi(const Poi &) = delete;
             void operator=(const Poi &) = delete;
             virtual ~Poi();
@@ -103,6 +103,15 @@ namespace dma {
 
             void setColor(const Color& color);
 
+            /**
+             * Sets the text drawn over the POI, with the default font. An empty text removes the label.
+             */
+            void setLabel(const std::string& text);
+
+            inline const std::shared_ptr<Label>& getLabel() const {
+                return mRenderingComponent->getLabel();
+            }
+
             /**
              * Set the POI orientation.
              *
@@ -114,10 +123,27 @@ namespace dma {
                 Entity::setOrientation(rotationMatrix);
             }
 
-            void animate();
+            /**
+             * Starts the POI animations from its current position, in the given pool.
+             * Running animations are restarted in place.
+             */
+            void animate(AnimationPool& animationPool);
+
+            /**
+             * Starts the same animations in the POI vertex shader instead, so that its transform stays static.
+             * @see RenderingComponent::setIdleAnimation
+             */
+            void animateInShader();
+
             void deanimate();
 
-            inline std::shared_ptr<Material> getMaterial() {
+            /**
+             * Hides the POI in a cluster, or shows it back. Clustered POIs stop their pool animations,
+             * started again from their rest position when they are shown.
+             */
+            void setClustered(bool clustered);
+
+            inline std::shared_ptr<MaterialInstance> getMaterial() {
                 return mRenderingComponent->getRenderingPackages()[0]->getMaterial();
             }
 
@@ -151,8 +177,11 @@ namespace dma {
             double mLon;
             double mAlt;
             bool mDirty;
-            TranslationAnimation* mCurrentTranslationAnimation;
-            RotationAnimation* mCurrentRotationAnimation;
+            AnimationPool* mAnimationPool;
+            AnimationPool::Track mTranslationTrack;
+            AnimationPool::Track mRotationTrack;
+            /** position the translation track bobs from */
+            glm::vec3 mRestPosition;
         };
     }
 }
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_POICLUSTERER_HPP_
+#define _DMA_POICLUSTERER_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "common/Types.hpp"
+#include "engine/Scene.hpp"
+#include "engine/geo/Poi.hpp"
+#include "engine/geo/PoiFactory.hpp"
+#include "utils/Color.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Collapses the POIs that would overlap on screen into cluster markers, so that the scene
+         * only updates, culls, sorts and draws what can be told apart.
+         *
+         * POIs are bucketed in a world grid whose cell size is a power of two, chosen for each POI so that a cell
+         * covers about 'cell size' pixels at its distance from the camera: cells are stable while the camera
+         * turns or pans, and split as it gets closer. Clustered POIs are hidden, and a marker scaled after
+         * the POI count, and labelled with it, is shown at their centroid. Clusters are only computed again when the POIs,
+         * the camera position or the projection change: a camera move only moves the POIs whose cell changed
+         * from a bucket to another, all POIs are bucketed again when the POIs, the cell size or the zoom change.
+         */
+        class PoiClusterer {
+
+        public:
+            /* ***
+             * CONSTANTS
+             */
+            /** default on-screen size of a cell, in pixels. */
+            static constexpr F32 DEFAULT_CELL_SIZE = 64.0f;
+            static constexpr U32 DEFAULT_MIN_CLUSTER_SIZE = 2;
+            /** prefix of the cluster marker SIDs. */
+            static constexpr const char* MARKER_SID = "cluster#";
+
+            PoiClusterer(Scene& scene, ResourceManager& resourceManager);
+            PoiClusterer(const PoiClusterer&) = delete;
+            void operator=(const PoiClusterer&) = delete;
+            virtual ~PoiClusterer();
+
+            /**
+             * Computes the clusters again if needed.
+             * @return true if the clusters have been computed again.
+             */
+            bool update(const std::map<std::string, std::shared_ptr<Poi>>& pois);
+
+            /**
+             * Removes the markers from the scene, and releases them.
+             */
+            void unload();
+
+            /**
+             * Forces the clusters to be computed again on the next update, after POIs were added, removed or moved.
+             */
+            inline void invalidate() {
+                mInvalidated = true;
+            }
+
+            /**
+             * Shows a POI that may have been hidden by the clusterer, when it leaves the scene.
+             */
+            inline void release(Poi& poi) {
+                poi.setClustered(false);
+            }
+
+            /**
+             * Disabling clustering shows all the given POIs back, and removes the markers from the scene.
+             */
+            void setEnabled(bool enabled, const std::map<std::string, std::shared_ptr<Poi>>& pois);
+
+            inline bool isEnabled() const {
+                return mEnabled;
+            }
+
+            /**
+             * @param pixels on-screen size of a cell. POIs closer than that on screen are likely to be clustered.
+             */
+            void setCellSize(F32 pixels);
+
+            /**
+             * @param count minimum number of POIs in a cell to make a cluster.
+             */
+            void setMinClusterSize(U32 count);
+
+            /**
+             * Sets how cluster markers look. Markers already built keep their look.
+             */
+            void setMarker(const std::string& shape, const std::string& icon, const Color& color);
+
+            /**
+             * @return the number of clusters shown.
+             */
+            inline U32 getClusterCount() const {
+                return mMarkerCount;
+            }
+
+            /**
+             * @return the number of POIs hidden in clusters.
+             */
+            inline U32 getClusteredPoiCount() const {
+                return mClusteredCount;
+            }
+
+        private:
+            struct Cell {
+                glm::vec3 sum;
+                U32 count;
+                /** index of the cell marker, if clustered */
+                U32 marker;
+                U64 key;
+            };
+
+            /**
+             * Adds the i-th POI to the cell of the given key, created if needed.
+             */
+            void mAddToCell(U32 i, U64 key);
+
+            /**
+             * Removes the i-th POI from its cell, released once empty.
+             */
+            void mRemoveFromCell(U32 i);
+
+            std::shared_ptr<Poi> mBuildMarker(U32 index);
+            void mRemoveMarkers(U32 from);
+
+            Scene& mScene;
+            PoiFactory mMarkerFactory;
+            std::string mMarkerShape;
+            std::string mMarkerIcon;
+            Color mMarkerColor;
+            bool mEnabled;
+            bool mInvalidated;
+            F32 mCellSize;
+            U32 mMinClusterSize;
+
+            /** camera when the clusters were last computed */
+            glm::vec3 mLastEye;
+            F32 mLastFocal;
+            U32 mLastHeight;
+
+            /** non empty cells, by key */
+            std::unordered_map<U64, U32> mCellIndex;
+            std::vector<Cell> mCells;
+            /** indices of the empty cells, reused first */
+            std::vector<U32> mFreeCells;
+            /** cell, cell key and bucketed position of each POI, in map order */
+            std::vector<U32> mPoiCells;
+            std::vector<U64> mPoiKeys;
+            std::vector<glm::vec3> mPoiPositions;
+            /** marker pool. The first mMarkerCount ones are in the scene. */
+            std::vector<std::shared_ptr<Poi>> mMarkers;
+            U32 mMarkerCount;
+            U32 mClusteredCount;
+        };
+    }
+}
+
+#endif //_DMA_POICLUSTERER_HPP_
@@ -59,6 +59,7 @@ namespace dma {
                 Builder& shape(const std::string& shape);
                 Builder& icon(const std::string& icon);
                 Builder& color(const Color& color);
+                Builder& label(const std::string& label);
                 std::shared_ptr<Poi> build();
             protected:
                 ResourceManager& mResourceManager;
@@ -66,6 +67,7 @@ namespace dma {
                 std::string mShape;
                 std::string mIcon;
                 Color mColor;
+                std::string mLabel;
             };
 
         public:
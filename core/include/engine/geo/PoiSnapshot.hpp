@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_POISNAPSHOT_HPP_
+#define _DMA_POISNAPSHOT_HPP_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "common/Types.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Immutable copy of the POI world bounds and of the camera, published by the render thread
+         * once per drawn frame, so that POIs can be picked from any thread without waiting for a step.
+         *
+         * Two frames are kept: the render thread fills the one that is not published, and readers
+         * count themselves on the published one. Reading never blocks; publishing is skipped
+         * (and retried on the next step) while readers still hold the frame to fill.
+         */
+        class PoiSnapshot {
+
+        public:
+            struct Frame {
+                glm::mat4 inverseV;
+                glm::mat4 inverseP;
+                glm::vec3 cameraPosition;
+                F32 viewportWidth;
+                F32 viewportHeight;
+                std::vector<std::string> sids;
+                /** world bounding spheres: center in xyz, radius in w. */
+                std::vector<glm::vec4> spheres;
+            };
+
+            PoiSnapshot();
+            PoiSnapshot(const PoiSnapshot&) = delete;
+            void operator=(const PoiSnapshot&) = delete;
+
+            /**
+             * Render thread only.
+             * @return the frame to fill, or nullptr if it is still read: the publication must be retried later.
+             */
+            Frame* beginPublish();
+
+            /**
+             * Render thread only. Publishes the frame returned by beginPublish.
+             */
+            void endPublish();
+
+            /**
+             * Thread safe. Casts a ray from the camera through the given screen point.
+             * @param sid filled with the SID of the closest intersected POI.
+             * @return false if no POI is intersected, or if nothing was published yet.
+             */
+            bool pick(int screenX, int screenY, std::string& sid) const;
+
+        private:
+            Frame mFrames[2];
+            /** index of the published frame, or -1 */
+            std::atomic<int> mFront;
+            mutable std::atomic<U32> mReaders[2];
+        };
+    }
+}
+
+#endif //_DMA_POISNAPSHOT_HPP_
@@ -18,8 +18,10 @@
 #ifndef _DMA_GEO_TILE_HPP_
 #define _DMA_GEO_TILE_HPP_
 
+#include "common/HandleTable.hpp"
 #include "engine/Entity.hpp"
 #include "resource/Quad.hpp"
+#include "resource/TerrainMesh.hpp"
 #include "LatLng.hpp"
 
 namespace dma {
@@ -31,11 +33,11 @@ namespace dma {
 
         public:
             Tile(std::shared_ptr<Quad> quad,
-                 std::shared_ptr<Material> material,
+                 std::shared_ptr<MaterialInstance> material,
                 const LatLng& coords, int x, int y, int z);
 
             Tile(std::shared_ptr<Quad> quad,
-                 std::shared_ptr<Material> material);
+                 std::shared_ptr<MaterialInstance> material);
 
             virtual ~Tile();
 
@@ -70,7 +72,12 @@ namespace dma {
 
             std::shared_ptr<Map> getDiffuseMap();
 
-            std::shared_ptr<Material> getMaterial();
+            std::shared_ptr<MaterialInstance> getMaterial();
+
+            /**
+             * Drapes the tile over the given terrain mesh, or lays it flat again if nullptr.
+             */
+            void setTerrainMesh(const std::shared_ptr<TerrainMesh>& mesh);
 
         private:
             //FIELDS
@@ -80,6 +87,11 @@ namespace dma {
             int z;
             bool mDirty;
             std::shared_ptr<Quad> mQuad;
+            /** map of the tile once looked up, null while the default map is shown */
+            Handle<Map> mDiffuseHandle;
+            std::shared_ptr<TerrainMesh> mTerrainMesh;
+            /** grid resolution of the terrain mesh shown or being built, 0 if flat */
+            U32 mTerrainSegments;
         };
     }
 }
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_GEO_TILEID_HPP_
+#define _DMA_GEO_TILEID_HPP_
+
+#include <cstddef>
+
+#include "common/Types.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Identifies a tile by its zoom level and coordinates.
+         * Its key is computed from z/x/y, without going through a string.
+         */
+        struct TileId {
+            /** hash functor, for unordered containers */
+            struct Hash {
+                inline std::size_t operator()(const TileId& id) const {
+                    U64 key = id.getKey();
+                    return (std::size_t) (key ^ (key >> 32));
+                }
+            };
+
+            int x;
+            int y;
+            int z;
+
+            TileId() : x(-1), y(-1), z(-1) {}
+            TileId(int x, int y, int z) : x(x), y(y), z(z) {}
+
+            /**
+             * @return 5 bits of zoom, then 29 bits for each coordinate: unique up to zoom 29.
+             */
+            inline U64 getKey() const {
+                return ((U64) (z & 0x1F) << 58) | ((U64) (x & 0x1FFFFFFF) << 29) | (U64) (y & 0x1FFFFFFF);
+            }
+
+            inline bool operator==(const TileId& other) const {
+                return x == other.x && y == other.y && z == other.z;
+            }
+
+            inline bool operator!=(const TileId& other) const {
+                return !(*this == other);
+            }
+        };
+    }
+}
+
+#endif //_DMA_GEO_TILEID_HPP_
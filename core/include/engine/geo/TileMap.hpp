@@ -18,12 +18,20 @@
 #ifndef _DMA_GEO_TILEMAP_HPP_
 #define _DMA_GEO_TILEMAP_HPP_
 
+#include "engine/Scene.hpp"
 #include "engine/geo/Tile.hpp"
+#include "engine/geo/TileId.hpp"
+#include "engine/geo/ElevationTile.hpp"
+#include "engine/geo/VectorStyle.hpp"
+#include "engine/geo/VectorTile.hpp"
 #include "engine/geo/GeoEngineCallbacks.hpp"
+#include "async/TaskScheduler.hpp"
+#include "async/ThreadPool.hpp"
 #include "resource/ResourceManager.hpp"
 
 #include <list>
 #include <queue>
+#include <unordered_map>
 
 namespace dma {
     namespace geo {
@@ -38,10 +46,55 @@ namespace dma {
             static constexpr int        SIZE       = 7;
             static constexpr int        OFFSET     = SIZE / 2;
             static constexpr int        ZOOM     = 19;
+            /** sid of the vector style, under style/ */
+            static constexpr char       VECTOR_STYLE[]      = "vector";
+            /** number of vector tiles kept loaded out of the window */
+            static constexpr U32        VECTOR_CACHE_SIZE   = 8;
+            static constexpr char       VECTOR_EXTENSION[]  = ".mvt";
+            /** elevation tiles are terrain-RGB images, under texture/elevation/ */
+            static constexpr char       ELEVATION_PREFIX[]  = "elevation/";
+            static constexpr char       ELEVATION_EXTENSION[] = ".png";
+            /** number of elevation tiles kept loaded out of the window */
+            static constexpr U32        ELEVATION_CACHE_SIZE = 4;
+            /** terrain grid resolution of a tile, by its distance in tiles to the center one */
+            static constexpr U32        TERRAIN_SEGMENTS[OFFSET + 1] = {8, 8, 4, 2};
+            /** minimum depth of the terrain skirts, in meters */
+            static constexpr F32        MIN_SKIRT_DEPTH     = 2.0f;
 
             friend class GeoSceneManager;
 
         public:
+            static constexpr int        DEFAULT_VECTOR_ZOOM = 14;
+            static constexpr int        DEFAULT_TERRAIN_ZOOM = 14;
+
+            struct VectorStats {
+                /** loaded vector tiles, and the ones drawable */
+                U32 tileCount = 0;
+                U32 readyCount = 0;
+                U32 meshCount = 0;
+                U32 vertexCount = 0;
+                U32 triangleCount = 0;
+                /** CPU copy of the vertex & index buffers */
+                U32 byteCount = 0;
+                /** tiles decoded & tessellated so far, and the worker time they took, in seconds */
+                U32 builtCount = 0;
+                F32 buildTime = 0.0f;
+            };
+
+            struct TerrainStats {
+                /** loaded elevation tiles, and the ones decoded */
+                U32 elevationCount = 0;
+                U32 readyCount = 0;
+                /** tiles draped over a terrain mesh */
+                U32 meshCount = 0;
+                U32 vertexCount = 0;
+                U32 triangleCount = 0;
+                /** CPU copy of the elevation samples, and of the vertex & index buffers */
+                U32 byteCount = 0;
+                /** terrain meshes built so far, and the worker time they took with the decoding, in seconds */
+                U32 builtCount = 0;
+                F32 buildTime = 0.0f;
+            };
 
             /* ***
              * STATIC TOOL METHODS
@@ -75,6 +128,102 @@ namespace dma {
 
             void setNamespace(const std::string& ns);
 
+            /**
+             * Only tiles at most 'radius' tiles away from the center one are drawn.
+             * Tiles out of this window are still loaded, to be shown again without delay.
+             */
+            void setWindowRadius(int radius);
+
+            inline int getWindowRadius() const {
+                return mWindowRadius;
+            }
+
+            /**
+             * If enabled, the tile map is drawn out of vector tiles (.mvt files, next to the .png ones) instead
+             * of raster ones. Vector tiles are requested at the vector zoom, where one tile spans many raster
+             * ones: their features are decoded and tessellated on worker threads, then drawn with the materials
+             * of the vector style (style/vector.json). Disabled by default.
+             */
+            void setVectorEnabled(bool enabled);
+
+            inline bool isVectorEnabled() const {
+                return mVectorEnabled;
+            }
+
+            /**
+             * Sets the zoom level vector tiles are requested at, at most ZOOM.
+             */
+            void setVectorZoom(int zoom);
+
+            inline int getVectorZoom() const {
+                return mVectorZoom;
+            }
+
+            /**
+             * Notify that a vector tile file provided is available
+             * @return Status::OK if the tile is part of the tile map.
+             */
+            Status notifyVectorTileAvailable(int x, int y, int z);
+
+            /**
+             * If enabled, tiles are draped over terrain meshes, built out of elevation tiles (terrain-RGB images,
+             * under texture/elevation/) requested at the terrain zoom. Meshes are built on a worker thread, with
+             * a grid resolution decreasing away from the center tile. Disabled by default.
+             * Heights are relative to the ground under the first elevation tile loaded.
+             */
+            void setTerrainEnabled(bool enabled);
+
+            inline bool isTerrainEnabled() const {
+                return mTerrainEnabled;
+            }
+
+            /**
+             * Sets the zoom level elevation tiles are requested at, at most ZOOM.
+             */
+            void setTerrainZoom(int zoom);
+
+            inline int getTerrainZoom() const {
+                return mTerrainZoom;
+            }
+
+            /**
+             * Notify that an elevation tile file provided is available
+             * @return Status::OK if the tile is part of the tile map.
+             */
+            Status notifyElevationTileAvailable(int x, int y, int z);
+
+            /**
+             * @return the height of the terrain at the given location, in meters, or 0 if unknown.
+             */
+            F32 getGroundHeight(double lat, double lng) const;
+
+            /**
+             * @return a number changing whenever getGroundHeight may return other heights.
+             */
+            inline U32 getGroundRevision() const {
+                return mGroundRevision;
+            }
+
+            /**
+             * Adds the vector tiles & terrain meshes built since the last call to the scene.
+             * Requires an OpenGL context.
+             */
+            void flush();
+
+            /**
+             * Uploads the vector tiles & terrain meshes again, after the OpenGL context changed.
+             */
+            void refresh();
+
+            /**
+             * Releases the OpenGL buffers of the vector tiles & terrain meshes.
+             */
+            void wipe();
+
+            VectorStats getVectorStats() const;
+
+            TerrainStats getTerrainStats() const;
+
             void setCallbacks(GeoEngineCallbacks* callbacks) {
                 if(!callbacks) {
                     mCallbacks = mNullCallbacks;
@@ -84,16 +233,16 @@ namespace dma {
             }
 
         private:
-            TileMap(ResourceManager&);
+            TileMap(Scene&, ResourceManager&);
             TileMap(const TileMap&) = delete;
             void operator=(const TileMap&) = delete;
             virtual ~TileMap();
 
             //METHODS
 
-            std::string tileSid(int x, int y, int z) const;
+            std::string tileSid(int x, int y, int z, const char* prefix = "tiles/") const;
 
-            Status mUpdateTile(std::shared_ptr<Tile> tile, double lat, double lng,
+            Status mUpdateTile(Tile& tile, double lat, double lng,
                     float width, float height,
                     int x, int y, int z);
 
@@ -101,15 +250,126 @@ namespace dma {
 
             void mRemoveAllTiles();
 
-            std::shared_ptr<Tile> findTile(int x, int y, int z);
+            void mUpdateVisibility();
+
+            Tile* findTile(int x, int y, int z);
+
+            /**
+             * @return the fallback map shown while a tile is not available.
+             */
+            std::shared_ptr<Map> mGetDefaultMap();
+
+            /**
+             * Sets the map of the tile, or the default map if it has none. Builds no string
+             * once the map is loaded.
+             * @return false if the tile has no map.
+             */
+            bool mUpdateDiffuseMap(Tile& tile);
+
+            /**
+             * Loads the vector tiles covering the window, and drops the ones out of it beyond the cache size.
+             */
+            void mUpdateVectorTiles();
+
+            /**
+             * Reads the vector tile, and posts its build to the worker threads, or requests it.
+             */
+            void mLoadVectorTile(const std::shared_ptr<VectorTile>& tile);
+
+            void mOnVectorTileBuilt(const std::weak_ptr<VectorTile>& target, U32 generation, bool decoded,
+                                    const std::vector<VectorTile::Part>& parts, F32 buildTime);
+
+            void mShowVectorTile(VectorTile& tile, bool visible);
+
+            void mRemoveVectorTile(U64 key);
+
+            /**
+             * Drops all vector tiles, including the ones being built.
+             */
+            void mClearVectorTiles();
+
+            /**
+             * Loads the elevation tiles covering the window, and requests the terrain meshes of the tiles.
+             */
+            void mUpdateTerrain();
+
+            /**
+             * Reads the elevation tile, and posts its decoding to the worker thread, or requests it.
+             */
+            void mLoadElevationTile(const std::shared_ptr<ElevationTile>& tile);
+
+            void mOnElevationTileDecoded(const std::shared_ptr<ElevationTile>& target, U32 generation,
+                                         bool decoded, F32 decodeTime);
+
+            /**
+             * Posts the build of the terrain mesh of the tile, if its resolution changed and its elevation
+             * tile is decoded.
+             */
+            void mUpdateTileTerrain(Tile& tile);
+
+            void mOnTerrainMeshBuilt(int x, int y, int z, U32 segments, U32 generation,
+                                     const std::shared_ptr<TerrainMesh>& mesh, F32 buildTime);
+
+            /**
+             * Lays the tile flat, until its terrain mesh is built again.
+             */
+            void mFlattenTile(Tile& tile);
+
+            /**
+             * Drops all elevation tiles & terrain meshes, including the ones being built.
+             */
+            void mClearTerrain();
+
+            /**
+             * Sets the memory held by vector tiles & terrain to the resource manager report.
+             */
+            void mReportMemory();
 
             //Fields
+            Scene& mScene;
             ResourceManager& mResourceManager;
             /** the last known center position. */
             int mLastX, mLastY;
+            int mWindowRadius;
             std::list<std::shared_ptr<Tile>> mTiles;
+            /** tiles indexed by TileId key. */
+            std::unordered_map<U64, Tile*> mTileIndex;
+            Handle<Map> mDefaultMap;
             std::string mNamespace;
             GeoEngineCallbacks* mNullCallbacks, * mCallbacks;
+
+            bool mVectorEnabled;
+            int mVectorZoom;
+            /** bumped whenever all vector tiles are dropped, so that the builds in progress are ignored */
+            U32 mVectorGeneration;
+            /** bumped on each window update */
+            U32 mVectorUpdate;
+            std::unordered_map<U64, std::shared_ptr<VectorTile>> mVectorTiles;
+            /** read-only once loaded, shared with the worker threads */
+            std::shared_ptr<const VectorStyle> mVectorStyle;
+            ThreadPool mVectorPool;
+            /** filled by the worker threads, flushed on the OpenGL thread */
+            TaskScheduler mBuilt;
+            /** meshes of dropped tiles, released once no frame draws them anymore */
+            std::vector<std::shared_ptr<GeneratedMesh>> mRetiredMeshes;
+            U32 mVectorBuiltCount;
+            F32 mVectorBuildTime;
+
+            bool mTerrainEnabled;
+            int mTerrainZoom;
+            /** bumped whenever all elevation tiles are dropped, so that the builds in progress are ignored */
+            U32 mTerrainGeneration;
+            /** bumped on each window update */
+            U32 mTerrainUpdate;
+            std::unordered_map<U64, std::shared_ptr<ElevationTile>> mElevationTiles;
+            /** a single thread: terrain builds are small, and cancelled apart from the vector ones */
+            ThreadPool mTerrainPool;
+            /** elevation of the ground the heights are relative to, once known */
+            F32 mTerrainBase;
+            bool mHasTerrainBase;
+            U32 mGroundRevision;
+            U32 mTerrainBuiltCount;
+            F32 mTerrainBuildTime;
         };
     }
 }
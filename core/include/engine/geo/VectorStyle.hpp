@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_GEO_VECTORSTYLE_HPP_
+#define _DMA_GEO_VECTORSTYLE_HPP_
+
+#include <string>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "utils/MvtReader.hpp"
+#include "glm/glm.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Tells how vector tile features are drawn. Each rule selects the features of a layer,
+         * optionally by the value of one of their properties, and gives the way they are tessellated
+         * and the material they are drawn with. A feature takes the first rule it matches.
+         *
+         * Parsed from json:
+         * {"rules": [{"type": "background", "color": [0.9, 0.9, 0.9]},
+         *            {"layer": "road", "filter": {"class": ["primary"]}, "type": "line", "width": 8, "order": 2},
+         *            {"layer": "building", "type": "extrusion", "height": 10}]}
+         */
+        class VectorStyle {
+
+        public:
+            /* ***
+             * CONSTANTS
+             */
+            static constexpr char GROUND_MATERIAL[] = "vector_ground";
+            static constexpr char BUILDING_MATERIAL[] = "vector_building";
+
+            enum Kind {
+                /** covers the whole tile */
+                BACKGROUND = 0,
+                /** polygons, flat on the ground */
+                FILL = 1,
+                /** lines and polygon outlines, as flat strips on the ground */
+                LINE = 2,
+                /** polygons, as walls and roofs */
+                EXTRUSION = 3
+            };
+
+            struct Rule {
+                Kind kind = FILL;
+                std::string layer;
+                /** if not empty, only features whose 'filterKey' property is one of 'filterValues' match */
+                std::string filterKey;
+                std::vector<std::string> filterValues;
+                std::string material;
+                glm::vec3 color = glm::vec3(1.0f);
+                /** lines: width, in meters */
+                F32 width = 1.0f;
+                /** extrusions: height of the features which do not have one, in meters */
+                F32 height = 10.0f;
+                /** flat geometries: those of higher order are drawn over the others */
+                U32 order = 0;
+            };
+
+            VectorStyle();
+            virtual ~VectorStyle();
+
+            Status parse(const std::string& json);
+
+            inline const std::vector<Rule>& getRules() const {
+                return mRules;
+            }
+
+            /**
+             * @param rules receives the indices of the rules selecting features of the given layer.
+             */
+            void findRules(const std::string& layer, std::vector<U32>& rules) const;
+
+            /**
+             * @return whether the feature of the layer passes the rule filter.
+             */
+            bool matches(const Rule& rule, const MvtReader::Layer& layer, const MvtReader::Feature& feature) const;
+
+        private:
+            std::vector<Rule> mRules;
+        };
+    }
+}
+
+#endif //_DMA_GEO_VECTORSTYLE_HPP_
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_GEO_VECTORTILE_HPP_
+#define _DMA_GEO_VECTORTILE_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "engine/Entity.hpp"
+#include "engine/geo/LatLng.hpp"
+#include "resource/VectorMesh.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * A vector tile, drawn as one entity per bucket of triangles built out of it (see VectorTileBuilder).
+         * All its entities are placed at the north-west corner of the tile.
+         */
+        class VectorTile {
+
+            friend class TileMap;
+            friend class GeoSceneManager;
+
+        public:
+            enum State {
+                /** waiting for its file */
+                REQUESTED,
+                /** decoded & tessellated in the background */
+                BUILDING,
+                READY,
+                FAILED
+            };
+
+            /**
+             * A bucket of triangles, and the style rule it was built for.
+             */
+            struct Part {
+                U32 rule;
+                std::shared_ptr<VectorMesh> mesh;
+            };
+
+            VectorTile(int x, int y, int z);
+            VectorTile(const VectorTile&) = delete;
+            void operator=(const VectorTile&) = delete;
+            virtual ~VectorTile();
+
+            inline State getState() const {
+                return mState;
+            }
+
+            inline const std::vector<std::shared_ptr<Entity>>& getEntities() const {
+                return mEntities;
+            }
+
+        private:
+            int x;
+            int y;
+            int z;
+            State mState;
+            /** north-west corner */
+            LatLng mCoords;
+            /** in meters */
+            F32 mWidth;
+            F32 mHeight;
+            /** the entities must be placed again */
+            bool mDirty;
+            bool mInScene;
+            /** TileMap generation the tile was requested in: results of older generations are dropped */
+            U32 mGeneration;
+            /** TileMap update the tile was last needed by */
+            U32 mLastUse;
+            std::vector<std::shared_ptr<VectorMesh>> mMeshes;
+            std::vector<std::shared_ptr<Entity>> mEntities;
+        };
+    }
+}
+
+#endif //_DMA_GEO_VECTORTILE_HPP_
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_GEO_VECTORTILEBUILDER_HPP_
+#define _DMA_GEO_VECTORTILEBUILDER_HPP_
+
+#include <vector>
+
+#include "common/Types.hpp"
+#include "engine/geo/VectorStyle.hpp"
+#include "utils/MvtReader.hpp"
+#include "utils/Triangulator.hpp"
+#include "glm/glm.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /**
+         * Tessellates the features of a decoded vector tile into triangles, grouped by style rule.
+         * Positions are in meters from the north-west corner of the tile: x to the east, z to the south,
+         * y up. Flat geometries are raised a little by rule order, so that they do not z-fight.
+         *
+         * Does not touch OpenGL: a builder may run on any thread, one builder per thread.
+         */
+        class VectorTileBuilder {
+
+        public:
+            /* ***
+             * CONSTANTS
+             */
+            /** height between flat geometries of consecutive orders, in meters */
+            static constexpr F32 ORDER_HEIGHT = 0.05f;
+            /** max vertex count of a bucket, so that it can be drawn with 16-bit indices */
+            static constexpr U32 MAX_BUCKET_VERTICES = 65535;
+            /** miters of sharp line joins are cut at this ratio of the line width */
+            static constexpr F32 MITER_LIMIT = 2.0f;
+
+            struct Vertex {
+                glm::vec3 position;
+                glm::vec3 normal;
+            };
+
+            /**
+             * Triangles of one style rule. A rule may have several buckets.
+             */
+            struct Bucket {
+                U32 rule;
+                std::vector<Vertex> vertices;
+                std::vector<U16> indices;
+            };
+
+            struct Stats {
+                U32 featureCount = 0;
+                U32 vertexCount = 0;
+                U32 triangleCount = 0;
+            };
+
+            VectorTileBuilder(const VectorStyle& style);
+            VectorTileBuilder(const VectorTileBuilder&) = delete;
+            void operator=(const VectorTileBuilder&) = delete;
+            virtual ~VectorTileBuilder();
+
+            /**
+             * @param width width of the tile, in meters.
+             * @param height height of the tile, in meters.
+             * @param buckets receives the triangles.
+             */
+            void build(const std::vector<MvtReader::Layer>& layers, F32 width, F32 height,
+                       std::vector<Bucket>& buckets);
+
+            inline const Stats& getStats() const {
+                return mStats;
+            }
+
+        private:
+            Bucket* mGetBucket(U32 rule, U32 vertexCount);
+            void mAddBackground(U32 rule);
+            void mAddPolygons(U32 rule, const MvtReader::Layer& layer, const MvtReader::Feature& feature);
+            void mAddPolygon(U32 rule, F32 bottom, F32 top);
+            void mAddLines(U32 rule, const MvtReader::Feature& feature);
+            void mAddLine(U32 rule, const glm::vec2* points, U32 count, bool closed);
+            void mAddTriangle(Bucket& bucket, U16 a, U16 b, U16 c, const glm::vec3& normal);
+
+            /** tile coordinates to meters */
+            inline glm::vec2 mToMeters(const glm::vec2& point) const {
+                return point * mScale;
+            }
+
+            const VectorStyle& mStyle;
+            std::vector<Bucket>* mBuckets;
+            /** index of the bucket filled for each rule, or -1 */
+            std::vector<int> mCurrentBuckets;
+            glm::vec2 mScale;
+            Stats mStats;
+
+            Triangulator mTriangulator;
+            std::vector<U32> mLayerRules;
+            /** polygon being tessellated, in meters */
+            std::vector<glm::vec2> mPolygon;
+            std::vector<U32> mRings;
+            std::vector<U32> mTriangles;
+            std::vector<glm::vec2> mLine;
+        };
+    }
+}
+
+#endif //_DMA_GEO_VECTORTILEBUILDER_HPP_
@@ -96,6 +96,7 @@ namespace dma {
          */
         inline void setAspectRatio(F32 aspect) {
             mFrustum.setAspectRatio(aspect);
+            mDirty = true;
         }
 
         /**
@@ -106,6 +107,7 @@ namespace dma {
         inline void setFovY(F32 fovy) {
             mBaseFov = fovy;
             mFrustum.setFovY(fovy);
+            mDirty = true;
         }
 
         inline bool containsSphere(const glm::vec3& center, float radius) {
@@ -161,8 +163,9 @@ namespace dma {
 
         /**
          * Updates the camera view matrix
+         * @return true if the view or the projection changed.
          */
-        virtual void update(float dt);
+        virtual bool update(float dt);
 
 
     protected:
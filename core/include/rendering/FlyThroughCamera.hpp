@@ -40,7 +40,7 @@ namespace dma {
         void pitch(const float offset);
         void yaw(const float offset);
 
-        virtual void update(float dt) override;
+        virtual bool update(float dt) override;
 
     private:
         /* ---------------- FIELDS ----------------*/
@@ -18,27 +18,39 @@
 #ifndef _DMA_HUDELEMENT_HPP_
 #define _DMA_HUDELEMENT_HPP_
 
+#include <string>
 
-#include <engine/Entity.hpp>
-#include <resource/Quad.hpp>
+#include "common/Types.hpp"
+#include "rendering/Label.hpp"
 
 namespace dma {
 
+    /**
+     * A textured rectangle drawn over the scene, in pixels from the bottom left corner of the viewport,
+     * with an optional label centered on it. Elements without texture only draw their label.
+     * Changes to an element already added are drawn after a call to Engine::updateHUDElement.
+     */
     class HUDElement {
 
     friend class HUDSystem;
     friend class RenderingEngine;
 
     public:
+        static constexpr U32 NO_SLOT = (U32) -1;
 
+        HUDElement() : x(0), y(0), width(0), height(0), mSlot(NO_SLOT) {}
+
+        /** top left corner */
         int x;
         int y;
         int width;
         int height;
         std::string textureSID;
+        Label label;
 
     private:
-        std::shared_ptr<Entity> mEntity;
+        /** index of the element quad in the HUD system */
+        U32 mSlot;
     };
 }
 
@@ -20,16 +20,26 @@
 
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 #include <resource/ResourceManager.hpp>
 #include "rendering/HUDElement.hpp"
+#include "rendering/SpriteAtlas.hpp"
 
 namespace dma {
 
+    /**
+     * Draws all HUD elements in a single call: their quads are written in one dynamic vertex buffer,
+     * and their textures packed in a sprite atlas.
+     */
     class HUDSystem {
 
         friend class RenderingEngine;
 
     public:
+        struct Vertex {
+            glm::vec2 position;
+            glm::vec2 uv;
+        };
 
         HUDSystem(ResourceManager& resourceManager);
         virtual ~HUDSystem();
@@ -38,17 +48,56 @@ namespace dma {
 
         void addHUDElement(std::shared_ptr<HUDElement> hudElement);
 
-        inline const std::list<std::shared_ptr<HUDElement>>& getHUDElements() {
+        /**
+         * Writes the quad of the element again, after its position, size or texture changed.
+         * Only this quad is uploaded on the next frame.
+         */
+        void updateHUDElement(const HUDElement& hudElement);
+
+        void removeHUDElement(const std::shared_ptr<HUDElement>& hudElement);
+
+        inline const std::vector<std::shared_ptr<HUDElement>>& getHUDElements() {
             return mHUDElements;
         }
 
+        /**
+         * Forgets the GL buffers and the atlas texture if they were lost with the context.
+         * They are created again on the next draw.
+         */
+        void refresh();
+
         void unload();
 
     private:
+        void mWriteQuad(const HUDElement& hudElement);
+
+        /**
+         * Uploads the quads and the atlas rows changed since the last call, growing the buffers if needed.
+         * Leaves the vertex & index buffers bound.
+         */
+        void mUpload();
+
+        /**
+         * Registers the memory held by the buffers and the atlas in the memory report of the resource manager.
+         */
+        void mReportMemory();
+
         glm::mat4 mV;
         glm::mat4 mP;
         ResourceManager& mResourceManager;
-        std::list<std::shared_ptr<HUDElement>> mHUDElements;
+        std::vector<std::shared_ptr<HUDElement>> mHUDElements;
+        /** 4 vertices per element, in the order of mHUDElements */
+        std::vector<Vertex> mVertices;
+        SpriteAtlas mAtlas;
+        /** gives the program HUD elements are drawn with */
+        std::shared_ptr<MaterialInstance> mMaterial;
+        GLuint mVertexBuffer;
+        GLuint mIndexBuffer;
+        /** number of elements the buffers can hold */
+        U32 mCapacity;
+        /** elements to upload: [mDirtyBegin, mDirtyEnd) */
+        U32 mDirtyBegin;
+        U32 mDirtyEnd;
     };
 }
 
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_LABEL_HPP_
+#define _DMA_LABEL_HPP_
+
+#include <string>
+
+#include "glm/glm.hpp"
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * A line of text drawn with a signed distance field font, over an entity or a HUD element.
+     * Lines are separated by '\n', and the text is utf-8.
+     * Changes to a label already drawn are drawn when its entity is invalidated.
+     */
+    class Label {
+
+    public:
+        static constexpr F32 DEFAULT_SIZE = 16.0f;
+
+        Label(const std::string& text = "");
+
+        std::string text;
+        /** em size, in pixels */
+        F32 size;
+        glm::vec4 color;
+        /** labels that overlap on screen are dropped, lowest priority first */
+        I32 priority;
+        /** SID of the font */
+        std::string font;
+    };
+}
+
+#endif //_DMA_LABEL_HPP_
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_LABELSYSTEM_HPP_
+#define _DMA_LABELSYSTEM_HPP_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "common/Types.hpp"
+#include "rendering/Label.hpp"
+#include "resource/ResourceManager.hpp"
+
+namespace dma {
+
+    /**
+     * Lays out labels with their signed distance field fonts, drops those overlapping on screen,
+     * and batches the remaining glyph quads in one dynamic vertex buffer: one draw call per font.
+     *
+     * Layouts are cached by font & text, so that a label is only laid out again when its text changes.
+     * Everything here runs on the GL thread.
+     */
+    class LabelSystem {
+
+        friend class RenderingEngine;
+
+    public:
+        /* ***
+         * CONSTANTS
+         */
+        /** layouts kept in cache. Unused ones are dropped beyond this count. */
+        static constexpr U32 LAYOUT_CACHE_SIZE = 4096;
+        /** side of the cells of the screen grid used to find overlapping labels, in pixels */
+        static constexpr U32 GRID_CELL_SIZE = 64;
+        /** glyphs drawn per draw call, at most: 4 vertices each, with 16 bits indices */
+        static constexpr U32 BATCH_SIZE = 16384;
+
+        struct Vertex {
+            /** screen position in xy, half the width of the antialiased outline in distance units in z */
+            glm::vec3 position;
+            glm::vec2 uv;
+            U8 color[4];
+        };
+
+        /**
+         * Label counts of the last frame drawn, and memory used.
+         */
+        struct Stats {
+            U32 fontCount;
+            U32 glyphCount;
+            /** size of the font atlases, in bytes */
+            U32 atlasBytes;
+            U32 layoutCount;
+            /** CPU size of the cached layouts, in bytes */
+            U32 layoutBytes;
+            /** size of the vertex & index buffers, in bytes */
+            U32 bufferBytes;
+            /** labels submitted, drawn, and dropped because they overlapped */
+            U32 labelCount;
+            U32 drawnCount;
+            U32 rejectedCount;
+            U32 drawCalls;
+        };
+
+        LabelSystem(ResourceManager& resourceManager);
+        LabelSystem(const LabelSystem&) = delete;
+        void operator=(const LabelSystem&) = delete;
+        virtual ~LabelSystem();
+
+        void setViewport(U32 width, U32 height);
+
+        /**
+         * Overlapping labels are dropped if enabled, the default.
+         */
+        inline void setCollisionEnabled(bool enabled) {
+            mCollisionEnabled = enabled;
+        }
+
+        inline bool isCollisionEnabled() const {
+            return mCollisionEnabled;
+        }
+
+        /**
+         * @return the stats of the last frame drawn, and the memory currently used.
+         */
+        Stats getStats() const;
+
+        /**
+         * Forgets the GL buffers if they were lost with the context. They are created again on the next draw.
+         */
+        void refresh();
+
+        void unload();
+
+    private:
+        struct Glyph {
+            /** quad corners, in pixels at the font size */
+            glm::vec2 min;
+            glm::vec2 max;
+            glm::vec2 uvMin;
+            glm::vec2 uvMax;
+        };
+
+        /**
+         * Glyph quads of a text, centered on the x axis. The first baseline is y = 0.
+         */
+        struct Layout {
+            std::shared_ptr<Font> font;
+            std::vector<Glyph> glyphs;
+            glm::vec2 min;
+            glm::vec2 max;
+            /** frame it was last used at */
+            U32 lastUse;
+        };
+
+        /**
+         * A label to place this frame.
+         */
+        struct Item {
+            const Layout* layout;
+            /** bottom left corner of the label, in pixels */
+            glm::vec2 origin;
+            F32 scale;
+            glm::vec4 color;
+            I32 priority;
+            F32 depth;
+            /** HUD labels are never dropped */
+            bool reserved;
+            bool operator<(const Item& other) const {
+                if (reserved != other.reserved) {
+                    return reserved;
+                }
+                if (priority != other.priority) {
+                    return priority > other.priority;
+                }
+                return depth < other.depth;
+            }
+        };
+
+        struct Rect {
+            glm::vec2 min;
+            glm::vec2 max;
+        };
+
+        struct Batch {
+            GLuint texture;
+            U32 first;
+            U32 count;
+        };
+
+        /**
+         * Starts the labels of a new frame.
+         */
+        void mBegin();
+
+        /**
+         * Adds a label whose bottom center is at the given screen position.
+         * @param depth distance to the camera: closer labels are kept first among labels of the same priority.
+         */
+        void mAddLabel(const Label& label, const glm::vec2& anchor, F32 depth);
+
+        /**
+         * Adds a label centered on the given screen position, that is never dropped.
+         */
+        void mAddScreenLabel(const Label& label, const glm::vec2& center);
+
+        /**
+         * Keeps labels out of a screen rectangle, such as a HUD element.
+         */
+        void mReserve(const glm::vec2& min, const glm::vec2& max);
+
+        /**
+         * Drops overlapping labels, writes the quads of the others in the vertex buffer, and groups them by font.
+         * Leaves the vertex & index buffers bound.
+         * @return the number of batches to draw.
+         */
+        U32 mBuild();
+
+        const Layout* mGetLayout(const Label& label);
+        void mLayout(const Font& font, const std::string& text, Layout& layout) const;
+        bool mOverlaps(const Rect& rect) const;
+        void mInsert(const Rect& rect);
+        void mUpload();
+        void mTrimCache();
+        /** registers the memory held by the buffers in the memory report of the resource manager */
+        void mReportMemory();
+
+        ResourceManager& mResourceManager;
+        glm::mat4 mP;
+        U32 mViewportWidth;
+        U32 mViewportHeight;
+        bool mCollisionEnabled;
+
+        std::unordered_map<std::string, Layout> mLayouts;
+        U32 mFrame;
+
+        std::vector<Item> mItems;
+        std::vector<Rect> mReserved;
+        /** rectangles taken this frame, and the indices of those overlapping each grid cell */
+        std::vector<Rect> mRects;
+        std::vector<std::vector<U32>> mGrid;
+        U32 mGridWidth;
+        U32 mGridHeight;
+
+        std::vector<Vertex> mVertices;
+        std::vector<Batch> mBatches;
+        GLuint mVertexBuffer;
+        GLuint mIndexBuffer;
+        U32 mBufferSize;
+
+        U32 mLabelCount;
+        U32 mDrawnCount;
+        U32 mRejectedCount;
+    };
+}
+
+#endif //_DMA_LABELSYSTEM_HPP_
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_RENDERQUEUE_HPP_
+#define _DMA_RENDERQUEUE_HPP_
+
+#include "common/Types.hpp"
+#include "common/FrameAllocator.hpp"
+
+namespace dma {
+
+    class RenderingPackage;
+
+    /**
+     * Packages to draw in a frame, sorted by a 32-bit key with a radix sort.
+     * Entries are allocated from the frame allocator: the queue must be cleared before it is reset.
+     */
+    class RenderQueue {
+
+    public:
+        enum class Order {
+            /** the closest first. Packages at the same depth are grouped by state. */
+            FRONT_TO_BACK,
+            /** the farthest first, for blending */
+            BACK_TO_FRONT
+        };
+
+        struct Entry {
+            U32 key;
+            /** index of the package transforms in the frame list */
+            U32 transforms;
+            RenderingPackage* package;
+        };
+
+        RenderQueue(Order order, FrameAllocator& allocator);
+        RenderQueue(const RenderQueue&) = delete;
+        void operator=(const RenderQueue&) = delete;
+        virtual ~RenderQueue();
+
+        /**
+         * @param depth any non-negative value increasing with the distance to the camera,
+         *          such as the squared distance.
+         * @param state identifies the GL state of the package, such as its shader program.
+         *          Only its 8 low bits are used, by FRONT_TO_BACK queues.
+         */
+        void push(RenderingPackage* package, U32 transforms, F32 depth, U32 state);
+
+        /**
+         * Sorts the entries in the queue order. Entries of the same key keep the order they were pushed in.
+         */
+        void sort();
+
+        inline const Entry* begin() const {
+            return mEntries;
+        }
+
+        inline const Entry* end() const {
+            return mEntries + mCount;
+        }
+
+        inline U32 size() const {
+            return mCount;
+        }
+
+        inline bool empty() const {
+            return mCount == 0;
+        }
+
+        /**
+         * Removes all entries. The next frame reserves as many entries as this one held.
+         */
+        void clear();
+
+    private:
+        void mGrow();
+
+        Order mOrder;
+        FrameAllocator& mAllocator;
+        Entry* mEntries;
+        U32 mCount;
+        U32 mCapacity;
+        /** count of the last frame that held entries */
+        U32 mLastCount;
+    };
+}
+
+#endif //_DMA_RENDERQUEUE_HPP_
@@ -19,8 +19,10 @@
 #define _DMA_RENDERINGCOMPONENT_HPP_
 
 #include "rendering/RenderingPackage.hpp"
+#include "rendering/Label.hpp"
+#include "engine/TransformComponent.hpp"
 #include "resource/Mesh.hpp"
-#include "resource/Material.hpp"
+#include "resource/MaterialInstance.hpp"
 
 #include <vector>
 
@@ -30,9 +32,9 @@ namespace dma {
 
 
     public:
-        RenderingComponent(const glm::mat4& M,
+        RenderingComponent(const TransformComponent& transformComponent,
                            std::shared_ptr<Mesh> mesh,
-                           std::shared_ptr<Material> material);
+                           std::shared_ptr<MaterialInstance> material);
         RenderingComponent(const RenderingComponent&) = delete;
         void operator=(const RenderingComponent&) = delete;
         virtual ~RenderingComponent();
@@ -40,7 +42,7 @@ namespace dma {
 
         void setMesh(std::shared_ptr<Mesh> mesh);
 
-        inline const std::shared_ptr<Mesh> getMesh() const {
+        inline const std::shared_ptr<Mesh>& getMesh() const {
             return mMesh;
         }
 
@@ -48,11 +50,78 @@ namespace dma {
             return mRenderingPackages;
         }
 
-        void setMaterial(std::shared_ptr<Material> material);
+        void setMaterial(std::shared_ptr<MaterialInstance> material);
+
+        /**
+         * Computes MV, MVP & N again if the model matrix or the view changed since the last call.
+         * @param viewRevision identifies V & P: it must change whenever one of them changes.
+         */
+        void updateTransforms(const glm::mat4& V, const glm::mat4& P, U32 viewRevision) const;
+
+        /**
+         * @return the transforms computed by the last updateTransforms call.
+         */
+        inline const TransformCache& getTransforms() const {
+            return mTransforms;
+        }
+
+        /**
+         * Starts an idle animation evaluated by the vertex shader from the time uniform, while the
+         * transform stays static: the mesh bobs up by 'amplitude' and spins around the up axis,
+         * 'phase' seconds ahead. Shaders without the idle uniforms draw the mesh static.
+         */
+        void setIdleAnimation(float phase, float amplitude);
+
+        void clearIdleAnimation();
+
+        inline bool hasIdleAnimation() const {
+            return mIdleAnimated;
+        }
+
+        /**
+         * Allows the component to be drawn as a camera-facing billboard when it gets small on screen.
+         * The billboard takes the diffuse color and map of the given pass of its material.
+         * @see Scene::setImpostorSize
+         */
+        inline void setImpostorPass(U8 pass) {
+            mImpostorPass = (int) pass;
+        }
+
+        inline void clearImpostor() {
+            mImpostorPass = -1;
+        }
+
+        inline bool hasImpostor() const {
+            return mImpostorPass >= 0;
+        }
+
+        inline U8 getImpostorPass() const {
+            return (U8) mImpostorPass;
+        }
+
+        /**
+         * Sets the label drawn over the component, or nullptr.
+         */
+        inline void setLabel(const std::shared_ptr<Label>& label) {
+            mLabel = label;
+        }
+
+        inline const std::shared_ptr<Label>& getLabel() const {
+            return mLabel;
+        }
 
     private:
+        const TransformComponent& mTransformComponent;
+        /** derived from the transform component, shared by all rendering packages */
+        mutable TransformCache mTransforms;
         std::vector<RenderingPackage*> mRenderingPackages;
         std::shared_ptr<Mesh> mMesh;
+        bool mIdleAnimated;
+        float mIdlePhase;
+        float mIdleAmplitude;
+        /** material pass the billboard looks like, or -1 */
+        int mImpostorPass;
+        std::shared_ptr<Label> mLabel;
     };
 }
 
@@ -19,15 +19,19 @@
 #define _DMA_RENDERINGENGINE_HPP_
 
 #include "common/Types.hpp"
+#include "common/FrameAllocator.hpp"
 #include "rendering/Camera.hpp"
 #include "rendering/RenderingPackage.hpp"
 #include "rendering/RenderingComponent.hpp"
+#include "rendering/RenderQueue.hpp"
 #include "rendering/SkyBox.hpp"
 #include "rendering/Light.hpp"
+#include "rendering/VertexArray.hpp"
+#include "engine/Entity.hpp"
 #include "HUDSystem.hpp"
+#include "LabelSystem.hpp"
 
 #include <list>
-#include <queue>
 
 namespace dma {
 
@@ -35,14 +39,63 @@ namespace dma {
 
     private:
 
-        struct Entry {
-            F32 distance;
-            RenderingPackage* renderingPackage;
-            bool operator<(const Entry & other) const {
-                return (distance < other.distance);
+        /**
+         * A component drawn as a camera-facing billboard.
+         */
+        struct Impostor {
+            glm::vec3 center;
+            F32 radius;
+            glm::vec3 color;
+            /** diffuse map, or nullptr. Kept alive by the scene, see FrameList::retired. */
+            Map* map;
+            bool operator<(const Impostor& other) const {
+                return map < other.map;
             }
         };
 
+        /**
+         * A label drawn over a component, placed on screen when the frame list is drawn.
+         */
+        struct LabelEntry {
+            std::shared_ptr<const Label> label;
+            glm::vec3 center;
+            F32 radius;
+        };
+
+        struct ImpostorVertex {
+            glm::vec3 center;
+            /** billboard corner, in [-1, 1] */
+            glm::vec2 corner;
+            /** color in rgb, radius in a */
+            glm::vec4 color;
+        };
+
+        /**
+         * What is needed to draw the scene of a frame, built by the scene step.
+         * Matrices are copies: drawing a frame list does not read live transforms.
+         * Packages are referenced by raw pointers: their entities are kept alive by the scene,
+         * then by the list itself once removed from the scene (see retire()).
+         */
+        struct FrameList {
+            glm::mat4 V;
+            glm::mat4 P;
+            std::vector<TransformCache> transforms;
+            /** entities removed from the scene before the list was drawn. Released on the GL thread. */
+            std::vector<std::shared_ptr<Entity>> retired;
+            /** holds the queue entries, reset with the list */
+            FrameAllocator allocator;
+            RenderQueue frontToBack;
+            RenderQueue backToFront;
+            std::vector<Impostor> impostors;
+            std::vector<LabelEntry> labels;
+            /** true if built and not drawn yet */
+            bool ready = false;
+
+            FrameList() :
+                    frontToBack(RenderQueue::Order::FRONT_TO_BACK, allocator),
+                    backToFront(RenderQueue::Order::BACK_TO_FRONT, allocator) {}
+        };
+
     public:
 
         RenderingEngine(ResourceManager& resourceManager);
@@ -63,18 +116,105 @@ namespace dma {
         inline U32 getViewportWidth() const { return mViewportWidth; }
         inline U32 getViewportHeight() const { return mViewportHeight; }
 
-        inline void setSkyBox(SkyBox* skyBox) { mSkyBox = skyBox; }
+        inline void setSkyBox(SkyBox* skyBox) {
+            mSkyBox = skyBox;
+            mInvalidated = true;
+        }
+
+        /**
+         * Allows or prevents the skybox to be drawn, whether the scene has one or not.
+         */
+        inline void setSkyBoxAllowed(bool allowed) {
+            mInvalidated |= allowed != mSkyBoxAllowed;
+            mSkyBoxAllowed = allowed;
+        }
+
+        inline void setLight(const Light& light) {
+            mLight = light;
+            ++mLightRevision;
+            mInvalidated = true;
+        }
+
+        /**
+         * Forces the next frame to be drawn, even if the scene did not change.
+         */
+        inline void invalidate() { mInvalidated = true; }
 
-        inline void setLight(const Light& light) { mLight = light; }
+        /**
+         * @return true if the rendering state changed since the last drawn frame.
+         */
+        inline bool isInvalidated() const { return mInvalidated; }
+
+        /**
+         * @return true if the last drawn frame had idle animations evaluated by shaders:
+         * the next frame must be drawn even if the scene did not change.
+         */
+        inline bool isAnimated() const { return mAnimated; }
+
+        /**
+         * Sets the time given to shaders, in seconds.
+         */
+        void setTime(double seconds);
+
+        /**
+         * Starts building the frame list of the next frame, with the current view & projection.
+         * Must be called before subscribing the components of the frame.
+         */
+        void beginFrameList();
+
+        /**
+         * @param depth any non-negative value increasing with the distance to the camera,
+         *          such as the squared distance: packages are sorted by it.
+         */
+        void subscribe(const std::shared_ptr<Entity>& entity, float depth);
+
+        /**
+         * Draws the entity as a billboard facing the camera, instead of its mesh.
+         * Billboards of a frame are batched in a single dynamic vertex buffer, and drawn with the opaque meshes.
+         * @param center world center of the billboard.
+         * @param radius world half size of the billboard.
+         * @see RenderingComponent::setImpostorPass
+         */
+        void subscribeImpostor(const std::shared_ptr<Entity>& entity, const glm::vec3& center, F32 radius);
+
+        /**
+         * Keeps the entity, removed from the scene, alive until the frame lists that may reference it are drawn.
+         * Must be called on the GL thread, between scene steps.
+         */
+        void retire(const std::shared_ptr<Entity>& entity);
+
+        /**
+         * If enabled, frame lists are double buffered: the next frame list may be built on another thread
+         * while the current one is drawn. Lists are swapped with swapFrameLists.
+         */
+        void setDoubleBuffered(bool enabled);
+
+        /**
+         * Makes the frame list last built the one to draw.
+         */
+        void swapFrameLists();
 
-        void subscribe(RenderingPackage* package, bool front2back, float distanceFromCamera);
+        /**
+         * @return true if the frame list to draw was built and not drawn yet.
+         */
+        inline bool isFrameListReady() const { return mFrameLists[mDrawList].ready; }
 
-        void subscribe(const RenderingComponent* component, float distanceFromCamera);
+        /**
+         * Draws a label above the bounding sphere of the given center & radius, in the current frame list.
+         */
+        void subscribeLabel(const std::shared_ptr<Label>& label, const glm::vec3& center, F32 radius);
 
         void subscribeHUDElement(std::shared_ptr<HUDElement> hudElement);
 
         /**
-         * Render the current frame.
+         * Uploads the changes made to an element already subscribed.
+         */
+        void updateHUDElement(const HUDElement& hudElement);
+
+        void unsubscribeHUDElement(const std::shared_ptr<HUDElement>& hudElement);
+
+        /**
+         * Render the current frame list.
          * setCamera must have been called with a valid camera before the first call to this method.
          */
         void drawFrame();
@@ -85,26 +225,138 @@ namespace dma {
         inline void setVP(const glm::mat4& V, const glm::mat4& P) {
             mV = &V;
             mP = &P;
+            mInvalidated = true;
         }
 
 
         inline F32 getAspectRatio() const { return mAspectRatio; }
 
+        /**
+         * @return the number of glUniform calls made during the last drawn frame.
+         */
+        inline U32 getUniformUploadCount() const { return mUniformUploadCount; }
+
+        /**
+         * @return the number of glUniform calls avoided during the last drawn frame, as programs already held the values.
+         */
+        inline U32 getUniformSkipCount() const { return mUniformSkipCount; }
+
+        /**
+         * @return the number of billboards drawn in the last drawn frame.
+         */
+        inline U32 getImpostorCount() const { return mImpostorCount; }
+
+        inline LabelSystem::Stats getLabelStats() const { return mLabelSystem.getStats(); }
+
+        inline void setLabelCollisionEnabled(bool enabled) {
+            mLabelSystem.setCollisionEnabled(enabled);
+            mInvalidated = true;
+        }
+
     private:
-        void mDraw(RenderingPackage* package, const glm::mat4& V, const glm::mat4& P);
-        void mDrawSkyBox();
+        /**
+         * Computes the eye-space light for this frame, when the light or the view changed.
+         */
+        void mUpdateLight(const glm::mat4& V);
 
+        void mUseProgram(const ShaderProgram& program);
+
+        /**
+         * Uploads the light to the given program, once per program and light revision.
+         */
+        void mSetupLight(ShaderProgram& program);
+
+        /**
+         * Draws the package with the given transforms.
+         */
+        void mDraw(RenderingPackage* package, const TransformCache& transforms);
+
+        /**
+         * Lists the mesh attributes read by a pass with the given functionalities.
+         */
+        void mGetAttributes(const Mesh& mesh, U32 funcFlags, const ShaderProgram& shaderProgram,
+                            std::vector<VertexArray::Attribute>& attributes) const;
+        void mAddAttribute(const Mesh& mesh, const VertexElement& element, GLint location,
+                           std::vector<VertexArray::Attribute>& attributes) const;
+        void mDrawSkyBox(const glm::mat4& V, const glm::mat4& P);
+
+        /**
+         * Draws the billboards of the frame list, one draw call per diffuse map.
+         */
+        void mDrawImpostors(FrameList& list);
+
+        /**
+         * Registers the memory held by the billboard buffers in the memory report of the resource manager.
+         */
+        void mReportImpostorMemory();
+
+        /**
+         * Draws all HUD elements in one call.
+         */
+        void mDrawHUD();
+
+        /**
+         * Places the labels of the frame list and of the HUD on screen.
+         */
+        void mCollectLabels(const FrameList& list);
+
+        /**
+         * Draws the labels collected, one draw call per font.
+         */
+        void mDrawLabels();
+        void mClearFrameList(FrameList& list);
+
+        ResourceManager& mResourceManager;
         HUDSystem mHUDSystem;
+        LabelSystem mLabelSystem;
         SkyBox* mSkyBox;
+        bool mSkyBoxAllowed;
+        /** true if the next frame must be drawn */
+        bool mInvalidated;
+        bool mAnimated;
+        /** time uniform, wrapped to keep its precision */
+        F32 mTime;
         Light mLight;
+        /** incremented when the light or the view changes */
+        U32 mLightRevision;
+        /** light revision mLightEyePosition was computed for */
+        U32 mLightEyeRevision;
+        glm::vec4 mLightEyePosition;
+        /** program currently in use */
+        GLuint mCurrentProgram;
+        U32 mUniformUploadCount;
+        U32 mUniformSkipCount;
         const glm::mat4* mV;
         const glm::mat4* mP;
         U32 mViewportWidth;
         U32 mViewportHeight;
         F32 mAspectRatio;
-        std::priority_queue<Entry> mFrontToBack;
-        std::priority_queue<Entry> mBackToFront;
-        GLuint mAttribIndices[ShaderProgram::AttribSem::AS_size];
+        /** incremented each time the scene view changes, by the scene step */
+        U32 mSceneViewRevision;
+        /** view & projection the scene revision was taken for */
+        glm::mat4 mLastV;
+        glm::mat4 mLastP;
+        /** view the light eye position was computed for */
+        glm::mat4 mLightV;
+        FrameList mFrameLists[2];
+        /** list filled by the scene step, and list drawn. The same one unless double buffered. */
+        U32 mBuildList;
+        U32 mDrawList;
+        /** attributes of the vertex array being built */
+        std::vector<VertexArray::Attribute> mAttributes;
+
+        std::shared_ptr<ShaderProgram> mImpostorProgram;
+        /** true if the impostor program could not be loaded: billboards are not drawn. */
+        bool mImpostorProgramMissing;
+        GLuint mImpostorVertexBuffer;
+        GLuint mImpostorIndexBuffer;
+        U32 mImpostorBufferSize;
+        std::vector<ImpostorVertex> mImpostorVertices;
+        U32 mImpostorCount;
+
+        std::shared_ptr<ShaderProgram> mLabelProgram;
+        /** true if the label program could not be loaded: labels are not drawn. */
+        bool mLabelProgramMissing;
     };
 }
 
@@ -21,38 +21,53 @@
 #include <utils/Log.hpp>
 #include "resource/Mesh.hpp"
 #include "resource/ShaderProgram.hpp"
-#include "resource/Material.hpp"
+#include "resource/MaterialInstance.hpp"
 #include "resource/Texture.hpp"
 #include "glm/glm.hpp"
 
 namespace dma {
 
+    /**
+     * Matrices derived from an entity model matrix and the current view & projection.
+     * They are only computed again when one of them changed, tracked with revisions.
+     */
+    struct TransformCache {
+        glm::mat4 MV;
+        glm::mat4 MVP;
+        glm::mat3 N;
+        /** idle animation in model space, null if none. See RenderingComponent::setIdleAnimation */
+        glm::vec4 idleBob = glm::vec4(0.0f);
+        glm::vec3 idleAxis = glm::vec3(0.0f);
+        /** TransformComponent revision the matrices were computed from */
+        U32 modelRevision = 0;
+        /** RenderingEngine view revision the matrices were computed from, 0 if never computed */
+        U32 viewRevision = 0;
+    };
+
     /**
      * Contains all information needed to be consumed by the rendering engine.
      */
     class RenderingPackage {
 
     public:
-        RenderingPackage(const glm::mat4& M,
-                         std::shared_ptr<Mesh>,
-                         std::shared_ptr<Material>);
+        RenderingPackage(std::shared_ptr<Mesh>,
+                         std::shared_ptr<MaterialInstance>);
 
         virtual ~RenderingPackage();
 
         inline bool isBackToFront() const { return mMaterial->isBackToFront();}
 
-        inline std::shared_ptr<Material> getMaterial() { return mMaterial; }
+        inline std::shared_ptr<MaterialInstance> getMaterial() { return mMaterial; }
 
         inline void setMesh(std::shared_ptr<Mesh> mesh) { mMesh = mesh; }
 
-        inline void setMaterial(std::shared_ptr<Material> material) { mMaterial = material; }
+        inline void setMaterial(std::shared_ptr<MaterialInstance> material) { mMaterial = material; }
 
     private:
         //FIELDS
         friend class RenderingEngine;
-        const glm::mat4& M;
         std::shared_ptr<Mesh> mMesh;
-        std::shared_ptr<Material> mMaterial;
+        std::shared_ptr<MaterialInstance> mMaterial;
     };
 }
 
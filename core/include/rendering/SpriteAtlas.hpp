@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_SPRITEATLAS_HPP_
+#define _DMA_SPRITEATLAS_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "common/Types.hpp"
+#include "resource/Image.hpp"
+#include "resource/MemoryReport.hpp"
+#include "utils/GLES2Logger.hpp"
+
+namespace dma {
+
+    /**
+     * Packs small images in rows of a single RGBA texture, so that sprites using different images
+     * are drawn with one texture bound. Pixels are kept on the CPU side to restore the texture after a context loss.
+     */
+    class SpriteAtlas {
+
+    public:
+        /* ***
+         * CONSTANTS
+         */
+        /** width & height of the atlas texture, in pixels */
+        static constexpr U32 SIZE = 1024;
+        /** transparent pixels around each image, to prevent linear filtering from bleeding neighbours */
+        static constexpr U32 PADDING = 1;
+
+        /**
+         * Texture coordinates of an image in the atlas.
+         */
+        struct Region {
+            glm::vec2 uvMin;
+            glm::vec2 uvMax;
+        };
+
+        SpriteAtlas();
+        SpriteAtlas(const SpriteAtlas&) = delete;
+        void operator=(const SpriteAtlas&) = delete;
+        virtual ~SpriteAtlas();
+
+        /**
+         * Adds the image under the given SID, unless it is already in the atlas.
+         * @return false if the atlas is full or the image format unsupported.
+         */
+        bool add(const std::string& sid, Image& image, Region* region);
+
+        /**
+         * @return false if no image was added with this SID.
+         */
+        bool find(const std::string& sid, Region* region) const;
+
+        /**
+         * Creates the texture if needed, and uploads the rows changed since the last call.
+         * Until an image is added, the texture is a single transparent white texel: there is always
+         * a texture to bind, and untextured quads stay invisible as they do over the atlas padding.
+         * @return true if the texture has been (re)allocated.
+         */
+        bool upload();
+
+        inline GLuint getHandle() const {
+            return mHandle;
+        }
+
+        /**
+         * @return the pixels kept on the CPU side, and the texture once uploaded.
+         */
+        MemoryUsage getMemoryUsage() const;
+
+        /**
+         * Forgets the GL texture, which is no longer valid after a context loss. Uploaded again on next upload().
+         */
+        void invalidate();
+
+        /**
+         * Deletes the GL texture, and forgets all images.
+         */
+        void unload();
+
+    private:
+        std::unordered_map<std::string, Region> mRegions;
+        /** RGBA pixels, bottom row first. Allocated with the first image. */
+        std::vector<BYTE> mPixels;
+        /** row being filled */
+        U32 mShelfX;
+        U32 mShelfY;
+        U32 mShelfHeight;
+        GLuint mHandle;
+        /** width & height of the texture: 0 if not created, 1 until an image is added, then SIZE. */
+        U32 mTextureSize;
+        /** rows to upload: [mDirtyBegin, mDirtyEnd) */
+        U32 mDirtyBegin;
+        U32 mDirtyEnd;
+    };
+}
+
+#endif //_DMA_SPRITEATLAS_HPP_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_VERTEXARRAY_HPP_
+#define _DMA_VERTEXARRAY_HPP_
+
+#include <vector>
+
+#include "utils/GLES2Logger.hpp"
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Records the vertex attribute bindings of a mesh for a given shader program,
+     * so that a draw call binds them at once.
+     *
+     * Uses OES_vertex_array_object when available. Otherwise the bindings are kept
+     * CPU side and replayed on bind().
+     *
+     * The OpenGL vertex array is not deleted on destruction: copies share its handle, and
+     * may be destroyed out of the GL thread. Owners call wipe(), see Mesh::wipe.
+     */
+    class VertexArray {
+
+    public:
+        struct Attribute {
+            GLuint index;
+            GLint count;
+            GLenum type;
+            GLboolean normalized;
+            GLsizei stride;
+            U32 offset;
+        };
+
+        /* ***
+         * CONSTRUCTORS
+         */
+        VertexArray();
+        virtual ~VertexArray();
+
+        /**
+         * Loads the OES_vertex_array_object entry points, if supported.
+         * Must be called for each new OpenGL context: vertex arrays recorded
+         * in a previous context are outdated afterwards.
+         */
+        static void init();
+
+        /**
+         * @return true if vertex arrays are recorded by the driver, false if they are emulated.
+         */
+        static bool isNativeSupported();
+
+        /**
+         * Records the given attributes, read from the given buffers.
+         */
+        void build(GLuint vertexBuffer, GLuint indexBuffer, const std::vector<Attribute>& attributes);
+
+        /**
+         * Binds the vertex & index buffers, and enables the recorded attributes.
+         */
+        void bind() const;
+        void unbind() const;
+
+        /**
+         * @return true if it was recorded in the current context, from the given buffers.
+         */
+        bool isValid(GLuint vertexBuffer, GLuint indexBuffer) const;
+
+        /**
+         * Delete the OpenGL vertex array. Must be called from the GL thread before destruction.
+         */
+        void wipe();
+
+    private:
+        /** incremented by init(), on each new OpenGL context. */
+        static U32 contextRevision;
+
+        GLuint mHandle;
+        GLuint mVertexBuffer;
+        GLuint mIndexBuffer;
+        U32 mContextRevision;
+        std::vector<Attribute> mAttributes;
+    };
+}
+
+#endif //_DMA_VERTEXARRAY_HPP_
@@ -37,6 +37,7 @@ namespace dma {
      * Contains information about a vertex element:
      * - its semantic
      * - its count and type, for example: 3 GL_FLOAT
+     * - whether integer types are normalized, for example: 2 GL_UNSIGNED_SHORT read as [0, 1] floats
      * - its offset in the vbo, for example:
      *        if normal is after position and position has
      *        3 GL_FLOAT, offset of normal will be 3 * sizeof(GLfloat)
@@ -58,19 +59,29 @@ namespace dma {
             mSemantic(NONE),
             mCount(0),
             mType(-1),
+            mNormalized(false),
             mSizeInByte(0),
             mOffset(0)
         {}
-        VertexElement(Semantic semantic, U32 count, GLenum type, U32 offset) :
+        VertexElement(Semantic semantic, U32 count, GLenum type, U32 offset, bool normalized = false) :
             mSemantic(semantic),
             mCount(count),
             mType(type),
+            mNormalized(normalized),
             mOffset(offset)
         {
             switch (type) {
             case GL_FLOAT:
                 mSizeInByte = (U32)(count * sizeof(GLfloat));
                 break;
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+                mSizeInByte = (U32)(count * sizeof(GLshort));
+                break;
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                mSizeInByte = (U32)(count * sizeof(GLbyte));
+                break;
             default:
                 assert(false);
             }
@@ -84,6 +95,9 @@ namespace dma {
         inline GLenum getType() const {
             return mType;
         }
+        inline bool isNormalized() const {
+            return mNormalized;
+        }
         inline U32 getCount() const {
             return mCount;
         }
@@ -113,7 +127,7 @@ namespace dma {
             default:
                 assert(false);
             }
-            oss << "mSemantic=" << sem << " mCount=" << mCount << " mType=" << mType << " mSizeInByte="
+            oss << "mSemantic=" << sem << " mCount=" << mCount << " mType=" << mType << " mNormalized=" << mNormalized << " mSizeInByte="
                     << mSizeInByte << " mOffset=" << mOffset;
             return oss.str();
         }
@@ -122,6 +136,7 @@ namespace dma {
         VertexElement::Semantic mSemantic;
         U32 mCount;
         GLenum mType;
+        bool mNormalized;
         U32 mSizeInByte;
         U32 mOffset;
     };
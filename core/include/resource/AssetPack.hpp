@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_ASSETPACK_HPP_
+#define _DMA_ASSETPACK_HPP_
+
+#include <string>
+#include <vector>
+
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Read-only, memory-mapped archive of resource files.
+     *
+     * Layout (little endian):
+     *  - Header: magic "ARPK", version, entry count, then offset & size of the name block.
+     *  - Table of contents: one Record per file, sorted by name, so lookups are binary searches.
+     *  - Name block: file names relative to the resource dir, e.g. "shader/default.v.glsl".
+     *  - Payloads, each aligned on ALIGNMENT bytes.
+     *
+     * Payloads are read in place: an Entry stays valid as long as the pack is open.
+     */
+    class AssetPack {
+
+    public:
+        /* ***
+         * CONSTANTS
+         */
+        static constexpr U32 VERSION = 1;
+        static constexpr U32 ALIGNMENT = 16;
+
+        struct Entry {
+            const BYTE* data;
+            U32 size;
+        };
+
+        AssetPack();
+        virtual ~AssetPack();
+        AssetPack(const AssetPack&) = delete;
+        void operator=(const AssetPack&) = delete;
+
+        /**
+         * Maps the given pack file in memory, closing the currently open pack if any.
+         */
+        Status open(const std::string& path);
+
+        /**
+         * Maps a pack stored inside another file, closing the currently open pack if any.
+         * On Android, this reads the pack in place from the APK, when it is stored uncompressed.
+         * The file descriptor is not kept: the caller still owns it.
+         * @param offset offset of the pack in the file, in bytes. Needs not be page-aligned.
+         * @param length size of the pack, in bytes.
+         * @param name used in logs.
+         */
+        Status open(int fd, U64 offset, U64 length, const std::string& name);
+
+        void close();
+
+        inline bool isOpen() const {
+            return mData != nullptr;
+        }
+
+        /**
+         * @param name file name, relative to the resource dir.
+         * @return true if the pack holds the file. If so, entry holds its content.
+         */
+        bool find(const std::string& name, Entry& entry) const;
+
+        /**
+         * @return the number of files in the pack.
+         */
+        U32 getEntryCount() const;
+
+        /**
+         * @return the name of the i-th file, in sorted order.
+         */
+        std::string getName(U32 i) const;
+
+        /**
+         * @return the content of the i-th file, in sorted order.
+         */
+        Entry getEntry(U32 i) const;
+
+        /**
+         * Writes a pack out of the given files.
+         * @param rootDir the resource dir.
+         * @param names file names, relative to rootDir.
+         */
+        static Status write(const std::string& path, const std::string& rootDir, std::vector<std::string> names);
+
+    private:
+        struct Header {
+            char magic[4];
+            U32 version;
+            U32 entryCount;
+            U32 namesOffset;
+            U32 namesSize;
+        };
+
+        struct Record {
+            U32 nameOffset;
+            U32 nameLength;
+            U32 dataOffset;
+            U32 dataSize;
+        };
+
+        const Record* mRecords() const;
+        const char* mName(const Record& record) const;
+
+        /** start & size of the pack. */
+        const BYTE* mData;
+        size_t mSize;
+        /** start & size of the mapped pages, which hold the pack. */
+        void* mMapping;
+        size_t mMappingSize;
+    };
+}
+
+#endif //_DMA_ASSETPACK_HPP_
@@ -19,6 +19,7 @@
 #define _DMA_CUBEMAP_HPP_
 
 #include "resource/Texture.hpp"
+#include "resource/SpillCache.hpp"
 
 namespace dma {
 
@@ -45,16 +46,37 @@ namespace dma {
         Status load(const std::string& dirName);
 
         /**
-         * From cache if any
+         * From cache if any, then from the spill cache, then from disk
          */
         Status refresh(const std::string& dirName);
 
+        /**
+         * Sets what becomes of the face images once uploaded, applied to the images already loaded.
+         * @param spillCache required by Retention::SPILL. Must outlive the cube map.
+         */
+        void setRetention(Retention retention, SpillCache* spillCache);
+
+        /**
+         * Removes the faces written to the spill cache, if any.
+         */
+        void removeSpilled();
+
+        U32 getCpuBytes() const override;
+
     private:
 
         Status mLoadFromImages();
+        /** reads the faces back from the spill cache. */
+        bool mReadSpilled();
+        /** releases the faces according to the retention. */
+        void mReleaseImages();
         void mDeleteImages();
+        std::string mGetFaceName(U32 face) const;
 
         Image* mImages[6];
+        std::string mDirName;
+        Retention mRetention;
+        SpillCache* mSpillCache;
     };
 }
 
@@ -24,13 +24,14 @@
 #include "resource/TextureManager.hpp"
 #include "resource/Map.hpp"
 #include "resource/CubeMap.hpp"
+#include "resource/MemoryReport.hpp"
 
 namespace dma {
 
     class CubeMapManager {
 
     public:
-        CubeMapManager(const std::string& dir);
+        CubeMapManager(const std::string& dir, SpillCache& spillCache);
         virtual ~CubeMapManager();
 
         CubeMapManager(const CubeMapManager&) = delete;
@@ -45,11 +46,29 @@ namespace dma {
         void unload();
         void update();
 
+        /**
+         * Sets what becomes of the face images of the cube maps once uploaded, including the
+         * cube maps already loaded.
+         * @see CubeMap::setRetention
+         */
+        void setRetention(Retention retention);
+
+        inline Retention getRetention() const {
+            return mRetention;
+        }
+
+        /**
+         * @return the memory held by the loaded cube maps.
+         */
+        MemoryUsage getMemoryUsage() const;
+
     private:
         void mLoadCubeMap(std::shared_ptr<CubeMap> cubeMap, const std::string& sid);
 
         std::map<std::string, std::shared_ptr<CubeMap>> mCubeMaps;
         std::string mDir;
+        SpillCache& mSpillCache;
+        Retention mRetention;
     };
 } /* namespace dma */
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_FONT_HPP_
+#define _DMA_FONT_HPP_
+
+#include <string>
+#include <unordered_map>
+
+#include "glm/glm.hpp"
+#include "common/Types.hpp"
+#include "resource/Image.hpp"
+#include "utils/GLES2Logger.hpp"
+
+namespace dma {
+
+    /**
+     * Glyph metrics & signed distance field atlas of a font, as generated by the arpigl-fontgen tool.
+     * The atlas is a grayscale texture where 0.5 is the glyph outline: glyphs generated once at a given size are drawn
+     * sharp at any size. Metrics are in pixels at the generation size.
+     *
+     * Its .json file holds the size, range, lineHeight, ascender, width & height of the atlas, and the glyphs,
+     * each as [code, x, y, width, height, bearingX, bearingY, advance], in atlas pixels from its top left corner.
+     */
+    class Font {
+
+        friend class FontManager;
+
+    public:
+        struct Glyph {
+            glm::vec2 uvMin;
+            glm::vec2 uvMax;
+            /** bottom left corner of the glyph quad, from the pen position on the baseline */
+            glm::vec2 offset;
+            glm::vec2 size;
+            F32 advance;
+        };
+
+        Font();
+        Font(const Font&) = delete;
+        void operator=(const Font&) = delete;
+        virtual ~Font();
+
+        /**
+         * @return the glyph of the given unicode code point, or nullptr if the font has none.
+         */
+        inline const Glyph* getGlyph(U32 code) const {
+            auto it = mGlyphs.find(code);
+            return it != mGlyphs.end() ? &it->second : nullptr;
+        }
+
+        inline const std::string& getSID() const { return mSID; }
+
+        /** em size glyphs were generated at, in pixels */
+        inline F32 getSize() const { return mSize; }
+
+        /** distance covered by the field on each side of the glyph outlines, in pixels at the generation size */
+        inline F32 getRange() const { return mRange; }
+
+        inline F32 getLineHeight() const { return mLineHeight; }
+
+        inline F32 getAscender() const { return mAscender; }
+
+        inline U32 getGlyphCount() const { return (U32) mGlyphs.size(); }
+
+        /**
+         * @return the size of the atlas texture, in bytes.
+         */
+        U32 getAtlasBytes() const;
+
+        /**
+         * @return the size of the GL texture, in bytes, or 0 if it is not uploaded.
+         */
+        inline U32 getGpuBytes() const {
+            return mHandle != 0 ? getAtlasBytes() : 0;
+        }
+
+        /**
+         * @return the atlas texture. Uploads it first if needed.
+         */
+        GLuint getHandle();
+
+        /**
+         * Forgets the GL texture, which is no longer valid after a context loss.
+         * It is uploaded again from the image kept in cache on the next getHandle().
+         */
+        void invalidate();
+
+        /**
+         * Deletes the GL texture.
+         */
+        void wipe();
+
+    private:
+        /**
+         * Reads the metrics. mImage must be loaded first.
+         */
+        Status mParse(const std::string& json);
+
+        std::string mSID;
+        F32 mSize;
+        F32 mRange;
+        F32 mLineHeight;
+        F32 mAscender;
+        std::unordered_map<U32, Glyph> mGlyphs;
+        /** atlas, stored bottom row first */
+        Image mImage;
+        GLuint mHandle;
+    };
+}
+
+#endif //_DMA_FONT_HPP_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_FONTMANAGER_HPP_
+#define _DMA_FONTMANAGER_HPP_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "common/Sid.hpp"
+#include "resource/Font.hpp"
+#include "resource/MemoryReport.hpp"
+#include "resource/ResourceIndex.hpp"
+
+namespace dma {
+
+    /**
+     * Loads the glyph atlases of the font/ directory. A font is a <sid>.json & <sid>.png pair.
+     */
+    class FontManager {
+
+    public:
+        FontManager(const std::string& dir, ResourceIndex& fileIndex);
+        virtual ~FontManager();
+        FontManager(const FontManager&) = delete;
+        FontManager& operator=(const FontManager&) = delete;
+
+        /**
+         * @return the font, or nullptr if it doesn't exist or cannot be read.
+         */
+        std::shared_ptr<Font> acquire(const std::string& sid, Status* result);
+
+        bool hasResource(const std::string& sid) const;
+
+        /**
+         * Forgets the GL textures after a context loss. They are uploaded again when next drawn.
+         */
+        void refresh();
+
+        void wipe();
+        void unload();
+
+        /**
+         * Unloads the fonts no longer referenced outside of the manager.
+         */
+        void update();
+
+        /**
+         * @return the memory held by the glyph atlases.
+         */
+        MemoryUsage getMemoryUsage() const;
+
+    private:
+        Status mLoad(Font& font, const std::string& sid);
+
+        std::unordered_map<Sid, std::shared_ptr<Font>, Sid::Hash> mFonts;
+        std::string mFontDir;
+        ResourceIndex& mFileIndex;
+    };
+}
+
+#endif //_DMA_FONTMANAGER_HPP_
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_GENERATEDMESH_HPP_
+#define _DMA_GENERATEDMESH_HPP_
+
+#include "resource/Mesh.hpp"
+
+namespace dma {
+
+    /**
+     * A mesh made at runtime rather than loaded by the MeshManager.
+     * It may be built on any thread; upload() must then be called on the OpenGL one before drawing it.
+     * Its data stays CPU side, to be uploaded again after a context loss.
+     */
+    class GeneratedMesh : public Mesh {
+
+    public:
+        GeneratedMesh(const GeneratedMesh&) = delete;
+        void operator=(const GeneratedMesh&) = delete;
+        virtual ~GeneratedMesh();
+
+        /**
+         * (Re)creates the OpenGL buffers. Requires an OpenGL context.
+         */
+        void upload();
+
+        inline bool isUploaded() const {
+            return mVertexBuffer != nullptr;
+        }
+
+        /**
+         * Deletes the OpenGL buffers, if uploaded.
+         */
+        void release();
+
+        inline U32 getTriangleCount() const {
+            return (U32) mIndexData.size() / 3;
+        }
+
+    protected:
+        GeneratedMesh();
+    };
+}
+
+#endif //_DMA_GENERATEDMESH_HPP_
@@ -41,13 +41,33 @@ namespace dma {
         Status loadAsPNG(const std::string&filename, bool reverse);
         Status loadAsPNG(BYTE* data);
 
-        U32 getWidth();
-        U32 getHeight();
-        GLint getFormat();
-        BYTE* getPixels();
+        /**
+         * Decodes a PNG file that is already in memory.
+         * @param name the file name, for logging.
+         * @param reverse if true, rows are stored bottom-up.
+         */
+        Status loadAsPNG(const BYTE* data, U32 size, const std::string& name, bool reverse);
+
+        U32 getWidth() const;
+        U32 getHeight() const;
+        GLint getFormat() const;
+        BYTE* getPixels() const;
+
+        inline U32 getBytesPerPixel() const {
+            return mBytesPerPixel;
+        }
+
+        /**
+         * @return the size of the pixels, in bytes, or 0 if the image is empty.
+         */
+        inline U32 getSizeInBytes() const {
+            return mPixels != nullptr ? mWidth * mHeight * mBytesPerPixel : 0;
+        }
 
     private:
         void mReadPngData(png_struct* png_ptr, GLubyte* data, bool reverse);
+        /** reads the image, once libpng is set up and the magic number read. */
+        Status mReadPng(png_struct* png_ptr, png_info* info_ptr, const std::string& fname, bool reverse);
 
     private:
         U32 mWidth;
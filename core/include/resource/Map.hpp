@@ -18,7 +18,11 @@
 #ifndef _DMA_MAP_HPP_
 #define _DMA_MAP_HPP_
 
+#include <vector>
+
 #include "resource/Texture.hpp"
+#include "resource/ResourceIndex.hpp"
+#include "resource/SpillCache.hpp"
 #include "utils/GLES2Logger.hpp"
 
 namespace dma {
@@ -37,7 +41,58 @@ namespace dma {
             mImage = image;
         }
 
+        /**
+         * @return the Image cache, or nullptr if the map has none.
+         */
+        inline Image* getImage() const {
+            return mImage;
+        }
+
+        /**
+         * Sets what is done with the Image cache once uploaded, from the next upload on.
+         * Maps loaded from an Image always keep it, as it cannot be read again.
+         * @param spillCache required by Retention::SPILL. Must outlive the map.
+         */
+        void setRetention(Retention retention, SpillCache* spillCache);
+
+        inline Retention getRetention() const {
+            return mRetention;
+        }
+
+        /**
+         * Makes the map read its file from the asset packs of the index, unless overridden by a loose file.
+         * @param fileIndex must outlive the map.
+         */
+        inline void setFileIndex(const ResourceIndex* fileIndex) {
+            mFileIndex = fileIndex;
+        }
+
+        inline const std::string& getFilename() const {
+            return mFilename;
+        }
+
+        /**
+         * Reads the Image cache again if it was released after upload, with its mipmap levels if it was spilled.
+         * It is kept until the next upload or releaseImage().
+         * @return the Image cache, or nullptr if it cannot be read.
+         */
+        Image* restoreImage();
+
+        /**
+         * Releases the Image cache and its mipmap levels according to the retention.
+         */
+        void releaseImage();
+
+        /**
+         * Loads the map from the given file, packed if the map has a file index.
+         */
         Status load(const std::string& filename);
+
+        /**
+         * Loads the map from a PNG file already in memory, eg. in an asset pack.
+         * @param filename the file name, for logging.
+         */
+        Status load(const BYTE* data, U32 size, const std::string& filename);
         /**
          * Loads the map from the provided Image.
          * A copy will be kept in cache.
@@ -46,11 +101,53 @@ namespace dma {
         Status refresh(const std::string &filename);
         Status refresh();
 
+        /**
+         * Forget the GL handle (which is no longer valid after a context loss)
+         * and mark this map as waiting for a deferred refresh.
+         */
+        void invalidate();
+
+        /**
+         * Sets the max anisotropy used by maps loaded from now on.
+         * The actual value is clamped to what the platform supports. 1.0 disables anisotropic filtering.
+         */
+        static void setMaxAnisotropy(F32 anisotropy);
+
+        /**
+         * Applies the current max anisotropy to this already loaded map.
+         */
+        void applyAnisotropy();
+
+        U32 getCpuBytes() const override;
+
+        /**
+         * @return true if the map has been invalidated and not refreshed yet.
+         */
+        inline bool isRestorePending() const {
+            return mRestorePending;
+        }
+
     private:
 
         Status mLoadFromImage();
+        /** decodes mFilename, or returns nullptr. */
+        Image* mReadImage() const;
+        /** releases mImage and mMipmaps. */
+        void mDeleteImage();
+        /** sets the anisotropy filter of the currently bound texture. */
+        void mSetupAnisotropy();
 
         Image* mImage;
+        /**
+         * Mipmap levels of mImage, from level 1 down to 1x1, one after the other. Built with the first upload,
+         * then kept, spilled or released with mImage: a restore uploads them rather than generating them again.
+         */
+        std::vector<BYTE> mMipmaps;
+        std::string mFilename;
+        bool mRestorePending;
+        Retention mRetention;
+        SpillCache* mSpillCache;
+        const ResourceIndex* mFileIndex;
 
     };
 }
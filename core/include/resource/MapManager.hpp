@@ -20,16 +20,23 @@
 
 #include <string>
 #include <memory>
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include "common/Sid.hpp"
+#include "common/HandleTable.hpp"
+#include "engine/geo/TileId.hpp"
 #include "resource/Map.hpp"
+#include "resource/MemoryReport.hpp"
+#include "resource/ResourceIndex.hpp"
 
 namespace dma {
 
     class MapManager {
 
     public:
-        MapManager(const std::string& dir);
+        MapManager(const std::string& dir, ResourceIndex& fileIndex, SpillCache& spillCache);
         virtual ~MapManager();
 
         MapManager(const MapManager&) = delete;
@@ -37,20 +44,143 @@ namespace dma {
 
         void init();
         std::shared_ptr<Map> acquire(const std::string& sid);
+
+        /**
+         * Same as acquire(), returning a handle: the map remains loaded as long
+         * as it is referenced by a shared pointer, not by handles.
+         * @return a null handle if the map doesn't exist.
+         */
+        Handle<Map> acquireHandle(const std::string& sid);
+
+        /**
+         * @return the map, or an empty pointer if the handle is stale. O(1), no reference counting.
+         */
+        inline const std::shared_ptr<Map>& get(Handle<Map> handle) const {
+            return mMaps.getShared(handle);
+        }
         bool hasResource(const std::string& sid) const;
 
+        /**
+         * @return the map returned by acquire() when the requested one doesn't exist.
+         */
+        inline const std::shared_ptr<Map>& getFallback() const {
+            return mFallbackMap;
+        }
+
+        /**
+         * Notifies that the file of the given map has been written by the platform.
+         */
+        void notifyAvailable(const std::string& sid);
+
+        /**
+         * Sets the directory of the tile maps, relative to the map dir, as "tiles/<namespace>/".
+         * Tile maps are indexed by TileId: the directory is scanned once, then lookups build no string.
+         * A path is only built to read a tile map from disk.
+         */
+        void setTileDir(const std::string& dir);
+
+        /**
+         * @return true if the tile has a map in the tile directory.
+         */
+        bool hasTile(const geo::TileId& id);
+
+        /**
+         * Loads the map of the tile if need be.
+         * @return a null handle if the tile has no map.
+         */
+        Handle<Map> acquireTileHandle(const geo::TileId& id);
+
+        /**
+         * Notifies that the map of the tile has been written by the platform.
+         */
+        void notifyTileAvailable(const geo::TileId& id);
+
         void reload();
-        void refresh();
+
+        /**
+         * Refreshes all maps from cache if any.
+         * @param deferred if true, only the fallback map is refreshed right away.
+         *                 Other maps are invalidated, and refreshed either when they are drawn,
+         *                 or by subsequent calls to restore().
+         */
+        void refresh(bool deferred = false);
+
+        /**
+         * Refreshes pending maps, most referenced first, until the time budget is spent.
+         * @param budget time budget, in seconds.
+         * @return the number of maps still pending.
+         */
+        U32 restore(F32 budget);
+
+        inline bool isRestorePending() const {
+            return !mRestoreQueue.empty();
+        }
+
+        /**
+         * Sets the max anisotropy of all maps, loaded or to be loaded.
+         * @see Map::setMaxAnisotropy
+         */
+        void setMaxAnisotropy(F32 anisotropy);
+
+        /**
+         * Sets what is done with the images of the maps once uploaded, loaded maps included.
+         * @see Map::setRetention
+         */
+        void setRetention(Retention retention);
+
+        inline Retention getRetention() const {
+            return mRetention;
+        }
+
+        /**
+         * @return the memory held by the loaded maps, the fallback one included.
+         */
+        MemoryUsage getMemoryUsage() const;
+
         void wipe();
         void unload();
         void update();
 
     private:
         void mLoadMap(std::shared_ptr<Map>, const std::string& sid);
+        /** loads the map into mMaps, without indexing it. @return a null handle if it doesn't exist. */
+        Handle<Map> mAddMap(const std::string& sid);
+        /** loads the map from the asset pack, or from the loose file if it overrides the packed one. */
+        Status mReadMap(Map& map, const std::string& filename);
+        /** indexes the files of the tile dir, if the file index changed since last time. */
+        void mScanTiles();
+        std::string mTileSid(const geo::TileId& id) const;
+
+        /** erases the entries of maps unloaded by update(). */
+        template<typename Index>
+        void mEraseStale(Index& index) {
+            auto it = index.begin();
+            while (it != index.end()) {
+                if (!mMaps.isValid(it->second)) {
+                    it = index.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
 
-        std::map<std::string, std::shared_ptr<Map>> mMaps;
+        /** all loaded maps: the named ones, and the tile ones */
+        HandleTable<Map> mMaps;
+        /** named maps */
+        std::unordered_map<Sid, Handle<Map>, Sid::Hash> mIndex;
+        /** maps of the tile dir, by TileId key: their paths are not interned. */
+        std::unordered_map<U64, Handle<Map>> mTileIndex;
+        /** TileId keys of the files of the tile dir */
+        std::unordered_set<U64> mTileFiles;
+        std::string mTileDir;
+        /** revision of the tile dir in the file index when it was scanned */
+        U32 mTileRevision;
+        std::vector<std::weak_ptr<Map>> mRestoreQueue;
         std::shared_ptr<Map> mFallbackMap;
         std::string mMapDir;
+        ResourceIndex& mFileIndex;
+        SpillCache& mSpillCache;
+        Retention mRetention;
     };
 }
 
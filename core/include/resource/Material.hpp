@@ -26,10 +26,10 @@
 
 namespace dma {
     class Material {
-    	static constexpr int DMA_MAX_PASS_COUNT = 4;
         friend class MaterialManager;
 
     public:
+    	static constexpr int DMA_MAX_PASS_COUNT = 4;
 
         Material();
         Material(const Material&);
@@ -42,9 +42,19 @@ namespace dma {
             return mPasses[i];
         }
 
+        inline const Pass& getPass(U8 i) const {
+            assert(i < mPassCount);
+            return mPasses[i];
+        }
+
         inline U8 getPassCount() const { return mPassCount; }
 
-        inline const std::string& getSID() { return mSID; }
+        inline const std::string& getSID() const { return mSID; }
+
+        /**
+         * @return a key unique to this material, shared by its MaterialInstances.
+         */
+        inline U32 getSortKey() const { return mSortKey; }
 
 
         inline void setDiffuseMap(std::shared_ptr<Map> diffuseMap, U8 passNum) {
@@ -63,6 +73,9 @@ namespace dma {
         Pass mPasses[DMA_MAX_PASS_COUNT];
         U8 mPassCount;
         bool mBackToFront;
+        U32 mSortKey;
+
+        static U32 sortKeyCount;
     };
 }
 
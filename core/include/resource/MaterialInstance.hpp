@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_MATERIALINSTANCE_HPP_
+#define _DMA_MATERIALINSTANCE_HPP_
+
+#include <memory>
+
+#include "common/Types.hpp"
+#include "resource/Material.hpp"
+#include "glm/glm.hpp"
+
+
+namespace dma {
+
+    /**
+     * A material as used by an entity: it reads its passes from a base Material,
+     * shared by all instances and never modified through them,
+     * and only stores the parameters it overrides.
+     */
+    class MaterialInstance {
+
+    public:
+        MaterialInstance(std::shared_ptr<Material> base);
+        MaterialInstance(const MaterialInstance&) = delete;
+        void operator=(const MaterialInstance&) = delete;
+        virtual ~MaterialInstance();
+
+        inline const std::shared_ptr<Material>& getBase() const { return mBase; }
+
+        inline const std::string& getSID() const { return mBase->getSID(); }
+
+        inline bool isBackToFront() const { return mBase->isBackToFront(); }
+
+        inline U8 getPassCount() const { return mBase->getPassCount(); }
+
+        /**
+         * @return the base pass: overridden parameters must be read from the instance.
+         */
+        inline const Pass& getPass(U8 i) const { return mBase->getPass(i); }
+
+        /**
+         * Instances of the same base material share the same sort key.
+         */
+        inline U32 getSortKey() const { return mBase->getSortKey(); }
+
+        /**
+         * @return the base pass functionalities, as changed by overrides.
+         */
+        inline U32 getFuncFlags(U8 i) const {
+            assert(i < getPassCount());
+            const Override& o = mOverrides[i];
+            return (mBase->getPass(i).getFuncFlags() & ~o.removedFuncFlags) | o.addedFuncFlags;
+        }
+
+        inline bool hasFunc(U8 i, Pass::Func func) const {
+            return (getFuncFlags(i) & (1L << func)) != 0;
+        }
+
+        const std::shared_ptr<Map>& getDiffuseMap(U8 i) const;
+        void setDiffuseMap(std::shared_ptr<Map> diffuseMap, U8 i);
+
+        bool isDiffuseMapEnabled(U8 i) const;
+        void setDiffuseMapEnabled(bool enabled, U8 i);
+
+        const glm::vec3& getDiffuseColor(U8 i) const;
+        void setDiffuseColor(const glm::vec3& diffuseColor, U8 i);
+
+        /**
+         * @param lightingMode Pass::LIGHTING_FLAT or Pass::LIGHTING_SMOOTH
+         */
+        void setLightingMode(Pass::Func lightingMode, U8 i);
+
+    private:
+        enum OverrideFlag {
+            DIFFUSE_MAP = 1 << 0,
+            DIFFUSE_MAP_ENABLED = 1 << 1,
+            DIFFUSE_COLOR = 1 << 2,
+        };
+
+        void mAddFunc(Pass::Func func, U8 i);
+        void mRemoveFunc(Pass::Func func, U8 i);
+
+        struct Override {
+            U8 flags = 0;
+            /** functionalities enabled on top of, or disabled from, the base pass ones */
+            U32 addedFuncFlags = 0;
+            U32 removedFuncFlags = 0;
+            bool diffuseMapEnabled = false;
+            glm::vec3 diffuseColor;
+            std::shared_ptr<Map> diffuseMap;
+        };
+
+        std::shared_ptr<Material> mBase;
+        Override mOverrides[Material::DMA_MAX_PASS_COUNT];
+    };
+}
+
+#endif //_DMA_MATERIALINSTANCE_HPP_
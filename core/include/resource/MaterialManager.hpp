@@ -19,6 +19,7 @@
 #define _DMA_MATERIALMANAGER_HPP
 
 #include "resource/Material.hpp"
+#include "resource/MaterialInstance.hpp"
 #include "resource/IResourceManager.hpp"
 #include "resource/ShaderManager.hpp"
 #include "resource/MapManager.hpp"
@@ -26,6 +27,10 @@
 #include <string>
 #include <set>
 #include <list>
+#include <unordered_map>
+
+#include "common/Sid.hpp"
+#include "common/HandleTable.hpp"
 
 namespace dma {
 
@@ -61,13 +66,18 @@ namespace dma {
             std::shared_ptr<Material> acquire(const std::string& sid, Status* result) override;
 
             std::shared_ptr<Material> create();
-            std::shared_ptr<Material> create(const std::string& sid, Status* result);
+
+            /**
+             * @return a new instance of the material corresponding to the given SID.
+             */
+            std::shared_ptr<MaterialInstance> create(const std::string& sid, Status* result);
 
             virtual bool hasResource(const std::string &) const;
 
         private:
             //CONSTRUCTORS
             MaterialManager(const std::string& rootDir,
+                            ResourceIndex& fileIndex,
                             ShaderManager& shaderManager,
                             MapManager& mapManager);
             MaterialManager(const MaterialManager&) = delete;
@@ -75,14 +85,16 @@ namespace dma {
 
 
             //METHODS
-            Status mLoad(std::shared_ptr<Material> material,  const std::string& sid) const;
+            Status mLoad(const std::shared_ptr<Material>& material, const std::string& sid) const;
 
             //FIELDS
             std::string                     mLocalDir;
+            ResourceIndex&                  mFileIndex;
 
             ShaderManager&                  mShaderManager;
             MapManager&                     mMapManager;
-            std::map<std::string, std::shared_ptr<Material>> mMaterials;
+            HandleTable<Material>           mMaterials;
+            std::unordered_map<Sid, Handle<Material>, Sid::Hash> mIndex;
             std::shared_ptr<Material>       mFallbackMaterial;
         };
 }
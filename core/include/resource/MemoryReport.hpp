@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_MEMORYREPORT_HPP_
+#define _DMA_MEMORYREPORT_HPP_
+
+#include "common/Types.hpp"
+
+namespace dma {
+
+    /**
+     * Memory held by the resources of one type.
+     */
+    struct MemoryUsage {
+        U32 count = 0;
+        /** data kept in RAM, as image or vertex caches */
+        U64 cpuBytes = 0;
+        /** estimated size of the OpenGL textures & buffers */
+        U64 gpuBytes = 0;
+
+        inline void add(U64 cpu, U64 gpu) {
+            ++count;
+            cpuBytes += cpu;
+            gpuBytes += gpu;
+        }
+
+        inline MemoryUsage& operator+=(const MemoryUsage& other) {
+            count += other.count;
+            cpuBytes += other.cpuBytes;
+            gpuBytes += other.gpuBytes;
+            return *this;
+        }
+    };
+
+
+    /**
+     * Memory held by the engine, per resource type, along with its high-water marks.
+     * Peaks are kept per field: the peak CPU & GPU sizes may have been reached at different times.
+     */
+    class MemoryReport {
+
+    public:
+        enum Category : U8 {
+            MESH, MAP, CUBEMAP, FONT, VECTOR_TILE, TERRAIN, SHADER,
+            /** HUD sprite atlas */
+            SPRITE_ATLAS,
+            /** dynamic vertex & index buffers of the HUD, the labels and the billboards */
+            HUD_BUFFER, LABEL_BUFFER, IMPOSTOR_BUFFER,
+            size
+        };
+
+        /**
+         * Sets the current usage of the category, raising the high-water marks if needed.
+         */
+        void set(Category category, const MemoryUsage& usage);
+
+        inline const MemoryUsage& get(Category category) const {
+            return mCurrent[category];
+        }
+
+        inline const MemoryUsage& getPeak(Category category) const {
+            return mPeaks[category];
+        }
+
+        /**
+         * @return the sum of all categories.
+         */
+        MemoryUsage getTotal() const;
+
+        inline const MemoryUsage& getPeakTotal() const {
+            return mPeakTotal;
+        }
+
+        static const char* getName(Category category);
+
+    private:
+        static const char* CATEGORY_NAMES[];
+
+        MemoryUsage mCurrent[size];
+        MemoryUsage mPeaks[size];
+        MemoryUsage mPeakTotal;
+    };
+}
+
+#endif //_DMA_MEMORYREPORT_HPP_
@@ -21,14 +21,18 @@
 #include "rendering/VertexBuffer.hpp"
 #include "rendering/IndexBuffer.hpp"
 #include "rendering/VertexElement.hpp"
+#include "rendering/VertexArray.hpp"
 #include "utils/VertexIndices.hpp"
 
 #include <vector>
 #include <set>
 #include <memory>
 #include <rendering/BoundingSphere.hpp>
+#include "glm/glm.hpp"
 
 namespace dma {
+    class ShaderProgram;
+
     class Mesh {
 
     public:
@@ -72,6 +76,60 @@ namespace dma {
 
         inline const BoundingSphere& getBoundingSphere() const { return mBoundingSphere; }
 
+        /**
+         * @return true if positions are stored as 16-bit integers, relative to the mesh bounding box.
+         * They are decoded by getPositionDecode().
+         */
+        inline bool hasQuantizedPositions() const {
+            return mQuantizedPositions;
+        }
+
+        /**
+         * @return the matrix transforming stored positions into model space.
+         */
+        inline const glm::mat4& getPositionDecode() const {
+            return mPositionDecode;
+        }
+
+        /**
+         * @return the scale from model space to stored positions, for shaders offsetting positions in model space.
+         */
+        inline const glm::vec3& getPositionScale() const {
+            return mPositionScale;
+        }
+
+        /**
+         * @return the number of bytes saved by quantization, compared to 32-bit floats.
+         */
+        inline U32 getBytesSaved() const {
+            return mBytesSaved;
+        }
+
+        /**
+         * @return the size of the vertex & index data kept CPU side, in bytes.
+         */
+        inline U32 getCpuBytes() const {
+            return (U32) (mVertexData.size() + mIndexData.size() * sizeof(U16));
+        }
+
+        /**
+         * @return the size of the OpenGL buffers, in bytes, or 0 if they are not uploaded.
+         */
+        U32 getGpuBytes() const;
+
+        /**
+         * @return the vertex array recorded for the given program & pass functions,
+         * or nullptr if there is none or if it is outdated.
+         */
+        const VertexArray* findVertexArray(const ShaderProgram& program, U32 funcFlags) const;
+
+        /**
+         * Records the given attributes for the given program & pass functions,
+         * replacing the previous vertex array if any.
+         */
+        const VertexArray& setVertexArray(const ShaderProgram& program, U32 funcFlags,
+                                          const std::vector<VertexArray::Attribute>& attributes);
+
         /**
          * Clear OpenGL resources
          */
@@ -81,12 +139,18 @@ namespace dma {
         //METHODS
         void addVertexElement(const VertexElement& vertexElement);
 
-        inline const bool hasCache() {
-            return !positions.empty();
+        /**
+         * @return true if the GPU-ready vertex & index data are kept CPU side,
+         * so that the mesh can be re-uploaded without going through the whole loading pipeline.
+         */
+        inline bool hasCache() const {
+            return !mVertexData.empty();
         }
 
         void clearCache();
 
+        void clearVertexArrays();
+
         //FIELDS
         std::string mSID;
         VertexElement mVertexElements[VertexElement::Semantic::SIZE];
@@ -96,12 +160,24 @@ namespace dma {
         std::shared_ptr<VertexBuffer> mVertexBuffer;
         std::shared_ptr<IndexBuffer> mIndexBuffer;
         BoundingSphere mBoundingSphere;
-
-        //Cache variables
-        std::vector<glm::vec3> positions;
-        std::vector<glm::vec2> uvs;
-        std::vector<glm::vec3> flatNormals;
-        std::vector<VertexIndices> vertexIndices;
+        bool mQuantizedPositions;
+        glm::mat4 mPositionDecode;
+        glm::vec3 mPositionScale;
+        U32 mBytesSaved;
+
+        struct VertexArrayEntry {
+            const ShaderProgram* program;
+            /** to detect program relinks */
+            U32 programRevision;
+            U32 funcFlags;
+            VertexArray vertexArray;
+        };
+        /** one vertex array per program & pass functions the mesh has been drawn with */
+        std::vector<VertexArrayEntry> mVertexArrays;
+
+        //Cache variables: interleaved vertices & indices, exactly as uploaded to the GPU.
+        std::vector<BYTE> mVertexData;
+        std::vector<U16> mIndexData;
     };
 }
 
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <rendering/Vertex.hpp>
 #include <utils/GLES2Logger.hpp>
@@ -27,6 +28,11 @@
 #include "resource/IResourceManager.hpp"
 #include "utils/VertexIndices.hpp"
 #include "resource/Mesh.hpp"
+#include "resource/MemoryReport.hpp"
+#include "resource/ResourceIndex.hpp"
+#include "resource/SpillCache.hpp"
+#include "common/Sid.hpp"
+#include "common/HandleTable.hpp"
 #include "glm/glm.hpp"
 
 
@@ -41,6 +47,20 @@ namespace dma {
 
 
     public:
+        /**
+         * Vertex elements that may be stored in compact integer formats rather than 32-bit floats.
+         */
+        enum Quantization {
+            QUANTIZE_NONE = 0,
+            /** normals as normalized 8-bit integers */
+            QUANTIZE_NORMALS = 1 << 0,
+            /** UVs as normalized 16-bit integers, for meshes whose UVs are in [0, 1] */
+            QUANTIZE_UVS = 1 << 1,
+            /** positions as normalized 16-bit integers, relative to the mesh bounding box */
+            QUANTIZE_POSITIONS = 1 << 2,
+            QUANTIZE_ALL = QUANTIZE_NORMALS | QUANTIZE_UVS | QUANTIZE_POSITIONS
+        };
+
         virtual ~MeshManager();
 
         /**
@@ -65,7 +85,8 @@ namespace dma {
         void update() override;
 
         /**
-         * From cache if any
+         * From cache if any.
+         * Cached meshes are re-uploaded as is, without parsing nor normal generation.
          */
         Status refresh();
 
@@ -85,25 +106,69 @@ namespace dma {
 
         bool hasResource(const std::string &) const;
 
+        /**
+         * Sets the Quantization flags applied to the meshes loaded from now on.
+         */
+        inline void setQuantization(U32 flags) {
+            mQuantization = flags;
+        }
+
+        inline U32 getQuantization() const {
+            return mQuantization;
+        }
+
+        /**
+         * @return the number of bytes saved by quantization, over all loaded meshes.
+         */
+        U32 getBytesSaved() const;
+
+        /**
+         * Sets what becomes of the vertex & index data of the meshes once uploaded, including the
+         * meshes already loaded. Refreshing a mesh whose data was dropped parses its file again.
+         */
+        void setRetention(Retention retention);
+
+        inline Retention getRetention() const {
+            return mRetention;
+        }
+
+        /**
+         * @return the memory held by the loaded meshes.
+         */
+        MemoryUsage getMemoryUsage() const;
+
     private:
-        MeshManager(const std::string& rootDir);
+        MeshManager(const std::string& rootDir, ResourceIndex& fileIndex, SpillCache& spillCache);
         MeshManager(const MeshManager&) = delete;
         void operator=(const MeshManager&) = delete;
 
         //METHODS
         //Mesh* mLoad(const std::string& sid, bool* result) const;
         //Mesh* mLoad(Mesh* mesh, const std::string& sid, bool* result) const;
-        Status mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid) const;
-        Status mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid,
+        Status mLoad(const std::shared_ptr<Mesh>& mesh, const std::string& sid) const;
+        /** parses the obj file of the mesh. */
+        Status mRead(const std::shared_ptr<Mesh>& mesh, const std::string& sid) const;
+        Status mLoad(const std::shared_ptr<Mesh>& mesh, const std::string& sid,
                      std::vector<glm::vec3> &positions,
                      std::vector<glm::vec2>& uvs,
                      std::vector<glm::vec3>& flatNormals,
                      std::vector<VertexIndices>& vertexIndices) const;
+        /** (re)creates the GL buffers out of the mesh's cached vertex & index data. */
+        Status mUpload(const std::shared_ptr<Mesh>& mesh) const;
+        /** fills the mesh's cached data from the spill cache, if it holds the key. */
+        bool mReadSpilled(Mesh& mesh, const std::string& key) const;
+        /** applies the retention policy to the mesh's cached data, once uploaded. */
+        void mRelease(Mesh& mesh, const std::string& key) const;
 
         // FIELDS
-        std::map<std::string, std::shared_ptr<Mesh>> mMeshes;
+        HandleTable<Mesh> mMeshes;
+        std::unordered_map<Sid, Handle<Mesh>, Sid::Hash> mIndex;
         std::shared_ptr<Mesh> mFallbackMesh;
         std::string mLocalDir;
+        ResourceIndex& mFileIndex;
+        SpillCache& mSpillCache;
+        U32 mQuantization;
+        Retention mRetention;
     };
 }
 
@@ -51,7 +51,7 @@ namespace dma {
 
         virtual ~Pass();
 
-        inline std::shared_ptr<ShaderProgram> getShaderProgram() const {
+        inline const std::shared_ptr<ShaderProgram>& getShaderProgram() const {
             return mShaderProgram;
         }
 
@@ -67,7 +67,7 @@ namespace dma {
             return mDepthWriting;
         }
 
-        inline std::shared_ptr<Map> getDiffuseMap() const {
+        inline const std::shared_ptr<Map>& getDiffuseMap() const {
             return mDiffuseMap;
         }
 
@@ -77,7 +77,7 @@ namespace dma {
             mDiffuseMapEnabled = enabled;
         }
 
-        inline bool isDiffuseMapEnabled() {
+        inline bool isDiffuseMapEnabled() const {
             return mDiffuseMapEnabled;
         }
 
@@ -99,7 +99,7 @@ namespace dma {
                     removeFunc(Func::LIGHTING_FLAT);
                     break;
                 default:
-                    Log::warn("Pass", "Wrong lighting mode. Has no effect");
+                    LOG_WARN("Pass", "Wrong lighting mode. Has no effect");
                     assert(false);
                     return;
             }
@@ -111,6 +111,10 @@ namespace dma {
             return (mFuncFlags & (1L << func)) != 0;
         }
 
+        inline U32 getFuncFlags() const {
+            return mFuncFlags;
+        }
+
     private:
         void addFunc(Func func);
         void removeFunc(Func func);
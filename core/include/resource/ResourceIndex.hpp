@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_RESOURCEINDEX_HPP_
+#define _DMA_RESOURCEINDEX_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/Types.hpp"
+#include "resource/AssetPack.hpp"
+
+namespace dma {
+
+    /**
+     * In-memory index of the files of the resource directory.
+     * The tree is scanned once by init(), then kept current by the engine's own writes
+     * (add(), remove()) and, on Linux, optionally by inotify (setWatchEnabled(), poll()).
+     * Existence checks are hash lookups and make no filesystem call.
+     *
+     * If the resource directory holds an asset pack (PACK_FILE), or if one is given by setPackFile(),
+     * its files are indexed too.
+     * Loose files override packed ones, so that a packed resource can be edited in place.
+     *
+     * Paths outside of the indexed directory are checked on the filesystem.
+     */
+    class ResourceIndex {
+
+    public:
+        static constexpr char PACK_FILE[] = "arpigl.pack";
+
+        ResourceIndex(const std::string& rootDir);
+        virtual ~ResourceIndex();
+        ResourceIndex(const ResourceIndex&) = delete;
+        void operator=(const ResourceIndex&) = delete;
+
+        /**
+         * (Re)scans the whole resource directory, and opens its asset pack if any.
+         */
+        void init();
+
+        /**
+         * Reads the asset pack from the given file region rather than from PACK_FILE, from the next init() on.
+         * On Android, this maps the pack straight from the APK, so it needs not be extracted first.
+         * The file descriptor is duplicated: the caller may close its own.
+         * @param fd file holding the pack, or -1 to go back to PACK_FILE.
+         * @see AssetPack::open(int, U64, U64, const std::string&)
+         */
+        void setPackFile(int fd, U64 offset, U64 length);
+
+        /**
+         * Leaves the given directory, relative to the resource dir, out of the index and the watches:
+         * for files the engine writes for itself, which are no resources. To be called before init().
+         */
+        void ignore(const std::string& dir);
+
+        /**
+         * Drops the index. Subsequent checks go to the filesystem until init() is called again.
+         */
+        void clear();
+
+        /**
+         * @return true if the given file exists.
+         */
+        bool exists(const std::string& path) const;
+
+        /**
+         * @return true if the given file is to be read from the asset pack, ie. it is packed and not
+         *         overridden by a loose file. If so, entry holds its content.
+         */
+        bool findPacked(const std::string& path, AssetPack::Entry& entry) const;
+
+        /**
+         * Fills the buffer with the content of the given file, loose or packed.
+         */
+        Status read(const std::string& path, std::string& buffer) const;
+
+        inline const AssetPack& getPack() const {
+            return mPack;
+        }
+
+        /**
+         * Notifies that the given file has been written.
+         */
+        void add(const std::string& path);
+
+        /**
+         * Notifies that the given file has been removed.
+         */
+        void remove(const std::string& path);
+
+        /**
+         * Checks the given file on the filesystem, and updates the index accordingly.
+         * @return true if the file exists.
+         */
+        bool refresh(const std::string& path);
+
+        /**
+         * Enables or disables inotify watches on the resource directory.
+         * Only supported on Linux: no effect elsewhere.
+         */
+        void setWatchEnabled(bool enabled);
+
+        inline bool isWatchEnabled() const {
+            return mWatchFd >= 0;
+        }
+
+        /**
+         * Applies pending inotify events, without blocking. No effect if watches are disabled.
+         * If the event queue overflowed, events were lost: the whole tree is scanned again.
+         * @return the number of changes made to the index, a rescan counting as one.
+         */
+        U32 poll();
+
+        /**
+         * @return the loose files, relative to the resource dir.
+         */
+        inline const std::unordered_set<std::string>& getFiles() const {
+            return mFiles;
+        }
+
+        /**
+         * Calls f with the path, relative to dir, of each loose file under dir.
+         */
+        template<typename F>
+        void forEachFile(const std::string& dir, F f) const {
+            std::string relative;
+            if (!mRelative(dir, relative)) {
+                return;
+            }
+            for (const std::string& file : mFiles) {
+                if (file.compare(0, relative.size(), relative) == 0) {
+                    f(file.c_str() + relative.size());
+                }
+            }
+        }
+
+        /**
+         * @return a counter bumped whenever the files under dir are changed from the filesystem,
+         *         ie. other than by add() and remove(), or the whole index is rebuilt:
+         *         indexes derived from the files of dir are to be rebuilt then.
+         */
+        U32 getRevision(const std::string& dir) const;
+
+        /**
+         * @return the number of indexed files.
+         */
+        inline size_t size() const {
+            return mFiles.size();
+        }
+
+    private:
+        /**
+         * @return true if path is in the indexed directory. If so, relative holds the path relative to it.
+         */
+        bool mRelative(const std::string& path, std::string& relative) const;
+
+        /**
+         * Recursively indexes the given directory, relative to the root dir.
+         */
+        void mScan(const std::string& dir);
+
+        void mWatch(const std::string& dir);
+
+        void mRemoveDir(const std::string& dir);
+
+        /**
+         * Bumps the revision of the directories holding the given path, relative to the root dir.
+         */
+        void mTouch(const std::string& path);
+
+        std::string mRootDir;
+        bool mInit;
+        /** bumped when the whole index is rebuilt */
+        U32 mRevision;
+        /** bumped when a file under the directory changes, by directory relative to the root dir. Never reset. */
+        std::unordered_map<std::string, U32> mDirRevisions;
+        std::unordered_set<std::string> mFiles;
+        AssetPack mPack;
+        /** file holding the pack, -1 to read PACK_FILE, and the region of the pack in it. */
+        int mPackFd;
+        U64 mPackOffset;
+        U64 mPackLength;
+        /** inotify file descriptor, -1 if watches are disabled. */
+        int mWatchFd;
+        /** watched directories, relative to the root dir, by watch descriptor. */
+        std::unordered_map<int, std::string> mWatches;
+        /** directories left out, relative to the root dir, with a trailing slash. */
+        std::unordered_set<std::string> mIgnoredDirs;
+    };
+}
+
+#endif //_DMA_RESOURCEINDEX_HPP_
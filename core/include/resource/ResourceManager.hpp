@@ -23,8 +23,12 @@
 #include "resource/ShaderManager.hpp"
 #include "resource/MeshManager.hpp"
 #include "resource/MapManager.hpp"
+#include "resource/FontManager.hpp"
 #include "resource/MaterialManager.hpp"
+#include "resource/MemoryReport.hpp"
 #include "resource/QuadFactory.hpp"
+#include "resource/ResourceIndex.hpp"
+#include "resource/SpillCache.hpp"
 
 #include <string>
 
@@ -52,7 +56,18 @@ namespace dma {
          * ENUM
          */
         enum ResourceType {
-            SHADER = 0, MESH = 1, TEXTURE = 2, MATERIAL = 3, SCENE = 4, CUBEMAP = 5, TILE = 6, size = 7
+            SHADER = 0, MESH = 1, TEXTURE = 2, MATERIAL = 3, SCENE = 4, CUBEMAP = 5, TILE = 6, FONT = 7, STYLE = 8, size = 9
+        };
+
+        /**
+         * How GPU resources are restored by refresh(), typically after an OpenGL context loss.
+         * - IMMEDIATE: everything is re-uploaded before refresh() returns.
+         * - PROGRESSIVE: shaders, meshes & cubemaps are re-uploaded right away from their cache,
+         *   maps are re-uploaded as soon as they are drawn, and the remaining ones are spread
+         *   over the next frames through restore().
+         */
+        enum class RestoreMode {
+            IMMEDIATE, PROGRESSIVE
         };
 
         struct ResourceIds {
@@ -87,6 +102,10 @@ namespace dma {
                 static constexpr char FALLBACK[]  = "fallback";
             };
 
+            struct Font {
+                static constexpr char DEFAULT[]  = "default";
+            };
+
         };
 
         /* ***
@@ -106,6 +125,70 @@ namespace dma {
          */
         Status refresh();
 
+        /**
+         * Restores resources left pending by a PROGRESSIVE refresh.
+         * @param budget time budget, in seconds.
+         * @return true if some resources are still pending.
+         */
+        bool restore(F32 budget);
+
+        inline bool isRestorePending() const {
+            return mMapManager.isRestorePending();
+        }
+
+        inline void setRestoreMode(RestoreMode mode) {
+            mRestoreMode = mode;
+        }
+
+        inline RestoreMode getRestoreMode() const {
+            return mRestoreMode;
+        }
+
+        /**
+         * Sets the MeshManager::Quantization flags applied to the meshes loaded from now on.
+         */
+        inline void setMeshQuantization(U32 flags) {
+            mMeshManager.setQuantization(flags);
+        }
+
+        /**
+         * @return the number of bytes saved by mesh quantization.
+         */
+        inline U32 getMeshBytesSaved() const {
+            return mMeshManager.getBytesSaved();
+        }
+
+        /**
+         * Sets what becomes of the CPU copy of the resources of the given type once uploaded to
+         * the GPU, including the resources already loaded. Only MESH, TEXTURE & CUBEMAP are supported:
+         * fonts keep their atlas, and the other types have no CPU copy to speak of.
+         * Defaults to Retention::KEEP.
+         */
+        void setRetention(ResourceType type, Retention retention);
+
+        Retention getRetention(ResourceType type) const;
+
+        /**
+         * @return the bytes written to the spill cache, on disk.
+         */
+        inline U64 getSpilledBytes() const {
+            return mSpillCache.getSizeInBytes();
+        }
+
+        /**
+         * Measures the memory held by the meshes, maps, cube maps & fonts, raising the high-water marks.
+         * Also done on each update().
+         * @return the report, holding as well the usages set with setMemoryUsage().
+         */
+        const MemoryReport& sampleMemory();
+
+        /**
+         * Sets the memory held by resources living outside of the managers, as vector tiles.
+         */
+        inline void setMemoryUsage(MemoryReport::Category category, const MemoryUsage& usage) {
+            mMemoryReport.set(category, usage);
+        }
+
         /**
          * Clean all GPU resources
          */
@@ -215,6 +298,72 @@ namespace dma {
         }
 
 
+        //--------------------------------------------------------------------------
+        /**
+         * Same as acquireMap(), returning a handle that is resolved without string lookup.
+         * @return a null handle if the map doesn't exist.
+         */
+        inline Handle<Map> acquireMapHandle(const std::string& sid) {
+            return mMapManager.acquireHandle(sid);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @return the map referenced by the handle, or an empty pointer if it was unloaded.
+         */
+        inline const std::shared_ptr<Map>& getMap(Handle<Map> handle) const {
+            return mMapManager.get(handle);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @return the map acquired in place of missing ones.
+         */
+        inline const std::shared_ptr<Map>& getFallbackMap() const {
+            return mMapManager.getFallback();
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * Sets the directory of the tile maps, under texture/, as "tiles/<namespace>/".
+         * @see MapManager::setTileDir
+         */
+        inline void setTileMapDir(const std::string& dir) {
+            mMapManager.setTileDir(dir);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @return true if the tile has a map. Builds no string.
+         */
+        inline bool hasTileMap(const geo::TileId& id) {
+            return mMapManager.hasTile(id);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * Same as acquireMapHandle(), for the map of the given tile.
+         * @return a null handle if the tile has no map.
+         */
+        inline Handle<Map> acquireTileMapHandle(const geo::TileId& id) {
+            return mMapManager.acquireTileHandle(id);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * Sets the max anisotropy of all maps.
+         */
+        inline void setMaxAnisotropy(F32 anisotropy) {
+            mMapManager.setMaxAnisotropy(anisotropy);
+        }
+
+
         //--------------------------------------------------------------------------
         /**
          * @param const std::string&
@@ -229,6 +378,28 @@ namespace dma {
         }
 
 
+        //--------------------------------------------------------------------------
+        /**
+         * @return true if the corresponding font exists.
+         */
+        inline bool hasFont(const std::string& sid) const {
+            return mFontManager.hasResource(sid);
+        }
+
+
+        //--------------------------------------------------------------------------
+        /**
+         * @param const std::string& -
+         *          SID of the font.
+         * @param Status* -
+         *          holds Status::OK if the font could be loaded.
+         * @return the Font corresponding to the sid, or nullptr.
+         */
+        inline std::shared_ptr<Font> acquireFont(const std::string& sid, Status* result) {
+            return mFontManager.acquire(sid, result);
+        }
+
+
         //--------------------------------------------------------------------------
         /**
          * @return true if the corresponding material exists.
@@ -262,9 +433,9 @@ namespace dma {
 
         //--------------------------------------------------------------------------
         /**
-         * Creates a new Material corresponding to the sid
+         * Creates a new instance of the Material corresponding to the sid
          */
-        inline std::shared_ptr<Material> createMaterial(const std::string& sid, Status* status) {
+        inline std::shared_ptr<MaterialInstance> createMaterial(const std::string& sid, Status* status) {
             return mMaterialManager.create(sid, status);
         }
 
@@ -286,19 +457,108 @@ namespace dma {
          */
         void update();
 
+        //--------------------------------------------------------------------------
+        /**
+         * Notifies that a file of the resource directory has been written by the engine.
+         */
+        inline void notifyFileWritten(const std::string& path) {
+            mFileIndex.add(path);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Notifies that the file of the given map has been written by the platform.
+         */
+        inline void notifyMapAvailable(const std::string& sid) {
+            mMapManager.notifyAvailable(sid);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Notifies that the map of the given tile has been written by the platform.
+         */
+        inline void notifyTileMapAvailable(const geo::TileId& id) {
+            mMapManager.notifyTileAvailable(id);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * @return true if the tile file (under texture/) corresponding to the sid exists.
+         * Tile files hold data other than maps, as vector tiles (".mvt") or elevation tiles (".png").
+         */
+        inline bool hasTileFile(const std::string& sid, const char* extension) const {
+            return mFileIndex.exists(mResourceDir + "texture/" + sid + extension);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Fills the buffer with the raw content of the given tile file.
+         */
+        inline Status readTileFile(const std::string& sid, const char* extension, std::string& buffer) const {
+            return mFileIndex.read(mResourceDir + "texture/" + sid + extension, buffer);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Notifies that the given tile file has been written by the platform.
+         */
+        inline void notifyTileFileAvailable(const std::string& sid, const char* extension) {
+            mFileIndex.add(mResourceDir + "texture/" + sid + extension);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Fills the buffer with the content of the given vector style (.json, under style/).
+         */
+        inline Status readVectorStyle(const std::string& sid, std::string& buffer) const {
+            return mFileIndex.read(mResourceDir + "style/" + sid + ".json", buffer);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Also keeps the resource index current with files written outside of the engine.
+         * Linux only.
+         * @see ResourceIndex::setWatchEnabled
+         */
+        inline void setFileWatchEnabled(bool enabled) {
+            mFileIndex.setWatchEnabled(enabled);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Reads the asset pack from the given file region, from the next init() on.
+         * @see ResourceIndex::setPackFile
+         */
+        inline void setPackFile(int fd, U64 offset, U64 length) {
+            mFileIndex.setPackFile(fd, offset, length);
+        }
+
+        //--------------------------------------------------------------------------
+        /**
+         * Applies changes made to the resource directory since the last call, if watched.
+         */
+        inline void pollFileChanges() {
+            mFileIndex.poll();
+        }
+
     private:
         /* ***
          * ATTRIBUTES
          */
 
         std::string                mResourceDir;
+        RestoreMode                mRestoreMode;
+        ResourceIndex              mFileIndex;
+        SpillCache                 mSpillCache;
 
         ShaderManager              mShaderManager;
         MeshManager                mMeshManager;
         MapManager                 mMapManager;
         CubeMapManager             mCubeMapManager;
+        FontManager                mFontManager;
         MaterialManager            mMaterialManager;
         QuadFactory                mQuadFactory;
+        MemoryReport               mMemoryReport;
 
         static constexpr int RESOURCE_MANAGER_ARRAY_SIZE = 6;
         /** array of the above resource managers. */
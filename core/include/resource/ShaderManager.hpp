@@ -25,6 +25,8 @@
 
 #include "resource/IResourceManager.hpp"
 #include "resource/ShaderProgram.hpp"
+#include "resource/MemoryReport.hpp"
+#include "resource/ResourceIndex.hpp"
 #include "common/Types.hpp"
 
 namespace dma {
@@ -76,9 +78,14 @@ namespace dma {
 
         virtual bool hasResource(const std::string &) const;
 
+        /**
+         * @return the memory held by the loaded programs, the fallback one included.
+         */
+        MemoryUsage getMemoryUsage() const;
+
 
     protected:
-        ShaderManager(const std::string& rootDir);
+        ShaderManager(const std::string& rootDir, ResourceIndex& fileIndex);
         ShaderManager(const ShaderManager&) = delete;
         void operator=(const ShaderManager&) = delete;
 
@@ -116,6 +123,7 @@ namespace dma {
         std::map<std::string, std::shared_ptr<ShaderProgram>> mShaderPrograms;
         std::shared_ptr<ShaderProgram> mFallbackShaderProgram;
         std::string mLocalDir;
+        ResourceIndex& mFileIndex;
     };
 
 }
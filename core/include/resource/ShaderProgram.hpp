@@ -21,6 +21,7 @@
 #include <utils/GLES2Logger.hpp>
 #include "common/Types.hpp"
 #include "utils/ExceptionType.hpp"
+#include "glm/glm.hpp"
 #include <string>
 
 namespace dma {
@@ -35,7 +36,8 @@ namespace dma {
             POS = 0,
             NORMAL = 1,
             UV = 2,
-            AS_size = 3
+            COLOR = 3,
+            AS_size = 4
         };
         enum UniformSem
         {
@@ -51,7 +53,12 @@ namespace dma {
             LIGHT0_AMBIENT = 9,
             LIGHT0_DIFFUSE = 10,
             LIGHT0_SPECULAR = 11,
-            US_size = 12
+            POSITION_SCALE = 12,
+            POSITION_DECODE = 13,
+            TIME = 14,
+            IDLE_BOB = 15,
+            IDLE_AXIS = 16,
+            US_size = 17
         };
 
         ShaderProgram();
@@ -69,6 +76,14 @@ namespace dma {
     public:
         inline GLuint getHandle() const {return mHandle;}
 
+        /**
+         * @return a number identifying the last link of the program, unique among all programs.
+         * Attribute locations may change from a link to another.
+         */
+        inline U32 getLinkRevision() const {
+            return mLinkRevision;
+        }
+
         inline U32 getAttributeFlags() const {
             return mAttributeFlags;
         }
@@ -93,11 +108,64 @@ namespace dma {
             return (bool) (mUniformFlags & (1L << sem));
         }
 
+        /**
+         * Uniform setters: the program keeps a copy of the values it holds, and only
+         * calls glUniform when a value changed. The program must be in use.
+         */
+        void setUniform(UniformSem sem, GLint value);
+        void setUniform(UniformSem sem, GLfloat value);
+        void setUniform(UniformSem sem, const glm::vec3& value);
+        void setUniform(UniformSem sem, const glm::vec4& value);
+        void setUniform(UniformSem sem, const glm::mat3& value);
+        void setUniform(UniformSem sem, const glm::mat4& value);
+
+        /**
+         * Revision of the light data last uploaded to this program, as set by the rendering engine.
+         */
+        inline U32 getLightRevision() const {
+            return mLightRevision;
+        }
+
+        inline void setLightRevision(U32 revision) {
+            mLightRevision = revision;
+        }
+
+        /**
+         * Number of glUniform calls made, and avoided, by all programs since the last reset.
+         */
+        static inline U32 getUniformUploadCount() {
+            return uniformUploadCount;
+        }
+
+        static inline U32 getUniformSkipCount() {
+            return uniformSkipCount;
+        }
+
+        static inline void resetUniformCounts() {
+            uniformUploadCount = 0;
+            uniformSkipCount = 0;
+        }
+
         /**
          * Clear OpenGL resources
          */
         void wipe();
 
+        /**
+         * @return the memory held on the CPU side: the program state and its source cache.
+         */
+        inline U32 getCpuBytes() const {
+            return (U32) (sizeof(ShaderProgram) + mVertexSource.capacity() + mFragmentSource.capacity());
+        }
+
+        /**
+         * @return the size of the linked program binary, 0 if the driver does not tell it
+         *         (no GL_OES_get_program_binary, nor OpenGL ES 3).
+         */
+        inline U32 getGpuBytes() const {
+            return mHandle != 0 ? mBinaryBytes : 0;
+        }
+
         inline bool hasCache() {
             return !mVertexSource.empty() && !mFragmentSource.empty();
         }
@@ -116,11 +184,21 @@ namespace dma {
          */
         Status mBindLocations();
 
+        /**
+         * Compares the value with the one the program holds, and keeps it if different.
+         * @return true if the value must be uploaded.
+         */
+        bool mCacheUniform(UniformSem sem, const void* value, size_t size);
+
 
     private:
         static const std::string attributeNames[AS_size];
         static const std::string uniformNames[US_size];
+        static U32 uniformUploadCount;
+        static U32 uniformSkipCount;
+        static U32 linkCount;
         GLuint mHandle;
+        U32 mLinkRevision;
         //The attribute flags
         U32 mAttributeFlags;
         // The attribute locations
@@ -129,6 +207,12 @@ namespace dma {
         U32 mUniformFlags;
         //The uniform locations
         GLint mUniformLocations[US_size];
+        // Shadow copy of the uniform values (as raw bytes), valid for the semantics flagged in mUniformCacheFlags
+        BYTE mUniformValues[US_size][sizeof(glm::mat4)];
+        U32 mUniformCacheFlags;
+        U32 mLightRevision;
+        /** see getGpuBytes() */
+        U32 mBinaryBytes;
         std::string mVertexSource;
         std::string mFragmentSource;
     };
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DMA_SPILLCACHE_HPP_
+#define _DMA_SPILLCACHE_HPP_
+
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "resource/Image.hpp"
+
+namespace dma {
+
+    /**
+     * What is done with the CPU copy of a resource once uploaded to the GPU.
+     * It is only needed to upload the resource again after an OpenGL context loss.
+     */
+    enum class Retention : U8 {
+        /** kept in memory: the fastest restore */
+        KEEP,
+        /** released, and read & decoded again from the resource file on restore */
+        DROP,
+        /** written to the spill cache then released: restored without decoding */
+        SPILL
+    };
+
+
+    /**
+     * Directory where resources spill their GPU-ready data, deflated.
+     * Entries only live as long as the engine: the ones left by a previous run are removed on init.
+     */
+    class SpillCache {
+
+    public:
+        struct Chunk {
+            const void* data;
+            U32 size;
+        };
+
+        SpillCache(const std::string& dir);
+        virtual ~SpillCache();
+        SpillCache(const SpillCache&) = delete;
+        void operator=(const SpillCache&) = delete;
+
+        /**
+         * Creates the directory if needed, and removes the entries left by a previous run.
+         * Other files of the directory are left untouched.
+         */
+        void init();
+
+        /**
+         * Removes all entries.
+         */
+        void clear();
+
+        inline bool contains(const std::string& key) const {
+            return mEntries.find(key) != mEntries.end();
+        }
+
+        /**
+         * Writes the chunks, one after the other, as the entry of the given key.
+         */
+        Status write(const std::string& key, std::initializer_list<Chunk> chunks);
+
+        /**
+         * Fills data with the entry of the given key.
+         */
+        Status read(const std::string& key, std::vector<BYTE>& data) const;
+
+        /**
+         * @param extra if not null, written after the pixels, eg. the mipmap levels of a map.
+         */
+        Status writeImage(const std::string& key, const Image& image, const std::vector<BYTE>* extra = nullptr);
+
+        /**
+         * @param extra if not null, filled with what was written after the pixels.
+         * @return the image of the given key, or nullptr if it cannot be read.
+         */
+        Image* readImage(const std::string& key, std::vector<BYTE>* extra = nullptr) const;
+
+        void remove(const std::string& key);
+
+        /**
+         * @return the size of the entries on disk, in bytes.
+         */
+        inline U64 getSizeInBytes() const {
+            return mSizeInBytes;
+        }
+
+    private:
+        struct Entry {
+            U32 file;
+            /** before & after deflate */
+            U32 size;
+            U32 storedSize;
+        };
+
+        std::string mPath(U32 file) const;
+
+        std::string mDir;
+        std::unordered_map<std::string, Entry> mEntries;
+        U32 mNextFile;
+        U64 mSizeInBytes;
+    };
+}
+
+#endif //_DMA_SPILLCACHE_HPP_
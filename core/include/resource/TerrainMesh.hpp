@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_TERRAINMESH_HPP_
+#define _DMA_TERRAINMESH_HPP_
+
+#include "resource/GeneratedMesh.hpp"
+
+namespace dma {
+
+    /**
+     * A regular grid of heights, in the space of a tile Quad: x goes east and y north, both in [-1, 1],
+     * and z is the height, in meters. Vertices have a position and the uv of the Quad.
+     * The grid is bordered by a skirt hanging below it, which hides the cracks between neighbouring
+     * grids of different resolutions.
+     */
+    class TerrainMesh : public GeneratedMesh {
+
+    public:
+        /**
+         * @param segments number of grid cells along each side.
+         * @param heights (segments + 1)² heights, row by row from the north-west corner.
+         * @param width, height size of the tile, in meters.
+         */
+        TerrainMesh(const std::string& sid, U32 segments, const std::vector<F32>& heights,
+                    F32 width, F32 height, F32 skirtDepth);
+        TerrainMesh(const TerrainMesh&) = delete;
+        void operator=(const TerrainMesh&) = delete;
+        virtual ~TerrainMesh();
+
+        inline U32 getSegments() const {
+            return mSegments;
+        }
+
+    private:
+        U32 mSegments;
+    };
+}
+
+#endif //_DMA_TERRAINMESH_HPP_
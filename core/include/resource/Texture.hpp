@@ -69,10 +69,29 @@ namespace dma {
         virtual Status refresh(const std::string& filename) = 0;
         virtual void wipe();
 
+        /**
+         * @return the size of the images kept in cache, in bytes.
+         */
+        virtual U32 getCpuBytes() const = 0;
+
+        /**
+         * @return the estimated size of the GL texture, mipmaps included, in bytes, or 0 if it is not uploaded.
+         */
+        inline U32 getGpuBytes() const {
+            return mHandle != 0 ? mGpuBytes : 0;
+        }
+
     protected:
+        /**
+         * @return the size of a texture level made of the given image, and of its whole mip chain if mipmapped.
+         */
+        static U32 computeGpuBytes(const Image& image, bool mipmapped);
+
         // openGL handle to this texture.
         GLuint mHandle;
         std::string mSID;
+        /** size of the texture as last uploaded, see getGpuBytes() */
+        U32 mGpuBytes;
 
     };
 
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_VECTORMESH_HPP_
+#define _DMA_VECTORMESH_HPP_
+
+#include "resource/GeneratedMesh.hpp"
+
+namespace dma {
+
+    /**
+     * A mesh of a vector tile, out of interleaved positions & flat normals (3 floats each) and 16-bit indices.
+     */
+    class VectorMesh : public GeneratedMesh {
+
+    public:
+        /**
+         * @param vertices position & flat normal of each vertex.
+         */
+        VectorMesh(const std::string& sid, const F32* vertices, U32 vertexCount, std::vector<U16>&& indices);
+        VectorMesh(const VectorMesh&) = delete;
+        void operator=(const VectorMesh&) = delete;
+        virtual ~VectorMesh();
+    };
+}
+
+#endif //_DMA_VECTORMESH_HPP_
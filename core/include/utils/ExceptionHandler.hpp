@@ -39,7 +39,7 @@ namespace dma {
         }
 
         static inline Status __DMA__throwError(const std::string& tag, dma::ExceptionType type, int line, const char* file, const char* func, const std::string& what) {
-            Log::error(tag, what);
+            Log::error(tag.c_str(), "%s", what.c_str());
             return (Status)type;
         }
 
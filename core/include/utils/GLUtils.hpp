@@ -48,6 +48,19 @@ namespace dma {
          */
         static bool isExtSupported(const std::string& extension);
 
+        /**
+         * @return the address of the given GL entry point (typically an extension function),
+         * or nullptr if the platform does not export it. Requires a current context.
+         * Implemented by each platform, with the loader of the kind of context it creates.
+         */
+        static void* getProcAddress(const char* name);
+
+        /**
+         * @return true if the current context is an OpenGL ES 3.0+ one.
+         * The engine is built against GLES2 headers: ES 3 entry points must be loaded with getProcAddress.
+         */
+        static bool isGles3();
+
         static void printGlContext();
 
         static bool hasGlContext();
@@ -21,28 +21,105 @@
 #include <string>
 #include <iostream>
 
+#include "common/Types.hpp"
+
+/*
+ * Highest level compiled in: 0 for errors only, up to 4 for traces.
+ * Levels other than errors are logged through the LOG_WARN, LOG_INFO, LOG_DEBUG and LOG_TRACE macros:
+ * above this level, the call compiles to nothing, arguments included.
+ */
+#ifndef LOG_LEVEL
+#if defined(DEBUG) && defined(TRACE)
+#define LOG_LEVEL 4
+#elif defined(DEBUG)
+#define LOG_LEVEL 3
+#else
+#define LOG_LEVEL 2
+#endif
+#endif
+
 namespace dma {
 
+    /**
+     * Messages are formatted by the caller into a lock-free ring buffer, and written by a background thread.
+     * Messages posted while the ring buffer is full are dropped and counted, except errors.
+     * @see LogSink
+     */
     class Log {
     public:
-        static void error(const std::string& tag, const std::string& message, ...);
-        static void warn(const std::string& tag, const std::string& message, ...);
-        static void info(const std::string& tag, const std::string& message, ...);
-#ifdef DEBUG
-        static void debug(const std::string& tag, const std::string& message, ...);
-#ifdef TRACE
-        static void trace(const std::string& tag, const std::string& message, ...);
+        enum Level : U8 {
+            LEVEL_ERROR, LEVEL_WARN, LEVEL_INFO, LEVEL_DEBUG, LEVEL_TRACE
+        };
+
+        /**
+         * Written before returning, as an error may be followed by a crash.
+         */
+        static void error(const char* tag, const char* message, ...);
+
+#if LOG_LEVEL >= 1
+        static void warn(const char* tag, const char* message, ...);
 #endif
+
+#if LOG_LEVEL >= 2
+        static void info(const char* tag, const char* message, ...);
 #endif
-#ifndef DEBUG
-        static inline void debug(const std::string& tag, const std::string& message, ...) {
-        }
+
+#if LOG_LEVEL >= 3
+        static void debug(const char* tag, const char* message, ...);
 #endif
-#ifndef TRACE
-        static inline void trace(const std::string& tag, const std::string& message, ...) {
-        }
+
+#if LOG_LEVEL >= 4
+        static void trace(const char* tag, const char* message, ...);
 #endif
+
+        /**
+         * Waits until the messages posted so far are written.
+         */
+        static void flush();
+
+        /**
+         * @return the number of messages dropped since the start, because the ring buffer was full.
+         */
+        static U64 getDroppedCount();
+
+    private:
+        friend class LogSink;
+
+        /**
+         * Writes a formatted message. Implemented by each platform, called on the log thread, or by the caller
+         * of an error while the ring buffer is full.
+         */
+        static void write(Level level, const char* tag, const char* message);
+
+        /**
+         * Flushes the messages written since the last call. Implemented by each platform.
+         */
+        static void sync();
     };
 }
 
+#if LOG_LEVEL >= 1
+#define LOG_WARN(...) ::dma::Log::warn(__VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void) 0)
+#endif
+
+#if LOG_LEVEL >= 2
+#define LOG_INFO(...) ::dma::Log::info(__VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void) 0)
+#endif
+
+#if LOG_LEVEL >= 3
+#define LOG_DEBUG(...) ::dma::Log::debug(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void) 0)
+#endif
+
+#if LOG_LEVEL >= 4
+#define LOG_TRACE(...) ::dma::Log::trace(__VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void) 0)
+#endif
+
 #endif /* _DMA_LOG_HPP_ */
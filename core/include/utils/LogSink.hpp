@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_LOGSINK_HPP_
+#define _DMA_LOGSINK_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <mutex>
+#include <thread>
+
+#include "utils/Log.hpp"
+
+namespace dma {
+
+    /**
+     * Background writer of the log.
+     * Callers format their message straight into a slot of a bounded lock-free ring buffer (multiple producers,
+     * one consumer), and never wait: if the ring buffer is full, the message is dropped and counted, unless it is
+     * an error, written by the caller then.
+     * The log thread writes the messages through the platform Log::write, and syncs the output once the ring
+     * buffer is drained, rather than after each message.
+     * A message identical to the previous one is not written again within REPEAT_INTERVAL: the number of
+     * repetitions is written instead.
+     */
+    class LogSink {
+
+    public:
+        /** number of slots, a power of two */
+        static constexpr U32 CAPACITY = 512;
+        static constexpr U32 TAG_SIZE = 32;
+        static constexpr U32 MESSAGE_SIZE = 256;
+        /** in milliseconds */
+        static constexpr U32 REPEAT_INTERVAL = 1000;
+        /** in milliseconds: the log thread sleeps this long at most while the ring buffer is empty */
+        static constexpr U32 IDLE_TIMEOUT = 100;
+
+        /**
+         * @return the sink, created and started by the first call.
+         */
+        static LogSink& getInstance();
+
+        LogSink(const LogSink&) = delete;
+        void operator=(const LogSink&) = delete;
+
+        /**
+         * Formats the message into the ring buffer. Never blocks.
+         */
+        void post(Log::Level level, const char* tag, const char* format, va_list args);
+
+        /**
+         * Waits until the messages posted so far are written.
+         */
+        void flush();
+
+        inline U64 getDroppedCount() const {
+            return mDroppedCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Slot {
+            /** equal to the position of the slot when free, to the position + 1 once filled */
+            std::atomic<U32> sequence;
+            Log::Level level;
+            char tag[TAG_SIZE];
+            char message[MESSAGE_SIZE];
+        };
+
+        LogSink();
+        ~LogSink();
+
+        void mLoop();
+
+        /**
+         * Writes the message, or counts it as a repetition of the previous one.
+         */
+        void mWrite(const Slot& slot, std::chrono::steady_clock::time_point now);
+
+        /**
+         * Writes the number of repetitions of the previous message, if any.
+         */
+        void mWriteRepeated();
+
+        Slot mSlots[CAPACITY];
+        /** next position to fill, shared by the producers */
+        std::atomic<U32> mHead;
+        /** next position to write, on the log thread */
+        U32 mTail;
+        /** positions written so far */
+        std::atomic<U32> mWritten;
+        std::atomic<U64> mDroppedCount;
+        /** set while the log thread sleeps, so that producers only notify it then */
+        std::atomic<bool> mIdle;
+        std::mutex mLock;
+        std::condition_variable mCondition;
+        /** notified by the log thread each time it is done writing, for flush() */
+        std::condition_variable mFlushCondition;
+        std::thread mThread;
+
+        /* state of the log thread */
+        U64 mReportedDroppedCount;
+        Slot mLast;
+        U32 mRepeatCount;
+        std::chrono::steady_clock::time_point mLastTime;
+    };
+}
+
+#endif //_DMA_LOGSINK_HPP_
@@ -57,6 +57,11 @@ namespace dma {
          */
         Status parse();
 
+        /**
+         * Same as parse(), from the content of the file, already read.
+         */
+        Status parse(const std::string& json);
+
         bool isBackToFront() const;
 
         /**
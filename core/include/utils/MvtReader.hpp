@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_MVTREADER_HPP_
+#define _DMA_MVTREADER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "glm/glm.hpp"
+
+namespace dma {
+
+    /**
+     * Decodes Mapbox Vector Tiles (protobuf, specification 2.1), gzipped or not.
+     * Geometries are decoded into tile coordinates, [0, extent] with y going down;
+     * tags are kept as indices into the layer key & value tables, as in the tile.
+     */
+    class MvtReader {
+
+    public:
+        enum GeomType {
+            UNKNOWN = 0,
+            POINT = 1,
+            LINESTRING = 2,
+            POLYGON = 3
+        };
+
+        struct Value {
+            enum Type {
+                STRING,
+                NUMBER,
+                BOOL
+            };
+            Type type = NUMBER;
+            std::string string;
+            F64 number = 0.0;
+        };
+
+        struct Feature {
+            U64 id = 0;
+            GeomType type = UNKNOWN;
+            /** key & value indices, in pairs */
+            std::vector<U32> tags;
+            /** vertices of all parts: points, lines, or polygon rings */
+            std::vector<glm::vec2> points;
+            /** index of the first vertex of each part */
+            std::vector<U32> parts;
+
+            inline U32 getPartCount() const {
+                return (U32) parts.size();
+            }
+
+            inline U32 getPartBegin(U32 part) const {
+                return parts[part];
+            }
+
+            inline U32 getPartEnd(U32 part) const {
+                return part + 1 < parts.size() ? parts[part + 1] : (U32) points.size();
+            }
+        };
+
+        struct Layer {
+            std::string name;
+            U32 extent = 4096;
+            std::vector<std::string> keys;
+            std::vector<Value> values;
+            std::vector<Feature> features;
+
+            /**
+             * @return the value of the feature tagged with the given key, or nullptr.
+             */
+            const Value* getProperty(const Feature& feature, const std::string& key) const;
+        };
+
+        /**
+         * @param data the tile, gzipped or not.
+         * @param layers receives the decoded layers.
+         * @return STATUS_KO if the tile is truncated or malformed.
+         */
+        static Status read(const BYTE* data, U32 size, std::vector<Layer>& layers);
+    };
+}
+
+#endif //_DMA_MVTREADER_HPP_
@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
 
 namespace dma {
         class ObjReader {
@@ -32,6 +33,11 @@ namespace dma {
             static const int FACE_N = 2;
 
             ObjReader(const std::string& path);
+
+            /**
+             * Reads an obj file that is already in memory. data must outlive the reader.
+             */
+            ObjReader(const BYTE* data, U32 size);
             ObjReader(const ObjReader&) = delete;
             void operator=(const ObjReader&) = delete;
             virtual ~ObjReader();
@@ -49,7 +55,9 @@ namespace dma {
             bool nextFace(U16 face[3][3]);
 
         private:
-            std::ifstream mInputStream;
+            std::ifstream mFileStream;
+            std::unique_ptr<std::streambuf> mMemoryBuffer;
+            std::istream mInputStream;
             Status mGotoLabel(const std::string&);
 
         };
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DMA_TRIANGULATOR_HPP_
+#define _DMA_TRIANGULATOR_HPP_
+
+#include <deque>
+#include <vector>
+
+#include "common/Types.hpp"
+#include "glm/glm.hpp"
+
+namespace dma {
+
+    /**
+     * Triangulates polygons with holes by ear clipping, holes being bridged into the outer ring first
+     * (after the earcut algorithm). Self-intersections and degenerate rings are tolerated:
+     * the polygon may then be partly covered, but the triangulation always ends.
+     *
+     * A triangulator keeps its node pool from one polygon to the next: reuse it on a thread.
+     */
+    class Triangulator {
+
+    public:
+        Triangulator();
+        Triangulator(const Triangulator&) = delete;
+        void operator=(const Triangulator&) = delete;
+        virtual ~Triangulator();
+
+        /**
+         * @param points vertices of all rings. Rings are not closed: their last vertex differs from the first one.
+         * @param rings index of the first vertex of each ring, the outer ring first, then the holes.
+         * The last ring ends with 'points'.
+         * @param triangles receives 3 indices into 'points' per triangle.
+         */
+        void triangulate(const std::vector<glm::vec2>& points, const std::vector<U32>& rings,
+                         std::vector<U32>& triangles);
+
+    private:
+        struct Node {
+            U32 i;
+            F64 x;
+            F64 y;
+            Node* prev;
+            Node* next;
+            bool steiner;
+        };
+
+        Node* mInsertNode(U32 i, const glm::vec2& point, Node* last);
+        Node* mLinkedList(const std::vector<glm::vec2>& points, U32 begin, U32 end, bool clockwise);
+        Node* mFilterPoints(Node* start, Node* end = nullptr);
+        void mEarcutLinked(Node* ear, int pass);
+        Node* mCureLocalIntersections(Node* start);
+        void mSplitEarcut(Node* start);
+        Node* mEliminateHoles(const std::vector<glm::vec2>& points, const std::vector<U32>& rings, Node* outerNode);
+        Node* mEliminateHole(Node* hole, Node* outerNode);
+        Node* mSplitPolygon(Node* a, Node* b);
+        void mEmit(const Node* a, const Node* b, const Node* c);
+
+        std::deque<Node> mNodes;
+        std::vector<Node*> mHoles;
+        std::vector<U32>* mTriangles;
+    };
+}
+
+#endif //_DMA_TRIANGULATOR_HPP_
@@ -20,6 +20,7 @@
 
 
 // std
+#include <atomic>
 #include <string>
 #include <vector>
 #include <cassert>
@@ -79,6 +80,25 @@ namespace dma {
 
         static std::string& addTrailingSlash(std::string& filename);
 
+        /**
+         * Number of filesystem calls (open, stat, readdir...) made through the engine since the last reset,
+         * from any thread.
+         */
+        static inline U32 getFileSyscallCount() {
+            return fileSyscallCount.load(std::memory_order_relaxed);
+        }
+
+        static inline void resetFileSyscallCount() {
+            fileSyscallCount.store(0, std::memory_order_relaxed);
+        }
+
+        static inline void countFileSyscall() {
+            // a counter only: it orders nothing.
+            fileSyscallCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    private:
+        static std::atomic<U32> fileSyscallCount;
     };
 
 
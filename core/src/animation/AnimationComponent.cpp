@@ -33,7 +33,8 @@ namespace dma {
 
 
     //------------------------------------------------------------------------------
-    void AnimationComponent::update(float dt) {
+    bool AnimationComponent::update(float dt) {
+        bool running = !mAnimations.empty();
         std::list<Animation*>::iterator it = mAnimations.begin();
         while (it != mAnimations.end()) {
             (*it)->update(dt);
@@ -43,5 +44,6 @@ namespace dma {
                 ++it;
             }
         }
+        return running;
     }
 }
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cassert>
+#include <initializer_list>
+
+#include "animation/AnimationPool.hpp"
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    //--------------------------------------------------------------------
+    template <typename T>
+    static inline void swapPop(std::vector<T>& column, U32 index) {
+        column[index] = column.back();
+        column.pop_back();
+    }
+
+
+
+    /* ================= PUBLIC ========================*/
+
+    //--------------------------------------------------------------------
+    AnimationPool::AnimationPool() :
+            mInterval(1),
+            mFrame(0),
+            mElapsed(0.0f)
+    {}
+
+
+    //--------------------------------------------------------------------
+    AnimationPool::~AnimationPool() {
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::reserve(U32 count) {
+        for (Columns* columns : {&mTranslations, &mRotations, &mSlerps}) {
+            columns->targets.reserve(count);
+            columns->times.reserve(count);
+            columns->durations.reserve(count);
+            columns->loops.reserve(count);
+            columns->handles.reserve(count);
+        }
+        mTranslationFrom.reserve(count);
+        mTranslationTo.reserve(count);
+        mTranslationFuncs.reserve(count);
+        mTranslationMirrors.reserve(count);
+        mRotationAngles.reserve(count);
+        mRotationCurrentAngles.reserve(count);
+        mRotationAxes.reserve(count);
+        mSlerpFrom.reserve(count);
+        mSlerpTo.reserve(count);
+        mInterpolants.reserve(count);
+        mTracks.reserve(3 * count);
+    }
+
+
+    //--------------------------------------------------------------------
+    AnimationPool::Track AnimationPool::addTranslation(TransformComponent& target,
+                                                       const glm::vec3& from, const glm::vec3& to,
+                                                       float duration, TranslationAnimation::Function func,
+                                                       bool loop, bool mirror) {
+        mTranslationFrom.push_back(from);
+        mTranslationTo.push_back(to);
+        mTranslationFuncs.push_back((U8) func);
+        mTranslationMirrors.push_back(mirror);
+        return mPush(TRANSLATION, mTranslations, target, duration, loop);
+    }
+
+
+    //--------------------------------------------------------------------
+    AnimationPool::Track AnimationPool::addRotation(TransformComponent& target,
+                                                    float duration, bool loop,
+                                                    float angle, const glm::vec3& axis) {
+        mRotationAngles.push_back(angle);
+        mRotationCurrentAngles.push_back(0.0f);
+        mRotationAxes.push_back(axis);
+        return mPush(ROTATION, mRotations, target, duration, loop);
+    }
+
+
+    //--------------------------------------------------------------------
+    AnimationPool::Track AnimationPool::addSlerp(TransformComponent& target,
+                                                 const glm::quat& from, const glm::quat& to,
+                                                 float duration, bool loop) {
+        mSlerpFrom.push_back(from);
+        mSlerpTo.push_back(to);
+        return mPush(SLERP, mSlerps, target, duration, loop);
+    }
+
+
+    //--------------------------------------------------------------------
+    bool AnimationPool::refreshTranslation(const Track& track, const glm::vec3& from, const glm::vec3& to, float duration) {
+        assert(duration > 0.0f);
+        const U32* found = mTracks.find(track.handle);
+        if (found == nullptr || track.type != TRANSLATION) {
+            return false;
+        }
+        U32 index = *found;
+        mTranslationFrom[index] = from;
+        mTranslationTo[index] = to;
+        mTranslations.durations[index] = duration;
+        mTranslations.times[index] = 0.0f; //reset the current time
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------
+    bool AnimationPool::isRunning(const Track& track) const {
+        return mTracks.isValid(track.handle);
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::remove(Track& track) {
+        const U32* found = mTracks.find(track.handle);
+        if (found != nullptr) {
+            mRemoveAt(track.type, *found);
+        }
+        track = Track();
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::clear() {
+        for (Columns* columns : {&mTranslations, &mRotations, &mSlerps}) {
+            columns->targets.clear();
+            columns->times.clear();
+            columns->durations.clear();
+            columns->loops.clear();
+            columns->handles.clear();
+        }
+        mTranslationFrom.clear();
+        mTranslationTo.clear();
+        mTranslationFuncs.clear();
+        mTranslationMirrors.clear();
+        mRotationAngles.clear();
+        mRotationCurrentAngles.clear();
+        mRotationAxes.clear();
+        mSlerpFrom.clear();
+        mSlerpTo.clear();
+
+        // invalidates every handle, and makes every slot available again.
+        mTracks.clear();
+        mFrame = 0;
+        mElapsed = 0.0f;
+    }
+
+
+    //--------------------------------------------------------------------
+    bool AnimationPool::step(float dt) {
+        mElapsed += dt;
+        if (++mFrame < mInterval) {
+            return false;
+        }
+        dt = mElapsed;
+        mFrame = 0;
+        mElapsed = 0.0f;
+        if (getTrackCount() == 0) {
+            return false;
+        }
+
+        mAdvance(mTranslations, dt);
+        mStepTranslations();
+        mRemoveFinished(TRANSLATION, mTranslations);
+
+        mAdvance(mRotations, dt);
+        mStepRotations();
+        mRemoveFinished(ROTATION, mRotations);
+
+        mAdvance(mSlerps, dt);
+        mStepSlerps();
+        mRemoveFinished(SLERP, mSlerps);
+        return true;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //--------------------------------------------------------------------
+    AnimationPool::Track AnimationPool::mPush(Type type, Columns& columns, TransformComponent& target,
+                                              float duration, bool loop) {
+        assert(duration > 0.0f);
+        Track track;
+        track.handle = mTracks.add((U32) columns.targets.size());
+        track.type = type;
+        columns.targets.push_back(&target);
+        columns.times.push_back(0.0f);
+        columns.durations.push_back(duration);
+        columns.loops.push_back(loop);
+        columns.handles.push_back(track.handle);
+        return track;
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::mRemoveAt(Type type, U32 index) {
+        Columns& columns = type == TRANSLATION ? mTranslations : (type == ROTATION ? mRotations : mSlerps);
+        assert(index < columns.targets.size());
+
+        mTracks.remove(columns.handles[index]);
+        // the last track takes the place of the removed one.
+        if (index + 1 < columns.handles.size()) {
+            *mTracks.find(columns.handles.back()) = index;
+        }
+
+        swapPop(columns.targets, index);
+        swapPop(columns.times, index);
+        swapPop(columns.durations, index);
+        swapPop(columns.loops, index);
+        swapPop(columns.handles, index);
+        switch (type) {
+            case TRANSLATION:
+                swapPop(mTranslationFrom, index);
+                swapPop(mTranslationTo, index);
+                swapPop(mTranslationFuncs, index);
+                swapPop(mTranslationMirrors, index);
+                break;
+            case ROTATION:
+                swapPop(mRotationAngles, index);
+                swapPop(mRotationCurrentAngles, index);
+                swapPop(mRotationAxes, index);
+                break;
+            case SLERP:
+                swapPop(mSlerpFrom, index);
+                swapPop(mSlerpTo, index);
+                break;
+        }
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::mAdvance(Columns& columns, float dt) {
+        const U32 count = (U32) columns.times.size();
+        float* times = columns.times.data();
+        const float* durations = columns.durations.data();
+        const U8* loops = columns.loops.data();
+        for (U32 i = 0; i < count; ++i) {
+            float time = times[i] + dt;
+            if (loops[i]) {
+                time = glm::mod<float>(time, durations[i]);
+            } else if (time > durations[i]) {
+                time = durations[i];
+            }
+            times[i] = time;
+        }
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::mStepTranslations() {
+        const U32 count = (U32) mTranslations.targets.size();
+        mInterpolants.resize(count);
+        for (U32 i = 0; i < count; ++i) {
+            float x = mTranslations.times[i] / mTranslations.durations[i];
+            bool mirror = mTranslationMirrors[i] != 0;
+            switch (mTranslationFuncs[i]) {
+                case TranslationAnimation::LINEAR:
+                    mInterpolants[i] = linear(x, mirror);
+                    break;
+                case TranslationAnimation::EASE:
+                    mInterpolants[i] = ease(x, mirror);
+                    break;
+                case TranslationAnimation::EASE_OUT:
+                    mInterpolants[i] = easeOut(x, mirror);
+                    break;
+                default:
+                    assert(false);
+                    mInterpolants[i] = x;
+                    break;
+            }
+        }
+        for (U32 i = 0; i < count; ++i) {
+            mTranslations.targets[i]->setPosition(glm::mix(mTranslationFrom[i], mTranslationTo[i], mInterpolants[i]));
+        }
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::mStepRotations() {
+        const U32 count = (U32) mRotations.targets.size();
+        mInterpolants.resize(count);
+        // rotations are applied incrementally: the interpolant is the angle to add since the last step.
+        for (U32 i = 0; i < count; ++i) {
+            float angle = mRotationAngles[i] * mRotations.times[i] / mRotations.durations[i];
+            mInterpolants[i] = glm::mod<float>(angle - mRotationCurrentAngles[i], 360.0f);
+            mRotationCurrentAngles[i] = angle;
+        }
+        for (U32 i = 0; i < count; ++i) {
+            mRotations.targets[i]->rotate(mInterpolants[i], mRotationAxes[i]);
+        }
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::mStepSlerps() {
+        const U32 count = (U32) mSlerps.targets.size();
+        for (U32 i = 0; i < count; ++i) {
+            float interpolant = mSlerps.times[i] / mSlerps.durations[i];
+            mSlerps.targets[i]->setOrientation(glm::slerp(mSlerpFrom[i], mSlerpTo[i], interpolant));
+        }
+    }
+
+
+    //--------------------------------------------------------------------
+    void AnimationPool::mRemoveFinished(Type type, const Columns& columns) {
+        // backwards, so that the track swapped into a removed place has already been checked.
+        for (U32 i = (U32) columns.targets.size(); i > 0; --i) {
+            U32 index = i - 1;
+            if (!columns.loops[index] && columns.times[index] >= columns.durations[index]) {
+                mRemoveAt(type, index);
+            }
+        }
+    }
+
+}
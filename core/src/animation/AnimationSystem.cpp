@@ -16,14 +16,9 @@
 
 
 
-#include "animation/AnimationSystem.hpp"
-#include "utils/Log.hpp"
-
-constexpr float ROTATION_RATE        = 90.0f;
-constexpr float TRANSLATION_LENGTH   = 2.0f;
-constexpr float TRANSLATION_SPEED    = 3.0f;
+#include <algorithm>
 
-constexpr char TAG[] = "AnimationSystem";
+#include "animation/AnimationSystem.hpp"
 
 namespace dma {
 
@@ -34,32 +29,29 @@ namespace dma {
 
     //--------------------------------------------------------------------
     void AnimationSystem::unload() {
-        assert(false); //TODO remove animation system
-        mAnimations.clear();
-        mAnimationComponents.clear();
+        mAnimationPools.clear();
     }
 
 
     //--------------------------------------------------------------------
-    void AnimationSystem::subscribe(AnimationComponent &animationComponent) {
-        assert(false); //TODO remove animation system
-        mAnimationComponents.push_back(&animationComponent);
+    void AnimationSystem::subscribe(AnimationPool &animationPool) {
+        mAnimationPools.push_back(&animationPool);
     }
 
 
     //--------------------------------------------------------------------
-    void AnimationSystem::unsubscribe(AnimationComponent &animationComponent) {
-        assert(false); //TODO remove animation system
-        mAnimationComponents.remove(&animationComponent);
+    void AnimationSystem::unsubscribe(AnimationPool &animationPool) {
+        mAnimationPools.erase(std::remove(mAnimationPools.begin(), mAnimationPools.end(), &animationPool),
+                              mAnimationPools.end());
     }
 
 
     //--------------------------------------------------------------------
-    void AnimationSystem::step(float dt) {
-        assert(false); //TODO remove animation system
-        for (AnimationComponent* ac : mAnimationComponents) {
-            ac->update(dt);
+    bool AnimationSystem::step(float dt) {
+        bool evaluated = false;
+        for (AnimationPool* pool : mAnimationPools) {
+            evaluated |= pool->step(dt);
         }
-
+        return evaluated;
     }
 }
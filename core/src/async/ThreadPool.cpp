@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cassert>
+
+#include "async/ThreadPool.hpp"
+
+namespace dma {
+
+    //---------------------------------------------------------------------------
+    ThreadPool::ThreadPool() :
+            mRunningCount(0),
+            mExit(false)
+    {}
+
+
+    //---------------------------------------------------------------------------
+    ThreadPool::~ThreadPool() {
+        stop();
+    }
+
+
+    //---------------------------------------------------------------------------
+    void ThreadPool::start(U32 threadCount) {
+        if (isRunning()) {
+            return;
+        }
+        if (threadCount == 0) {
+            U32 cores = std::thread::hardware_concurrency();
+            threadCount = cores > 1 ? cores - 1 : 1;
+        }
+        mExit = false;
+        for (U32 i = 0; i < threadCount; ++i) {
+            mThreads.push_back(std::thread(&ThreadPool::mLoop, this));
+        }
+    }
+
+
+    //---------------------------------------------------------------------------
+    void ThreadPool::stop() {
+        if (!isRunning()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(mLock);
+            mTasks.clear();
+            mExit = true;
+        }
+        mCondition.notify_all();
+        for (std::thread& thread : mThreads) {
+            thread.join();
+        }
+        mThreads.clear();
+    }
+
+
+    //---------------------------------------------------------------------------
+    void ThreadPool::post(std::function<void()> task) {
+        assert(isRunning());
+        {
+            std::lock_guard<std::mutex> guard(mLock);
+            mTasks.push_back(std::move(task));
+        }
+        mCondition.notify_one();
+    }
+
+
+    //---------------------------------------------------------------------------
+    U32 ThreadPool::cancelAll() {
+        std::lock_guard<std::mutex> guard(mLock);
+        U32 count = (U32) mTasks.size();
+        mTasks.clear();
+        mIdleCondition.notify_all();
+        return count;
+    }
+
+
+    //---------------------------------------------------------------------------
+    void ThreadPool::wait() {
+        std::unique_lock<std::mutex> lock(mLock);
+        mIdleCondition.wait(lock, [this]() { return mTasks.empty() && mRunningCount == 0; });
+    }
+
+
+    //---------------------------------------------------------------------------
+    void ThreadPool::mLoop() {
+        std::unique_lock<std::mutex> lock(mLock);
+        while (true) {
+            mCondition.wait(lock, [this]() { return !mTasks.empty() || mExit; });
+            if (mExit) {
+                return;
+            }
+            std::function<void()> task = std::move(mTasks.front());
+            mTasks.pop_front();
+            ++mRunningCount;
+            lock.unlock();
+            task();
+            lock.lock();
+            --mRunningCount;
+            if (mTasks.empty() && mRunningCount == 0) {
+                mIdleCondition.notify_all();
+            }
+        }
+    }
+}
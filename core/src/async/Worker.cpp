@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cassert>
+
+#include "async/Worker.hpp"
+
+namespace dma {
+
+    //---------------------------------------------------------------------------
+    Worker::Worker() :
+            mBusy(false),
+            mExit(false)
+    {}
+
+
+    //---------------------------------------------------------------------------
+    Worker::~Worker() {
+        stop();
+    }
+
+
+    //---------------------------------------------------------------------------
+    void Worker::start() {
+        if (isRunning()) {
+            return;
+        }
+        mExit = false;
+        mThread = std::thread(&Worker::mLoop, this);
+    }
+
+
+    //---------------------------------------------------------------------------
+    void Worker::stop() {
+        if (!isRunning()) {
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            mCondition.wait(lock, [this]() { return !mBusy; });
+            mExit = true;
+        }
+        mCondition.notify_all();
+        mThread.join();
+    }
+
+
+    //---------------------------------------------------------------------------
+    void Worker::run(std::function<void()> task) {
+        assert(isRunning());
+        {
+            std::lock_guard<std::mutex> guard(mLock);
+            assert(!mBusy && "previous task not waited for");
+            mTask = std::move(task);
+            mBusy = true;
+        }
+        mCondition.notify_all();
+    }
+
+
+    //---------------------------------------------------------------------------
+    void Worker::wait() {
+        std::unique_lock<std::mutex> lock(mLock);
+        mCondition.wait(lock, [this]() { return !mBusy; });
+    }
+
+
+    //---------------------------------------------------------------------------
+    void Worker::mLoop() {
+        std::unique_lock<std::mutex> lock(mLock);
+        while (true) {
+            mCondition.wait(lock, [this]() { return mBusy || mExit; });
+            if (mBusy) {
+                lock.unlock();
+                mTask();
+                lock.lock();
+                mTask = nullptr;
+                mBusy = false;
+                mCondition.notify_all();
+            } else {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "common/FrameAllocator.hpp"
+
+#include <algorithm>
+
+namespace dma {
+
+    /** blocks are allocated in multiples of this size */
+    constexpr size_t BLOCK_GRANULARITY = 4096;
+
+
+    /* ================= ROUTINES ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    static inline size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    FrameAllocator::FrameAllocator(U32 capacity) :
+            mBlock(nullptr),
+            mCapacity(alignUp(capacity, BLOCK_GRANULARITY)),
+            mOffset(0),
+            mRetiredBytes(0) {
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    FrameAllocator::~FrameAllocator() {
+        reset();
+        delete[] mBlock;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameAllocator::reset() {
+        if (!mRetired.empty()) {
+            const size_t used = mRetiredBytes + mOffset;
+            for (BYTE* block : mRetired) {
+                delete[] block;
+            }
+            mRetired.clear();
+            // the next frames fit in a single block.
+            if (used > mCapacity) {
+                delete[] mBlock;
+                mBlock = nullptr;
+                mCapacity = alignUp(used, BLOCK_GRANULARITY);
+            }
+        }
+        mOffset = 0;
+        mRetiredBytes = 0;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    void* FrameAllocator::mAllocate(size_t size, size_t alignment) {
+        // new[] aligns blocks for any fundamental type.
+        const size_t offset = alignUp(mOffset, alignment);
+        if (mBlock != nullptr && offset + size <= mCapacity) {
+            mOffset = offset + size;
+            return mBlock + offset;
+        }
+        if (mBlock != nullptr) {
+            // full: kept until the next reset.
+            mRetired.push_back(mBlock);
+            mRetiredBytes += mOffset;
+            mCapacity *= 2;
+        }
+        mCapacity = alignUp(std::max(mCapacity, size), BLOCK_GRANULARITY);
+        mBlock = new BYTE[mCapacity];
+        mOffset = size;
+        return mBlock;
+    }
+}
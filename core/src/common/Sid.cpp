@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common/Sid.hpp"
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    namespace {
+        constexpr U32 CHUNK_BITS = 10;
+        constexpr U32 CHUNK_SIZE = 1 << CHUNK_BITS;
+        /** 4M strings at most */
+        constexpr U32 MAX_CHUNKS = 4096;
+
+        /**
+         * Interned strings, indexed by id, in fixed-size chunks that never move.
+         * Only interning locks: a string is written before its id is handed out, so str()
+         * reads it without lock.
+         */
+        struct SidTable {
+            std::mutex mutex;
+            std::string* chunks[MAX_CHUNKS];
+            U32 size;
+            std::unordered_map<std::string, U32> ids;
+
+            SidTable() :
+                    chunks(),
+                    size(0)
+            {
+                // id 0 is the empty string.
+                push(std::string());
+            }
+
+            ~SidTable() {
+                for (std::string* chunk : chunks) {
+                    delete[] chunk;
+                }
+            }
+
+            U32 push(const std::string& str) {
+                U32 id = size;
+                U32 chunk = id >> CHUNK_BITS;
+                if (chunk >= MAX_CHUNKS) {
+                    throw std::runtime_error("Sid table full");
+                }
+                if (chunks[chunk] == nullptr) {
+                    chunks[chunk] = new std::string[CHUNK_SIZE];
+                }
+                chunks[chunk][id & (CHUNK_SIZE - 1)] = str;
+                ids[str] = id;
+                ++size;
+                return id;
+            }
+        };
+
+        //------------------------------------------------------------------------------
+        SidTable& getTable() {
+            static SidTable table;
+            return table;
+        }
+
+        //------------------------------------------------------------------------------
+        U32 intern(const std::string& str) {
+            SidTable& table = getTable();
+            std::lock_guard<std::mutex> lock(table.mutex);
+            auto it = table.ids.find(str);
+            if (it != table.ids.end()) {
+                return it->second;
+            }
+            return table.push(str);
+        }
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------------
+    Sid::Sid(const std::string& str) :
+            mId(intern(str))
+    {}
+
+
+    //------------------------------------------------------------------------------
+    Sid::Sid(const char* str) :
+            mId(intern(std::string(str)))
+    {}
+
+
+    //------------------------------------------------------------------------------
+    const std::string& Sid::str() const {
+        const SidTable& table = getTable();
+        return table.chunks[mId >> CHUNK_BITS][mId & (CHUNK_SIZE - 1)];
+    }
+}
@@ -38,7 +38,7 @@ namespace dma {
 
     //-----------------------------------------------------------
     void Timer::reset(){
-        Log::trace(TAG, "Resetting Timer");
+        LOG_TRACE(TAG, "Resetting Timer");
         mDT = 0.0f;
         mLastTime = now();
     }
@@ -31,6 +31,7 @@ namespace dma {
 #ifndef FPS_PRINT_RATE
     constexpr float Engine::FPS_PRINT_RATE;
 #endif
+    constexpr float Engine::RESTORE_BUDGET;
 
     /* ***
      * CONSTRUCTORS
@@ -38,8 +39,15 @@ namespace dma {
     //---------------------------------------------------------------------------------
     Engine::Engine(const std::string& rootDir) :
             mRootDir(rootDir),
+            mRestoreBudget(RESTORE_BUDGET),
+            mIdleFrameSkipping(false),
+            mPipelined(false),
+            mFrameBegun(false),
+            mUpdateChanged(false),
+            mSkippedFrameCount(0),
+            mFileSyscallCount(0),
             mIsInit(false) {
-        Log::trace(TAG, "Creating Engine...");
+        LOG_TRACE(TAG, "Creating Engine...");
 
         mRootDir = Utils::addTrailingSlash(mRootDir);
         mResourceManager = new ResourceManager(mRootDir);
@@ -47,23 +55,28 @@ namespace dma {
         mRenderingEngine = new RenderingEngine(*mResourceManager);
         mAnimationSystem = new AnimationSystem();
         mScene = new Scene(mResourceManager, mAnimationSystem, mRenderingEngine);
+        mFrameGovernor = new FrameGovernor();
+        mQualityLevel = mFrameGovernor->getQualityLevel();
 
-        Log::trace(TAG, "resource dir: %s", mRootDir.c_str());
+        LOG_TRACE(TAG, "resource dir: %s", mRootDir.c_str());
         assert(Utils::dirExists(mRootDir.c_str()));
 
-        Log::trace(TAG, "-----Engine created-----\n");
+        LOG_TRACE(TAG, "-----Engine created-----\n");
     }
 
     //---------------------------------------------------------------------------------
 
     Engine::~Engine() {
-        Log::trace(TAG, "Destroying Engine...");
+        LOG_TRACE(TAG, "Destroying Engine...");
+        mUpdateWorker.stop();
         delete mScene;
         delete mAnimationSystem;
+        // the rendering engine reports its memory to the resource manager until it is unloaded.
+        delete mRenderingEngine;
         delete mResourceManager;
         delete mGlobalTimer;
-        delete mRenderingEngine;
-        Log::trace(TAG, "-----Engine destroyed-----\n");
+        delete mFrameGovernor;
+        LOG_TRACE(TAG, "-----Engine destroyed-----\n");
     }
 
     /* ***
@@ -71,12 +84,12 @@ namespace dma {
      */
     //---------------------------------------------------------------------------------
     void Engine::setSurfaceSize(U32 width, U32 height) {
-        Log::trace(TAG, "Setting surface size...");
+        LOG_TRACE(TAG, "Setting surface size...");
 
         //init already called ?
 #ifdef DEBUG
         if (!mIsInit) {
-            Log::warn(TAG, "Setting viewport size while engine not initialized...");
+            LOG_WARN(TAG, "Setting viewport size while engine not initialized...");
         }
 #endif
         //check width & height param
@@ -87,7 +100,14 @@ namespace dma {
         mRenderingEngine->setViewport(width, height);
         mScene->getCamera().setAspectRatio(mRenderingEngine->getAspectRatio());
 
-        Log::trace(TAG, "Surface size set");
+        LOG_TRACE(TAG, "Surface size set");
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::setRestoreMode(ResourceManager::RestoreMode mode, float budget) {
+        mResourceManager->setRestoreMode(mode);
+        mRestoreBudget = budget;
     }
 
 
@@ -96,15 +116,15 @@ namespace dma {
         // an openGL context must be opened for this operation.
         bool hasOglContext = GLUtils::hasGlContext();
         if(!hasOglContext) {
-            Log::warn(TAG, "no openGL context has been created. 'init' may not work or may crash.");
+            LOG_WARN(TAG, "no openGL context has been created. 'init' may not work or may crash.");
         } else {
             GLUtils::printGlContext();
         }
         assert(hasOglContext);
 
-        Log::trace(TAG, "Initializing Engine...");
+        LOG_TRACE(TAG, "Initializing Engine...");
         if (mIsInit) {
-            Log::warn(TAG, "calling init twice.. This call will have no effect");
+            LOG_WARN(TAG, "calling init twice.. This call will have no effect");
             return false;
         }
 
@@ -123,10 +143,12 @@ namespace dma {
             return false;
         }
 
+        mFrameGovernor->init();
+
         // engine is not initialized.
         mIsInit = true;
 
-        Log::trace(TAG, "Engine initialized");
+        LOG_TRACE(TAG, "Engine initialized");
         return true;
     }
 
@@ -137,6 +159,7 @@ namespace dma {
         mResourceManager->refresh();
         mScene->refresh();
         mRenderingEngine->init();
+        mFrameGovernor->init();
     }
 
     //---------------------------------------------------------------------------------
@@ -150,19 +173,21 @@ namespace dma {
 
     //---------------------------------------------------------------------------------
     void Engine::unload() {
-        Log::trace(TAG, "Unloading Engine...");
+        LOG_TRACE(TAG, "Unloading Engine...");
         if(!mIsInit) {
-            Log::trace(TAG, "Unloading engine that is not initialized. Will have no effect.");
-            Log::trace(TAG, "Engine unloaded");
+            LOG_TRACE(TAG, "Unloading engine that is not initialized. Will have no effect.");
+            LOG_TRACE(TAG, "Engine unloaded");
             return;
         }
 
+        mUpdateWorker.wait();
         // if an openGL context is opened, try to clean up OGL resources.
         mScene->unload();
+        mFrameGovernor->wipe();
         mRenderingEngine->unload();
         mResourceManager->unload();
         mIsInit = false;
-        Log::trace(TAG, "Engine unloaded");
+        LOG_TRACE(TAG, "Engine unloaded");
     }
 
 
@@ -170,22 +195,89 @@ namespace dma {
     void Engine::wipe() {
         mAssertInit("Engine::wipe");
 
-        Log::trace(TAG, "Wiping Engine...");
+        LOG_TRACE(TAG, "Wiping Engine...");
         mResourceManager->wipe();
         mScene->wipe(); //wipe skybox
-        Log::trace(TAG, "Engine wiped");
+        mFrameGovernor->wipe();
+        LOG_TRACE(TAG, "Engine wiped");
     }
 
 
     //---------------------------------------------------------------------------------
-    void Engine::step() {
+    bool Engine::step() {
         mAssertInit("Engine::step");
+        if (!mFrameBegun) {
+            mFrameGovernor->beginFrame();
+        }
+        mFrameBegun = false;
         mGlobalTimer->update();
 #ifdef FPS_PRINT_RATE
         mUpdateFPS();
 #endif
-        mScene->step(mGlobalTimer->dt());
+        mFileSyscallCount = Utils::getFileSyscallCount();
+        Utils::resetFileSyscallCount();
+        mResourceManager->pollFileChanges();
+        if (mResourceManager->isRestorePending()) {
+            // restored textures are not drawn yet.
+            mResourceManager->restore(mRestoreBudget);
+            mRenderingEngine->invalidate();
+        }
+        // shader animations keep running while nothing changes on the CPU side.
+        if (!mIdleFrameSkipping || mRenderingEngine->isInvalidated() || mRenderingEngine->isAnimated()) {
+            mScene->invalidate();
+        }
+        mRenderingEngine->setTime(mGlobalTimer->now());
+
+        if (mPipelined) {
+            return mStepPipelined();
+        }
+        if (!mScene->step(mGlobalTimer->dt())) {
+            mFrameGovernor->skipFrame();
+            ++mSkippedFrameCount;
+            return false;
+        }
         mRenderingEngine->drawFrame();
+        mFrameGovernor->endFrame();
+        mApplyQuality();
+        return true;
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::beginFrame() {
+        mFrameGovernor->beginFrame();
+        mFrameBegun = true;
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::setIdleFrameSkippingEnabled(bool enabled) {
+        mIdleFrameSkipping = enabled;
+        mRenderingEngine->invalidate();
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::setPipelinedEnabled(bool enabled) {
+        if (enabled == mPipelined) {
+            return;
+        }
+        mPipelined = enabled;
+        if (enabled) {
+            mUpdateWorker.start();
+        } else {
+            mUpdateWorker.stop();
+        }
+        mRenderingEngine->setDoubleBuffered(enabled);
+        mFrameGovernor->setLatencyFrames(enabled ? 1 : 0);
+        // the next scene step builds the list to draw.
+        mScene->invalidate();
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::invalidate() {
+        mRenderingEngine->invalidate();
     }
 
 
@@ -195,6 +287,57 @@ namespace dma {
     }
 
 
+    //---------------------------------------------------------------------------------
+    void Engine::updateHUDElement(const HUDElement& hudElement) {
+        mRenderingEngine->updateHUDElement(hudElement);
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::removeHUDElement(const std::shared_ptr<HUDElement>& hudElement) {
+        mRenderingEngine->unsubscribeHUDElement(hudElement);
+    }
+
+
+    //---------------------------------------------------------------------------------
+    bool Engine::mStepPipelined() {
+        // the list built by the previous step is drawn, while the next one is built.
+        mRenderingEngine->swapFrameLists();
+        float dt = mGlobalTimer->dt();
+        mUpdateWorker.run([this, dt]() {
+            mUpdateChanged = mScene->step(dt);
+        });
+
+        bool drawn = mRenderingEngine->isFrameListReady();
+        if (drawn) {
+            mRenderingEngine->drawFrame();
+        }
+        mUpdateWorker.wait();
+
+        if (!drawn) {
+            mFrameGovernor->skipFrame();
+            ++mSkippedFrameCount;
+            return false;
+        }
+        mFrameGovernor->endFrame();
+        mApplyQuality();
+        return true;
+    }
+
+
+    //---------------------------------------------------------------------------------
+    void Engine::mApplyQuality() {
+        if (mFrameGovernor->getQualityLevel() == mQualityLevel) {
+            return;
+        }
+        mQualityLevel = mFrameGovernor->getQualityLevel();
+        const FrameGovernor::Quality& quality = mFrameGovernor->getQuality();
+        mResourceManager->setMaxAnisotropy(quality.anisotropy);
+        mRenderingEngine->setSkyBoxAllowed(quality.skyBox);
+        mRenderingEngine->invalidate();
+    }
+
+
     //---------------------------------------------------------------------------------
     void Engine::mUpdateFPS() {
         static float elapsedTime = 0.0f;
@@ -204,7 +347,7 @@ namespace dma {
         elapsedTime += mGlobalTimer->dt();
 
         if (elapsedTime >= FPS_PRINT_RATE && FPS_PRINT_RATE > 0) {
-            Log::info(TAG, "FPS = %f", (float)frameCount / elapsedTime);
+            LOG_INFO(TAG, "FPS = %f", (float)frameCount / elapsedTime);
             frameCount = 0;
             elapsedTime = 0.0f;
         }
@@ -23,23 +23,25 @@ namespace dma {
 
 
     //---------------------------------------------------------------------------
-    Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::vec3& pos) :
+    Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material, const glm::vec3& pos) :
             mTransformComponent(new TransformComponent()),
-            mRenderingComponent(new RenderingComponent(mTransformComponent->getM(), mesh, material)),
-            mAnimationComponent(NULL)
+            mRenderingComponent(new RenderingComponent(*mTransformComponent, mesh, material)),
+            mAnimationComponent(NULL),
+            mVisible(true),
+            mChanged(true)
     {
         mTransformComponent->setPosition(glm::vec3(pos));
     }
 
 
     //---------------------------------------------------------------------------
-    Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, float x, float y, float z) :
+    Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material, float x, float y, float z) :
             Entity(mesh, material, glm::vec3(x, y, z)) {
     }
 
 
     //---------------------------------------------------------------------------
-    Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material) :
+    Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material) :
             Entity(mesh, material, 0.0f, 0.0f, 0.0f) {
     }
 
@@ -55,22 +57,31 @@ namespace dma {
     //---------------------------------------------------------------------------
     void Entity::setMesh(std::shared_ptr<Mesh> mesh) {
         mRenderingComponent->setMesh(mesh);
+        mChanged = true;
     }
 
 
     //---------------------------------------------------------------------------
-    void Entity::setMaterial(std::shared_ptr<Material> material) {
+    void Entity::setMaterial(std::shared_ptr<MaterialInstance> material) {
         mRenderingComponent->setMaterial(material);
+        mChanged = true;
     }
 
 
     //---------------------------------------------------------------------------
-    void Entity::update(float dt) {
+    bool Entity::update(float dt) {
         assert(mTransformComponent != NULL);
-        mTransformComponent->update();
+        bool changed = mChanged;
+        mChanged = false;
+        if (!mVisible) {
+            // hidden entities are neither transformed nor animated: they catch up once shown.
+            return changed;
+        }
+        changed |= mTransformComponent->update();
         if (mAnimationComponent != nullptr) {
-            mAnimationComponent->update(dt);
+            changed |= mAnimationComponent->update(dt);
         }
+        return changed;
     }
 
 
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "glm/glm.hpp"
+
+#include "engine/FrameGovernor.hpp"
+#include "utils/GLUtils.hpp"
+#include "utils/Log.hpp"
+
+constexpr char TAG[] = "FrameGovernor";
+
+/** downgrade when the smoothed frame time goes over this ratio of the target */
+constexpr float DOWNGRADE_RATIO = 1.15f;
+/** upgrade when the smoothed frame time goes under this ratio of the target */
+constexpr float UPGRADE_RATIO = 0.7f;
+/** frames to wait after a change before downgrading again */
+constexpr unsigned DOWNGRADE_DELAY = 30;
+/** frames to wait after a change before upgrading again. Longer, to avoid oscillations. */
+constexpr unsigned UPGRADE_DELAY = 180;
+/** weight of the last frame in the smoothed frame time */
+constexpr float SMOOTHING = 0.1f;
+
+namespace dma {
+
+    constexpr U32 FrameGovernor::QUALITY_LEVEL_COUNT;
+    constexpr U32 FrameGovernor::HISTORY_SIZE;
+    constexpr F32 FrameGovernor::DEFAULT_TARGET_FRAME_RATE;
+    constexpr U32 FrameGovernor::QUERY_COUNT;
+
+    /* ================= ROUTINES ========================*/
+
+    static const FrameGovernor::Quality QUALITIES[FrameGovernor::QUALITY_LEVEL_COUNT] = {
+            // tileWindowRadius, anisotropy, skyBox, poiAnimationInterval
+            {1, 1.0f, false, 6},
+            {2, 2.0f, false, 3},
+            {3, 4.0f, true, 2},
+            {3, 16.0f, true, 1},
+    };
+
+#ifdef GL_EXT_disjoint_timer_query
+    static PFNGLGENQUERIESEXTPROC genQueries = nullptr;
+    static PFNGLDELETEQUERIESEXTPROC deleteQueries = nullptr;
+    static PFNGLBEGINQUERYEXTPROC beginQuery = nullptr;
+    static PFNGLENDQUERYEXTPROC endQuery = nullptr;
+    static PFNGLGETQUERYOBJECTUIVEXTPROC getQueryObjectuiv = nullptr;
+    static PFNGLGETQUERYOBJECTUI64VEXTPROC getQueryObjectui64v = nullptr;
+
+    //----------------------------------------------------------------------------------------------
+    static bool loadTimerQueryExt() {
+        if (!GLUtils::isExtSupported("GL_EXT_disjoint_timer_query")) {
+            return false;
+        }
+        genQueries = (PFNGLGENQUERIESEXTPROC) GLUtils::getProcAddress("glGenQueriesEXT");
+        deleteQueries = (PFNGLDELETEQUERIESEXTPROC) GLUtils::getProcAddress("glDeleteQueriesEXT");
+        beginQuery = (PFNGLBEGINQUERYEXTPROC) GLUtils::getProcAddress("glBeginQueryEXT");
+        endQuery = (PFNGLENDQUERYEXTPROC) GLUtils::getProcAddress("glEndQueryEXT");
+        getQueryObjectuiv = (PFNGLGETQUERYOBJECTUIVEXTPROC) GLUtils::getProcAddress("glGetQueryObjectuivEXT");
+        getQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VEXTPROC) GLUtils::getProcAddress("glGetQueryObjectui64vEXT");
+        return genQueries && deleteQueries && beginQuery && endQuery && getQueryObjectuiv && getQueryObjectui64v;
+    }
+#endif
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    FrameGovernor::FrameGovernor() :
+            mEnabled(false),
+            mTargetFrameTime(1.0f / DEFAULT_TARGET_FRAME_RATE),
+            mQualityLevel(QUALITY_LEVEL_COUNT - 1),
+            mAverageFrameTime(0.0f),
+            mFramesSinceChange(0),
+            mFrameStart(0.0),
+            mPreviousFrameStart(0.0),
+            mLatencyFrames(0),
+            mGpuTimerSupported(false),
+            mQueryHead(0),
+            mQueryTail(0),
+            mLastGpuTime(-1.0f)
+    {
+        for (U32 i = 0; i < QUERY_COUNT; ++i) {
+            mQueries[i] = 0;
+            mQuerySkipped[i] = false;
+            mQueryStart[i] = 0.0;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    FrameGovernor::~FrameGovernor() {
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::init() {
+        mQueryHead = mQueryTail = 0;
+        mLastGpuTime = -1.0f;
+#ifdef GL_EXT_disjoint_timer_query
+        mGpuTimerSupported = loadTimerQueryExt();
+        if (mGpuTimerSupported) {
+            genQueries(QUERY_COUNT, mQueries);
+        }
+#endif
+        if (!mGpuTimerSupported) {
+            LOG_INFO(TAG, "GPU timer queries not supported, frame time will be measured on CPU only.");
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::wipe() {
+#ifdef GL_EXT_disjoint_timer_query
+        if (mGpuTimerSupported) {
+            deleteQueries(QUERY_COUNT, mQueries);
+        }
+#endif
+        for (U32 i = 0; i < QUERY_COUNT; ++i) {
+            mQueries[i] = 0;
+        }
+        mGpuTimerSupported = false;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::setTargetFrameRate(F32 fps) {
+        assert(fps > 0.0f);
+        mTargetFrameTime = 1.0f / fps;
+        mFramesSinceChange = 0;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    const FrameGovernor::Quality& FrameGovernor::getQuality(U32 level) {
+        assert(level < QUALITY_LEVEL_COUNT);
+        return QUALITIES[level];
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::beginFrame() {
+        mPreviousFrameStart = mFrameStart;
+        mFrameStart = mTimer.now();
+#ifdef GL_EXT_disjoint_timer_query
+        // do not overwrite a query that has not been read back yet.
+        if (mGpuTimerSupported && mQueryHead - mQueryTail < QUERY_COUNT) {
+            beginQuery(GL_TIME_ELAPSED_EXT, mQueries[mQueryHead % QUERY_COUNT]);
+            mQueryStart[mQueryHead % QUERY_COUNT] = mFrameStart;
+        }
+#endif
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::endFrame() {
+#ifdef GL_EXT_disjoint_timer_query
+        if (mGpuTimerSupported && mQueryHead - mQueryTail < QUERY_COUNT) {
+            endQuery(GL_TIME_ELAPSED_EXT);
+            mQuerySkipped[mQueryHead % QUERY_COUNT] = false;
+            ++mQueryHead;
+        }
+#endif
+        double now = mTimer.now();
+        F32 cpuTime = (F32) (now - mFrameStart);
+        mPollGpuTimer();
+
+        Sample sample;
+        sample.cpuTime = cpuTime;
+        sample.gpuTime = mLastGpuTime;
+        sample.latency = (F32) (now - (mLatencyFrames > 0 ? mPreviousFrameStart : mFrameStart));
+        sample.qualityLevel = mQualityLevel;
+        mHistory.push_back(sample);
+        if (mHistory.size() > HISTORY_SIZE) {
+            mHistory.pop_front();
+        }
+
+        mAdapt(glm::max(cpuTime, mLastGpuTime));
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::skipFrame() {
+#ifdef GL_EXT_disjoint_timer_query
+        if (mGpuTimerSupported && mQueryHead - mQueryTail < QUERY_COUNT) {
+            endQuery(GL_TIME_ELAPSED_EXT);
+            mQuerySkipped[mQueryHead % QUERY_COUNT] = true;
+            ++mQueryHead;
+        }
+#endif
+        mPollGpuTimer();
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::mPollGpuTimer() {
+#ifdef GL_EXT_disjoint_timer_query
+        // results come a few frames late: read back every available one, never wait for them.
+        while (mGpuTimerSupported && mQueryTail != mQueryHead) {
+            GLuint query = mQueries[mQueryTail % QUERY_COUNT];
+            GLuint available = 0;
+            getQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+            if (!available) {
+                break;
+            }
+            GLuint64 elapsed = 0;
+            getQueryObjectui64v(query, GL_QUERY_RESULT_EXT, &elapsed);
+            bool skipped = mQuerySkipped[mQueryTail % QUERY_COUNT];
+            double wallTime = mTimer.now() - mQueryStart[mQueryTail % QUERY_COUNT];
+            ++mQueryTail;
+
+            GLint disjoint = 0;
+            glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+            // some drivers (llvmpipe) report garbage for the first query of a context.
+            if (!disjoint && !skipped && elapsed * 1.0e-9 <= wallTime) {
+                mLastGpuTime = (F32) (elapsed * 1.0e-9);
+            }
+        }
+#endif
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void FrameGovernor::mAdapt(F32 frameTime) {
+        if (mAverageFrameTime <= 0.0f) {
+            mAverageFrameTime = frameTime;
+        } else {
+            mAverageFrameTime += SMOOTHING * (frameTime - mAverageFrameTime);
+        }
+        ++mFramesSinceChange;
+
+        if (!mEnabled) {
+            return;
+        }
+
+        if (mAverageFrameTime > mTargetFrameTime * DOWNGRADE_RATIO
+            && mQualityLevel > 0
+            && mFramesSinceChange >= DOWNGRADE_DELAY) {
+            --mQualityLevel;
+            mFramesSinceChange = 0;
+            LOG_INFO(TAG, "frame time %fms over budget, lowering quality to %d",
+                      mAverageFrameTime * 1000.0f, mQualityLevel);
+        } else if (mAverageFrameTime < mTargetFrameTime * UPGRADE_RATIO
+                   && mQualityLevel < QUALITY_LEVEL_COUNT - 1
+                   && mFramesSinceChange >= UPGRADE_DELAY) {
+            ++mQualityLevel;
+            mFramesSinceChange = 0;
+            LOG_INFO(TAG, "frame time %fms under budget, raising quality to %d",
+                      mAverageFrameTime * 1000.0f, mQualityLevel);
+        }
+    }
+}
@@ -54,19 +54,19 @@ namespace dma {
 
     //----------------------------------------------------------------------
     void Scene::unload() {
-        Log::trace(TAG, "Unloading Scene...");
+        LOG_TRACE(TAG, "Unloading Scene...");
         mEntities.clear();
-        Log::trace(TAG, "Scene unloaded");
+        LOG_TRACE(TAG, "Scene unloaded");
     }
 
 
     //----------------------------------------------------------------------
     void Scene::refresh() {
-        Log::trace(TAG, "Refreshing Scene...");
+        LOG_TRACE(TAG, "Refreshing Scene...");
         if (mSkyBox != nullptr) {
             mSkyBox->refresh();
         }
-        Log::trace(TAG, "Scene refreshed");
+        LOG_TRACE(TAG, "Scene refreshed");
     }
 
 
@@ -86,7 +86,7 @@ namespace dma {
         if (mSkyboxEnabled) {
             std::shared_ptr<CubeMap> cubeMap = mResourceManager->acquireCubeMap("skybox/" + sid, &result);
             if (result != STATUS_OK) {
-                Log::warn(TAG, "Cannot use skybox %s, cubemap doesn't exist", sid.c_str());
+                LOG_WARN(TAG, "Cannot use skybox %s, cubemap doesn't exist", sid.c_str());
                 return result;
             }
             if (mSkyBox == nullptr) {
@@ -175,54 +175,89 @@ namespace dma {
         // don't forget to normalise the vector at some point
         ray_wor = glm::normalize(ray_wor);
 
-        //Log::debug(TAG, "%f %f %f", ray_wor.x, ray_wor.y, ray_wor.z);
+        //LOG_DEBUG(TAG, "%f %f %f", ray_wor.x, ray_wor.y, ray_wor.z);
         return ray_wor;
     }
 
 
     //----------------------------------------------------------------------
-    float Scene::distanceFromCamera(std::shared_ptr<Entity> entity) {
+    float Scene::distanceFromCamera(const std::shared_ptr<Entity>& entity) {
         glm::vec3 ce = entity->getPosition() - mCamera->getPosition(); // camera-entity vector
         return glm::length<float>(ce);
     }
 
 
     //----------------------------------------------------------------------
-    void Scene::step(float dt) {
+    float Scene::squaredDistanceFromCamera(const std::shared_ptr<Entity>& entity) {
+        glm::vec3 ce = entity->getPosition() - mCamera->getPosition();
+        return glm::dot(ce, ce);
+    }
+
+
+    //----------------------------------------------------------------------
+    bool Scene::step(float dt) {
         assert(mCamera != nullptr && "Camera not set before calling Scene#step");
-        mCamera->update(dt);
-        for (auto e : mEntities) {
+        bool changed = mChanged;
+        changed |= mAnimationSystem->step(dt);
+        changed |= mCamera->update(dt);
+        for (const auto& e : mEntities) {
             assert(e != nullptr);
-            e->update(dt);
-            if (e->isRenderable()) {
+            changed |= e->update(dt);
+        }
+        mChanged = false;
+        if (!changed) {
+            return false;
+        }
+
+        mRenderingEngine->beginFrameList();
+        // on-screen diameter of a sphere of radius 1 at a distance of 1, in pixels.
+        const float pixelScale = mCamera->getProjection()[1][1] * (float) getViewportHeight();
+        const float impostorSize2 = mImpostorSize * mImpostorSize;
+        for (const auto& e : mEntities) {
+            if (e->isRenderable() && e->isVisible()) {
                 const RenderingComponent *rc = e->getRenderingComponent();
                 assert(rc != nullptr);
 
                 // frustum culling
                 const BoundingSphere& sphere = rc->getMesh()->getBoundingSphere();
-                if (mCamera->containsSphere(glm::vec3(*e->getM() * glm::vec4(sphere.getCenter(), 1.0f)), sphere.getRadius())) {
-                    // Computes the distance to the camera
-                    float distance = distanceFromCamera(e);
-                    mRenderingEngine->subscribe(rc, distance);
+                const glm::vec3 center = glm::vec3(*e->getM() * glm::vec4(sphere.getCenter(), 1.0f));
+                if (mCamera->containsSphere(center, sphere.getRadius())) {
+                    // Computes the distance to the camera, squared: it is only compared.
+                    const float distance2 = squaredDistanceFromCamera(e);
+                    const float diameter = sphere.getRadius() * pixelScale;
+                    if (rc->hasImpostor() && diameter * diameter < impostorSize2 * distance2) {
+                        mRenderingEngine->subscribeImpostor(e, center, sphere.getRadius());
+                    } else {
+                        mRenderingEngine->subscribe(e, distance2);
+                    }
+                    if (rc->getLabel() != nullptr) {
+                        mRenderingEngine->subscribeLabel(rc->getLabel(), center, sphere.getRadius());
+                    }
                 }
             }
         }
+        return true;
     }
 
 
     //----------------------------------------------------------------------
     bool Scene::addEntity(std::shared_ptr<Entity> entity) {
-        return mEntities.insert(entity).second;
+        bool added = mEntities.insert(entity).second;
+        mChanged |= added;
+        return added;
     }
 
 
     //----------------------------------------------------------------------
     bool Scene::removeEntity(std::shared_ptr<Entity> entity) {
         if (mEntities.erase(entity) == 0) {
-            Log::warn(TAG, "Cannot remove entity since it doesn't belong to the scene");
+            LOG_WARN(TAG, "Cannot remove entity since it doesn't belong to the scene");
             assert(!"Cannot remove entity since it doesn't belong to the scene");
             return false;
         }
+        // frame lists only hold raw pointers.
+        mRenderingEngine->retire(entity);
+        mChanged = true;
         return true;
     }
 
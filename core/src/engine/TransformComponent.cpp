@@ -28,7 +28,8 @@ namespace dma {
                     mOrientation(glm::quat()), //identity quaternion
                     mScale(glm::vec3(1.0f)),
                     mM(glm::mat4(1.0f)),
-                    mDirty(true)
+                    mDirty(true),
+                    mRevision(0)
     {}
 
 
@@ -93,14 +94,17 @@ namespace dma {
 
 
     //------------------------------------------------------
-    void TransformComponent::update(const bool reverse) {
-        if (mDirty) {
-            if (reverse) {
-                mM = glm::scale(glm::mat4(1.0f), mScale) * glm::mat4_cast(mOrientation) * glm::translate(glm::mat4(1.0f), mPosition);
-            } else {
-                mM = glm::translate(glm::mat4(1.0f), mPosition) * glm::mat4_cast(mOrientation) * glm::scale(glm::mat4(1.0f), mScale);
-            }
-            mDirty = false;
+    bool TransformComponent::update(const bool reverse) {
+        if (!mDirty) {
+            return false;
         }
+        if (reverse) {
+            mM = glm::scale(glm::mat4(1.0f), mScale) * glm::mat4_cast(mOrientation) * glm::translate(glm::mat4(1.0f), mPosition);
+        } else {
+            mM = glm::translate(glm::mat4(1.0f), mPosition) * glm::mat4_cast(mOrientation) * glm::scale(glm::mat4(1.0f), mScale);
+        }
+        mDirty = false;
+        ++mRevision;
+        return true;
     }
 }
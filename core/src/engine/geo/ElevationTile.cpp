@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+
+#include "engine/geo/ElevationTile.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "ElevationTile";
+
+namespace dma {
+    namespace geo {
+
+        //--------------------------------------------------------------------------
+        ElevationTile::ElevationTile(int x, int y, int z) :
+                x(x), y(y), z(z),
+                mState(REQUESTED),
+                mLastUse(0),
+                mWidth(0),
+                mHeight(0),
+                mMin(0.0f),
+                mMax(0.0f)
+        {}
+
+
+        //--------------------------------------------------------------------------
+        ElevationTile::~ElevationTile() {
+
+        }
+
+
+        //--------------------------------------------------------------------------
+        Status ElevationTile::decode(Image& image) {
+            U32 bytesPerPixel;
+            switch (image.getFormat()) {
+                case GL_RGB:
+                    bytesPerPixel = 3;
+                    break;
+                case GL_RGBA:
+                    bytesPerPixel = 4;
+                    break;
+                default:
+                    Log::error(TAG, "Elevation tiles must be RGB or RGBA images");
+                    return STATUS_KO;
+            }
+            mWidth = image.getWidth();
+            mHeight = image.getHeight();
+            if (mWidth == 0 || mHeight == 0) {
+                return STATUS_KO;
+            }
+            const BYTE* pixels = image.getPixels();
+            mSamples.resize(mWidth * mHeight);
+            for (U32 i = 0; i < mWidth * mHeight; ++i) {
+                const BYTE* pixel = pixels + i * bytesPerPixel;
+                mSamples[i] = -10000.0f + (F32) ((U32) pixel[0] * 65536 + (U32) pixel[1] * 256 + pixel[2]) * 0.1f;
+            }
+            const auto minMax = std::minmax_element(mSamples.begin(), mSamples.end());
+            mMin = *minMax.first;
+            mMax = *minMax.second;
+            return STATUS_OK;
+        }
+
+
+        //--------------------------------------------------------------------------
+        F32 ElevationTile::getElevation(F32 u, F32 v) const {
+            if (mSamples.empty()) {
+                return 0.0f;
+            }
+            // samples are taken at the pixel centers.
+            const F32 px = std::max(0.0f, std::min(u * mWidth - 0.5f, (F32) (mWidth - 1)));
+            const F32 py = std::max(0.0f, std::min(v * mHeight - 0.5f, (F32) (mHeight - 1)));
+            const U32 x0 = (U32) px;
+            const U32 y0 = (U32) py;
+            const U32 x1 = std::min(x0 + 1, mWidth - 1);
+            const U32 y1 = std::min(y0 + 1, mHeight - 1);
+            const F32 fx = px - x0;
+            const F32 fy = py - y0;
+            const F32 top = mSamples[y0 * mWidth + x0] * (1.0f - fx) + mSamples[y0 * mWidth + x1] * fx;
+            const F32 bottom = mSamples[y1 * mWidth + x0] * (1.0f - fx) + mSamples[y1 * mWidth + x1] * fx;
+            return top * (1.0f - fy) + bottom * fy;
+        }
+    }
+}
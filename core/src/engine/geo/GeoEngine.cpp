@@ -33,8 +33,16 @@ namespace dma {
                 mPoiFactory(mEngine.getResourceManager()),
                 mGeoSceneManager(mEngine.getScene(), mEngine.getResourceManager()),
                 mDefaultCallbacks(new GeoEngineCallbacks()),
-                mCallbacks(mDefaultCallbacks)
-        {}
+                mCallbacks(mDefaultCallbacks),
+                mQualityLevel(mEngine.getFrameGovernor().getQualityLevel())
+        {
+            // a map is mostly made of tile maps: let the visible ones come back first after a context loss.
+            mEngine.setRestoreMode(ResourceManager::RestoreMode::PROGRESSIVE);
+            // keep the map smooth on throttled devices rather than pretty.
+            mEngine.getFrameGovernor().setEnabled(true);
+            // POI meshes: compact vertices, less bandwidth.
+            mEngine.getResourceManager().setMeshQuantization(MeshManager::QUANTIZE_ALL);
+        }
 
 
         //------------------------------------------------------------------------------
@@ -51,6 +59,7 @@ namespace dma {
             std::ofstream out(mRootDir + "texture/watermark.png", std::ios::binary);
             out.write((const char *) Watermark::DATA, Watermark::SIZE);
             out.close();
+            mEngine.getResourceManager().notifyFileWritten(mRootDir + "texture/watermark.png");
 
             std::shared_ptr<HUDElement> watermark = std::make_shared<HUDElement>();
             watermark->x = 20;
@@ -67,6 +76,7 @@ namespace dma {
         //------------------------------------------------------------------------------
         void GeoEngine::refresh() {
             mEngine.refresh();
+            mGeoSceneManager.refresh();
         }
 
 
@@ -76,6 +86,7 @@ namespace dma {
             out.write((const char *) Watermark::DATA, Watermark::SIZE);
             out.close();
             mEngine.reload();
+            mEngine.getResourceManager().notifyFileWritten(mRootDir + "texture/watermark.png");
         }
 
 
@@ -88,15 +99,34 @@ namespace dma {
 
         //------------------------------------------------------------------------------
         void GeoEngine::wipe() {
+            mGeoSceneManager.wipe();
             mEngine.wipe();
         }
 
 
         //------------------------------------------------------------------------------
-        void GeoEngine::step() {
+        bool GeoEngine::step() {
+            // the geo scene update is part of the measured frame.
+            mEngine.beginFrame();
             mMessageQueue.flush();
             mGeoSceneManager.step();
-            mEngine.step();
+            bool drawn = mEngine.step();
+            mGeoSceneManager.publishSnapshot(drawn);
+            mApplyQuality();
+            return drawn;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoEngine::mApplyQuality() {
+            const FrameGovernor& governor = mEngine.getFrameGovernor();
+            if (governor.getQualityLevel() == mQualityLevel) {
+                return;
+            }
+            mQualityLevel = governor.getQualityLevel();
+            const FrameGovernor::Quality& quality = governor.getQuality();
+            mGeoSceneManager.setTileWindowRadius(quality.tileWindowRadius);
+            mGeoSceneManager.setPoiAnimationInterval(quality.poiAnimationInterval);
         }
 
 
@@ -105,6 +135,17 @@ namespace dma {
             mMessageQueue << message;
         }
 
+        //------------------------------------------------------------------------------
+        std::string GeoEngine::pick(int screenX, int screenY) {
+            std::string sid;
+            mGeoSceneManager.getPoiSnapshot().pick(screenX, screenY, sid);
+            GeoSceneManager& geoSceneManager = mGeoSceneManager;
+            post([&geoSceneManager, sid]() {
+                geoSceneManager.select(sid);
+            });
+            return sid;
+        }
+
         //------------------------------------------------------------------------------
         void GeoEngine::setCallback(GeoEngineCallbacks* callbacks) {
             if (!callbacks) {
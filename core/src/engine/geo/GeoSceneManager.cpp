@@ -35,55 +35,75 @@ namespace dma {
         //------------------------------------------------------------------------------
         GeoSceneManager::GeoSceneManager(Scene& scene, ResourceManager& resourceManager) :
                 mScene(scene),
-                mTileMap(resourceManager),
+                mTileMap(scene, resourceManager),
                 mLastX(-1),
-                mLastY(-1)
+                mLastY(-1),
+                mPoiShaderAnimation(false),
+                mPoiClusterer(scene, resourceManager),
+                mSnapshotPending(false),
+                mGroundRevision(0)
         {
             // Add a default camera to the scene
             mScene.setCamera(std::make_shared<Camera>());
+            mScene.getAnimationSystem().subscribe(mPoiAnimations);
         }
 
 
         //------------------------------------------------------------------------------
         GeoSceneManager::~GeoSceneManager() {
+            // POIs may outlive the manager in the scene: their tracks must not point to the pool anymore.
+            for (auto& kv : mPOIs) {
+                kv.second->deanimate();
+            }
+            mScene.getAnimationSystem().unsubscribe(mPoiAnimations);
         }
 
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::init() {
             mTileMap.init();
-            for (std::shared_ptr<Tile> tile : mTileMap.getTiles()) {
+            for (const std::shared_ptr<Tile>& tile : mTileMap.getTiles()) {
                 mScene.addEntity(tile);
             }
         }
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::unload() {
-            Log::trace(TAG, "Unloading GeoSceneManager...");
-            for (std::shared_ptr<Tile> tile : mTileMap.getTiles()) {
+            LOG_TRACE(TAG, "Unloading GeoSceneManager...");
+            for (const std::shared_ptr<Tile>& tile : mTileMap.getTiles()) {
                 mScene.removeEntity(tile);
             }
             mTileMap.unload();
             removeAllPois();
+            mPoiClusterer.unload();
             mOrigin.lat = 0.0;
             mOrigin.lng = 0.0;
-            Log::trace(TAG, "GeoSceneManager unloaded");
+            LOG_TRACE(TAG, "GeoSceneManager unloaded");
         }
 
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::step() { //TODO optimization ?
+            mTileMap.flush();
+            mUpdateGround();
+
             for (auto& kv : mPOIs) {
-                auto poi = kv.second;
+                const std::shared_ptr<Poi>& poi = kv.second;
                 if (poi->isDirty()) {
-                    const glm::vec3 pos = computePosition(poi->getLat(), poi->getLng(), poi->getAlt());
-                    std::static_pointer_cast<Entity>(poi)->setPosition(pos);
-                    poi->animate();
+                    mPoiClusterer.invalidate();
+                    const F32 ground = mTileMap.getGroundHeight(poi->getLat(), poi->getLng());
+                    const glm::vec3 pos = computePosition(poi->getLat(), poi->getLng(), poi->getAlt() + ground);
+                    static_cast<Entity&>(*poi).setPosition(pos);
+                    if (mPoiShaderAnimation) {
+                        poi->animateInShader();
+                    } else {
+                        poi->animate(mPoiAnimations);
+                    }
                     poi->setDirty(false);
                 }
             }
 
-            for (auto tile : mTileMap.getTiles()) {
+            for (const std::shared_ptr<Tile>& tile : mTileMap.getTiles()) {
                 if (tile->isDirty()) {
                     double lat = tile->getLat();
                     double lon = tile->getLng();
@@ -94,6 +114,19 @@ namespace dma {
                     tile->setDirty(false);
                 }
             }
+
+            for (auto& kv : mTileMap.mVectorTiles) {
+                VectorTile& tile = *kv.second;
+                if (tile.mDirty) {
+                    const glm::vec3 dest = computePosition(tile.mCoords.lat, tile.mCoords.lng, 0.0);
+                    for (const std::shared_ptr<Entity>& entity : tile.mEntities) {
+                        entity->setPosition(dest);
+                    }
+                    tile.mDirty = false;
+                }
+            }
+
+            mPoiClusterer.update(mPOIs);
         }
 
 
@@ -109,7 +142,7 @@ namespace dma {
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::setOrigin(double lat, double lon) {
-            Log::trace(TAG, "Setting new Origin: old=(%f, %f) new=(%f, %f)",
+            LOG_TRACE(TAG, "Setting new Origin: old=(%f, %f) new=(%f, %f)",
                        mOrigin.lat, mOrigin.lng, lat, lon);
             mOrigin = LatLng(lat, lon);
 
@@ -117,9 +150,49 @@ namespace dma {
                 kv.second->setDirty(true);
             }
 
-            for (auto tile : mTileMap.getTiles()) {
+            for (const std::shared_ptr<Tile>& tile : mTileMap.getTiles()) {
                 tile->setDirty(true);
             }
+
+            for (auto& kv : mTileMap.mVectorTiles) {
+                kv.second->mDirty = true;
+            }
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setTerrainEnabled(bool enabled) {
+            mTileMap.setTerrainEnabled(enabled);
+            mUpdateGround();
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::mUpdateGround() {
+            if (mGroundRevision == mTileMap.getGroundRevision()) {
+                return;
+            }
+            mGroundRevision = mTileMap.getGroundRevision();
+            for (auto& kv : mPOIs) {
+                kv.second->setDirty(true);
+            }
+            if (mLastX >= 0) {
+                const F32 ground = mTileMap.getGroundHeight(mCameraCoords.lat, mCameraCoords.lng);
+                mScene.getCamera().setPosition(computePosition(mCameraCoords.lat, mCameraCoords.lng,
+                                                               mCameraCoords.alt + ground));
+            }
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::refresh() {
+            mTileMap.refresh();
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::wipe() {
+            mTileMap.wipe();
         }
 
         //------------------------------------------------------------------------------
@@ -137,18 +210,19 @@ namespace dma {
         //------------------------------------------------------------------------------
         bool GeoSceneManager::addPoi(std::shared_ptr<Poi> poi) {
             if (hasPoi(poi->getSid())) {
-                Log::warn(TAG, "GeoScene already contains Poi with SID = %s", poi->getSid().c_str());
+                LOG_WARN(TAG, "GeoScene already contains Poi with SID = %s", poi->getSid().c_str());
                 return false;
             }
             int x = GeoUtils::lng2tilex(poi->getLng(), ZOOM_LEVEL);
             int y = GeoUtils::lat2tiley(poi->getLat(), ZOOM_LEVEL);
             if (!TileMap::isInRange(x, y, mLastX, mLastY)) {
-                Log::warn(TAG, "Trying to add poi %s that is out of the tile map range", poi->getSid().c_str());
+                LOG_WARN(TAG, "Trying to add poi %s that is out of the tile map range", poi->getSid().c_str());
                 return false;
             }
-            Log::debug(TAG, "Adding Poi %s", poi->getSid().c_str());
+            LOG_DEBUG(TAG, "Adding Poi %s", poi->getSid().c_str());
             mPOIs[poi->getSid()] = poi;
             mScene.addEntity(poi);
+            mPoiClusterer.invalidate();
             return true;
         }
 
@@ -156,11 +230,14 @@ namespace dma {
         //------------------------------------------------------------------------------
         bool GeoSceneManager::removePoi(const std::string& sid) {
             if (mPOIs.find(sid) == mPOIs.end()) {
-                Log::warn(TAG, "Trying to remove poi with SID = %s from the GeoScene that does not exist", sid.c_str());
+                LOG_WARN(TAG, "Trying to remove poi with SID = %s from the GeoScene that does not exist", sid.c_str());
                 return false;
             }
             mScene.removeEntity(mPOIs[sid]);
+            mPOIs[sid]->deanimate();
+            mPoiClusterer.release(*mPOIs[sid]);
             mPOIs.erase(sid);
+            mPoiClusterer.invalidate();
             return true;
         }
 
@@ -169,8 +246,11 @@ namespace dma {
         void GeoSceneManager::removeAllPois() {
             for (auto& kv : mPOIs) {
                 mScene.removeEntity(kv.second);
+                kv.second->deanimate();
+                mPoiClusterer.release(*kv.second);
             }
             mPOIs.clear();
+            mPoiClusterer.invalidate();
         }
 
 
@@ -198,7 +278,7 @@ namespace dma {
         //------------------------------------------------------------------------------
         std::shared_ptr<Poi> GeoSceneManager::getPoi(const std::string &sid) {
             if (mPOIs.find(sid) == mPOIs.end()) {
-                Log::warn(TAG, "No poi found with the sid %s", sid.c_str());
+                LOG_WARN(TAG, "No poi found with the sid %s", sid.c_str());
                 return nullptr;
             }
             return mPOIs[sid];
@@ -207,7 +287,9 @@ namespace dma {
 
         //------------------------------------------------------------------------------
         void GeoSceneManager::placeCamera(const LatLng& coords) {
-            placeCamera(LatLngAlt(coords.lat, coords.lng, mScene.getCamera().getPosition().y));
+            // the current altitude, above the ground.
+            const F32 ground = mTileMap.getGroundHeight(mCameraCoords.lat, mCameraCoords.lng);
+            placeCamera(LatLngAlt(coords.lat, coords.lng, mScene.getCamera().getPosition().y - ground));
         }
 
 
@@ -230,7 +312,8 @@ namespace dma {
                 if (GeoUtils::slc(LatLng(coords.lat, coords.lng), mOrigin) > ORIGIN_SHIFTING_TRESHOLD) {
                     setOrigin(coords.lat, coords.lng);
                     // Update the current camera position with no translation
-                    camera.setPosition(computePosition(mCameraCoords.lat, mCameraCoords.lng, mCameraCoords.alt));
+                    camera.setPosition(computePosition(mCameraCoords.lat, mCameraCoords.lng, mCameraCoords.alt
+                                                       + mTileMap.getGroundHeight(mCameraCoords.lat, mCameraCoords.lng)));
                 }
                 mTileMap.update(x0, y0);
 
@@ -240,6 +323,7 @@ namespace dma {
                     int y = GeoUtils::lat2tiley(poi->getLat(), ZOOM_LEVEL);
                     if (!TileMap::isInRange(x, y, x0, y0)) {
                         mScene.removeEntity(poi);
+                        mPoiClusterer.release(*poi);
                         mPOIs.erase(poi->getSid());
                     } else {
                         poi->setDirty(true);
@@ -247,7 +331,8 @@ namespace dma {
                 }
             }
 
-            glm::vec3 pos = computePosition(coords.lat, coords.lng, coords.alt);
+            glm::vec3 pos = computePosition(coords.lat, coords.lng,
+                                            coords.alt + mTileMap.getGroundHeight(coords.lat, coords.lng));
             if (!TileMap::isInRange(mLastX, mLastY, x0, y0)) {
                 translationDuration = -1.0f;
             }
@@ -272,51 +357,91 @@ namespace dma {
 
         //------------------------------------------------------------------------------
         std::shared_ptr<Poi> GeoSceneManager::pick(int screenX, int screenY) {
-            std::list<std::shared_ptr<Poi>> intersected;
             glm::vec3 ray = mScene.castRay(screenX, screenY);
+            const glm::vec3& origin = mScene.getCamera().getPosition();
 
+            std::shared_ptr<Poi> closest;
+            float distance = 0.0f;
             for (auto& kv : mPOIs) {
-                std::shared_ptr<Poi> poi = kv.second;
-                if (poi->intersects(ray, mScene.getCamera().getPosition())) {
-                    intersected.push_back(poi);
+                const std::shared_ptr<Poi>& poi = kv.second;
+                if (poi->isVisible() && poi->intersects(ray, origin)) {
+                    float d = mScene.distanceFromCamera(poi);
+                    if (closest == nullptr || d < distance) {
+                        closest = poi;
+                        distance = d;
+                    }
                 }
             }
 
-            if (intersected.empty()) {
+            select(closest != nullptr ? closest->getSid() : std::string());
+            return closest;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::select(const std::string& sid) {
+            auto it = sid.empty() ? mPOIs.end() : mPOIs.find(sid);
+            if (it == mPOIs.end()) {
                 if (mSelected != nullptr) {
-                    mSelected->getMaterial()->getPass(0).setDiffuseColor(glm::vec3(0.0f, 0.0f, 0.0f));
+                    mSelected->getMaterial()->setDiffuseColor(glm::vec3(0.0f, 0.0f, 0.0f), 0);
+                    mSelected->invalidate();
                     mTileMap.mCallbacks->onPoiDeselected(mSelected->getSid()); //TODO shared pointer etc... see TODO below
                     mSelected = nullptr;
                 }
-                return nullptr;
+                return;
             }
 
-            std::shared_ptr<Poi> closest = intersected.back();
-            intersected.pop_back();
-            float distance = mScene.distanceFromCamera(closest);
-
-            while (!intersected.empty()) {
-                float d =  mScene.distanceFromCamera(intersected.back());
-                if (d < distance) {
-                    closest = intersected.back();
-                    distance = d;
-                }
-                intersected.pop_back();
-            }
-
-            //Log::debug(TAG, "closest: %s", closest->getSid().c_str());
-
-            closest->getMaterial()->getPass(0).setDiffuseColor(glm::vec3(0.8f, 0.1f, 0.3f));
+            const std::shared_ptr<Poi>& closest = it->second;
+            closest->getMaterial()->setDiffuseColor(glm::vec3(0.8f, 0.1f, 0.3f), 0);
+            closest->invalidate();
             if (mSelected != nullptr && mSelected->getSid() != closest->getSid()) {
-                mSelected->getMaterial()->getPass(0).setDiffuseColor(glm::vec3(0.0f, 0.0f, 0.0f));
+                mSelected->getMaterial()->setDiffuseColor(glm::vec3(0.0f, 0.0f, 0.0f), 0);
+                mSelected->invalidate();
                 mTileMap.mCallbacks->onPoiDeselected(mSelected->getSid()); //TODO see TODO below
             }
             mSelected = closest;
 
             // Notify listener TODO keep reference and use shared pointer
             mTileMap.mCallbacks->onPoiSelected(mSelected->getSid());
+        }
 
-            return closest;
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::publishSnapshot(bool changed) {
+            if (!changed && !mSnapshotPending) {
+                return;
+            }
+            PoiSnapshot::Frame* frame = mPoiSnapshot.beginPublish();
+            if (frame == nullptr) {
+                mSnapshotPending = true;
+                return;
+            }
+
+            Camera& camera = mScene.getCamera();
+            frame->inverseV = glm::inverse(camera.getView());
+            frame->inverseP = glm::inverse(camera.getProjection());
+            frame->cameraPosition = camera.getPosition();
+            frame->viewportWidth = (F32) mScene.getViewportWidth();
+            frame->viewportHeight = (F32) mScene.getViewportHeight();
+
+            // vectors keep their capacity from a publication to another. Clustered POIs are not published.
+            frame->sids.resize(mPOIs.size());
+            frame->spheres.resize(mPOIs.size());
+            U32 i = 0;
+            for (auto& kv : mPOIs) {
+                if (!kv.second->isVisible()) {
+                    continue;
+                }
+                const BoundingSphere& sphere = kv.second->getMesh()->getBoundingSphere();
+                glm::vec4 center = *kv.second->getM() * glm::vec4(sphere.getCenter(), 1.0f);
+                frame->sids[i] = kv.first;
+                frame->spheres[i] = glm::vec4(glm::vec3(center), sphere.getRadius());
+                ++i;
+            }
+            frame->sids.resize(i);
+            frame->spheres.resize(i);
+            mPoiSnapshot.endPublish();
+            mSnapshotPending = false;
         }
 
 
@@ -324,7 +449,30 @@ namespace dma {
         void GeoSceneManager::updateTileDiffuseMaps() {
             mTileMap.updateDiffuseMaps();
         }
-    }
-}
 
 
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setPoiAnimationInterval(U32 interval) {
+            mPoiAnimations.setInterval(interval);
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setPoiShaderAnimationEnabled(bool enabled) {
+            if (enabled == mPoiShaderAnimation) {
+                return;
+            }
+            mPoiShaderAnimation = enabled;
+            // animated again on the next step.
+            for (auto& kv : mPOIs) {
+                kv.second->setDirty(true);
+            }
+        }
+
+
+        //------------------------------------------------------------------------------
+        void GeoSceneManager::setPoiClusteringEnabled(bool enabled) {
+            mPoiClusterer.setEnabled(enabled, mPOIs);
+        }
+    }
+}
@@ -21,6 +21,11 @@
 
 #define POI_PASS 1
 
+/** height of the POI bobbing, in world units */
+constexpr float BOB_HEIGHT = 2.0f;
+/** shader animation phases are spread over this duration, in seconds */
+constexpr unsigned PHASE_SPREAD_MS = 12000;
+
 namespace dma {
     namespace geo {
 
@@ -29,14 +34,14 @@ namespace dma {
         //---------------------------------------------------------------
         Poi::Poi(const std::string& sid,
                  std::shared_ptr<Mesh> mesh,
-                 std::shared_ptr<Material> material) :
+                 std::shared_ptr<MaterialInstance> material) :
                 Entity(mesh, material),
                 mSID(sid),
-                mCurrentTranslationAnimation(nullptr),
-                mCurrentRotationAnimation(nullptr)
-
+                mAnimationPool(nullptr),
+                mRestPosition(0.0f)
         {
-            addAnimationComponent();
+            // seen from afar, the POI is a disc of its color.
+            mRenderingComponent->setImpostorPass(POI_PASS);
         }
 
 //        Poi::Poi(const std::string& sid) :
@@ -50,8 +55,20 @@ namespace dma {
 
         //---------------------------------------------------------------
         Poi::~Poi() {
-            delete mCurrentTranslationAnimation;
-            delete mCurrentRotationAnimation;
+            deanimate();
+        }
+
+
+        //---------------------------------------------------------------
+        void Poi::setLabel(const std::string& text) {
+            if (text.empty()) {
+                Entity::setLabel(nullptr);
+            } else if (getLabel() == nullptr) {
+                Entity::setLabel(std::make_shared<Label>(text));
+            } else {
+                getLabel()->text = text;
+                invalidate();
+            }
         }
 
 
@@ -73,32 +90,47 @@ namespace dma {
 
 
         //---------------------------------------------------------------
-        void Poi::animate() {
-            assert(Entity::isAnimable());
+        void Poi::animate(AnimationPool& animationPool) {
+            if (mAnimationPool != &animationPool) {
+                deanimate();
+                mAnimationPool = &animationPool;
+            }
+            if (mRenderingComponent->hasIdleAnimation()) {
+                mRenderingComponent->clearIdleAnimation();
+                invalidate();
+            }
 
+            mRestPosition = mTransformComponent->getPosition();
+            if (!isVisible()) {
+                // clustered: animated again when shown.
+                animationPool.remove(mTranslationTrack);
+                animationPool.remove(mRotationTrack);
+                return;
+            }
 
-            if (mCurrentTranslationAnimation != nullptr) {
-                mAnimationComponent->remove(mCurrentTranslationAnimation);
-                delete mCurrentTranslationAnimation;
+            const glm::vec3& from = mRestPosition;
+            const glm::vec3 to = from + glm::vec3(0.0f, BOB_HEIGHT, 0.0f);
+            if (!animationPool.refreshTranslation(mTranslationTrack, from, to, 3.0f)) {
+                mTranslationTrack = animationPool.addTranslation(*mTransformComponent, from, to, 3.0f,
+                                                                 TranslationAnimation::Function::EASE, true, true);
             }
 
-            if (mCurrentRotationAnimation != nullptr) {
-                mAnimationComponent->remove(mCurrentRotationAnimation);
-                delete mCurrentRotationAnimation;
+            // the rotation does not depend on the position: it keeps running.
+            if (!animationPool.isRunning(mRotationTrack)) {
+                mRotationTrack = animationPool.addRotation(*mTransformComponent,
+                                                           4.0f, true, 360.0f,
+                                                           glm::normalize(glm::vec3(0.0f, 1.0f, 0.0f)));
             }
+        }
 
-            mCurrentTranslationAnimation =
-                    new TranslationAnimation(*mTransformComponent,
-                                             mTransformComponent->getPosition(),
-                                             mTransformComponent->getPosition() + glm::vec3(0.0f, 2.0f, 0.0f),
-                                             3.0f, TranslationAnimation::Function::EASE, true, true);
-            mAnimationComponent->add(mCurrentTranslationAnimation);
-
-            mCurrentRotationAnimation =
-                    new RotationAnimation(*mTransformComponent,
-                                          4.0f, true, 360.0f,
-                                          glm::normalize(glm::vec3(0.0f, 1.0f, 0.0f)));
-            mAnimationComponent->add(mCurrentRotationAnimation);
+
+        //---------------------------------------------------------------
+        void Poi::animateInShader() {
+            deanimate();
+            // POIs do not bob in sync.
+            float phase = (float) (std::hash<std::string>()(mSID) % PHASE_SPREAD_MS) / 1000.0f;
+            mRenderingComponent->setIdleAnimation(phase, BOB_HEIGHT);
+            invalidate();
         }
 
 
@@ -117,18 +149,38 @@ namespace dma {
 
         //---------------------------------------------------------------
         void Poi::deanimate() {
-            mAnimationComponent->remove(mCurrentTranslationAnimation);
-            delete mCurrentTranslationAnimation;
-            mCurrentTranslationAnimation = nullptr;
-            mAnimationComponent->remove(mCurrentRotationAnimation);
-            delete mCurrentRotationAnimation;
-            mCurrentRotationAnimation = nullptr;
+            if (mAnimationPool != nullptr) {
+                mAnimationPool->remove(mTranslationTrack);
+                mAnimationPool->remove(mRotationTrack);
+                mAnimationPool = nullptr;
+            }
+            mRenderingComponent->clearIdleAnimation();
+        }
+
+
+        //---------------------------------------------------------------
+        void Poi::setClustered(bool clustered) {
+            if (clustered != isVisible()) {
+                return;
+            }
+            setVisible(!clustered);
+            if (mAnimationPool == nullptr) {
+                return;
+            }
+            if (clustered) {
+                mAnimationPool->remove(mTranslationTrack);
+                mAnimationPool->remove(mRotationTrack);
+                Entity::setPosition(mRestPosition);
+            } else {
+                animate(*mAnimationPool);
+            }
         }
 
 
         //---------------------------------------------------------------
         void Poi::setColor(const Color &color) {
-            getMaterial()->getPass(POI_PASS).setDiffuseColor(glm::vec3(color.r, color.g, color.b));
+            getMaterial()->setDiffuseColor(glm::vec3(color.r, color.g, color.b), POI_PASS);
+            invalidate();
         }
 
 
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cmath>
+
+#include "engine/geo/PoiClusterer.hpp"
+
+/** the clusters are computed again when the camera moved further than this, in meters. */
+constexpr float REFRESH_DISTANCE = 1.0f;
+/** cells are at least 2^MIN_LEVEL meters wide, and at most 2^MAX_LEVEL. */
+constexpr int MIN_LEVEL = 0;
+constexpr int MAX_LEVEL = 16;
+/** cell coordinates are packed on CELL_BITS bits, offset by CELL_OFFSET. */
+constexpr int CELL_BITS = 28;
+constexpr dma::I64 CELL_OFFSET = 1 << (CELL_BITS - 1);
+/** marker scale growth when the POI count doubles. */
+constexpr float MARKER_GROWTH = 0.25f;
+
+namespace dma {
+    namespace geo {
+        constexpr char TAG[] = "PoiClusterer";
+
+        constexpr F32 PoiClusterer::DEFAULT_CELL_SIZE;
+        constexpr U32 PoiClusterer::DEFAULT_MIN_CLUSTER_SIZE;
+        constexpr const char* PoiClusterer::MARKER_SID;
+
+        /* ================= ROUTINES ========================*/
+
+        //------------------------------------------------------------------------------
+        static inline U64 cellKey(int level, I64 x, I64 z) {
+            const U64 mask = (1ULL << CELL_BITS) - 1;
+            return ((U64) level << (2 * CELL_BITS))
+                   | ((U64) (x + CELL_OFFSET) & mask) << CELL_BITS
+                   | ((U64) (z + CELL_OFFSET) & mask);
+        }
+
+        //------------------------------------------------------------------------------
+        static inline U64 cellKey(const glm::vec3& position, const glm::vec3& eye, F32 cellAngle) {
+            F32 extent = glm::distance(eye, position) * cellAngle;
+            int level = extent > 0.0f ? (int) std::ceil(std::log2(extent)) : MIN_LEVEL;
+            level = glm::clamp(level, MIN_LEVEL, MAX_LEVEL);
+            F32 size = std::ldexp(1.0f, level);
+            return cellKey(level, (I64) std::floor(position.x / size), (I64) std::floor(position.z / size));
+        }
+
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------------
+        PoiClusterer::PoiClusterer(Scene& scene, ResourceManager& resourceManager) :
+                mScene(scene),
+                mMarkerFactory(resourceManager),
+                mMarkerShape("sphere"),
+                mMarkerColor(0.9f, 0.5f, 0.1f),
+                mEnabled(false),
+                mInvalidated(true),
+                mCellSize(DEFAULT_CELL_SIZE),
+                mMinClusterSize(DEFAULT_MIN_CLUSTER_SIZE),
+                mLastFocal(0.0f),
+                mLastHeight(0),
+                mMarkerCount(0),
+                mClusteredCount(0)
+        {}
+
+
+        //------------------------------------------------------------------------------
+        PoiClusterer::~PoiClusterer() {
+        }
+
+
+        //------------------------------------------------------------------------------
+        bool PoiClusterer::update(const std::map<std::string, std::shared_ptr<Poi>>& pois) {
+            if (!mEnabled) {
+                return false;
+            }
+            Camera& camera = mScene.getCamera();
+            const glm::vec3 eye = camera.getPosition();
+            const F32 focal = camera.getProjection()[1][1];
+            const U32 height = mScene.getViewportHeight();
+            const bool rebuild = mInvalidated || focal != mLastFocal || height != mLastHeight
+                                 || mPoiCells.size() != pois.size();
+            if (!rebuild && glm::distance(eye, mLastEye) < REFRESH_DISTANCE) {
+                return false;
+            }
+            mInvalidated = false;
+            mLastEye = eye;
+            mLastFocal = focal;
+            mLastHeight = height;
+
+            // size of a cell seen at a distance of 1, in meters.
+            const F32 cellAngle = height > 0 ? 2.0f * mCellSize / (focal * (F32) height) : 0.0f;
+
+            // 1. bucket POIs
+            U32 i = 0;
+            if (rebuild) {
+                mCellIndex.clear();
+                mCells.clear();
+                mFreeCells.clear();
+                mPoiCells.resize(pois.size());
+                mPoiKeys.resize(pois.size());
+                mPoiPositions.resize(pois.size());
+                for (const auto& kv : pois) {
+                    mPoiPositions[i] = kv.second->Entity::getPosition();
+                    mAddToCell(i, cellKey(mPoiPositions[i], eye, cellAngle));
+                    ++i;
+                }
+            } else {
+                // POIs did not move since they were bucketed: only the cells of some of them changed with the camera.
+                bool moved = false;
+                for (i = 0; i < mPoiKeys.size(); ++i) {
+                    const U64 key = cellKey(mPoiPositions[i], eye, cellAngle);
+                    if (key != mPoiKeys[i]) {
+                        mRemoveFromCell(i);
+                        mAddToCell(i, key);
+                        moved = true;
+                    }
+                }
+                if (!moved) {
+                    return false;
+                }
+            }
+
+            // 2. place markers
+            U32 markerCount = 0;
+            mClusteredCount = 0;
+            for (Cell& cell : mCells) {
+                // empty cells are never clustered.
+                if (cell.count < mMinClusterSize) {
+                    continue;
+                }
+                cell.marker = markerCount++;
+                mClusteredCount += cell.count;
+                std::shared_ptr<Poi> marker = cell.marker < mMarkers.size() ? mMarkers[cell.marker]
+                                                                            : mBuildMarker(cell.marker);
+                static_cast<Entity&>(*marker).setPosition(cell.sum / (F32) cell.count);
+                marker->setScale(glm::vec3(1.0f + MARKER_GROWTH * std::log2((F32) cell.count)));
+                // markers are reused by index: only relabel the ones whose count changed.
+                const std::string label = std::to_string(cell.count);
+                if (marker->getLabel() == nullptr || marker->getLabel()->text != label) {
+                    marker->setLabel(label);
+                }
+                if (cell.marker >= mMarkerCount) {
+                    mScene.addEntity(marker);
+                }
+            }
+            mRemoveMarkers(markerCount);
+            mMarkerCount = markerCount;
+
+            // 3. hide clustered POIs
+            i = 0;
+            for (const auto& kv : pois) {
+                kv.second->setClustered(mCells[mPoiCells[i++]].count >= mMinClusterSize);
+            }
+            return true;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::unload() {
+            mRemoveMarkers(0);
+            mMarkers.clear();
+            mMarkerCount = 0;
+            mClusteredCount = 0;
+            mInvalidated = true;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::setEnabled(bool enabled, const std::map<std::string, std::shared_ptr<Poi>>& pois) {
+            if (enabled == mEnabled) {
+                return;
+            }
+            mEnabled = enabled;
+            mInvalidated = true;
+            if (!enabled) {
+                mRemoveMarkers(0);
+                mMarkerCount = 0;
+                mClusteredCount = 0;
+                for (const auto& kv : pois) {
+                    release(*kv.second);
+                }
+            }
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::setCellSize(F32 pixels) {
+            assert(pixels > 0.0f);
+            mCellSize = pixels;
+            mInvalidated = true;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::setMinClusterSize(U32 count) {
+            mMinClusterSize = glm::max(count, 2u);
+            mInvalidated = true;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::setMarker(const std::string& shape, const std::string& icon, const Color& color) {
+            mMarkerShape = shape;
+            mMarkerIcon = icon;
+            mMarkerColor = color;
+        }
+
+
+        /* ================= PRIVATE ========================*/
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::mAddToCell(U32 i, U64 key) {
+            auto inserted = mCellIndex.insert(std::make_pair(key, 0u));
+            if (inserted.second) {
+                if (mFreeCells.empty()) {
+                    inserted.first->second = (U32) mCells.size();
+                    mCells.push_back(Cell{glm::vec3(0.0f), 0, 0, key});
+                } else {
+                    inserted.first->second = mFreeCells.back();
+                    mFreeCells.pop_back();
+                    mCells[inserted.first->second] = Cell{glm::vec3(0.0f), 0, 0, key};
+                }
+            }
+            Cell& cell = mCells[inserted.first->second];
+            cell.sum += mPoiPositions[i];
+            ++cell.count;
+            mPoiCells[i] = inserted.first->second;
+            mPoiKeys[i] = key;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::mRemoveFromCell(U32 i) {
+            Cell& cell = mCells[mPoiCells[i]];
+            assert(cell.count > 0);
+            if (--cell.count == 0) {
+                // the sum is reset with the cell, so that rounding errors do not pile up.
+                mCellIndex.erase(cell.key);
+                mFreeCells.push_back(mPoiCells[i]);
+                cell.sum = glm::vec3(0.0f);
+            } else {
+                cell.sum -= mPoiPositions[i];
+            }
+        }
+
+
+        //------------------------------------------------------------------------------
+        std::shared_ptr<Poi> PoiClusterer::mBuildMarker(U32 index) {
+            assert(index == mMarkers.size());
+            std::shared_ptr<Poi> marker = mMarkerFactory.builder()
+                    .sid(MARKER_SID + std::to_string(index))
+                    .shape(mMarkerShape)
+                    .icon(mMarkerIcon)
+                    .color(mMarkerColor)
+                    .build();
+            mMarkers.push_back(marker);
+            LOG_DEBUG(TAG, "%d cluster markers", (int) mMarkers.size());
+            return marker;
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiClusterer::mRemoveMarkers(U32 from) {
+            for (U32 i = from; i < mMarkerCount; ++i) {
+                mScene.removeEntity(mMarkers[i]);
+            }
+        }
+    }
+}
@@ -89,29 +89,37 @@ namespace dma {
         }
 
 
+        //------------------------------------------------------------------------------
+        PoiFactory::Builder &PoiFactory::Builder::label(const std::string &label) {
+            mLabel = label;
+            return *this;
+        }
+
+
         //------------------------------------------------------------------------------
         std::shared_ptr<Poi> PoiFactory::Builder::build() {
             Status result;
 
             std::shared_ptr<Mesh> mesh = mResourceManager.acquireMesh(mShape, &result);
-            std::shared_ptr<Material> material = mResourceManager.createMaterial("poi", &result);
+            std::shared_ptr<MaterialInstance> material = mResourceManager.createMaterial("poi", &result);
 
             //////////////////////////////////////////////////////
             // Setup the "poi" pass
-            Pass& poiPass = material->getPass(POI_PASS);
             if (mIcon.empty()) {
-                poiPass.setDiffuseMapEnabled(false);
+                material->setDiffuseMapEnabled(false, POI_PASS);
             } else {
-                poiPass.setDiffuseMap(mResourceManager.acquireMap(ICON_DIR + mIcon));
+                material->setDiffuseMap(mResourceManager.acquireMap(ICON_DIR + mIcon), POI_PASS);
             }
-            poiPass.setDiffuseColor(glm::vec3(mColor.r, mColor.g, mColor.b));
+            material->setDiffuseColor(glm::vec3(mColor.r, mColor.g, mColor.b), POI_PASS);
             if (mesh->hasFlatNormals()) {
-                poiPass.setLightingMode(Pass::Func::LIGHTING_FLAT);
+                material->setLightingMode(Pass::Func::LIGHTING_FLAT, POI_PASS);
             } else {
-                poiPass.setLightingMode(Pass::Func::LIGHTING_SMOOTH);
+                material->setLightingMode(Pass::Func::LIGHTING_SMOOTH, POI_PASS);
             }
 
-            return std::make_shared<Poi>(mSid, mesh, material);
+            std::shared_ptr<Poi> poi = std::make_shared<Poi>(mSid, mesh, material);
+            poi->setLabel(mLabel);
+            return poi;
         }
 
     } /* namespace geo */
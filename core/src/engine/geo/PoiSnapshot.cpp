@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cassert>
+
+#include "engine/geo/PoiSnapshot.hpp"
+
+namespace dma {
+    namespace geo {
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------------
+        PoiSnapshot::PoiSnapshot() :
+                mFront(-1)
+        {
+            mReaders[0] = 0;
+            mReaders[1] = 0;
+        }
+
+
+        //------------------------------------------------------------------------------
+        PoiSnapshot::Frame* PoiSnapshot::beginPublish() {
+            int back = mFront.load() == 0 ? 1 : 0;
+            // a reader which counted itself after this check will see that the frame is not published, and retry.
+            if (mReaders[back].load() != 0) {
+                return nullptr;
+            }
+            return &mFrames[back];
+        }
+
+
+        //------------------------------------------------------------------------------
+        void PoiSnapshot::endPublish() {
+            int back = mFront.load() == 0 ? 1 : 0;
+            assert(mFrames[back].sids.size() == mFrames[back].spheres.size());
+            mFront.store(back);
+        }
+
+
+        //------------------------------------------------------------------------------
+        bool PoiSnapshot::pick(int screenX, int screenY, std::string& sid) const {
+            int front;
+            do {
+                front = mFront.load();
+                if (front < 0) {
+                    return false;
+                }
+                ++mReaders[front];
+                if (mFront.load() == front) {
+                    break;
+                }
+                // published again meanwhile: the counted frame may be being filled.
+                --mReaders[front];
+            } while (true);
+
+            const Frame& frame = mFrames[front];
+
+            // the ray, as Scene::castRay
+            float x = (2.0f * screenX) / frame.viewportWidth - 1.0f;
+            float y = 1.0f - (2.0f * screenY) / frame.viewportHeight;
+            glm::vec4 eye = frame.inverseP * glm::vec4(x, y, -1.0f, 1.0f);
+            eye = glm::vec4(eye.x, eye.y, -1.0f, 0.0f);
+            const glm::vec3 ray = glm::normalize(glm::vec3(frame.inverseV * eye));
+            const glm::vec3& origin = frame.cameraPosition;
+
+            // the closest intersected bounding sphere, as Poi::intersects
+            int closest = -1;
+            float closestDistance = 0.0f;
+            const U32 count = (U32) frame.spheres.size();
+            for (U32 i = 0; i < count; ++i) {
+                const glm::vec4& sphere = frame.spheres[i];
+                glm::vec3 oc = origin - glm::vec3(sphere);
+                float b = glm::dot(ray, oc);
+                float c = glm::dot(oc, oc) - sphere.w * sphere.w;
+                if (b <= 0.0f && b * b - c >= 0.0f) {
+                    float distance = glm::dot(oc, oc);
+                    if (closest < 0 || distance < closestDistance) {
+                        closest = (int) i;
+                        closestDistance = distance;
+                    }
+                }
+            }
+            if (closest >= 0) {
+                sid = frame.sids[closest];
+            }
+
+            --mReaders[front];
+            return closest >= 0;
+        }
+    }
+}
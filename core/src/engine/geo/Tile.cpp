@@ -27,12 +27,13 @@ namespace dma {
 
         //--------------------------------------------------------------------------
         Tile::Tile(std::shared_ptr<Quad> quad,
-                   std::shared_ptr<Material> material,
+                   std::shared_ptr<MaterialInstance> material,
                    const LatLng& coords, int x, int y, int z) :
                 Entity(quad, material),
                 mCoords(coords),
                 x(x), y(y), z(z),
-                mQuad(quad)
+                mQuad(quad),
+                mTerrainSegments(0)
         {
             pitch(-90.0f);
             setScale(mQuad->getScale());
@@ -40,7 +41,7 @@ namespace dma {
 
 
         //--------------------------------------------------------------------------
-        Tile::Tile(std::shared_ptr<Quad> quad, std::shared_ptr<Material> material) :
+        Tile::Tile(std::shared_ptr<Quad> quad, std::shared_ptr<MaterialInstance> material) :
             Tile(quad, material, LatLng(), -1, -1, -1)
         {
         }
@@ -66,18 +67,31 @@ namespace dma {
         //--------------------------------------------------------------------------
         void Tile::setDiffuseMap(std::shared_ptr<Map> diffuseMap) {
             getMaterial()->setDiffuseMap(diffuseMap, TILE_PASS_INDEX);
+            invalidate();
         }
 
 
         //--------------------------------------------------------------------------
         std::shared_ptr<Map> Tile::getDiffuseMap() {
-            return getMaterial()->getPass(TILE_PASS_INDEX).getDiffuseMap();
+            return getMaterial()->getDiffuseMap(TILE_PASS_INDEX);
         }
 
 
         //--------------------------------------------------------------------------
-        std::shared_ptr<Material> Tile::getMaterial() {
+        std::shared_ptr<MaterialInstance> Tile::getMaterial() {
             return mRenderingComponent->getRenderingPackages()[0]->getMaterial();
         }
+
+
+        //--------------------------------------------------------------------------
+        void Tile::setTerrainMesh(const std::shared_ptr<TerrainMesh>& mesh) {
+            mTerrainMesh = mesh;
+            if (mesh) {
+                mRenderingComponent->setMesh(mesh);
+            } else {
+                mRenderingComponent->setMesh(mQuad);
+            }
+            invalidate();
+        }
     }
 }
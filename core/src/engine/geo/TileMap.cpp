@@ -18,8 +18,15 @@
 
 #include <utils/GeoUtils.hpp>
 #include <string.h>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include "utils/Utils.hpp"
+#include "utils/MvtReader.hpp"
+#include "common/Timer.hpp"
 #include "engine/geo/TileMap.hpp"
+#include "engine/geo/VectorTileBuilder.hpp"
+#include "resource/Image.hpp"
 
 #define DEFAULT_TILE_DIFFUSE_MAP "damier"
 
@@ -31,6 +38,16 @@ namespace dma {
         constexpr int TileMap::SIZE;
         constexpr int TileMap::OFFSET;
         constexpr int TileMap::ZOOM;
+        constexpr char TileMap::VECTOR_STYLE[];
+        constexpr U32 TileMap::VECTOR_CACHE_SIZE;
+        constexpr char TileMap::VECTOR_EXTENSION[];
+        constexpr char TileMap::ELEVATION_PREFIX[];
+        constexpr char TileMap::ELEVATION_EXTENSION[];
+        constexpr U32 TileMap::ELEVATION_CACHE_SIZE;
+        constexpr U32 TileMap::TERRAIN_SEGMENTS[];
+        constexpr F32 TileMap::MIN_SKIRT_DEPTH;
+        constexpr int TileMap::DEFAULT_VECTOR_ZOOM;
+        constexpr int TileMap::DEFAULT_TERRAIN_ZOOM;
 
         //---------------------------------------------------------------------------
         bool TileMap::isInRange(int x, int y, int xp, int yp) {
@@ -46,18 +63,38 @@ namespace dma {
 
 
         //---------------------------------------------------------------------------
-        TileMap::TileMap(ResourceManager& resourceManager) :
+        TileMap::TileMap(Scene& scene, ResourceManager& resourceManager) :
+                mScene(scene),
                 mResourceManager(resourceManager),
                 mLastX(-1),
                 mLastY(-1),
+                mWindowRadius(OFFSET),
                 mNullCallbacks(new GeoEngineCallbacks()),
-                mCallbacks(mNullCallbacks) {
+                mCallbacks(mNullCallbacks),
+                mVectorEnabled(false),
+                mVectorZoom(DEFAULT_VECTOR_ZOOM),
+                mVectorGeneration(0),
+                mVectorUpdate(0),
+                mVectorBuiltCount(0),
+                mVectorBuildTime(0.0f),
+                mTerrainEnabled(false),
+                mTerrainZoom(DEFAULT_TERRAIN_ZOOM),
+                mTerrainGeneration(0),
+                mTerrainUpdate(0),
+                mTerrainBase(0.0f),
+                mHasTerrainBase(false),
+                mGroundRevision(0),
+                mTerrainBuiltCount(0),
+                mTerrainBuildTime(0.0f) {
 
         }
 
 
         //---------------------------------------------------------------------------
         TileMap::~TileMap() {
+            // the workers post to this tile map.
+            mVectorPool.stop();
+            mTerrainPool.stop();
             unload();
             delete mNullCallbacks;
         }
@@ -70,7 +107,7 @@ namespace dma {
             for (int i = 0; i < SIZE * SIZE; ++i) {
                 std::shared_ptr<Quad> quad = mResourceManager.createQuad(1.0f, 1.0f);
                 Status status;
-                std::shared_ptr<Material> mat = mResourceManager.createMaterial(TILE_MATERIAL, &status); //material with default tile texture
+                std::shared_ptr<MaterialInstance> mat = mResourceManager.createMaterial(TILE_MATERIAL, &status); //material with default tile texture
                 std::shared_ptr<Tile> tile = std::make_shared<Tile>(quad, mat);
                 //TODO remove set in material tile.json tile->setDiffuseMap(mResourceManager.acquireTexture(DEFAULT_TILE_DIFFUSE_MAP, &status));
                 tile->mDirty = true;
@@ -81,14 +118,21 @@ namespace dma {
 
         //---------------------------------------------------------------------------
         void TileMap::unload() {
+            mVectorPool.stop();
+            mTerrainPool.stop();
+            mClearVectorTiles();
+            mClearTerrain();
+            mBuilt.cancelAll();
+            mRetiredMeshes.clear();
             mRemoveAllTiles();
             mLastX = mLastY = -1;
+            mReportMemory();
         }
 
 
         //---------------------------------------------------------------------------
         void TileMap::update(int x0, int y0) {
-            Log::trace(TAG, "Updating TileMap (%d, %d, %d)", x0, y0, ZOOM);
+            LOG_TRACE(TAG, "Updating TileMap (%d, %d, %d)", x0, y0, ZOOM);
 
             //TODO check x and y bounds
             if (x0 <= OFFSET || y0 <= OFFSET) {
@@ -115,15 +159,15 @@ namespace dma {
             bool isUpToDate[SIZE][SIZE];
             memset(isUpToDate, 0, SIZE*SIZE);
 
-            std::list<std::shared_ptr<Tile>> toUpdate;
+            std::list<Tile*> toUpdate;
 
-            for (auto tile : mTiles) {
+            for (const auto& tile : mTiles) {
                 if (isInRange(tile->x, tile->y, x0, y0)) {
                     int i = tile->x - x0 + OFFSET;
                     int j = tile->y - y0 + OFFSET;
                     isUpToDate[i][j] = true;
                 } else {
-                    toUpdate.push_back(tile);
+                    toUpdate.push_back(tile.get());
                 }
             }
 
@@ -132,7 +176,7 @@ namespace dma {
                     int i = x - x0 + OFFSET;
                     int j = y - y0 + OFFSET;
                     if (!isUpToDate[i][j]) {
-                        std::shared_ptr<Tile> tile = toUpdate.front();
+                        Tile* tile = toUpdate.front();
                         toUpdate.pop_front();
                         double tileLat = coords[i][j][0];
                         double tileLng = coords[i][j][1];
@@ -145,12 +189,12 @@ namespace dma {
 
                         float width = (float) GeoUtils::slc(LatLng(tileLat, tileLng), LatLng(rightTileLat, rightTileLng));
                         float height = (float) GeoUtils::slc(LatLng(tileLat, tileLng), LatLng(bottomTileLat, bottomTileLon));
-                        Status status = mUpdateTile(tile, tileLat, tileLng, width, height, x, y, z);
+                        Status status = mUpdateTile(*tile, tileLat, tileLng, width, height, x, y, z);
                         if (status != STATUS_OK) {
                             std::stringstream ss;
                             ss << "error while creating tilemap (" << x0 << "," << y0
                             << ") with tile (" << x << ", " << y << ", " << z << ")";
-                            Log::error(TAG, ss.str());
+                            Log::error(TAG, "%s", ss.str().c_str());
                             throw std::runtime_error(ss.str());
                         }
                     }
@@ -161,13 +205,20 @@ namespace dma {
 
             mLastX = x0;
             mLastY = y0;
+            mUpdateVisibility();
+            mUpdateVectorTiles();
+            mUpdateTerrain();
+            mReportMemory();
         }
 
 
         //---------------------------------------------------------------------------
         Status TileMap::notifyTileAvailable(int x, int y, int z) {
-            Log::trace(TAG, "Notifying tile available (%d, %d, %d)", x, y, z);
-            std::shared_ptr<Tile> tile = findTile(x, y, z);
+            LOG_TRACE(TAG, "Notifying tile available (%d, %d, %d)", x, y, z);
+            if (mVectorEnabled && z == mVectorZoom) {
+                return notifyVectorTileAvailable(x, y, z);
+            }
+            Tile* tile = findTile(x, y, z);
             if (tile == nullptr) {
                 std::stringstream ss;
                 ss <<"Trying to set Tile Image but Tile (" << x << ", " << y << ", " << z << ") doesn't exist in the TileMap";
@@ -176,93 +227,809 @@ namespace dma {
                 //throw std::runtime_error(ss.str());
                 //throwException(TAG, ExceptionType::NO_SUCH_ELEMENT, ss.str());
             }
-            std::string sid = tileSid(x, y, z);
-            std::shared_ptr<Map> diffuseMap = mResourceManager.acquireMap(sid);
-            tile->setDiffuseMap(diffuseMap);
+            mResourceManager.notifyTileMapAvailable(TileId(x, y, z));
+            mUpdateDiffuseMap(*tile);
             return STATUS_OK;
         }
 
 
         //---------------------------------------------------------------------------
-        Status TileMap::mUpdateTile(std::shared_ptr<Tile> tile, double lat, double lng, float width, float height, int x , int y, int z) {
+        Status TileMap::mUpdateTile(Tile& tile, double lat, double lng, float width, float height, int x , int y, int z) {
+            auto it = mTileIndex.find(TileId(tile.x, tile.y, tile.z).getKey());
+            if (it != mTileIndex.end() && it->second == &tile) {
+                mTileIndex.erase(it);
+            }
 
-            tile->x = x;
-            tile->y = y;
-            tile->z = z;
-            tile->setSize(width, height);
-            tile->mCoords.lat = lat;
-            tile->mCoords.lng = lng;
+            mFlattenTile(tile);
+            tile.x = x;
+            tile.y = y;
+            tile.z = z;
+            tile.setSize(width, height);
+            tile.mCoords.lat = lat;
+            tile.mCoords.lng = lng;
+            mTileIndex[TileId(x, y, z).getKey()] = &tile;
 
-            std::shared_ptr<Map> diffuseMap;
+            if (!mUpdateDiffuseMap(tile)) {
+                // raster tiles are hidden while vector ones are drawn.
+                if (!mNamespace.empty() && !mVectorEnabled) {
+                    LOG_TRACE(TAG, "No map found for tile (%d, %d, %d)", x, y, z);
+                    mCallbacks->onTileRequest(x, y, z);
+                }
+            }
+
+            tile.setDirty(true);
+            //LOG_TRACE(TAG, "Tile (%d, %d, %d) updated, diffuse map: %s", x, y, z, diffuseMap->getSID().c_str());
+            return STATUS_OK;
+        }
 
-            std::string sid = tileSid(x, y, z);
 
-            diffuseMap = mResourceManager.acquireMap(DEFAULT_TILE_DIFFUSE_MAP);
-            if (mResourceManager.hasMap(sid)) {
-                diffuseMap = mResourceManager.acquireMap(sid);
-            } else if (!mNamespace.empty()) {
-                Log::trace(TAG, "No tile found with sid %s", sid.c_str());
-                mCallbacks->onTileRequest(x, y, z);
+        //---------------------------------------------------------------------------
+        void TileMap::setWindowRadius(int radius) {
+            radius = std::max(0, std::min(radius, OFFSET));
+            if (radius != mWindowRadius) {
+                LOG_DEBUG(TAG, "Setting tile window radius: %d", radius);
+                mWindowRadius = radius;
+                mUpdateVisibility();
             }
+        }
 
-            tile->setDiffuseMap(diffuseMap);
-            tile->setDirty(true);
-            //Log::trace(TAG, "Tile (%d, %d, %d) updated, diffuse map: %s", x, y, z, diffuseMap->getSID().c_str());
-            return STATUS_OK;
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateVisibility() {
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                tile->setVisible(!mVectorEnabled
+                                 && std::abs(tile->x - mLastX) <= mWindowRadius
+                                 && std::abs(tile->y - mLastY) <= mWindowRadius);
+            }
         }
 
 
         //---------------------------------------------------------------------------
         void TileMap::mRemoveAllTiles() {
+            mTileIndex.clear();
             mTiles.clear();
+            mDefaultMap = Handle<Map>();
         }
 
 
         //---------------------------------------------------------------------------
-        std::shared_ptr<Tile> TileMap::findTile(int x, int y, int z) {
-            for (auto tile : mTiles) {
-                if (tile->x == x && tile->y == y && tile->z == z) {
-                    return tile;
-                }
+        Tile* TileMap::findTile(int x, int y, int z) {
+            auto it = mTileIndex.find(TileId(x, y, z).getKey());
+            return it != mTileIndex.end() ? it->second : nullptr;
+        }
+
+
+        //---------------------------------------------------------------------------
+        std::shared_ptr<Map> TileMap::mGetDefaultMap() {
+            const std::shared_ptr<Map>& map = mResourceManager.getMap(mDefaultMap);
+            if (map) {
+                return map;
+            }
+            // first call, or the map was unloaded since.
+            mDefaultMap = mResourceManager.acquireMapHandle(DEFAULT_TILE_DIFFUSE_MAP);
+            if (mDefaultMap.isNull()) {
+                return mResourceManager.getFallbackMap();
+            }
+            return mResourceManager.getMap(mDefaultMap);
+        }
+
+
+        //---------------------------------------------------------------------------
+        bool TileMap::mUpdateDiffuseMap(Tile& tile) {
+            Handle<Map> handle = mResourceManager.acquireTileMapHandle(TileId(tile.x, tile.y, tile.z));
+            if (handle.isNull()) {
+                tile.mDiffuseHandle = handle;
+                tile.setDiffuseMap(mGetDefaultMap());
+                return false;
+            }
+            if (handle != tile.mDiffuseHandle) {
+                tile.mDiffuseHandle = handle;
+                tile.setDiffuseMap(mResourceManager.getMap(handle));
             }
-            return nullptr;
+            return true;
         }
 
 
         //---------------------------------------------------------------------------
-        std::string TileMap::tileSid(int x, int y, int z) const {
-            std::stringstream ssid;
-            ssid << "tiles/";
+        std::string TileMap::tileSid(int x, int y, int z, const char* prefix) const {
+            char coords[48];
+            snprintf(coords, sizeof(coords), "%d/%d/%d", z, x, y);
+            std::string sid(prefix);
+            sid.reserve(sid.size() + mNamespace.size() + 1 + strlen(coords));
             if (!mNamespace.empty()) {
-                ssid << mNamespace << "/";
+                sid.append(mNamespace).push_back('/');
             }
-            ssid << z << "/" << x << "/" << y;
-            return ssid.str();
+            sid.append(coords);
+            return sid;
         }
 
 
         //---------------------------------------------------------------------------
         void TileMap::setNamespace(const std::string &ns) {
-            Log::debug(TAG, "Setting namespace: %s", ns.c_str());
+            LOG_DEBUG(TAG, "Setting namespace: %s", ns.c_str());
             mNamespace = ns;
+            mResourceManager.setTileMapDir(ns.empty() ? "tiles/" : "tiles/" + ns + "/");
             if (mTiles.front()->x != -1) { // -1 means tile map not set
                 updateDiffuseMaps();
             }
+            // tiles of the former namespace.
+            mClearVectorTiles();
+            mUpdateVectorTiles();
+            mClearTerrain();
+            mUpdateTerrain();
         }
 
 
         //---------------------------------------------------------------------------
         void TileMap::updateDiffuseMaps() {
-            for (std::shared_ptr<Tile> tile : mTiles) {
-                std::string sid = tileSid(tile->x, tile->y, tile->z);
-                if (mResourceManager.hasMap(sid)) {
-                    tile->setDiffuseMap(mResourceManager.acquireMap(sid));
-                } else {
-                    tile->setDiffuseMap(mResourceManager.acquireMap(DEFAULT_TILE_DIFFUSE_MAP));
+            for (const auto& tile : mTiles) {
+                if (!mUpdateDiffuseMap(*tile) && !mVectorEnabled) {
                     mCallbacks->onTileRequest(tile->x, tile->y, tile->z);
                 }
                 tile->setDirty(true);
             }
         }
-    }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::setVectorEnabled(bool enabled) {
+            if (enabled == mVectorEnabled) {
+                return;
+            }
+            LOG_DEBUG(TAG, "%s vector tiles", enabled ? "Enabling" : "Disabling");
+            if (enabled && !mVectorStyle) {
+                std::string json;
+                std::shared_ptr<VectorStyle> style = std::make_shared<VectorStyle>();
+                if (mResourceManager.readVectorStyle(VECTOR_STYLE, json) != STATUS_OK
+                    || style->parse(json) != STATUS_OK) {
+                    Log::error(TAG, "Could not load vector style %s: vector tiles stay disabled", VECTOR_STYLE);
+                    return;
+                }
+                mVectorStyle = style;
+            }
+            mVectorEnabled = enabled;
+            if (enabled) {
+                mUpdateVectorTiles();
+            } else {
+                mClearVectorTiles();
+                if (!mTiles.empty() && mTiles.front()->x != -1) {
+                    // raster tiles were not requested meanwhile.
+                    updateDiffuseMaps();
+                }
+            }
+            mUpdateVisibility();
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::setVectorZoom(int zoom) {
+            zoom = std::max(0, std::min(zoom, ZOOM));
+            if (zoom != mVectorZoom) {
+                LOG_DEBUG(TAG, "Setting vector tile zoom: %d", zoom);
+                mVectorZoom = zoom;
+                mClearVectorTiles();
+                mUpdateVectorTiles();
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        Status TileMap::notifyVectorTileAvailable(int x, int y, int z) {
+            auto it = mVectorTiles.find(TileId(x, y, z).getKey());
+            if (it == mVectorTiles.end()) {
+                Log::error(TAG, "Vector tile (%d, %d, %d) doesn't exist in the TileMap", x, y, z);
+                return STATUS_KO;
+            }
+            mResourceManager.notifyTileFileAvailable(tileSid(x, y, z), VECTOR_EXTENSION);
+            if (it->second->mState == VectorTile::REQUESTED || it->second->mState == VectorTile::FAILED) {
+                mLoadVectorTile(it->second);
+            }
+            return STATUS_OK;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::flush() {
+            bool changed = mBuilt.flush() > 0;
+            auto it = mRetiredMeshes.begin();
+            while (it != mRetiredMeshes.end()) {
+                if (it->unique()) {
+                    (*it)->release();
+                    it = mRetiredMeshes.erase(it);
+                    changed = true;
+                } else {
+                    ++it;
+                }
+            }
+            if (changed) {
+                mReportMemory();
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::refresh() {
+            for (auto& kv : mVectorTiles) {
+                for (const std::shared_ptr<VectorMesh>& mesh : kv.second->mMeshes) {
+                    mesh->upload();
+                }
+            }
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                if (tile->mTerrainMesh) {
+                    tile->mTerrainMesh->upload();
+                }
+            }
+            mReportMemory();
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::wipe() {
+            for (auto& kv : mVectorTiles) {
+                for (const std::shared_ptr<VectorMesh>& mesh : kv.second->mMeshes) {
+                    mesh->release();
+                }
+            }
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                if (tile->mTerrainMesh) {
+                    tile->mTerrainMesh->release();
+                }
+            }
+            for (const std::shared_ptr<GeneratedMesh>& mesh : mRetiredMeshes) {
+                mesh->release();
+            }
+            mRetiredMeshes.clear();
+            mReportMemory();
+        }
+
+
+        //---------------------------------------------------------------------------
+        TileMap::VectorStats TileMap::getVectorStats() const {
+            VectorStats stats;
+            stats.tileCount = (U32) mVectorTiles.size();
+            for (const auto& kv : mVectorTiles) {
+                const VectorTile& tile = *kv.second;
+                if (tile.mState == VectorTile::READY) {
+                    ++stats.readyCount;
+                }
+                for (const std::shared_ptr<VectorMesh>& mesh : tile.mMeshes) {
+                    ++stats.meshCount;
+                    stats.vertexCount += mesh->getVertexCount();
+                    stats.triangleCount += mesh->getTriangleCount();
+                    stats.byteCount += mesh->getCpuBytes();
+                }
+            }
+            stats.builtCount = mVectorBuiltCount;
+            stats.buildTime = mVectorBuildTime;
+            return stats;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateVectorTiles() {
+            if (!mVectorEnabled || mLastX < 0 || mLastY < 0) {
+                return;
+            }
+            ++mVectorUpdate;
+            const int shift = ZOOM - mVectorZoom;
+            const int z = mVectorZoom;
+            const int x0 = (mLastX - OFFSET) >> shift;
+            const int x1 = (mLastX + OFFSET) >> shift;
+            const int y0 = (mLastY - OFFSET) >> shift;
+            const int y1 = (mLastY + OFFSET) >> shift;
+            for (int x = x0; x <= x1; ++x) {
+                for (int y = y0; y <= y1; ++y) {
+                    const U64 key = TileId(x, y, z).getKey();
+                    auto it = mVectorTiles.find(key);
+                    if (it == mVectorTiles.end()) {
+                        std::shared_ptr<VectorTile> tile = std::make_shared<VectorTile>(x, y, z);
+                        tile->mCoords = LatLng(GeoUtils::tiley2lat(y, z), GeoUtils::tilex2long(x, z));
+                        tile->mWidth = (float) GeoUtils::slc(tile->mCoords,
+                                                             LatLng(tile->mCoords.lat, GeoUtils::tilex2long(x + 1, z)));
+                        tile->mHeight = (float) GeoUtils::slc(tile->mCoords,
+                                                              LatLng(GeoUtils::tiley2lat(y + 1, z), tile->mCoords.lng));
+                        tile->mGeneration = mVectorGeneration;
+                        it = mVectorTiles.emplace(key, tile).first;
+                        mLoadVectorTile(tile);
+                    }
+                    it->second->mLastUse = mVectorUpdate;
+                    mShowVectorTile(*it->second, true);
+                }
+            }
+
+            // least recently used tiles out of the window are dropped first.
+            std::vector<std::pair<U32, U64>> unused;
+            for (const auto& kv : mVectorTiles) {
+                if (kv.second->mLastUse != mVectorUpdate) {
+                    mShowVectorTile(*kv.second, false);
+                    unused.push_back(std::make_pair(kv.second->mLastUse, kv.first));
+                }
+            }
+            if (unused.size() > VECTOR_CACHE_SIZE) {
+                std::sort(unused.begin(), unused.end());
+                for (size_t i = 0; i < unused.size() - VECTOR_CACHE_SIZE; ++i) {
+                    mRemoveVectorTile(unused[i].second);
+                }
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mLoadVectorTile(const std::shared_ptr<VectorTile>& tile) {
+            const std::string sid = tileSid(tile->x, tile->y, tile->z);
+            if (!mResourceManager.hasTileFile(sid, VECTOR_EXTENSION)) {
+                tile->mState = VectorTile::REQUESTED;
+                if (!mNamespace.empty()) {
+                    LOG_TRACE(TAG, "No vector tile found with sid %s", sid.c_str());
+                    mCallbacks->onTileRequest(tile->x, tile->y, tile->z);
+                }
+                return;
+            }
+
+            // read here, as the resource index is not thread safe.
+            std::shared_ptr<std::string> data = std::make_shared<std::string>();
+            if (mResourceManager.readTileFile(sid, VECTOR_EXTENSION, *data) != STATUS_OK) {
+                Log::error(TAG, "Could not read vector tile %s", sid.c_str());
+                tile->mState = VectorTile::FAILED;
+                return;
+            }
+            if (!mVectorPool.isRunning()) {
+                mVectorPool.start();
+            }
+            tile->mState = VectorTile::BUILDING;
+
+            const U32 generation = tile->mGeneration;
+            const F32 width = tile->mWidth;
+            const F32 height = tile->mHeight;
+            std::shared_ptr<const VectorStyle> style = mVectorStyle;
+            // the tile itself is not touched by the worker, nor kept alive by it.
+            std::weak_ptr<VectorTile> target = tile;
+            mVectorPool.post([this, sid, data, target, generation, width, height, style]() {
+                Timer timer;
+                timer.reset();
+                std::vector<MvtReader::Layer> layers;
+                std::vector<VectorTile::Part> parts;
+                bool decoded = MvtReader::read((const BYTE*) data->data(), (U32) data->size(), layers) == STATUS_OK;
+                if (decoded) {
+                    std::vector<VectorTileBuilder::Bucket> buckets;
+                    VectorTileBuilder builder(*style);
+                    builder.build(layers, width, height, buckets);
+                    for (size_t i = 0; i < buckets.size(); ++i) {
+                        VectorTileBuilder::Bucket& bucket = buckets[i];
+                        if (bucket.indices.empty()) {
+                            continue;
+                        }
+                        VectorTile::Part part;
+                        part.rule = bucket.rule;
+                        part.mesh = std::make_shared<VectorMesh>(sid + "#" + std::to_string(i),
+                                                                 (const F32*) bucket.vertices.data(),
+                                                                 (U32) bucket.vertices.size(),
+                                                                 std::move(bucket.indices));
+                        parts.push_back(part);
+                    }
+                }
+                const F32 buildTime = timer.liveDT();
+                mBuilt << [this, target, generation, decoded, parts, buildTime]() {
+                    mOnVectorTileBuilt(target, generation, decoded, parts, buildTime);
+                };
+            });
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mOnVectorTileBuilt(const std::weak_ptr<VectorTile>& target, U32 generation, bool decoded,
+                                         const std::vector<VectorTile::Part>& parts, F32 buildTime) {
+            // the tile may have been evicted, and added again with a build of its own, while this one ran.
+            std::shared_ptr<VectorTile> built = target.lock();
+            if (generation != mVectorGeneration || !built || built->mState != VectorTile::BUILDING) {
+                return; // dropped meanwhile: the meshes were never uploaded.
+            }
+            auto it = mVectorTiles.find(TileId(built->x, built->y, built->z).getKey());
+            if (it == mVectorTiles.end() || it->second != built) {
+                return;
+            }
+            ++mVectorBuiltCount;
+            mVectorBuildTime += buildTime;
+
+            VectorTile& tile = *built;
+            if (!decoded) {
+                Log::error(TAG, "Could not decode vector tile (%d, %d, %d)", tile.x, tile.y, tile.z);
+                tile.mState = VectorTile::FAILED;
+                return;
+            }
+            const std::vector<VectorStyle::Rule>& rules = mVectorStyle->getRules();
+            for (const VectorTile::Part& part : parts) {
+                const VectorStyle::Rule& rule = rules[part.rule];
+                Status status;
+                std::shared_ptr<MaterialInstance> material = mResourceManager.createMaterial(rule.material, &status);
+                if (status != STATUS_OK) {
+                    Log::error(TAG, "Vector style material %s not found", rule.material.c_str());
+                    continue;
+                }
+                material->setDiffuseColor(rule.color, 0);
+                part.mesh->upload();
+                tile.mMeshes.push_back(part.mesh);
+                tile.mEntities.push_back(std::make_shared<Entity>(part.mesh, material));
+            }
+            tile.mState = VectorTile::READY;
+            tile.mDirty = true;
+            if (tile.mLastUse == mVectorUpdate) {
+                mShowVectorTile(tile, true);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mShowVectorTile(VectorTile& tile, bool visible) {
+            if (visible == tile.mInScene || tile.mState != VectorTile::READY) {
+                return;
+            }
+            for (const std::shared_ptr<Entity>& entity : tile.mEntities) {
+                if (visible) {
+                    mScene.addEntity(entity);
+                } else {
+                    mScene.removeEntity(entity);
+                }
+            }
+            tile.mInScene = visible;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mRemoveVectorTile(U64 key) {
+            auto it = mVectorTiles.find(key);
+            if (it == mVectorTiles.end()) {
+                return;
+            }
+            VectorTile& tile = *it->second;
+            mShowVectorTile(tile, false);
+            tile.mEntities.clear();
+            for (std::shared_ptr<VectorMesh>& mesh : tile.mMeshes) {
+                mRetiredMeshes.push_back(mesh);
+            }
+            mVectorTiles.erase(it);
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mClearVectorTiles() {
+            ++mVectorGeneration;
+            mVectorPool.cancelAll();
+            while (!mVectorTiles.empty()) {
+                mRemoveVectorTile(mVectorTiles.begin()->first);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::setTerrainEnabled(bool enabled) {
+            if (enabled == mTerrainEnabled) {
+                return;
+            }
+            LOG_DEBUG(TAG, "%s terrain", enabled ? "Enabling" : "Disabling");
+            mTerrainEnabled = enabled;
+            if (enabled) {
+                mUpdateTerrain();
+            } else {
+                mClearTerrain();
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::setTerrainZoom(int zoom) {
+            zoom = std::max(0, std::min(zoom, ZOOM));
+            if (zoom != mTerrainZoom) {
+                LOG_DEBUG(TAG, "Setting terrain zoom: %d", zoom);
+                mTerrainZoom = zoom;
+                mClearTerrain();
+                mUpdateTerrain();
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        Status TileMap::notifyElevationTileAvailable(int x, int y, int z) {
+            auto it = mElevationTiles.find(TileId(x, y, z).getKey());
+            if (it == mElevationTiles.end()) {
+                Log::error(TAG, "Elevation tile (%d, %d, %d) doesn't exist in the TileMap", x, y, z);
+                return STATUS_KO;
+            }
+            mResourceManager.notifyTileFileAvailable(tileSid(x, y, z, ELEVATION_PREFIX), ELEVATION_EXTENSION);
+            if (it->second->mState == ElevationTile::REQUESTED || it->second->mState == ElevationTile::FAILED) {
+                mLoadElevationTile(it->second);
+            }
+            return STATUS_OK;
+        }
+
+
+        //---------------------------------------------------------------------------
+        F32 TileMap::getGroundHeight(double lat, double lng) const {
+            if (!mTerrainEnabled || !mHasTerrainBase) {
+                return 0.0f;
+            }
+            // fractional tile coordinates, as in GeoUtils.
+            const double n = (double) (1 << mTerrainZoom);
+            const double latRad = lat * M_PI / 180.0;
+            const double fx = (lng + 180.0) / 360.0 * n;
+            const double fy = (1.0 - log(tan(latRad) + 1.0 / cos(latRad)) / M_PI) / 2.0 * n;
+            const int x = (int) floor(fx);
+            const int y = (int) floor(fy);
+            auto it = mElevationTiles.find(TileId(x, y, mTerrainZoom).getKey());
+            if (it == mElevationTiles.end() || it->second->mState != ElevationTile::READY) {
+                return 0.0f;
+            }
+            return it->second->getElevation((F32) (fx - x), (F32) (fy - y)) - mTerrainBase;
+        }
+
+
+        //---------------------------------------------------------------------------
+        TileMap::TerrainStats TileMap::getTerrainStats() const {
+            TerrainStats stats;
+            stats.elevationCount = (U32) mElevationTiles.size();
+            for (const auto& kv : mElevationTiles) {
+                const ElevationTile& tile = *kv.second;
+                if (tile.mState == ElevationTile::READY) {
+                    ++stats.readyCount;
+                    stats.byteCount += (U32) (tile.mSamples.size() * sizeof(F32));
+                }
+            }
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                if (tile->mTerrainMesh) {
+                    ++stats.meshCount;
+                    stats.vertexCount += tile->mTerrainMesh->getVertexCount();
+                    stats.triangleCount += tile->mTerrainMesh->getTriangleCount();
+                    stats.byteCount += tile->mTerrainMesh->getCpuBytes();
+                }
+            }
+            stats.builtCount = mTerrainBuiltCount;
+            stats.buildTime = mTerrainBuildTime;
+            return stats;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateTerrain() {
+            if (!mTerrainEnabled || mLastX < 0 || mLastY < 0) {
+                return;
+            }
+            ++mTerrainUpdate;
+            const int shift = ZOOM - mTerrainZoom;
+            const int z = mTerrainZoom;
+            const int x0 = (mLastX - OFFSET) >> shift;
+            const int x1 = (mLastX + OFFSET) >> shift;
+            const int y0 = (mLastY - OFFSET) >> shift;
+            const int y1 = (mLastY + OFFSET) >> shift;
+            for (int x = x0; x <= x1; ++x) {
+                for (int y = y0; y <= y1; ++y) {
+                    const U64 key = TileId(x, y, z).getKey();
+                    auto it = mElevationTiles.find(key);
+                    if (it == mElevationTiles.end()) {
+                        std::shared_ptr<ElevationTile> tile = std::make_shared<ElevationTile>(x, y, z);
+                        it = mElevationTiles.emplace(key, tile).first;
+                        mLoadElevationTile(tile);
+                    }
+                    it->second->mLastUse = mTerrainUpdate;
+                }
+            }
+
+            // least recently used tiles out of the window are dropped first.
+            std::vector<std::pair<U32, U64>> unused;
+            for (const auto& kv : mElevationTiles) {
+                if (kv.second->mLastUse != mTerrainUpdate) {
+                    unused.push_back(std::make_pair(kv.second->mLastUse, kv.first));
+                }
+            }
+            if (unused.size() > ELEVATION_CACHE_SIZE) {
+                std::sort(unused.begin(), unused.end());
+                for (size_t i = 0; i < unused.size() - ELEVATION_CACHE_SIZE; ++i) {
+                    mElevationTiles.erase(unused[i].second);
+                }
+            }
+
+            // the center moved: so did the resolution of the tiles around it.
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                mUpdateTileTerrain(*tile);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mLoadElevationTile(const std::shared_ptr<ElevationTile>& tile) {
+            const std::string sid = tileSid(tile->x, tile->y, tile->z, ELEVATION_PREFIX);
+            if (!mResourceManager.hasTileFile(sid, ELEVATION_EXTENSION)) {
+                tile->mState = ElevationTile::REQUESTED;
+                if (!mNamespace.empty()) {
+                    LOG_TRACE(TAG, "No elevation tile found with sid %s", sid.c_str());
+                    mCallbacks->onElevationTileRequest(tile->x, tile->y, tile->z);
+                }
+                return;
+            }
+
+            // read here, as the resource index is not thread safe.
+            std::shared_ptr<std::string> data = std::make_shared<std::string>();
+            if (mResourceManager.readTileFile(sid, ELEVATION_EXTENSION, *data) != STATUS_OK) {
+                Log::error(TAG, "Could not read elevation tile %s", sid.c_str());
+                tile->mState = ElevationTile::FAILED;
+                return;
+            }
+            if (!mTerrainPool.isRunning()) {
+                mTerrainPool.start(1);
+            }
+            tile->mState = ElevationTile::DECODING;
+
+            const U32 generation = mTerrainGeneration;
+            // the samples are written by the worker, and only read once the tile is READY.
+            std::shared_ptr<ElevationTile> target = tile;
+            mTerrainPool.post([this, sid, data, generation, target]() {
+                Timer timer;
+                timer.reset();
+                Image image;
+                bool decoded = image.loadAsPNG((const BYTE*) data->data(), (U32) data->size(), sid, false) == STATUS_OK
+                               && target->decode(image) == STATUS_OK;
+                const F32 decodeTime = timer.liveDT();
+                mBuilt << [this, generation, target, decoded, decodeTime]() {
+                    mOnElevationTileDecoded(target, generation, decoded, decodeTime);
+                };
+            });
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mOnElevationTileDecoded(const std::shared_ptr<ElevationTile>& target, U32 generation,
+                                              bool decoded, F32 decodeTime) {
+            if (generation != mTerrainGeneration) {
+                return;
+            }
+            // the tile may have been evicted, and created again with a decode of its own, while this one ran.
+            auto it = mElevationTiles.find(TileId(target->x, target->y, target->z).getKey());
+            if (it == mElevationTiles.end() || it->second != target || target->mState != ElevationTile::DECODING) {
+                return;
+            }
+            mTerrainBuildTime += decodeTime;
+            ElevationTile& tile = *target;
+            if (!decoded) {
+                Log::error(TAG, "Could not decode elevation tile (%d, %d, %d)", tile.x, tile.y, tile.z);
+                tile.mState = ElevationTile::FAILED;
+                return;
+            }
+            tile.mState = ElevationTile::READY;
+            if (!mHasTerrainBase) {
+                // keeps heights close to 0 around the camera, where float precision matters.
+                mTerrainBase = (tile.mMin + tile.mMax) / 2.0f;
+                mHasTerrainBase = true;
+            }
+            ++mGroundRevision;
+            for (const std::shared_ptr<Tile>& t : mTiles) {
+                mUpdateTileTerrain(*t);
+            }
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mUpdateTileTerrain(Tile& tile) {
+            if (!mTerrainEnabled || tile.x < 0 || mLastX < 0) {
+                return;
+            }
+            const int ring = std::max(std::abs(tile.x - mLastX), std::abs(tile.y - mLastY));
+            const U32 segments = TERRAIN_SEGMENTS[std::min(ring, OFFSET)];
+            if (segments == tile.mTerrainSegments) {
+                return;
+            }
+            const int shift = ZOOM - mTerrainZoom;
+            auto it = mElevationTiles.find(TileId(tile.x >> shift, tile.y >> shift, mTerrainZoom).getKey());
+            if (it == mElevationTiles.end() || it->second->mState != ElevationTile::READY) {
+                return;
+            }
+            tile.mTerrainSegments = segments;
+
+            // the tile covers [u0, u0 + scale] x [v0, v0 + scale] of its elevation tile.
+            const F32 scale = 1.0f / (F32) (1 << shift);
+            const F32 u0 = (tile.x - (it->second->x << shift)) * scale;
+            const F32 v0 = (tile.y - (it->second->y << shift)) * scale;
+            const int x = tile.x;
+            const int y = tile.y;
+            const int z = tile.z;
+            const U32 generation = mTerrainGeneration;
+            const F32 width = tile.getQuad().getWidth();
+            const F32 height = tile.getQuad().getHeight();
+            const F32 base = mTerrainBase;
+            std::shared_ptr<const ElevationTile> elevation = it->second;
+            const std::string sid = tileSid(x, y, z, "terrain/") + "#" + std::to_string(segments);
+            mTerrainPool.post([this, sid, elevation, x, y, z, segments, generation, u0, v0, scale,
+                               width, height, base]() {
+                Timer timer;
+                timer.reset();
+                std::vector<F32> heights;
+                heights.reserve((segments + 1) * (segments + 1));
+                F32 min = 0.0f;
+                F32 max = 0.0f;
+                for (U32 row = 0; row <= segments; ++row) {
+                    const F32 v = v0 + scale * row / segments;
+                    for (U32 col = 0; col <= segments; ++col) {
+                        const F32 h = elevation->getElevation(u0 + scale * col / segments, v) - base;
+                        min = heights.empty() ? h : std::min(min, h);
+                        max = heights.empty() ? h : std::max(max, h);
+                        heights.push_back(h);
+                    }
+                }
+                // deep enough to hide the steps between grids of different resolutions.
+                const F32 skirtDepth = std::max(MIN_SKIRT_DEPTH, max - min);
+                std::shared_ptr<TerrainMesh> mesh = std::make_shared<TerrainMesh>(sid, segments, heights,
+                                                                                  width, height, skirtDepth);
+                const F32 buildTime = timer.liveDT();
+                mBuilt << [this, x, y, z, segments, generation, mesh, buildTime]() {
+                    mOnTerrainMeshBuilt(x, y, z, segments, generation, mesh, buildTime);
+                };
+            });
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mOnTerrainMeshBuilt(int x, int y, int z, U32 segments, U32 generation,
+                                          const std::shared_ptr<TerrainMesh>& mesh, F32 buildTime) {
+            if (generation != mTerrainGeneration) {
+                return;
+            }
+            ++mTerrainBuiltCount;
+            mTerrainBuildTime += buildTime;
+            Tile* tile = findTile(x, y, z);
+            if (tile == nullptr || tile->mTerrainSegments != segments) {
+                return; // moved, or requested at another resolution meanwhile.
+            }
+            mesh->upload();
+            if (tile->mTerrainMesh) {
+                mRetiredMeshes.push_back(tile->mTerrainMesh);
+            }
+            tile->setTerrainMesh(mesh);
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mFlattenTile(Tile& tile) {
+            if (tile.mTerrainMesh) {
+                mRetiredMeshes.push_back(tile.mTerrainMesh);
+                tile.setTerrainMesh(nullptr);
+            }
+            tile.mTerrainSegments = 0;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mClearTerrain() {
+            ++mTerrainGeneration;
+            mTerrainPool.cancelAll();
+            mElevationTiles.clear();
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                mFlattenTile(*tile);
+            }
+            mHasTerrainBase = false;
+            ++mGroundRevision;
+        }
+
+
+        //---------------------------------------------------------------------------
+        void TileMap::mReportMemory() {
+            MemoryUsage vector;
+            for (const auto& kv : mVectorTiles) {
+                for (const std::shared_ptr<VectorMesh>& mesh : kv.second->mMeshes) {
+                    vector.add(mesh->getCpuBytes(), mesh->getGpuBytes());
+                }
+            }
+            mResourceManager.setMemoryUsage(MemoryReport::VECTOR_TILE, vector);
+
+            MemoryUsage terrain;
+            for (const auto& kv : mElevationTiles) {
+                // samples are written by the worker until the tile is ready.
+                const ElevationTile& tile = *kv.second;
+                terrain.add(tile.mState == ElevationTile::READY ? tile.mSamples.size() * sizeof(F32) : 0, 0);
+            }
+            for (const std::shared_ptr<Tile>& tile : mTiles) {
+                if (tile->mTerrainMesh) {
+                    terrain.add(tile->mTerrainMesh->getCpuBytes(), tile->mTerrainMesh->getGpuBytes());
+                }
+            }
+            mResourceManager.setMemoryUsage(MemoryReport::TERRAIN, terrain);
+        }
+}
 }
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+
+#include "rapidjson.h"
+#include "document.h"
+
+#include "engine/geo/VectorStyle.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "VectorStyle";
+
+namespace dma {
+    namespace geo {
+
+        constexpr char VectorStyle::GROUND_MATERIAL[];
+        constexpr char VectorStyle::BUILDING_MATERIAL[];
+
+        /* ================= ROUTINES ========================*/
+
+        //------------------------------------------------------------------------------------------
+        static bool readKind(const std::string& type, VectorStyle::Kind& kind) {
+            static const char* KINDS[] = {"background", "fill", "line", "extrusion"};
+            for (U32 i = 0; i < sizeof(KINDS) / sizeof(KINDS[0]); ++i) {
+                if (type == KINDS[i]) {
+                    kind = (VectorStyle::Kind) i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        static bool readRule(const rapidjson::Value& value, VectorStyle::Rule& rule) {
+            if (!value.IsObject() || !value.HasMember("type") || !value["type"].IsString()
+                || !readKind(value["type"].GetString(), rule.kind)) {
+                return false;
+            }
+            if (rule.kind != VectorStyle::BACKGROUND) {
+                if (!value.HasMember("layer") || !value["layer"].IsString()) {
+                    return false;
+                }
+                rule.layer = value["layer"].GetString();
+            }
+            if (value.HasMember("filter")) {
+                const rapidjson::Value& filter = value["filter"];
+                if (!filter.IsObject() || filter.MemberCount() != 1 || !filter.MemberBegin()->value.IsArray()) {
+                    return false;
+                }
+                rule.filterKey = filter.MemberBegin()->name.GetString();
+                const rapidjson::Value& values = filter.MemberBegin()->value;
+                for (rapidjson::SizeType i = 0; i < values.Size(); ++i) {
+                    if (!values[i].IsString()) {
+                        return false;
+                    }
+                    rule.filterValues.push_back(values[i].GetString());
+                }
+            }
+            rule.material = rule.kind == VectorStyle::EXTRUSION ?
+                            VectorStyle::BUILDING_MATERIAL : VectorStyle::GROUND_MATERIAL;
+            if (value.HasMember("material")) {
+                if (!value["material"].IsString()) {
+                    return false;
+                }
+                rule.material = value["material"].GetString();
+            }
+            if (value.HasMember("color")) {
+                const rapidjson::Value& color = value["color"];
+                if (!color.IsArray() || color.Size() != 3
+                    || !color[0].IsNumber() || !color[1].IsNumber() || !color[2].IsNumber()) {
+                    return false;
+                }
+                rule.color = glm::vec3(color[0].GetDouble(), color[1].GetDouble(), color[2].GetDouble());
+            }
+            if (value.HasMember("width")) {
+                if (!value["width"].IsNumber()) {
+                    return false;
+                }
+                rule.width = (F32) value["width"].GetDouble();
+            }
+            if (value.HasMember("height")) {
+                if (!value["height"].IsNumber()) {
+                    return false;
+                }
+                rule.height = (F32) value["height"].GetDouble();
+            }
+            if (value.HasMember("order")) {
+                if (!value["order"].IsUint()) {
+                    return false;
+                }
+                rule.order = value["order"].GetUint();
+            }
+            return true;
+        }
+
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------------------------
+        VectorStyle::VectorStyle() {
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        VectorStyle::~VectorStyle() {
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        Status VectorStyle::parse(const std::string& json) {
+            mRules.clear();
+            rapidjson::Document document;
+            document.Parse(json.c_str());
+            if (document.HasParseError() || !document.IsObject()
+                || !document.HasMember("rules") || !document["rules"].IsArray()) {
+                Log::error(TAG, "Invalid vector style");
+                return STATUS_KO;
+            }
+            const rapidjson::Value& rules = document["rules"];
+            for (rapidjson::SizeType i = 0; i < rules.Size(); ++i) {
+                Rule rule;
+                if (!readRule(rules[i], rule)) {
+                    Log::error(TAG, "Invalid vector style rule %d", (int) i);
+                    mRules.clear();
+                    return STATUS_KO;
+                }
+                mRules.push_back(rule);
+            }
+            return STATUS_OK;
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorStyle::findRules(const std::string& layer, std::vector<U32>& rules) const {
+            rules.clear();
+            for (U32 i = 0; i < mRules.size(); ++i) {
+                if (mRules[i].kind != BACKGROUND && mRules[i].layer == layer) {
+                    rules.push_back(i);
+                }
+            }
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        bool VectorStyle::matches(const Rule& rule, const MvtReader::Layer& layer,
+                                  const MvtReader::Feature& feature) const {
+            if (rule.filterKey.empty()) {
+                return true;
+            }
+            const MvtReader::Value* value = layer.getProperty(feature, rule.filterKey);
+            return value != nullptr && value->type == MvtReader::Value::STRING
+                   && std::find(rule.filterValues.begin(), rule.filterValues.end(), value->string)
+                      != rule.filterValues.end();
+        }
+    }
+}
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "engine/geo/VectorTileBuilder.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "VectorTileBuilder";
+
+namespace dma {
+    namespace geo {
+
+        constexpr F32 VectorTileBuilder::ORDER_HEIGHT;
+        constexpr U32 VectorTileBuilder::MAX_BUCKET_VERTICES;
+        constexpr F32 VectorTileBuilder::MITER_LIMIT;
+
+        static const glm::vec3 UP(0.0f, 1.0f, 0.0f);
+
+        /* ================= ROUTINES ========================*/
+
+        //------------------------------------------------------------------------------------------
+        /** surveyor's formula, positive for the exterior rings of a vector tile. */
+        static F64 signedArea(const glm::vec2* points, U32 count) {
+            F64 sum = 0.0;
+            for (U32 i = 0, j = count - 1; i < count; j = i++) {
+                sum += (F64) points[j].x * points[i].y - (F64) points[i].x * points[j].y;
+            }
+            return sum / 2.0;
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        /** height property of a feature, as set by the common vector tile schemas. */
+        static bool readHeight(const MvtReader::Layer& layer, const MvtReader::Feature& feature,
+                               const char* key, const char* fallbackKey, F32& height) {
+            const MvtReader::Value* value = layer.getProperty(feature, key);
+            if (value == nullptr || value->type != MvtReader::Value::NUMBER) {
+                value = layer.getProperty(feature, fallbackKey);
+            }
+            if (value == nullptr || value->type != MvtReader::Value::NUMBER) {
+                return false;
+            }
+            height = (F32) value->number;
+            return true;
+        }
+
+
+        /* ================= PUBLIC ========================*/
+
+        //------------------------------------------------------------------------------------------
+        VectorTileBuilder::VectorTileBuilder(const VectorStyle& style) :
+                mStyle(style),
+                mBuckets(nullptr),
+                mScale(1.0f)
+        {}
+
+
+        //------------------------------------------------------------------------------------------
+        VectorTileBuilder::~VectorTileBuilder() {
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::build(const std::vector<MvtReader::Layer>& layers, F32 width, F32 height,
+                                      std::vector<Bucket>& buckets) {
+            const std::vector<VectorStyle::Rule>& rules = mStyle.getRules();
+            mBuckets = &buckets;
+            mCurrentBuckets.assign(rules.size(), -1);
+            mStats = Stats();
+
+            mScale = glm::vec2(width, height);
+            for (U32 r = 0; r < rules.size(); ++r) {
+                if (rules[r].kind == VectorStyle::BACKGROUND) {
+                    mAddBackground(r);
+                }
+            }
+
+            for (const MvtReader::Layer& layer : layers) {
+                mStyle.findRules(layer.name, mLayerRules);
+                if (mLayerRules.empty()) {
+                    continue;
+                }
+                mScale = glm::vec2(width, height) / (F32) layer.extent;
+                for (const MvtReader::Feature& feature : layer.features) {
+                    for (U32 r : mLayerRules) {
+                        if (!mStyle.matches(rules[r], layer, feature)) {
+                            continue;
+                        }
+                        if (rules[r].kind == VectorStyle::LINE) {
+                            mAddLines(r, feature);
+                        } else {
+                            mAddPolygons(r, layer, feature);
+                        }
+                        ++mStats.featureCount;
+                        break;
+                    }
+                }
+            }
+
+            for (const Bucket& bucket : buckets) {
+                mStats.vertexCount += (U32) bucket.vertices.size();
+                mStats.triangleCount += (U32) bucket.indices.size() / 3;
+            }
+            mBuckets = nullptr;
+        }
+
+
+        /* ================= PRIVATE ========================*/
+
+        //------------------------------------------------------------------------------------------
+        VectorTileBuilder::Bucket* VectorTileBuilder::mGetBucket(U32 rule, U32 vertexCount) {
+            int& current = mCurrentBuckets[rule];
+            if (current < 0 || (*mBuckets)[current].vertices.size() + vertexCount > MAX_BUCKET_VERTICES) {
+                mBuckets->push_back(Bucket());
+                mBuckets->back().rule = rule;
+                current = (int) mBuckets->size() - 1;
+            }
+            return &(*mBuckets)[current];
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::mAddBackground(U32 rule) {
+            const F32 y = mStyle.getRules()[rule].order * ORDER_HEIGHT;
+            Bucket& bucket = *mGetBucket(rule, 4);
+            U16 base = (U16) bucket.vertices.size();
+            bucket.vertices.push_back(Vertex{glm::vec3(0.0f, y, 0.0f), UP});
+            bucket.vertices.push_back(Vertex{glm::vec3(mScale.x, y, 0.0f), UP});
+            bucket.vertices.push_back(Vertex{glm::vec3(mScale.x, y, mScale.y), UP});
+            bucket.vertices.push_back(Vertex{glm::vec3(0.0f, y, mScale.y), UP});
+            mAddTriangle(bucket, base, base + 1, base + 2, UP);
+            mAddTriangle(bucket, base, base + 2, base + 3, UP);
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::mAddPolygons(U32 rule, const MvtReader::Layer& layer,
+                                             const MvtReader::Feature& feature) {
+            if (feature.type != MvtReader::POLYGON) {
+                return;
+            }
+            const VectorStyle::Rule& style = mStyle.getRules()[rule];
+            F32 bottom = style.order * ORDER_HEIGHT;
+            F32 top = bottom;
+            if (style.kind == VectorStyle::EXTRUSION) {
+                bottom = 0.0f;
+                top = style.height;
+                readHeight(layer, feature, "render_height", "height", top);
+                readHeight(layer, feature, "render_min_height", "min_height", bottom);
+                if (top <= bottom) {
+                    return;
+                }
+            }
+
+            // an exterior ring and its holes make a polygon.
+            mPolygon.clear();
+            mRings.clear();
+            int exteriorSign = 0;
+            for (U32 part = 0; part < feature.getPartCount(); ++part) {
+                U32 begin = feature.getPartBegin(part);
+                U32 count = feature.getPartEnd(part) - begin;
+                if (count < 3) {
+                    continue;
+                }
+                F64 area = signedArea(&feature.points[begin], count);
+                if (area == 0.0) {
+                    continue;
+                }
+                // some tiles wind their rings the other way round: the first ring tells.
+                int sign = area > 0.0 ? 1 : -1;
+                if (exteriorSign == 0) {
+                    exteriorSign = sign;
+                }
+                if (sign == exteriorSign) {
+                    if (!mRings.empty()) {
+                        mAddPolygon(rule, bottom, top);
+                    }
+                    mPolygon.clear();
+                    mRings.clear();
+                } else if (mRings.empty()) {
+                    continue; // hole without exterior ring
+                }
+                mRings.push_back((U32) mPolygon.size());
+                for (U32 i = begin; i < begin + count; ++i) {
+                    mPolygon.push_back(mToMeters(feature.points[i]));
+                }
+            }
+            if (!mRings.empty()) {
+                mAddPolygon(rule, bottom, top);
+            }
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::mAddPolygon(U32 rule, F32 bottom, F32 top) {
+            const U32 count = (U32) mPolygon.size();
+            if (count > MAX_BUCKET_VERTICES) {
+                LOG_WARN(TAG, "Polygon of %d vertices skipped", count);
+                return;
+            }
+
+            // fill, or roof
+            mTriangles.clear();
+            mTriangulator.triangulate(mPolygon, mRings, mTriangles);
+            Bucket& bucket = *mGetBucket(rule, count);
+            U32 base = (U32) bucket.vertices.size();
+            for (const glm::vec2& point : mPolygon) {
+                bucket.vertices.push_back(Vertex{glm::vec3(point.x, top, point.y), UP});
+            }
+            for (size_t i = 0; i < mTriangles.size(); i += 3) {
+                mAddTriangle(bucket, (U16) (base + mTriangles[i]), (U16) (base + mTriangles[i + 1]),
+                             (U16) (base + mTriangles[i + 2]), UP);
+            }
+
+            if (mStyle.getRules()[rule].kind != VectorStyle::EXTRUSION) {
+                return;
+            }
+
+            // walls, facing out of the solid: out of exterior rings, into holes.
+            for (U32 ring = 0; ring < mRings.size(); ++ring) {
+                U32 begin = mRings[ring];
+                U32 end = ring + 1 < mRings.size() ? mRings[ring + 1] : count;
+                F32 side = (signedArea(&mPolygon[begin], end - begin) > 0.0) == (ring == 0) ? 1.0f : -1.0f;
+                for (U32 i = begin; i < end; ++i) {
+                    const glm::vec2& p0 = mPolygon[i];
+                    const glm::vec2& p1 = mPolygon[i + 1 < end ? i + 1 : begin];
+                    glm::vec2 d = p1 - p0;
+                    F32 length = glm::length(d);
+                    if (length == 0.0f) {
+                        continue;
+                    }
+                    const glm::vec3 normal = glm::vec3(d.y, 0.0f, -d.x) * (side / length);
+                    Bucket& walls = *mGetBucket(rule, 4);
+                    U16 b = (U16) walls.vertices.size();
+                    walls.vertices.push_back(Vertex{glm::vec3(p0.x, bottom, p0.y), normal});
+                    walls.vertices.push_back(Vertex{glm::vec3(p1.x, bottom, p1.y), normal});
+                    walls.vertices.push_back(Vertex{glm::vec3(p1.x, top, p1.y), normal});
+                    walls.vertices.push_back(Vertex{glm::vec3(p0.x, top, p0.y), normal});
+                    mAddTriangle(walls, b, b + 1, b + 2, normal);
+                    mAddTriangle(walls, b, b + 2, b + 3, normal);
+                }
+            }
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::mAddLines(U32 rule, const MvtReader::Feature& feature) {
+            if (feature.type != MvtReader::LINESTRING && feature.type != MvtReader::POLYGON) {
+                return;
+            }
+            for (U32 part = 0; part < feature.getPartCount(); ++part) {
+                U32 begin = feature.getPartBegin(part);
+                mAddLine(rule, &feature.points[begin], feature.getPartEnd(part) - begin,
+                         feature.type == MvtReader::POLYGON);
+            }
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::mAddLine(U32 rule, const glm::vec2* points, U32 count, bool closed) {
+            if (count * 2 > MAX_BUCKET_VERTICES) {
+                // in pieces sharing an end point.
+                U32 half = count / 2;
+                mAddLine(rule, points, half + 1, false);
+                mAddLine(rule, points + half, count - half, false);
+                if (closed) {
+                    glm::vec2 closing[] = {points[count - 1], points[0]};
+                    mAddLine(rule, closing, 2, false);
+                }
+                return;
+            }
+
+            mLine.clear();
+            for (U32 i = 0; i < count; ++i) {
+                glm::vec2 point = mToMeters(points[i]);
+                if (mLine.empty() || point != mLine.back()) {
+                    mLine.push_back(point);
+                }
+            }
+            if (closed && mLine.size() > 1 && mLine.front() == mLine.back()) {
+                mLine.pop_back();
+            }
+            const U32 n = (U32) mLine.size();
+            closed &= n > 2;
+            if (n < 2) {
+                return;
+            }
+
+            const VectorStyle::Rule& style = mStyle.getRules()[rule];
+            const F32 halfWidth = style.width / 2.0f;
+            const F32 y = style.order * ORDER_HEIGHT;
+            Bucket& bucket = *mGetBucket(rule, n * 2);
+            U32 base = (U32) bucket.vertices.size();
+            for (U32 i = 0; i < n; ++i) {
+                bool hasPrev = closed || i > 0;
+                bool hasNext = closed || i + 1 < n;
+                glm::vec2 prevNormal, nextNormal;
+                if (hasPrev) {
+                    glm::vec2 d = glm::normalize(mLine[i] - mLine[i > 0 ? i - 1 : n - 1]);
+                    prevNormal = glm::vec2(-d.y, d.x);
+                }
+                if (hasNext) {
+                    glm::vec2 d = glm::normalize(mLine[i + 1 < n ? i + 1 : 0] - mLine[i]);
+                    nextNormal = glm::vec2(-d.y, d.x);
+                }
+                if (!hasPrev) {
+                    prevNormal = nextNormal;
+                } else if (!hasNext) {
+                    nextNormal = prevNormal;
+                }
+
+                // miter join
+                glm::vec2 miter = prevNormal + nextNormal;
+                F32 miterLength = glm::length(miter);
+                F32 offset = halfWidth;
+                if (miterLength < 1e-4f) {
+                    miter = nextNormal; // u-turn
+                } else {
+                    miter /= miterLength;
+                    offset = halfWidth / glm::max(glm::dot(miter, nextNormal), 1.0f / MITER_LIMIT);
+                }
+                const glm::vec2 left = mLine[i] + miter * offset;
+                const glm::vec2 right = mLine[i] - miter * offset;
+                bucket.vertices.push_back(Vertex{glm::vec3(left.x, y, left.y), UP});
+                bucket.vertices.push_back(Vertex{glm::vec3(right.x, y, right.y), UP});
+            }
+            const U32 segmentCount = closed ? n : n - 1;
+            for (U32 i = 0; i < segmentCount; ++i) {
+                U16 a = (U16) (base + 2 * i);
+                U16 b = (U16) (base + 2 * ((i + 1) % n));
+                mAddTriangle(bucket, a, (U16) (a + 1), b, UP);
+                mAddTriangle(bucket, b, (U16) (a + 1), (U16) (b + 1), UP);
+            }
+        }
+
+
+        //------------------------------------------------------------------------------------------
+        void VectorTileBuilder::mAddTriangle(Bucket& bucket, U16 a, U16 b, U16 c, const glm::vec3& normal) {
+            // counter-clockwise when seen from the side the normal points to.
+            const glm::vec3& pa = bucket.vertices[a].position;
+            const glm::vec3 face = glm::cross(bucket.vertices[b].position - pa, bucket.vertices[c].position - pa);
+            if (glm::dot(face, normal) < 0.0f) {
+                std::swap(b, c);
+            }
+            bucket.indices.push_back(a);
+            bucket.indices.push_back(b);
+            bucket.indices.push_back(c);
+        }
+    }
+}
@@ -32,7 +32,8 @@ namespace dma {
     Camera::Camera() :
             mAnimationComponent(mTransformComponent),
             mCurrentTranslationAnimation(nullptr),
-            mCurrentSlerpAnimation(nullptr)
+            mCurrentSlerpAnimation(nullptr),
+            mDirty(true)
     {
         mView = glm::lookAt(glm::vec3(0.0f, 0.0, 7.0f),
                             glm::vec3(0.0f, 0.0f, 0.0f),
@@ -57,6 +58,7 @@ namespace dma {
         mFrustum.setPerspective(fovy, aspect, zNear, zFar);
         mBaseFov = fovy;
         mZoom = 1.0f;
+        mDirty = true;
     }
 
 
@@ -159,22 +161,24 @@ namespace dma {
 
 
     //--------------------------------------------------------------------------
-    void Camera::update(float dt) {
+    bool Camera::update(float dt) {
         mAnimationComponent.update(dt);
-        if (mDirty || mTransformComponent.isDirty()) {
-            mView = mTransformComponent.getOrientationMatrix() *
-                    glm::translate(glm::mat4(1.0f), -mTransformComponent.getPosition());
+        if (!mDirty && !mTransformComponent.isDirty()) {
+            return false;
+        }
+        mView = mTransformComponent.getOrientationMatrix() *
+                glm::translate(glm::mat4(1.0f), -mTransformComponent.getPosition());
 
-            glm::vec3 d = glm::vec3(0.0f, 0.0f, -1.0f) * mTransformComponent.getOrientationQuat();// * glm::vec3(1.0f, 0.0f, 0.0f);
-            d = glm::normalize(d);
+        glm::vec3 d = glm::vec3(0.0f, 0.0f, -1.0f) * mTransformComponent.getOrientationQuat();// * glm::vec3(1.0f, 0.0f, 0.0f);
+        d = glm::normalize(d);
 
-            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f) * mTransformComponent.getOrientationQuat();
-            up = glm::normalize(up);
+        glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f) * mTransformComponent.getOrientationQuat();
+        up = glm::normalize(up);
 
-            mFrustum.update(mTransformComponent.getPosition(), d, up);
+        mFrustum.update(mTransformComponent.getPosition(), d, up);
 
-            mDirty = false;
-            mTransformComponent.setDirty(false);
-        }
+        mDirty = false;
+        mTransformComponent.setDirty(false);
+        return true;
     }
 }
@@ -81,10 +81,11 @@ namespace dma {
 
 
     //-------------------------------------------------
-    void FlyThroughCamera::update(float dt) {
+    bool FlyThroughCamera::update(float dt) {
         mAnimationComponent.update(dt);
 
-        if (mDirty || mTransformComponent.isDirty()) {
+        bool changed = mDirty || mTransformComponent.isDirty();
+        if (changed) {
             float cosPitch = (float) cos(glm::radians(mPitch));
             float cosPitch90 = (float) cos(glm::radians(mPitch + 90.0f));
             float sinPitch = (float) sin(glm::radians(mPitch));
@@ -110,5 +111,6 @@ namespace dma {
             mDirty = false;
             mTransformComponent.setDirty(false);
         }
+        return changed;
     }
 }
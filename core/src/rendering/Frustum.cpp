@@ -53,7 +53,7 @@ namespace dma {
         // update projection matrix
         mProjection = glm::perspective(glm::radians(fovy), aspect, zNear, zFar);
 
-        //Log::debug(TAG, "nw=%f, nh=%f, fw=%f, fh=%f", nw, nh, fw, fh);
+        //LOG_DEBUG(TAG, "nw=%f, nh=%f, fw=%f, fh=%f", nw, nh, fw, fh);
     }
 
 
@@ -115,7 +115,7 @@ namespace dma {
 
         for (int i = 0; i < 6; i++) {
             distance = mPlanes[i].distance(center);
-            //Log::debug(TAG, "PLANE=%d   |||   distance = %f  |  radius = %f  |  center = %f %f %f", i, distance, radius, center.x, center.y, center.z);
+            //LOG_DEBUG(TAG, "PLANE=%d   |||   distance = %f  |  radius = %f  |  center = %f %f %f", i, distance, radius, center.x, center.y, center.z);
             if (distance > radius) {
                 return false;
             }
@@ -20,6 +20,6 @@
 
 namespace dma {
 
-
+    constexpr U32 HUDElement::NO_SLOT;
 
 }
\ No newline at end of file
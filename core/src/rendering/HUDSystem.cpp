@@ -16,17 +16,30 @@
 
 
 
+#include <algorithm>
+#include "glm/gtc/matrix_transform.hpp"
+
 #include "rendering/HUDSystem.hpp"
+#include "utils/GLUtils.hpp"
 
 #define HUD_ELEMENT_MATERIAL "hud"
 
+constexpr auto TAG = "HUDSystem";
+/** elements the buffers are created for, at least */
+constexpr dma::U32 MIN_CAPACITY = 16;
+
 namespace dma {
 
     //----------------------------------------------------------------------------
     HUDSystem::HUDSystem(ResourceManager& resourceManager) :
             mV(glm::mat4(1.0f)),
             mP(glm::mat4(1.0f)),
-            mResourceManager(resourceManager)
+            mResourceManager(resourceManager),
+            mVertexBuffer(0),
+            mIndexBuffer(0),
+            mCapacity(0),
+            mDirtyBegin(0),
+            mDirtyEnd(0)
     {}
 
 
@@ -45,24 +58,173 @@ namespace dma {
 
     //----------------------------------------------------------------------------
     void HUDSystem::addHUDElement(std::shared_ptr<HUDElement> hudElement) {
+        assert(hudElement->mSlot == HUDElement::NO_SLOT && "HUD element added twice");
+        if (mMaterial == nullptr) {
+            Status status;
+            mMaterial = mResourceManager.createMaterial(HUD_ELEMENT_MATERIAL, &status);
+        }
+        hudElement->mSlot = (U32) mHUDElements.size();
+        mHUDElements.push_back(hudElement);
+        mVertices.resize(mHUDElements.size() * 4);
+        mWriteQuad(*hudElement);
+    }
 
-        std::shared_ptr<Quad> quad = mResourceManager.createQuad(hudElement->width, hudElement->height);
-        Status status;
-        std::shared_ptr<Material> mat = mResourceManager.acquireMaterial(HUD_ELEMENT_MATERIAL, &status);
-        mat->getPass(0).setDiffuseMap(mResourceManager.acquireMap(hudElement->textureSID));
 
-        std::shared_ptr<Entity> entity = std::make_shared<Entity>(quad, mat);
-        entity->setPosition(glm::vec3(hudElement->x + hudElement->width / 2.0f, hudElement->y - hudElement->height / 2.0f, 0.0f));
-        entity->setScale(quad->getScale());
-        entity->update(0.0f);
-        hudElement->mEntity = entity;
-        mHUDElements.push_back(hudElement);
+    //----------------------------------------------------------------------------
+    void HUDSystem::updateHUDElement(const HUDElement& hudElement) {
+        assert(hudElement.mSlot < mHUDElements.size() && mHUDElements[hudElement.mSlot].get() == &hudElement);
+        mWriteQuad(hudElement);
+    }
+
+
+    //----------------------------------------------------------------------------
+    void HUDSystem::removeHUDElement(const std::shared_ptr<HUDElement>& hudElement) {
+        const U32 slot = hudElement->mSlot;
+        if (slot >= mHUDElements.size() || mHUDElements[slot] != hudElement) {
+            LOG_WARN(TAG, "Trying to remove a HUD element that was not added");
+            return;
+        }
+        // the last element takes the slot.
+        const U32 last = (U32) mHUDElements.size() - 1;
+        if (slot != last) {
+            mHUDElements[slot] = mHUDElements[last];
+            mHUDElements[slot]->mSlot = slot;
+            std::copy(mVertices.begin() + last * 4, mVertices.begin() + last * 4 + 4, mVertices.begin() + slot * 4);
+            mDirtyBegin = std::min(mDirtyBegin, slot);
+            mDirtyEnd = std::max(mDirtyEnd, slot + 1);
+        }
+        mHUDElements.pop_back();
+        mVertices.resize(mHUDElements.size() * 4);
+        mDirtyEnd = std::min(mDirtyEnd, (U32) mHUDElements.size());
+        hudElement->mSlot = HUDElement::NO_SLOT;
+    }
+
+
+    //----------------------------------------------------------------------------
+    void HUDSystem::refresh() {
+        if (glIsBuffer(mVertexBuffer) != GL_TRUE) {
+            mVertexBuffer = 0;
+            mIndexBuffer = 0;
+            mCapacity = 0;
+        }
+        if (glIsTexture(mAtlas.getHandle()) != GL_TRUE) {
+            mAtlas.invalidate();
+        }
+        mReportMemory();
     }
 
 
     //----------------------------------------------------------------------------
     void HUDSystem::unload() {
+        for (const std::shared_ptr<HUDElement>& hudElement : mHUDElements) {
+            hudElement->mSlot = HUDElement::NO_SLOT;
+        }
         mHUDElements.clear();
+        mVertices.clear();
+        if (mVertexBuffer != 0 && GLUtils::hasGlContext()) {
+            glDeleteBuffers(1, &mVertexBuffer);
+            glDeleteBuffers(1, &mIndexBuffer);
+        }
+        mVertexBuffer = 0;
+        mIndexBuffer = 0;
+        mCapacity = 0;
+        mDirtyBegin = mDirtyEnd = 0;
+        mAtlas.unload();
+        mMaterial = nullptr;
+        mReportMemory();
+    }
+
+
+    //----------------------------------------------------------------------------
+    void HUDSystem::mWriteQuad(const HUDElement& hudElement) {
+        SpriteAtlas::Region region;
+        if (hudElement.textureSID.empty()) {
+            // the atlas padding is transparent.
+            region.uvMin = region.uvMax = glm::vec2(0.0f);
+        } else if (!mAtlas.find(hudElement.textureSID, &region)) {
+            std::shared_ptr<Map> map = mResourceManager.acquireMap(hudElement.textureSID);
+            // the map may have released its image, see Map::setRetention.
+            Image* image = map != nullptr ? map->restoreImage() : nullptr;
+            if (image == nullptr || !mAtlas.add(hudElement.textureSID, *image, &region)) {
+                LOG_WARN(TAG, "HUD texture %s not available, the element is not drawn", hudElement.textureSID.c_str());
+                region.uvMin = region.uvMax = glm::vec2(0.0f);
+            }
+            if (map != nullptr) {
+                map->releaseImage();
+            }
+        }
+
+        // (x, y) is the top left corner
+        const F32 left = (F32) hudElement.x;
+        const F32 right = (F32) (hudElement.x + hudElement.width);
+        const F32 top = (F32) hudElement.y;
+        const F32 bottom = (F32) (hudElement.y - hudElement.height);
+        Vertex* quad = &mVertices[hudElement.mSlot * 4];
+        quad[0] = Vertex{glm::vec2(left, bottom), region.uvMin};
+        quad[1] = Vertex{glm::vec2(left, top), glm::vec2(region.uvMin.x, region.uvMax.y)};
+        quad[2] = Vertex{glm::vec2(right, top), region.uvMax};
+        quad[3] = Vertex{glm::vec2(right, bottom), glm::vec2(region.uvMax.x, region.uvMin.y)};
+
+        if (mDirtyBegin >= mDirtyEnd) {
+            mDirtyBegin = hudElement.mSlot;
+            mDirtyEnd = hudElement.mSlot + 1;
+        } else {
+            mDirtyBegin = std::min(mDirtyBegin, hudElement.mSlot);
+            mDirtyEnd = std::max(mDirtyEnd, hudElement.mSlot + 1);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------
+    void HUDSystem::mUpload() {
+        const U32 count = (U32) mHUDElements.size();
+        bool allocated = false;
+        if (mVertexBuffer == 0 || count > mCapacity) {
+            allocated = true;
+            // grown by doubling: adding elements one by one does not reallocate each time.
+            mCapacity = std::max(std::max(count, mCapacity * 2), MIN_CAPACITY);
+            assert(mCapacity * 4 <= 65536 && "too many HUD elements for 16 bits indices");
+            std::vector<GLushort> indices(mCapacity * 6);
+            for (U32 i = 0; i < mCapacity; ++i) {
+                const GLushort v = (GLushort) (i * 4);
+                const GLushort quad[6] = {v, (GLushort) (v + 2), (GLushort) (v + 1),
+                                          v, (GLushort) (v + 3), (GLushort) (v + 2)};
+                std::copy(quad, quad + 6, indices.begin() + i * 6);
+            }
+            if (mVertexBuffer == 0) {
+                glGenBuffers(1, &mVertexBuffer);
+                glGenBuffers(1, &mIndexBuffer);
+            }
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+            glBufferData(GL_ARRAY_BUFFER, mCapacity * 4 * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+            mDirtyBegin = 0;
+            mDirtyEnd = count;
+        } else {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+        }
+
+        if (mDirtyBegin < mDirtyEnd) {
+            glBufferSubData(GL_ARRAY_BUFFER, mDirtyBegin * 4 * sizeof(Vertex),
+                            (mDirtyEnd - mDirtyBegin) * 4 * sizeof(Vertex), &mVertices[mDirtyBegin * 4]);
+        }
+        mDirtyBegin = mDirtyEnd = 0;
+        if (mAtlas.upload() || allocated) {
+            mReportMemory();
+        }
+    }
+
+
+    //----------------------------------------------------------------------------
+    void HUDSystem::mReportMemory() {
+        MemoryUsage buffers;
+        if (mVertexBuffer != 0) {
+            buffers.add(mVertices.capacity() * sizeof(Vertex), mCapacity * (4 * sizeof(Vertex) + 6 * sizeof(GLushort)));
+        }
+        mResourceManager.setMemoryUsage(MemoryReport::HUD_BUFFER, buffers);
+        mResourceManager.setMemoryUsage(MemoryReport::SPRITE_ATLAS, mAtlas.getMemoryUsage());
     }
 
 }
@@ -58,7 +58,7 @@ namespace dma {
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, mSizeInByte, source);
 //        int size;
 //        glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
-//        Log::debug(TAG, "size=%d", size);
+//        LOG_DEBUG(TAG, "size=%d", size);
     }
 
     void IndexBuffer::wipe() {
@@ -0,0 +1,460 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/LabelSystem.hpp"
+#include "utils/GLUtils.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "LabelSystem";
+/** drawn instead of the characters missing from a font */
+constexpr dma::U32 REPLACEMENT_CHARACTER = '?';
+
+namespace dma {
+
+    constexpr U32 LabelSystem::LAYOUT_CACHE_SIZE;
+    constexpr U32 LabelSystem::GRID_CELL_SIZE;
+    constexpr U32 LabelSystem::BATCH_SIZE;
+
+    /* ================= ROUTINES ========================*/
+
+    //------------------------------------------------------------------------
+    /**
+     * Decodes the next code point of an utf-8 string. Invalid bytes are returned as is.
+     */
+    static U32 nextCodePoint(const std::string& text, size_t& i) {
+        const U8 c = (U8) text[i++];
+        U32 length = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+        if (length == 0 || i + length > text.size()) {
+            return c;
+        }
+        U32 code = c & (0x3F >> length);
+        for (U32 k = 0; k < length; ++k) {
+            code = (code << 6) | ((U8) text[i++] & 0x3F);
+        }
+        return code;
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    LabelSystem::LabelSystem(ResourceManager& resourceManager) :
+            mResourceManager(resourceManager),
+            mP(glm::mat4(1.0f)),
+            mViewportWidth(0),
+            mViewportHeight(0),
+            mCollisionEnabled(true),
+            mFrame(0),
+            mGridWidth(0),
+            mGridHeight(0),
+            mVertexBuffer(0),
+            mIndexBuffer(0),
+            mBufferSize(0),
+            mLabelCount(0),
+            mDrawnCount(0),
+            mRejectedCount(0)
+    {}
+
+
+    //------------------------------------------------------------------------
+    LabelSystem::~LabelSystem() {
+        unload();
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::setViewport(U32 width, U32 height) {
+        mViewportWidth = width;
+        mViewportHeight = height;
+        mP = glm::ortho(0.0f, (float) width, 0.0f, (float) height);
+        mGridWidth = width / GRID_CELL_SIZE + 1;
+        mGridHeight = height / GRID_CELL_SIZE + 1;
+        mGrid.resize(mGridWidth * mGridHeight);
+    }
+
+
+    //------------------------------------------------------------------------
+    LabelSystem::Stats LabelSystem::getStats() const {
+        Stats stats = {};
+        std::vector<Font*> fonts;
+        for (const auto& kv : mLayouts) {
+            const Layout& layout = kv.second;
+            stats.layoutBytes += (U32) (sizeof(Layout) + kv.first.capacity() + layout.glyphs.capacity() * sizeof(Glyph));
+            if (layout.font != nullptr && std::find(fonts.begin(), fonts.end(), layout.font.get()) == fonts.end()) {
+                fonts.push_back(layout.font.get());
+                stats.glyphCount += layout.font->getGlyphCount();
+                stats.atlasBytes += layout.font->getAtlasBytes();
+            }
+        }
+        stats.fontCount = (U32) fonts.size();
+        stats.layoutCount = (U32) mLayouts.size();
+        stats.bufferBytes = mBufferSize + (mIndexBuffer != 0 ? BATCH_SIZE * 6 * sizeof(GLushort) : 0);
+        stats.labelCount = mLabelCount;
+        stats.drawnCount = mDrawnCount;
+        stats.rejectedCount = mRejectedCount;
+        stats.drawCalls = (U32) mBatches.size();
+        return stats;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::refresh() {
+        if (glIsBuffer(mVertexBuffer) != GL_TRUE) {
+            mVertexBuffer = 0;
+            mIndexBuffer = 0;
+            mBufferSize = 0;
+            mReportMemory();
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::unload() {
+        if (mVertexBuffer != 0 && GLUtils::hasGlContext()) {
+            glDeleteBuffers(1, &mVertexBuffer);
+            glDeleteBuffers(1, &mIndexBuffer);
+        }
+        mVertexBuffer = 0;
+        mIndexBuffer = 0;
+        mBufferSize = 0;
+        mReportMemory();
+        mLayouts.clear();
+        mItems.clear();
+        mReserved.clear();
+        mRects.clear();
+        mVertices.clear();
+        mBatches.clear();
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mBegin() {
+        ++mFrame;
+        mTrimCache();
+        mItems.clear();
+        mReserved.clear();
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mAddLabel(const Label& label, const glm::vec2& anchor, F32 depth) {
+        const Layout* layout = mGetLayout(label);
+        if (layout == nullptr) {
+            return;
+        }
+        Item item;
+        item.layout = layout;
+        item.scale = label.size / layout->font->getSize();
+        // whole pixels keep the glyphs sharp.
+        item.origin = glm::floor(glm::vec2(anchor.x, anchor.y - item.scale * layout->min.y) + 0.5f);
+        item.color = label.color;
+        item.priority = label.priority;
+        item.depth = depth;
+        item.reserved = false;
+        mItems.push_back(item);
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mAddScreenLabel(const Label& label, const glm::vec2& center) {
+        const Layout* layout = mGetLayout(label);
+        if (layout == nullptr) {
+            return;
+        }
+        Item item;
+        item.layout = layout;
+        item.scale = label.size / layout->font->getSize();
+        item.origin = glm::floor(center - item.scale * 0.5f * (layout->min + layout->max) + 0.5f);
+        item.color = label.color;
+        item.priority = label.priority;
+        item.depth = 0.0f;
+        item.reserved = true;
+        mItems.push_back(item);
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mReserve(const glm::vec2& min, const glm::vec2& max) {
+        mReserved.push_back(Rect{min, max});
+    }
+
+
+    //------------------------------------------------------------------------
+    U32 LabelSystem::mBuild() {
+        mBatches.clear();
+        mVertices.clear();
+        mLabelCount = (U32) mItems.size();
+        mDrawnCount = 0;
+        mRejectedCount = 0;
+        if (mItems.empty()) {
+            return 0;
+        }
+
+        //////////////////////////////////////////////
+        // 1. Place labels, HUD ones first, then by priority and distance.
+        std::sort(mItems.begin(), mItems.end());
+        mRects.clear();
+        for (std::vector<U32>& cell : mGrid) {
+            cell.clear();
+        }
+        for (const Rect& rect : mReserved) {
+            mInsert(rect);
+        }
+
+        const glm::vec2 viewport((F32) mViewportWidth, (F32) mViewportHeight);
+        U32 kept = 0;
+        for (const Item& item : mItems) {
+            const Rect rect = {item.origin + item.scale * item.layout->min, item.origin + item.scale * item.layout->max};
+            if (rect.max.x < 0.0f || rect.max.y < 0.0f || rect.min.x > viewport.x || rect.min.y > viewport.y) {
+                continue;
+            }
+            if (mCollisionEnabled) {
+                if (!item.reserved && mOverlaps(rect)) {
+                    ++mRejectedCount;
+                    continue;
+                }
+                mInsert(rect);
+            }
+            mItems[kept++] = item;
+        }
+        mItems.resize(kept);
+        mDrawnCount = kept;
+
+        //////////////////////////////////////////////
+        // 2. Write the glyph quads, grouped by font.
+        std::stable_sort(mItems.begin(), mItems.end(), [](const Item& a, const Item& b) {
+            return a.layout->font.get() < b.layout->font.get();
+        });
+        U32 glyphCount = 0;
+        Font* batchFont = nullptr;
+        for (const Item& item : mItems) {
+            Font& font = *item.layout->font;
+            // labels are kept in one batch when they fit.
+            if (&font != batchFont || mBatches.back().count + item.layout->glyphs.size() > BATCH_SIZE) {
+                mBatches.push_back(Batch{font.getHandle(), glyphCount, 0});
+                batchFont = &font;
+            }
+            const F32 smoothing = 0.25f / (font.getRange() * item.scale);
+            U8 color[4];
+            for (U32 c = 0; c < 4; ++c) {
+                color[c] = (U8) (255.0f * glm::clamp(item.color[c], 0.0f, 1.0f) + 0.5f);
+            }
+            for (const Glyph& glyph : item.layout->glyphs) {
+                // labels longer than a batch are split, 16 bits indices cannot reach further.
+                if (mBatches.back().count == BATCH_SIZE) {
+                    mBatches.push_back(Batch{font.getHandle(), glyphCount, 0});
+                }
+                const glm::vec2 min = item.origin + item.scale * glyph.min;
+                const glm::vec2 max = item.origin + item.scale * glyph.max;
+                const Vertex quad[4] = {
+                        {glm::vec3(min.x, min.y, smoothing), glyph.uvMin, {color[0], color[1], color[2], color[3]}},
+                        {glm::vec3(max.x, min.y, smoothing), glm::vec2(glyph.uvMax.x, glyph.uvMin.y), {color[0], color[1], color[2], color[3]}},
+                        {glm::vec3(max.x, max.y, smoothing), glyph.uvMax, {color[0], color[1], color[2], color[3]}},
+                        {glm::vec3(min.x, max.y, smoothing), glm::vec2(glyph.uvMin.x, glyph.uvMax.y), {color[0], color[1], color[2], color[3]}},
+                };
+                mVertices.insert(mVertices.end(), quad, quad + 4);
+                ++mBatches.back().count;
+                ++glyphCount;
+            }
+        }
+
+        mUpload();
+        return (U32) mBatches.size();
+    }
+
+
+    //------------------------------------------------------------------------
+    const LabelSystem::Layout* LabelSystem::mGetLayout(const Label& label) {
+        if (label.text.empty() || label.size <= 0.0f) {
+            return nullptr;
+        }
+        std::string key = label.font;
+        key.push_back('\0');
+        key += label.text;
+        auto it = mLayouts.find(key);
+        if (it == mLayouts.end()) {
+            Layout layout;
+            Status status;
+            layout.font = mResourceManager.acquireFont(label.font, &status);
+            if (layout.font != nullptr) {
+                mLayout(*layout.font, label.text, layout);
+            }
+            // also cached if the font is missing, not to look for it every frame.
+            it = mLayouts.insert(std::make_pair(std::move(key), std::move(layout))).first;
+        }
+        it->second.lastUse = mFrame;
+        return it->second.font != nullptr && !it->second.glyphs.empty() ? &it->second : nullptr;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mLayout(const Font& font, const std::string& text, Layout& layout) const {
+        layout.glyphs.clear();
+        layout.min = glm::vec2(0.0f, font.getAscender() - font.getLineHeight());
+        layout.max = glm::vec2(0.0f, font.getAscender());
+
+        size_t i = 0;
+        size_t lineStart = 0;
+        F32 x = 0.0f;
+        F32 baseline = 0.0f;
+        while (i <= text.size()) {
+            const U32 code = i < text.size() ? nextCodePoint(text, i) : (++i, '\n');
+            if (code == '\n') {
+                // centers the line
+                const F32 offset = -0.5f * x;
+                for (size_t g = lineStart; g < layout.glyphs.size(); ++g) {
+                    layout.glyphs[g].min.x += offset;
+                    layout.glyphs[g].max.x += offset;
+                }
+                layout.min.x = glm::min(layout.min.x, offset);
+                layout.max.x = glm::max(layout.max.x, -offset);
+                lineStart = layout.glyphs.size();
+                x = 0.0f;
+                if (i <= text.size()) {
+                    baseline -= font.getLineHeight();
+                    layout.min.y -= font.getLineHeight();
+                }
+                continue;
+            }
+            const Font::Glyph* fontGlyph = font.getGlyph(code);
+            if (fontGlyph == nullptr) {
+                fontGlyph = font.getGlyph(REPLACEMENT_CHARACTER);
+                if (fontGlyph == nullptr) {
+                    continue;
+                }
+            }
+            if (fontGlyph->size.x > 0.0f) {
+                Glyph glyph;
+                glyph.min = glm::vec2(x, baseline) + fontGlyph->offset;
+                glyph.max = glyph.min + fontGlyph->size;
+                glyph.uvMin = fontGlyph->uvMin;
+                glyph.uvMax = fontGlyph->uvMax;
+                layout.glyphs.push_back(glyph);
+            }
+            x += fontGlyph->advance;
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    bool LabelSystem::mOverlaps(const Rect& rect) const {
+        const U32 x0 = (U32) glm::clamp((I32) (rect.min.x / GRID_CELL_SIZE), 0, (I32) mGridWidth - 1);
+        const U32 x1 = (U32) glm::clamp((I32) (rect.max.x / GRID_CELL_SIZE), 0, (I32) mGridWidth - 1);
+        const U32 y0 = (U32) glm::clamp((I32) (rect.min.y / GRID_CELL_SIZE), 0, (I32) mGridHeight - 1);
+        const U32 y1 = (U32) glm::clamp((I32) (rect.max.y / GRID_CELL_SIZE), 0, (I32) mGridHeight - 1);
+        for (U32 y = y0; y <= y1; ++y) {
+            for (U32 x = x0; x <= x1; ++x) {
+                for (U32 index : mGrid[y * mGridWidth + x]) {
+                    const Rect& other = mRects[index];
+                    if (rect.min.x < other.max.x && other.min.x < rect.max.x
+                        && rect.min.y < other.max.y && other.min.y < rect.max.y) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mInsert(const Rect& rect) {
+        if (mGrid.empty()) {
+            return;
+        }
+        const U32 x0 = (U32) glm::clamp((I32) (rect.min.x / GRID_CELL_SIZE), 0, (I32) mGridWidth - 1);
+        const U32 x1 = (U32) glm::clamp((I32) (rect.max.x / GRID_CELL_SIZE), 0, (I32) mGridWidth - 1);
+        const U32 y0 = (U32) glm::clamp((I32) (rect.min.y / GRID_CELL_SIZE), 0, (I32) mGridHeight - 1);
+        const U32 y1 = (U32) glm::clamp((I32) (rect.max.y / GRID_CELL_SIZE), 0, (I32) mGridHeight - 1);
+        const U32 index = (U32) mRects.size();
+        mRects.push_back(rect);
+        for (U32 y = y0; y <= y1; ++y) {
+            for (U32 x = x0; x <= x1; ++x) {
+                mGrid[y * mGridWidth + x].push_back(index);
+            }
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mUpload() {
+        if (mIndexBuffer == 0) {
+            std::vector<GLushort> indices(BATCH_SIZE * 6);
+            for (U32 i = 0; i < BATCH_SIZE; ++i) {
+                const GLushort v = (GLushort) (i * 4);
+                const GLushort quad[6] = {v, (GLushort) (v + 1), (GLushort) (v + 2),
+                                          v, (GLushort) (v + 2), (GLushort) (v + 3)};
+                std::copy(quad, quad + 6, indices.begin() + i * 6);
+            }
+            glGenBuffers(1, &mIndexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+            glGenBuffers(1, &mVertexBuffer);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+
+        const U32 size = (U32) (mVertices.size() * sizeof(Vertex));
+        glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+        if (size > mBufferSize) {
+            glBufferData(GL_ARRAY_BUFFER, size, mVertices.data(), GL_STREAM_DRAW);
+            mBufferSize = size;
+            mReportMemory();
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, mVertices.data());
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mReportMemory() {
+        MemoryUsage usage;
+        if (mIndexBuffer != 0) {
+            usage.add(mVertices.capacity() * sizeof(Vertex), mBufferSize + BATCH_SIZE * 6 * sizeof(GLushort));
+        }
+        mResourceManager.setMemoryUsage(MemoryReport::LABEL_BUFFER, usage);
+    }
+
+
+    //------------------------------------------------------------------------
+    void LabelSystem::mTrimCache() {
+        if (mLayouts.size() <= LAYOUT_CACHE_SIZE) {
+            return;
+        }
+        // drops the layouts not used by the last frame, oldest first, down to 3/4 of the cache.
+        std::vector<U32> uses;
+        uses.reserve(mLayouts.size());
+        for (const auto& kv : mLayouts) {
+            uses.push_back(kv.second.lastUse);
+        }
+        const size_t dropped = mLayouts.size() - LAYOUT_CACHE_SIZE * 3 / 4;
+        std::nth_element(uses.begin(), uses.begin() + dropped - 1, uses.end());
+        const U32 threshold = glm::min(uses[dropped - 1], mFrame >= 2 ? mFrame - 2 : 0);
+        for (auto it = mLayouts.begin(); it != mLayouts.end();) {
+            if (it->second.lastUse <= threshold) {
+                it = mLayouts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
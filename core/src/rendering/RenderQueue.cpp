@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "rendering/RenderQueue.hpp"
+
+#include <algorithm>
+#include <cstring>  // memcpy
+
+namespace dma {
+
+    /** entries reserved by the first push of a frame, at least */
+    constexpr U32 MIN_CAPACITY = 64;
+    /** the keys are sorted 8 bits at a time */
+    constexpr U32 RADIX_BITS = 8;
+    constexpr U32 RADIX_SIZE = 1 << RADIX_BITS;
+    constexpr U32 RADIX_PASSES = 32 / RADIX_BITS;
+
+
+    /* ================= ROUTINES ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    static inline U32 depthBits(F32 depth) {
+        // the bits of a non-negative float sort as the float does. Also maps NaN to 0.
+        if (!(depth > 0.0f)) {
+            return 0;
+        }
+        U32 bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        // the sign bit is always 0.
+        return bits << 1;
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    RenderQueue::RenderQueue(Order order, FrameAllocator& allocator) :
+            mOrder(order),
+            mAllocator(allocator),
+            mEntries(nullptr),
+            mCount(0),
+            mCapacity(0),
+            mLastCount(0) {
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    RenderQueue::~RenderQueue() {
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void RenderQueue::push(RenderingPackage* package, U32 transforms, F32 depth, U32 state) {
+        if (mCount == mCapacity) {
+            mGrow();
+        }
+        Entry& e = mEntries[mCount++];
+        if (mOrder == Order::FRONT_TO_BACK) {
+            // 24 bits of depth, then the state.
+            e.key = (depthBits(depth) & 0xFFFFFF00) | (state & 0xFF);
+        } else {
+            e.key = ~depthBits(depth);
+        }
+        e.transforms = transforms;
+        e.package = package;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void RenderQueue::sort() {
+        if (mCount < 2) {
+            return;
+        }
+        // least significant digit first, all histograms in a single read.
+        U32 histograms[RADIX_PASSES][RADIX_SIZE];
+        memset(histograms, 0, sizeof(histograms));
+        for (U32 i = 0; i < mCount; ++i) {
+            const U32 key = mEntries[i].key;
+            for (U32 pass = 0; pass < RADIX_PASSES; ++pass) {
+                ++histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)];
+            }
+        }
+
+        Entry* src = mEntries;
+        Entry* dst = nullptr;
+        for (U32 pass = 0; pass < RADIX_PASSES; ++pass) {
+            const U32 shift = pass * RADIX_BITS;
+            U32* offsets = histograms[pass];
+            // all keys share this digit: the pass would not move anything.
+            if (offsets[(src[0].key >> shift) & (RADIX_SIZE - 1)] == mCount) {
+                continue;
+            }
+            U32 offset = 0;
+            for (U32 digit = 0; digit < RADIX_SIZE; ++digit) {
+                const U32 count = offsets[digit];
+                offsets[digit] = offset;
+                offset += count;
+            }
+            if (dst == nullptr) {
+                dst = mAllocator.allocate<Entry>(mCount);
+            }
+            for (U32 i = 0; i < mCount; ++i) {
+                dst[offsets[(src[i].key >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        if (src != mEntries) {
+            mEntries = src;
+            mCapacity = mCount;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void RenderQueue::clear() {
+        if (mEntries != nullptr) {
+            mLastCount = mCount;
+        }
+        mEntries = nullptr;
+        mCount = 0;
+        mCapacity = 0;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    void RenderQueue::mGrow() {
+        const U32 capacity = std::max(std::max(mCapacity * 2, mLastCount), MIN_CAPACITY);
+        Entry* entries = mAllocator.allocate<Entry>(capacity);
+        if (mCount > 0) {
+            memcpy(entries, mEntries, mCount * sizeof(Entry));
+        }
+        // the previous entries are reclaimed by the allocator reset.
+        mEntries = entries;
+        mCapacity = capacity;
+    }
+}
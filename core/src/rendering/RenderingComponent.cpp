@@ -25,24 +25,23 @@ namespace dma {
     /* ================= ROUTINES ========================*/
 
     //---------------------------------------------------------------------
-    void assertMeshMaterialCompatible(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material) {
+    void assertMeshMaterialCompatible(std::shared_ptr<Mesh> mesh, std::shared_ptr<MaterialInstance> material) {
 
         for (U8 i = 0; i < material->getPassCount(); ++i) {
-            Pass& pass = material->getPass(i);
             ///////////////////////////////////////////////////
             // Check if mesh has position element (required)
             if (!mesh->hasVertexElement(VertexElement::Semantic::POSITION)) {
                 throw std::runtime_error("Transform required but mesh doesn't have position element");
             }
 
-            if (pass.hasFunc(Pass::Func::LIGHTING_FLAT)) {
+            if (material->hasFunc(i, Pass::Func::LIGHTING_FLAT)) {
                 ////////////////////////////////////////////////
                 // Check if mesh has flat normal element
                 if (!mesh->hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)) {
                     throw std::runtime_error("Flat lighting computation required but mesh doesn't have flat normal element");
                 }
             }
-            if (pass.hasFunc(Pass::Func::LIGHTING_SMOOTH)) {
+            if (material->hasFunc(i, Pass::Func::LIGHTING_SMOOTH)) {
                 ////////////////////////////////////////////////
                 // Check if mesh has smooth normal element
                 if (!mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL)) {
@@ -50,7 +49,7 @@ namespace dma {
                 }
             }
 
-            if (pass.hasFunc(Pass::Func::DIFFUSE_MAP)) {
+            if (material->hasFunc(i, Pass::Func::DIFFUSE_MAP)) {
                 ////////////////////////////////////////////////
                 // Check if mesh has uv element
                 if (!mesh->hasVertexElement(VertexElement::Semantic::UV)) {
@@ -58,7 +57,7 @@ namespace dma {
                 }
             }
 
-            if (pass.hasFunc(Pass::Func::SCALING)) {
+            if (material->hasFunc(i, Pass::Func::SCALING)) {
                 ////////////////////////////////////////////////
                 // Check if mesh has smooth normal element
                 if (!mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL)) {
@@ -71,14 +70,19 @@ namespace dma {
     /* ================= PUBLIC ========================*/
 
     //---------------------------------------------------------------------
-    RenderingComponent::RenderingComponent(const glm::mat4& M,
+    RenderingComponent::RenderingComponent(const TransformComponent& transformComponent,
                                            std::shared_ptr<Mesh> mesh,
-                                           std::shared_ptr<Material> material) :
-            mMesh(mesh)
+                                           std::shared_ptr<MaterialInstance> material) :
+            mTransformComponent(transformComponent),
+            mMesh(mesh),
+            mIdleAnimated(false),
+            mIdlePhase(0.0f),
+            mIdleAmplitude(0.0f),
+            mImpostorPass(-1)
     {
         // Check requirements
         assertMeshMaterialCompatible(mesh, material);
-        RenderingPackage* rp = new RenderingPackage(M, mesh, material);
+        RenderingPackage* rp = new RenderingPackage(mesh, material);
         mRenderingPackages.push_back(rp);
     }
 
@@ -93,12 +97,54 @@ namespace dma {
 
     //---------------------------------------------------------------------
     void RenderingComponent::setMesh(std::shared_ptr<Mesh> mesh) {
+        // also culled with its bounding sphere.
+        mMesh = mesh;
         mRenderingPackages[0]->setMesh(mesh); //TODO handle multiple submeshes
     }
 
 
     //---------------------------------------------------------------------
-    void RenderingComponent::setMaterial(std::shared_ptr<Material> material) {
+    void RenderingComponent::setMaterial(std::shared_ptr<MaterialInstance> material) {
         mRenderingPackages[0]->setMaterial(material);
     }
+
+
+    //---------------------------------------------------------------------
+    void RenderingComponent::updateTransforms(const glm::mat4& V, const glm::mat4& P, U32 viewRevision) const {
+        U32 modelRevision = mTransformComponent.getRevision();
+        if (mTransforms.modelRevision == modelRevision && mTransforms.viewRevision == viewRevision) {
+            return;
+        }
+        mTransforms.MV = V * mTransformComponent.getM();
+        mTransforms.MVP = P * mTransforms.MV;
+        mTransforms.N = glm::transpose(glm::inverse(glm::mat3(mTransforms.MV)));
+        if (mIdleAnimated) {
+            // the up axis, brought back into model space.
+            const glm::mat3 toModel = glm::inverse(glm::mat3(mTransformComponent.getM()));
+            const glm::vec3 up = toModel * glm::vec3(0.0f, 1.0f, 0.0f);
+            mTransforms.idleBob = glm::vec4(up * mIdleAmplitude, mIdlePhase);
+            mTransforms.idleAxis = glm::normalize(up);
+        } else {
+            mTransforms.idleBob = glm::vec4(0.0f);
+            mTransforms.idleAxis = glm::vec3(0.0f);
+        }
+        mTransforms.modelRevision = modelRevision;
+        mTransforms.viewRevision = viewRevision;
+    }
+
+
+    //---------------------------------------------------------------------
+    void RenderingComponent::setIdleAnimation(float phase, float amplitude) {
+        mIdleAnimated = true;
+        mIdlePhase = phase;
+        mIdleAmplitude = amplitude;
+        mTransforms.viewRevision = 0; // computed again on the next frame
+    }
+
+
+    //---------------------------------------------------------------------
+    void RenderingComponent::clearIdleAnimation() {
+        mIdleAnimated = false;
+        mTransforms.viewRevision = 0;
+    }
 }
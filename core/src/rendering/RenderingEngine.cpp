@@ -16,7 +16,9 @@
 
 
 
-#include <cstring>  // strlen
+#include <algorithm>
+#include <cmath>    // fmod
+#include <cstddef>  // offsetof
 
 #include "rendering/RenderingEngine.hpp"
 
@@ -39,7 +41,22 @@ namespace dma {
 
     /* ================= ROUTINES ========================*/
 
+    /** the time uniform wraps every hour: periods of shader animations must divide it. */
+    constexpr double TIME_PERIOD = 3600.0;
+    constexpr char IMPOSTOR_SHADER[] = "impostor";
+    constexpr char LABEL_SHADER[] = "sdf";
+    /** space between a label and the component it is drawn over, in pixels */
+    constexpr F32 LABEL_MARGIN = 4.0f;
+    /** billboards drawn by a draw call at most, for their vertices to be indexed on 16 bits. */
+    constexpr U32 IMPOSTOR_BATCH_SIZE = 65536 / 4;
+    static const glm::vec2 IMPOSTOR_CORNERS[4] = {
+            glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f)
+    };
+
     //------------------------------------------------------------------------
+    static inline bool hasFunc(U32 funcFlags, Pass::Func func) {
+        return (funcFlags & (1L << func)) != 0;
+    }
 
 
 
@@ -47,12 +64,33 @@ namespace dma {
 
     //------------------------------------------------------------------------
     RenderingEngine::RenderingEngine(ResourceManager& resourceManager) :
+            mResourceManager(resourceManager),
             mHUDSystem(resourceManager),
+            mLabelSystem(resourceManager),
             mSkyBox(nullptr),
+            mSkyBoxAllowed(true),
+            mInvalidated(true),
+            mAnimated(false),
+            mTime(0.0f),
+            mLightRevision(1),
+            mLightEyeRevision(0),
+            mCurrentProgram(0),
+            mUniformUploadCount(0),
+            mUniformSkipCount(0),
             mV(NULL),
             mP(NULL),
-            mAspectRatio(0.0f)
-    {}
+            mAspectRatio(0.0f),
+            mSceneViewRevision(1),
+            mBuildList(0),
+            mDrawList(0),
+            mImpostorProgramMissing(false),
+            mImpostorVertexBuffer(0),
+            mImpostorIndexBuffer(0),
+            mImpostorBufferSize(0),
+            mImpostorCount(0),
+            mLabelProgramMissing(false)
+    {
+    }
 
 
     //------------------------------------------------------------------------
@@ -77,6 +115,23 @@ namespace dma {
         glFrontFace(GL_CCW);
         glEnable(GL_DEPTH_TEST);
         glClearColor(CLEAR_COLOR);
+        mInvalidated = true;
+
+        // vertex arrays recorded in a previous context are rebuilt on their next draw.
+        VertexArray::init();
+
+        // force the light upload.
+        ++mLightRevision;
+
+        // billboard buffers of a previous context are created again on the next draw.
+        if (glIsBuffer(mImpostorVertexBuffer) != GL_TRUE || glIsBuffer(mImpostorIndexBuffer) != GL_TRUE) {
+            mImpostorVertexBuffer = 0;
+            mImpostorIndexBuffer = 0;
+            mImpostorBufferSize = 0;
+            mReportImpostorMemory();
+        }
+        mHUDSystem.refresh();
+        mLabelSystem.refresh();
 
         return STATUS_OK;
     }
@@ -85,21 +140,32 @@ namespace dma {
 
     //------------------------------------------------------------------------
     void RenderingEngine::unload() {
-        Log::trace(TAG, "Unloading RenderingEngine...");
+        LOG_TRACE(TAG, "Unloading RenderingEngine...");
 
         mHUDSystem.unload();
+        mLabelSystem.unload();
 
         // force program to not be used anymore, to ensure proper deletion.
         if (GLUtils::hasGlContext()) {
             glUseProgram(0);
+            if (mImpostorVertexBuffer != 0) {
+                glDeleteBuffers(1, &mImpostorVertexBuffer);
+                glDeleteBuffers(1, &mImpostorIndexBuffer);
+            }
         }
-        while (!mFrontToBack.empty()) {
-            mFrontToBack.pop();
-        }
-        while (!mBackToFront.empty()) {
-            mBackToFront.pop();
+        mImpostorVertexBuffer = 0;
+        mImpostorIndexBuffer = 0;
+        mImpostorBufferSize = 0;
+        mReportImpostorMemory();
+        mImpostorProgram = nullptr;
+        mImpostorProgramMissing = false;
+        mLabelProgram = nullptr;
+        mLabelProgramMissing = false;
+        mCurrentProgram = 0;
+        for (FrameList& list : mFrameLists) {
+            mClearFrameList(list);
         }
-        Log::trace(TAG, "RenderingEngine unloaded");
+        LOG_TRACE(TAG, "RenderingEngine unloaded");
     }
 
 
@@ -112,79 +178,172 @@ namespace dma {
         mAspectRatio = (F32) width / (F32) height;
         glViewport(0, 0, width, height);
         mHUDSystem.setViewport(width, height);
+        mLabelSystem.setViewport(width, height);
+        mInvalidated = true;
     }
 
 
     //------------------------------------------------------------------------
-    void RenderingEngine::subscribe(RenderingPackage* package, bool back2front, float distanceFromCamera) {
-        Entry e;
-        e.renderingPackage = package;
-        if (back2front) {
-            e.distance = distanceFromCamera; //the farthest first
-            mBackToFront.push(e);
+    void RenderingEngine::setTime(double seconds) {
+        mTime = (F32) fmod(seconds, TIME_PERIOD);
+    }
 
-        } else {
-            e.distance = -distanceFromCamera; //the closest first
-            mFrontToBack.push(e);
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::beginFrameList() {
+        assert (mV != NULL && "mV not set before building a frame list!");
+        assert (mP != NULL && "mP not set before building a frame list!");
+        FrameList& list = mFrameLists[mBuildList];
+        mClearFrameList(list);
+        list.V = *mV;
+        list.P = *mP;
+        if (list.V != mLastV || list.P != mLastP) {
+            mLastV = list.V;
+            mLastP = list.P;
+            ++mSceneViewRevision;
         }
+        list.ready = true;
     }
 
 
     //------------------------------------------------------------------------
-    void RenderingEngine::subscribe(const RenderingComponent* component, float distanceFromCamera) {
-        for(RenderingPackage* rp : component->getRenderingPackages()) {
-            subscribe(rp, rp->isBackToFront(), distanceFromCamera);
+    void RenderingEngine::subscribe(const std::shared_ptr<Entity>& entity, float depth) {
+        FrameList& list = mFrameLists[mBuildList];
+        assert(list.ready && "beginFrameList not called before subscribing components");
+        const RenderingComponent* component = entity->getRenderingComponent();
+        component->updateTransforms(list.V, list.P, mSceneViewRevision);
+        const U32 transforms = (U32) list.transforms.size();
+        list.transforms.push_back(component->getTransforms());
+        for (RenderingPackage* rp : component->getRenderingPackages()) {
+            if (rp->isBackToFront()) {
+                list.backToFront.push(rp, transforms, depth, 0);
+            } else {
+                // packages at the same depth are grouped by program.
+                const MaterialInstance& material = *rp->mMaterial;
+                const ShaderProgram* program = material.getPassCount() > 0 ?
+                                               material.getPass(0).getShaderProgram().get() : nullptr;
+                list.frontToBack.push(rp, transforms, depth, program != nullptr ? program->getHandle() : 0);
+            }
         }
     }
 
 
+    //------------------------------------------------------------------------
+    void RenderingEngine::subscribeImpostor(const std::shared_ptr<Entity>& entity, const glm::vec3& center, F32 radius) {
+        FrameList& list = mFrameLists[mBuildList];
+        assert(list.ready && "beginFrameList not called before subscribing components");
+        const RenderingComponent* component = entity->getRenderingComponent();
+        assert(component->hasImpostor());
+
+        const std::shared_ptr<MaterialInstance>& material = component->getRenderingPackages()[0]->mMaterial;
+        U8 pass = component->getImpostorPass();
+        assert(pass < material->getPassCount());
+        Impostor impostor;
+        impostor.center = center;
+        impostor.radius = radius;
+        impostor.color = material->getDiffuseColor(pass);
+        impostor.map = material->hasFunc(pass, Pass::Func::DIFFUSE_MAP) && material->isDiffuseMapEnabled(pass) ?
+                       material->getDiffuseMap(pass).get() : nullptr;
+        list.impostors.push_back(impostor);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::subscribeLabel(const std::shared_ptr<Label>& label, const glm::vec3& center, F32 radius) {
+        FrameList& list = mFrameLists[mBuildList];
+        assert(list.ready && "beginFrameList not called before subscribing components");
+        list.labels.push_back(LabelEntry{label, center, radius});
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::retire(const std::shared_ptr<Entity>& entity) {
+        // only the list last built may still reference the entity, if not drawn yet.
+        // Otherwise, the caller releases it right away.
+        FrameList& list = mFrameLists[mBuildList];
+        if (list.ready) {
+            list.retired.push_back(entity);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::setDoubleBuffered(bool enabled) {
+        mBuildList = enabled ? 1 - mDrawList : mDrawList;
+        mClearFrameList(mFrameLists[1 - mDrawList]);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::swapFrameLists() {
+        std::swap(mBuildList, mDrawList);
+    }
+
+
     //------------------------------------------------------------------------
     void RenderingEngine::subscribeHUDElement(std::shared_ptr<HUDElement> hudElement) {
         mHUDSystem.addHUDElement(hudElement);
+        mInvalidated = true;
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::updateHUDElement(const HUDElement& hudElement) {
+        mHUDSystem.updateHUDElement(hudElement);
+        mInvalidated = true;
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::unsubscribeHUDElement(const std::shared_ptr<HUDElement>& hudElement) {
+        mHUDSystem.removeHUDElement(hudElement);
+        mInvalidated = true;
     }
 
 
     //------------------------------------------------------------------------
     void RenderingEngine::drawFrame() {
-        assert (mV != NULL && "mV not set before rendering starts!");
-        assert (mP != NULL && "mP not set before rendering starts!");
+        FrameList& list = mFrameLists[mDrawList];
         glDepthMask(GL_TRUE);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        ShaderProgram::resetUniformCounts();
+        mAnimated = false;
+        // programs may have been changed outside of the rendering engine.
+        mCurrentProgram = 0;
+        mUpdateLight(list.V);
+
         ///////////////////////////////////////////
         // 1. Draw front to back
-        while (!mFrontToBack.empty()) {
-            mDraw(mFrontToBack.top().renderingPackage, *mV, *mP);
-            mFrontToBack.pop();
+        list.frontToBack.sort();
+        for (const RenderQueue::Entry& e : list.frontToBack) {
+            mDraw(e.package, list.transforms[e.transforms]);
         }
+        mDrawImpostors(list);
 
         ///////////////////////////////////////////
         // 2. Draw the skybox (early depth testing) if any
-        if (mSkyBox) {
-            mDrawSkyBox();
+        if (mSkyBox && mSkyBoxAllowed) {
+            mDrawSkyBox(list.V, list.P);
         }
 
         ///////////////////////////////////////////
         // 3. Draw back to front
-        while (!mBackToFront.empty()) {
-            mDraw(mBackToFront.top().renderingPackage, *mV, *mP);
-            mBackToFront.pop();
+        list.backToFront.sort();
+        for (const RenderQueue::Entry& e : list.backToFront) {
+            mDraw(e.package, list.transforms[e.transforms]);
         }
+        mCollectLabels(list);
+        mClearFrameList(list);
 
 
         ///////////////////////////////////////////
-        // 4. Draw the HUD
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        for (auto hudElem : mHUDSystem.getHUDElements()) {
-            for (auto rp : hudElem->mEntity->getRenderingComponent()->getRenderingPackages()) {
-                mDraw(rp, mHUDSystem.mV, mHUDSystem.mP);
-                //mDraw(rp, *mV, *mP);
-            }
-        }
-        glDisable(GL_BLEND);
-        glEnable(GL_DEPTH_TEST);
+        // 4. Draw the HUD, and the labels over it
+        mDrawHUD();
+        mDrawLabels();
+        mInvalidated = false;
+        mUniformUploadCount = ShaderProgram::getUniformUploadCount();
+        mUniformSkipCount = ShaderProgram::getUniformSkipCount();
     }
 
 
@@ -192,40 +351,101 @@ namespace dma {
     /* ================= PRIVATE ========================*/
 
     //------------------------------------------------------------------------
-    void RenderingEngine::mDraw(RenderingPackage* package, const glm::mat4& V, const glm::mat4& P) {
+    void RenderingEngine::mClearFrameList(FrameList& list) {
+        list.transforms.clear();
+        list.impostors.clear();
+        list.labels.clear();
+        list.retired.clear();
+        list.frontToBack.clear();
+        list.backToFront.clear();
+        list.allocator.reset();
+        list.ready = false;
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mUpdateLight(const glm::mat4& V) {
+        if (V != mLightV) {
+            // the light is given in eye coordinates.
+            mLightV = V;
+            ++mLightRevision;
+        }
+        if (mLightEyeRevision == mLightRevision) {
+            return;
+        }
+        mLightEyePosition = V * glm::vec4(mLight.position, 1.0f);
+        mLightEyePosition.w = 0.0f;
+        mLightEyeRevision = mLightRevision;
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mUseProgram(const ShaderProgram& program) {
+        if (program.getHandle() != mCurrentProgram) {
+            glUseProgram(program.getHandle());
+            mCurrentProgram = program.getHandle();
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mSetupLight(ShaderProgram& program) {
+        if (!program.hasUniform(ShaderProgram::UniformSem::LIGHT0_POSITION)
+            || program.getLightRevision() == mLightRevision) {
+            return;
+        }
+        program.setUniform(ShaderProgram::UniformSem::LIGHT0_POSITION, mLightEyePosition);
+        program.setUniform(ShaderProgram::UniformSem::LIGHT0_AMBIENT, mLight.ambient);
+        program.setUniform(ShaderProgram::UniformSem::LIGHT0_DIFFUSE, mLight.diffuse);
+        program.setUniform(ShaderProgram::UniformSem::LIGHT0_SPECULAR, mLight.specular);
+        program.setLightRevision(mLightRevision);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDraw(RenderingPackage* package, const TransformCache& transforms) {
         GLUtils::clearGlErrors();
 
         assert(package != NULL);
 
-        std::shared_ptr<Mesh> mesh = package->mMesh;
-        std::shared_ptr<Material> material = package->mMaterial;
-
-        //Log::debug(TAG, "%s", glm::to_string(*(package->M)).c_str());
+        // references: no reference counting on the draw path.
+        const std::shared_ptr<Mesh>& mesh = package->mMesh;
+        const std::shared_ptr<MaterialInstance>& material = package->mMaterial;
 
-        const glm::mat4 MV = V * package->M;
-        const glm::mat4 MVP = P * MV;
-        const glm::mat3 N = glm::transpose(glm::inverse(glm::mat3(MV)));
+        // quantized positions are decoded by the transforms, unless the shader decodes them itself:
+        // computed by the first pass needing them. Normals are not affected.
+        const bool quantized = mesh->hasQuantizedPositions();
+        bool decoded = false;
+        glm::mat4 decodedMV;
+        glm::mat4 decodedMVP;
+        const glm::mat3& N = transforms.N;
 
 
         for (U8 i = 0; i < material->getPassCount(); ++i) {
 
-            Pass& pass = material->getPass(i);
+            const Pass& pass = material->getPass(i);
+            U32 funcFlags = material->getFuncFlags(i);
 
-            std::shared_ptr<ShaderProgram> shaderProgram = pass.getShaderProgram();
+            const std::shared_ptr<ShaderProgram>& shaderProgram = pass.getShaderProgram();
 
             assert(shaderProgram != NULL && "ShaderProgram is NULL before calling glUseProgram");
             assert(shaderProgram->getHandle() != 0 && "ShaderProgram handle is 0 before calling glUseProgram");
-            glUseProgram(shaderProgram->getHandle());
-
-            glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer().getHandle());
+            mUseProgram(*shaderProgram);
+
+            bool shaderDecode = shaderProgram->hasUniform(ShaderProgram::UniformSem::POSITION_DECODE);
+            bool decode = quantized && !shaderDecode;
+            if (decode && !decoded) {
+                decodedMV = transforms.MV * mesh->getPositionDecode();
+                decodedMVP = transforms.MVP * mesh->getPositionDecode();
+                decoded = true;
+            }
+            const glm::mat4& MV = decode ? decodedMV : transforms.MV;
+            const glm::mat4& MVP = decode ? decodedMVP : transforms.MVP;
 
             /////////////////////////////////////////////////////////////////////////
             // Setup rendering state according to the material functionalities.    //
             /////////////////////////////////////////////////////////////////////////
 
-            GLint attr;
-            U16 attribCount = 0;
-
             ////////////////////////////////////////////////////////////////////////////////////////////////////
             // Setup cull mode
             switch (pass.getCullMode()) {
@@ -257,143 +477,147 @@ namespace dma {
             // Setup Transform
 
             // Uniforms
-            glUniformMatrix4fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::MVP),
-                               1, GL_FALSE, glm::value_ptr(MVP));
-            // Attributes
-            // Positions
-            assert(mesh->hasVertexElement(VertexElement::Semantic::POSITION));
-            attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::POS);
-            mAttribIndices[attribCount++] = (GLuint) attr;
-            glEnableVertexAttribArray((GLuint) attr);
-            const VertexElement& positionElement = mesh->getVertexElement(VertexElement::Semantic::POSITION);
-            glVertexAttribPointer((GLuint) attr,
-                                  positionElement.getCount(),
-                                  positionElement.getType(),
-                                  GL_FALSE,
-                                  mesh->getVertexSize(),
-                                  ((GLvoid *) (U64) (positionElement.getOffset())));
+            shaderProgram->setUniform(ShaderProgram::UniformSem::MVP, MVP);
+            if (shaderDecode) {
+                shaderProgram->setUniform(ShaderProgram::UniformSem::POSITION_DECODE, mesh->getPositionDecode());
+            }
+
+            //////////////////////////////////////////////
+            // Setup idle animation, evaluated by the shader
+            if (shaderProgram->hasUniform(ShaderProgram::UniformSem::IDLE_BOB)) {
+                shaderProgram->setUniform(ShaderProgram::UniformSem::TIME, mTime);
+                shaderProgram->setUniform(ShaderProgram::UniformSem::IDLE_BOB, transforms.idleBob);
+                shaderProgram->setUniform(ShaderProgram::UniformSem::IDLE_AXIS, transforms.idleAxis);
+                mAnimated |= transforms.idleAxis != glm::vec3(0.0f);
+            }
 
 
             //////////////////////////////////////////////
             // Setup lighting computation
-            if (pass.hasFunc(Pass::Func::LIGHTING_FLAT)
-                || pass.hasFunc(Pass::Func::LIGHTING_SMOOTH)) {
+            if (material->hasFunc(i, Pass::Func::LIGHTING_FLAT)
+                || material->hasFunc(i, Pass::Func::LIGHTING_SMOOTH)) {
 
                 // Uniform
-                glUniformMatrix4fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::MV),
-                                   1, GL_FALSE, glm::value_ptr(MV));
-                glUniformMatrix3fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::N),
-                                   1, GL_FALSE, glm::value_ptr(N));
-                // Attributes
-                // Normal
-                assert(mesh->hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)
-                       || mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL));
-                attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::NORMAL);
-                mAttribIndices[attribCount++] = (GLuint) attr;
-                glEnableVertexAttribArray((GLuint) attr);
-                const VertexElement &normalElement = pass.hasFunc(Pass::LIGHTING_FLAT) ?
-                                                     mesh->getVertexElement(VertexElement::Semantic::FLAT_NORMAL) :
-                                                     mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
-                glVertexAttribPointer((GLuint) attr,
-                                      normalElement.getCount(),
-                                      normalElement.getType(),
-                                      GL_FALSE,
-                                      mesh->getVertexSize(),
-                                      ((GLvoid *) (U64) (normalElement.getOffset())));
+                shaderProgram->setUniform(ShaderProgram::UniformSem::MV, MV);
+                shaderProgram->setUniform(ShaderProgram::UniformSem::N, N);
             }
 
             //////////////////////////////////////////////
             // Setup diffuse map
-            if (pass.hasFunc(Pass::Func::DIFFUSE_MAP)) {
+            if (material->hasFunc(i, Pass::Func::DIFFUSE_MAP)) {
                 // active & bind texture
                 glActiveTexture(GL_TEXTURE0);
-                std::shared_ptr<Map> diffuseMap = pass.getDiffuseMap();
+                const std::shared_ptr<Map>& diffuseMap = material->getDiffuseMap(i);
+                if (diffuseMap->isRestorePending()) {
+                    // visible maps are restored first, whatever the restore budget.
+                    diffuseMap->refresh();
+                }
                 glBindTexture(GL_TEXTURE_2D, diffuseMap->getHandle());
-                glUniform1i(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::DM),
-                            0); //0 means GL_TEXTURE0
-                // Attributes
-                // UV
-                assert(mesh->hasVertexElement(VertexElement::Semantic::UV));
-                attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::UV);
-                mAttribIndices[attribCount++] = (GLuint) attr;
-                glEnableVertexAttribArray((GLuint) attr);
-                const VertexElement &uvElement = mesh->getVertexElement(VertexElement::Semantic::UV);
-                glVertexAttribPointer((GLuint) attr,
-                                      uvElement.getCount(),
-                                      uvElement.getType(),
-                                      GL_FALSE,
-                                      mesh->getVertexSize(),
-                                      ((GLvoid *) (U64) (uvElement.getOffset())));
-
-                if (pass.hasFunc(Pass::Func::DIFFUSE_MAP_ACTIVATION)) {
-                    glUniformMatrix4fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::MV),
-                                       1, GL_FALSE, glm::value_ptr(MV));
-                    glUniform1i(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::DM_ACTIVATION),
-                                pass.isDiffuseMapEnabled());
+                shaderProgram->setUniform(ShaderProgram::UniformSem::DM, 0); //0 means GL_TEXTURE0
+
+                if (material->hasFunc(i, Pass::Func::DIFFUSE_MAP_ACTIVATION)) {
+                    shaderProgram->setUniform(ShaderProgram::UniformSem::MV, MV);
+                    shaderProgram->setUniform(ShaderProgram::UniformSem::DM_ACTIVATION,
+                                              (GLint) material->isDiffuseMapEnabled(i));
                 }
             }
 
             //////////////////////////////////////////////
             // Setup scaling
-            if (pass.hasFunc(Pass::Func::SCALING)) {
+            if (material->hasFunc(i, Pass::Func::SCALING)) {
                 // Uniform
-                glUniformMatrix3fv(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::N),
-                                   1, GL_FALSE, glm::value_ptr(N));
-                // Attributes
-                // Normal
-                assert(mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL));
-                attr = shaderProgram->getAttributeLocation(ShaderProgram::AttribSem::NORMAL);
-                mAttribIndices[attribCount++] = (GLuint) attr;
-                glEnableVertexAttribArray((GLuint) attr);
-                const VertexElement &normalElement = mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
-                glVertexAttribPointer((GLuint) attr,
-                                      normalElement.getCount(),
-                                      normalElement.getType(),
-                                      GL_FALSE,
-                                      mesh->getVertexSize(),
-                                      ((GLvoid *) (U64) (normalElement.getOffset())));
+                shaderProgram->setUniform(ShaderProgram::UniformSem::N, N);
+            }
+
+            // shaders offsetting positions in model space must scale offsets like quantized positions.
+            if (shaderProgram->hasUniform(ShaderProgram::UniformSem::POSITION_SCALE)) {
+                shaderProgram->setUniform(ShaderProgram::UniformSem::POSITION_SCALE, mesh->getPositionScale());
             }
 
             //////////////////////////////////////////////
             // Setup diffuse color
-            if (pass.hasFunc(Pass::Func::DIFFUSE_COLOR)) {
+            if (material->hasFunc(i, Pass::Func::DIFFUSE_COLOR)) {
                 // Uniforms
-                const glm::vec3& diffuseColor = pass.getDiffuseColor();
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::DIFFUSE_COLOR),
-                            diffuseColor.r, diffuseColor.g, diffuseColor.b);
+                shaderProgram->setUniform(ShaderProgram::UniformSem::DIFFUSE_COLOR, material->getDiffuseColor(i));
             }
 
 
             //////////////////////////////////////////////
             // Setup lights
-            if (shaderProgram->hasUniform(ShaderProgram::UniformSem::LIGHT0_POSITION)) {
-                glm::vec4 lightPos = V * glm::vec4(mLight.position, 1.0f);
-                lightPos.w = 0.0f;
-                glUniform4f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_POSITION), lightPos.x, lightPos.y, lightPos.z, lightPos.w);
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_AMBIENT), mLight.ambient.r, mLight.ambient.g, mLight.ambient.b);
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_DIFFUSE), mLight.diffuse.r, mLight.diffuse.g, mLight.diffuse.b);
-                glUniform3f(shaderProgram->getUniformLocation(ShaderProgram::UniformSem::LIGHT0_SPECULAR), mLight.specular.r, mLight.specular.g, mLight.specular.b);
-            }
+            mSetupLight(*shaderProgram);
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->getIndexBuffer().getHandle());
+            //////////////////////////////////////////////
+            // Setup vertex attributes
+            const VertexArray* vertexArray = mesh->findVertexArray(*shaderProgram, funcFlags);
+            if (vertexArray == nullptr) {
+                mAttributes.clear();
+                mGetAttributes(*mesh, funcFlags, *shaderProgram, mAttributes);
+                vertexArray = &mesh->setVertexArray(*shaderProgram, funcFlags, mAttributes);
+            }
+            vertexArray->bind();
 
             glDrawElements(GL_TRIANGLES,
                            mesh->getIndexBuffer().getElementCount(),
                            GL_UNSIGNED_SHORT, 0);
 
+            vertexArray->unbind();
+        }
+    }
 
-            //////////////////////////////////////////////
-            // Disable vertex attrib arrays
-            for (U16 j = 0; j < attribCount; ++j) {
-                glDisableVertexAttribArray(mAttribIndices[j]);
-            }
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mGetAttributes(const Mesh& mesh, U32 funcFlags, const ShaderProgram& shaderProgram,
+                                         std::vector<VertexArray::Attribute>& attributes) const {
+        // Positions
+        assert(mesh.hasVertexElement(VertexElement::Semantic::POSITION));
+        mAddAttribute(mesh, mesh.getVertexElement(VertexElement::Semantic::POSITION),
+                      shaderProgram.getAttributeLocation(ShaderProgram::AttribSem::POS), attributes);
+
+        // Normals, for lighting
+        if (hasFunc(funcFlags, Pass::Func::LIGHTING_FLAT)
+            || hasFunc(funcFlags, Pass::Func::LIGHTING_SMOOTH)) {
+            assert(mesh.hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)
+                   || mesh.hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL));
+            const VertexElement &normalElement = hasFunc(funcFlags, Pass::LIGHTING_FLAT) ?
+                                                 mesh.getVertexElement(VertexElement::Semantic::FLAT_NORMAL) :
+                                                 mesh.getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
+            mAddAttribute(mesh, normalElement,
+                          shaderProgram.getAttributeLocation(ShaderProgram::AttribSem::NORMAL), attributes);
+        }
+
+        // UV, for the diffuse map
+        if (hasFunc(funcFlags, Pass::Func::DIFFUSE_MAP)) {
+            assert(mesh.hasVertexElement(VertexElement::Semantic::UV));
+            mAddAttribute(mesh, mesh.getVertexElement(VertexElement::Semantic::UV),
+                          shaderProgram.getAttributeLocation(ShaderProgram::AttribSem::UV), attributes);
+        }
+
+        // Normals, for scaling
+        if (hasFunc(funcFlags, Pass::Func::SCALING)) {
+            assert(mesh.hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL));
+            mAddAttribute(mesh, mesh.getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL),
+                          shaderProgram.getAttributeLocation(ShaderProgram::AttribSem::NORMAL), attributes);
         }
     }
 
 
     //------------------------------------------------------------------------
-    void RenderingEngine::mDrawSkyBox() {
-        glm::mat4 MVP = *mP * glm::mat4(glm::mat3(*mV)); //remove translation components
+    void RenderingEngine::mAddAttribute(const Mesh& mesh, const VertexElement& element, GLint location,
+                                        std::vector<VertexArray::Attribute>& attributes) const {
+        VertexArray::Attribute attribute;
+        attribute.index = (GLuint) location;
+        attribute.count = element.getCount();
+        attribute.type = element.getType();
+        attribute.normalized = element.isNormalized() ? GL_TRUE : GL_FALSE;
+        attribute.stride = mesh.getVertexSize();
+        attribute.offset = element.getOffset();
+        attributes.push_back(attribute);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawSkyBox(const glm::mat4& V, const glm::mat4& P) {
+        glm::mat4 MVP = P * glm::mat4(glm::mat3(V)); //remove translation components
 
         glDisable(GL_CULL_FACE);
         glDepthMask(GL_FALSE);
@@ -401,7 +625,7 @@ namespace dma {
 
         std::shared_ptr<ShaderProgram> program = mSkyBox->getShaderProgram();
 
-        glUseProgram(program->getHandle());
+        mUseProgram(*program);
 
         glBindBuffer(GL_ARRAY_BUFFER, mSkyBox->getVertexBuffer().getHandle());
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mSkyBox->getIndexBuffer().getHandle());
@@ -409,10 +633,9 @@ namespace dma {
         glActiveTexture(GL_TEXTURE0);
 
         // Uniforms
-        glUniformMatrix4fv(program->getUniformLocation(ShaderProgram::UniformSem::MVP),
-                           1, GL_FALSE, glm::value_ptr(MVP));
+        program->setUniform(ShaderProgram::UniformSem::MVP, MVP);
         glBindTexture(GL_TEXTURE_CUBE_MAP, mSkyBox->getCubeMap()->getHandle());
-        glUniform1i(program->getUniformLocation(ShaderProgram::UniformSem::CUBE_MAP), 0); //0 means GL_TEXTURE0
+        program->setUniform(ShaderProgram::UniformSem::CUBE_MAP, 0); //0 means GL_TEXTURE0
         // Attributes
         // UV
         GLuint attr = (GLuint) program->getAttributeLocation(ShaderProgram::AttribSem::POS);
@@ -432,4 +655,259 @@ namespace dma {
         glDepthMask(GL_TRUE);
         glDepthFunc(GL_LESS); // Set depth function back to default
     }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawImpostors(FrameList& list) {
+        mImpostorCount = 0;
+        if (list.impostors.empty() || mImpostorProgramMissing) {
+            return;
+        }
+        if (mImpostorProgram == nullptr) {
+            Status status;
+            mImpostorProgram = mResourceManager.acquireShaderProgram(IMPOSTOR_SHADER, &status);
+            if (status != STATUS_OK || !mImpostorProgram->hasAttribute(ShaderProgram::AttribSem::COLOR)) {
+                Log::error(TAG, "cannot load the %s shader: billboards will not be drawn", IMPOSTOR_SHADER);
+                mImpostorProgram = nullptr;
+                mImpostorProgramMissing = true;
+                return;
+            }
+        }
+
+        //////////////////////////////////////////////
+        // Batch: billboards sharing a map are drawn together.
+        std::sort(list.impostors.begin(), list.impostors.end());
+        const U32 count = (U32) list.impostors.size();
+        mImpostorVertices.resize(count * 4);
+        for (U32 i = 0; i < count; ++i) {
+            const Impostor& impostor = list.impostors[i];
+            for (U32 c = 0; c < 4; ++c) {
+                ImpostorVertex& vertex = mImpostorVertices[i * 4 + c];
+                vertex.center = impostor.center;
+                vertex.corner = IMPOSTOR_CORNERS[c];
+                vertex.color = glm::vec4(impostor.color, impostor.radius);
+            }
+        }
+
+        if (mImpostorIndexBuffer == 0) {
+            std::vector<GLushort> indices(IMPOSTOR_BATCH_SIZE * 6);
+            for (U32 i = 0; i < IMPOSTOR_BATCH_SIZE; ++i) {
+                const GLushort v = (GLushort) (i * 4);
+                const GLushort quad[6] = {v, (GLushort) (v + 1), (GLushort) (v + 2),
+                                          v, (GLushort) (v + 2), (GLushort) (v + 3)};
+                std::copy(quad, quad + 6, indices.begin() + i * 6);
+            }
+            glGenBuffers(1, &mImpostorIndexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mImpostorIndexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+            glGenBuffers(1, &mImpostorVertexBuffer);
+        }
+
+        // one dynamic vertex buffer, grown when needed.
+        const U32 size = (U32) (mImpostorVertices.size() * sizeof(ImpostorVertex));
+        glBindBuffer(GL_ARRAY_BUFFER, mImpostorVertexBuffer);
+        if (size > mImpostorBufferSize) {
+            glBufferData(GL_ARRAY_BUFFER, size, mImpostorVertices.data(), GL_STREAM_DRAW);
+            mImpostorBufferSize = size;
+            mReportImpostorMemory();
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, mImpostorVertices.data());
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mImpostorIndexBuffer);
+
+        //////////////////////////////////////////////
+        // Setup
+        ShaderProgram& program = *mImpostorProgram;
+        mUseProgram(program);
+        program.setUniform(ShaderProgram::UniformSem::MV, list.V);
+        program.setUniform(ShaderProgram::UniformSem::MVP, list.P * list.V);
+        program.setUniform(ShaderProgram::UniformSem::DM, 0);
+        glDisable(GL_CULL_FACE);
+        glDepthMask(GL_TRUE);
+        glActiveTexture(GL_TEXTURE0);
+
+        const GLuint position = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::POS);
+        const GLuint corner = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::UV);
+        const GLuint color = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::COLOR);
+        glEnableVertexAttribArray(position);
+        glEnableVertexAttribArray(corner);
+        glEnableVertexAttribArray(color);
+
+        //////////////////////////////////////////////
+        // Draw, per batch of IMPOSTOR_BATCH_SIZE, then per map
+        for (U32 batch = 0; batch < count; batch += IMPOSTOR_BATCH_SIZE) {
+            const U32 batchEnd = glm::min(count, batch + IMPOSTOR_BATCH_SIZE);
+            const U64 offset = (U64) batch * 4 * sizeof(ImpostorVertex);
+            glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, sizeof(ImpostorVertex),
+                                  (GLvoid*) (offset + offsetof(ImpostorVertex, center)));
+            glVertexAttribPointer(corner, 2, GL_FLOAT, GL_FALSE, sizeof(ImpostorVertex),
+                                  (GLvoid*) (offset + offsetof(ImpostorVertex, corner)));
+            glVertexAttribPointer(color, 4, GL_FLOAT, GL_FALSE, sizeof(ImpostorVertex),
+                                  (GLvoid*) (offset + offsetof(ImpostorVertex, color)));
+
+            U32 first = batch;
+            while (first < batchEnd) {
+                Map* map = list.impostors[first].map;
+                U32 last = first + 1;
+                while (last < batchEnd && list.impostors[last].map == map) {
+                    ++last;
+                }
+                if (map != nullptr) {
+                    if (map->isRestorePending()) {
+                        map->refresh();
+                    }
+                    glBindTexture(GL_TEXTURE_2D, map->getHandle());
+                }
+                program.setUniform(ShaderProgram::UniformSem::DM_ACTIVATION, (GLint) (map != nullptr));
+                glDrawElements(GL_TRIANGLES, (last - first) * 6, GL_UNSIGNED_SHORT,
+                               (GLvoid*) (U64) ((first - batch) * 6 * sizeof(GLushort)));
+                first = last;
+            }
+        }
+
+        glDisableVertexAttribArray(position);
+        glDisableVertexAttribArray(corner);
+        glDisableVertexAttribArray(color);
+        mImpostorCount = count;
+    }
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mReportImpostorMemory() {
+        MemoryUsage usage;
+        if (mImpostorIndexBuffer != 0) {
+            usage.add(mImpostorVertices.capacity() * sizeof(ImpostorVertex),
+                      mImpostorBufferSize + IMPOSTOR_BATCH_SIZE * 6 * sizeof(GLushort));
+        }
+        mResourceManager.setMemoryUsage(MemoryReport::IMPOSTOR_BUFFER, usage);
+    }
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawHUD() {
+        if (mHUDSystem.getHUDElements().empty() || mHUDSystem.mMaterial == nullptr) {
+            return;
+        }
+        mHUDSystem.mUpload();
+
+        //////////////////////////////////////////////
+        // Setup: all elements share the atlas, and the program of the HUD material.
+        ShaderProgram& program = *mHUDSystem.mMaterial->getPass(0).getShaderProgram();
+        mUseProgram(program);
+        program.setUniform(ShaderProgram::UniformSem::MVP, mHUDSystem.mP * mHUDSystem.mV);
+        program.setUniform(ShaderProgram::UniformSem::DM, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, mHUDSystem.mAtlas.getHandle());
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        const GLuint position = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::POS);
+        const GLuint uv = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::UV);
+        glEnableVertexAttribArray(position);
+        glEnableVertexAttribArray(uv);
+        glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, sizeof(HUDSystem::Vertex),
+                              (GLvoid*) offsetof(HUDSystem::Vertex, position));
+        glVertexAttribPointer(uv, 2, GL_FLOAT, GL_FALSE, sizeof(HUDSystem::Vertex),
+                              (GLvoid*) offsetof(HUDSystem::Vertex, uv));
+
+        //////////////////////////////////////////////
+        // Draw, in one call
+        glDrawElements(GL_TRIANGLES, (GLsizei) mHUDSystem.getHUDElements().size() * 6, GL_UNSIGNED_SHORT, 0);
+
+        glDisableVertexAttribArray(position);
+        glDisableVertexAttribArray(uv);
+        glDisable(GL_BLEND);
+        glEnable(GL_DEPTH_TEST);
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mCollectLabels(const FrameList& list) {
+        mLabelSystem.mBegin();
+
+        // HUD elements are kept clear of labels, and their own labels always drawn.
+        for (const std::shared_ptr<HUDElement>& hudElement : mHUDSystem.getHUDElements()) {
+            const glm::vec2 min((F32) hudElement->x, (F32) (hudElement->y - hudElement->height));
+            const glm::vec2 max((F32) (hudElement->x + hudElement->width), (F32) hudElement->y);
+            if (!hudElement->textureSID.empty()) {
+                mLabelSystem.mReserve(min, max);
+            }
+            mLabelSystem.mAddScreenLabel(hudElement->label, 0.5f * (min + max));
+        }
+
+        const glm::mat4 VP = list.P * list.V;
+        const glm::vec2 viewport((F32) mViewportWidth, (F32) mViewportHeight);
+        // on-screen radius of a sphere of radius 1 at a distance of 1, in pixels.
+        const F32 pixelScale = 0.5f * list.P[1][1] * viewport.y;
+        for (const LabelEntry& entry : list.labels) {
+            const glm::vec4 clip = VP * glm::vec4(entry.center, 1.0f);
+            if (clip.w <= 0.0f) {
+                continue;
+            }
+            glm::vec2 anchor = (0.5f + 0.5f * glm::vec2(clip) / clip.w) * viewport;
+            anchor.y += entry.radius * pixelScale / clip.w + LABEL_MARGIN;
+            mLabelSystem.mAddLabel(*entry.label, anchor, clip.w);
+        }
+    }
+
+
+    //------------------------------------------------------------------------
+    void RenderingEngine::mDrawLabels() {
+        if (mLabelProgramMissing) {
+            return;
+        }
+        const U32 batchCount = mLabelSystem.mBuild();
+        if (batchCount == 0) {
+            return;
+        }
+        if (mLabelProgram == nullptr) {
+            Status status;
+            mLabelProgram = mResourceManager.acquireShaderProgram(LABEL_SHADER, &status);
+            if (status != STATUS_OK || !mLabelProgram->hasAttribute(ShaderProgram::AttribSem::COLOR)) {
+                Log::error(TAG, "cannot load the %s shader: labels will not be drawn", LABEL_SHADER);
+                mLabelProgram = nullptr;
+                mLabelProgramMissing = true;
+                return;
+            }
+        }
+
+        //////////////////////////////////////////////
+        // Setup
+        ShaderProgram& program = *mLabelProgram;
+        mUseProgram(program);
+        program.setUniform(ShaderProgram::UniformSem::MVP, mLabelSystem.mP);
+        program.setUniform(ShaderProgram::UniformSem::DM, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        const GLuint position = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::POS);
+        const GLuint uv = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::UV);
+        const GLuint color = (GLuint) program.getAttributeLocation(ShaderProgram::AttribSem::COLOR);
+        glEnableVertexAttribArray(position);
+        glEnableVertexAttribArray(uv);
+        glEnableVertexAttribArray(color);
+
+        //////////////////////////////////////////////
+        // Draw, per font
+        for (const LabelSystem::Batch& batch : mLabelSystem.mBatches) {
+            const U64 offset = (U64) batch.first * 4 * sizeof(LabelSystem::Vertex);
+            glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, sizeof(LabelSystem::Vertex),
+                                  (GLvoid*) (offset + offsetof(LabelSystem::Vertex, position)));
+            glVertexAttribPointer(uv, 2, GL_FLOAT, GL_FALSE, sizeof(LabelSystem::Vertex),
+                                  (GLvoid*) (offset + offsetof(LabelSystem::Vertex, uv)));
+            glVertexAttribPointer(color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LabelSystem::Vertex),
+                                  (GLvoid*) (offset + offsetof(LabelSystem::Vertex, color)));
+            glBindTexture(GL_TEXTURE_2D, batch.texture);
+            glDrawElements(GL_TRIANGLES, batch.count * 6, GL_UNSIGNED_SHORT, 0);
+        }
+
+        glDisableVertexAttribArray(position);
+        glDisableVertexAttribArray(uv);
+        glDisableVertexAttribArray(color);
+        glDisable(GL_BLEND);
+        glEnable(GL_DEPTH_TEST);
+    }
 }
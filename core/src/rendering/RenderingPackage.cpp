@@ -24,10 +24,8 @@ namespace dma {
 
         /* ================= PUBLIC ========================*/
 
-        RenderingPackage::RenderingPackage(const glm::mat4& M,
-                                           std::shared_ptr<Mesh> mesh,
-                                           std::shared_ptr<Material> material)  :
-                M(M),
+        RenderingPackage::RenderingPackage(std::shared_ptr<Mesh> mesh,
+                                           std::shared_ptr<MaterialInstance> material)  :
                 mMesh(mesh),
                 mMaterial(material)
         {}
@@ -74,7 +74,7 @@ namespace dma {
 
         /////////////////////////////////////////////////////////////////////////
         // Fills data
-        Log::debug(TAG, "%d, %d", positionElement.getSizeInByte(), positionElement.getOffset());
+        LOG_DEBUG(TAG, "%d, %d", positionElement.getSizeInByte(), positionElement.getOffset());
         for (U32 v = 0; v < vertexCount; ++v) {
             memcpy(&data[v * vertexSize + positionElement.getOffset()], &(positions[3*v]), positionElement.getSizeInByte());
         }
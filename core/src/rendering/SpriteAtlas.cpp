@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "rendering/SpriteAtlas.hpp"
+#include "utils/GLUtils.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "SpriteAtlas";
+
+namespace dma {
+
+    constexpr U32 SpriteAtlas::SIZE;
+    constexpr U32 SpriteAtlas::PADDING;
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    SpriteAtlas::SpriteAtlas() :
+            mShelfX(0),
+            mShelfY(0),
+            mShelfHeight(0),
+            mHandle(0),
+            mTextureSize(0),
+            mDirtyBegin(SIZE),
+            mDirtyEnd(0)
+    {}
+
+
+    //------------------------------------------------------------------------
+    SpriteAtlas::~SpriteAtlas() {
+    }
+
+
+    //------------------------------------------------------------------------
+    bool SpriteAtlas::add(const std::string& sid, Image& image, Region* region) {
+        if (find(sid, region)) {
+            return true;
+        }
+
+        U32 channels;
+        switch (image.getFormat()) {
+            case GL_LUMINANCE: channels = 1; break;
+            case GL_LUMINANCE_ALPHA: channels = 2; break;
+            case GL_RGB: channels = 3; break;
+            case GL_RGBA: channels = 4; break;
+            default:
+                Log::error(TAG, "unsupported format for image %s", sid.c_str());
+                return false;
+        }
+
+        // next free spot, on the current shelf or a new one above.
+        const U32 width = image.getWidth() + 2 * PADDING;
+        const U32 height = image.getHeight() + 2 * PADDING;
+        if (mShelfX + width > SIZE) {
+            mShelfY += mShelfHeight;
+            mShelfX = 0;
+            mShelfHeight = 0;
+        }
+        if (width > SIZE || mShelfY + height > SIZE) {
+            Log::error(TAG, "no room left for image %s (%dx%d)", sid.c_str(), image.getWidth(), image.getHeight());
+            return false;
+        }
+        if (mPixels.empty()) {
+            mPixels.assign(SIZE * SIZE * 4, 0);
+        }
+
+        const U32 x0 = mShelfX + PADDING;
+        const U32 y0 = mShelfY + PADDING;
+        const BYTE* source = image.getPixels();
+        for (U32 y = 0; y < image.getHeight(); ++y) {
+            for (U32 x = 0; x < image.getWidth(); ++x) {
+                const BYTE* s = source + (y * image.getWidth() + x) * channels;
+                BYTE* d = &mPixels[((y0 + y) * SIZE + x0 + x) * 4];
+                if (channels <= 2) {
+                    d[0] = d[1] = d[2] = s[0];
+                    d[3] = channels == 2 ? s[1] : (BYTE) 255;
+                } else {
+                    d[0] = s[0];
+                    d[1] = s[1];
+                    d[2] = s[2];
+                    d[3] = channels == 4 ? s[3] : (BYTE) 255;
+                }
+            }
+        }
+        mDirtyBegin = glm::min(mDirtyBegin, y0);
+        mDirtyEnd = glm::max(mDirtyEnd, y0 + image.getHeight());
+        mShelfX += width;
+        mShelfHeight = glm::max(mShelfHeight, height);
+
+        // texel centers, so that the border texels are not blended with the padding.
+        Region r;
+        r.uvMin = (glm::vec2(x0, y0) + 0.5f) / (F32) SIZE;
+        r.uvMax = (glm::vec2(x0 + image.getWidth(), y0 + image.getHeight()) - 0.5f) / (F32) SIZE;
+        mRegions[sid] = r;
+        if (region != nullptr) {
+            *region = r;
+        }
+        return true;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool SpriteAtlas::find(const std::string& sid, Region* region) const {
+        auto it = mRegions.find(sid);
+        if (it == mRegions.end()) {
+            return false;
+        }
+        if (region != nullptr) {
+            *region = it->second;
+        }
+        return true;
+    }
+
+
+    //------------------------------------------------------------------------
+    bool SpriteAtlas::upload() {
+        const U32 size = mPixels.empty() ? 1 : SIZE;
+        if (mHandle != 0 && mTextureSize == size && mDirtyBegin >= mDirtyEnd) {
+            return false;
+        }
+        if (mHandle == 0) {
+            glGenTextures(1, &mHandle);
+            glBindTexture(GL_TEXTURE_2D, mHandle);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            mTextureSize = 0;
+        } else {
+            glBindTexture(GL_TEXTURE_2D, mHandle);
+        }
+        const bool allocated = mTextureSize != size;
+        if (mPixels.empty()) {
+            static const BYTE placeholder[4] = {255, 255, 255, 0};
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+        } else if (allocated) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SIZE, SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, mPixels.data());
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, mDirtyBegin, SIZE, mDirtyEnd - mDirtyBegin, GL_RGBA, GL_UNSIGNED_BYTE,
+                            &mPixels[mDirtyBegin * SIZE * 4]);
+        }
+        mTextureSize = size;
+        mDirtyBegin = SIZE;
+        mDirtyEnd = 0;
+        return allocated;
+    }
+
+
+    //------------------------------------------------------------------------
+    MemoryUsage SpriteAtlas::getMemoryUsage() const {
+        MemoryUsage usage;
+        if (!mPixels.empty() || mHandle != 0) {
+            usage.add(mPixels.capacity(), mHandle != 0 ? mTextureSize * mTextureSize * 4 : 0);
+        }
+        return usage;
+    }
+
+
+    //------------------------------------------------------------------------
+    void SpriteAtlas::invalidate() {
+        mHandle = 0;
+        mTextureSize = 0;
+    }
+
+
+    //------------------------------------------------------------------------
+    void SpriteAtlas::unload() {
+        if (mHandle != 0 && GLUtils::hasGlContext()) {
+            glDeleteTextures(1, &mHandle);
+        }
+        mHandle = 0;
+        mTextureSize = 0;
+        mRegions.clear();
+        mPixels.clear();
+        mPixels.shrink_to_fit();
+        mShelfX = mShelfY = mShelfHeight = 0;
+        mDirtyBegin = SIZE;
+        mDirtyEnd = 0;
+    }
+}
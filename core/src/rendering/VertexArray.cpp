@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "rendering/VertexArray.hpp"
+#include "utils/GLUtils.hpp"
+#include "utils/Log.hpp"
+
+constexpr char TAG[] = "VertexArray";
+
+namespace dma {
+
+    U32 VertexArray::contextRevision = 0;
+
+    /* ================= ROUTINES ========================*/
+
+#ifdef GL_OES_vertex_array_object
+    static PFNGLGENVERTEXARRAYSOESPROC genVertexArrays = nullptr;
+    static PFNGLBINDVERTEXARRAYOESPROC bindVertexArray = nullptr;
+    static PFNGLDELETEVERTEXARRAYSOESPROC deleteVertexArrays = nullptr;
+#endif
+    static bool nativeSupported = false;
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    VertexArray::VertexArray() :
+            mHandle(0),
+            mVertexBuffer(0),
+            mIndexBuffer(0),
+            mContextRevision(0)
+    {}
+
+
+    //----------------------------------------------------------------------------------------------
+    VertexArray::~VertexArray() {
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void VertexArray::init() {
+        ++contextRevision;
+        nativeSupported = false;
+#ifdef GL_OES_vertex_array_object
+        if (GLUtils::isExtSupported("GL_OES_vertex_array_object")) {
+            genVertexArrays = (PFNGLGENVERTEXARRAYSOESPROC) GLUtils::getProcAddress("glGenVertexArraysOES");
+            bindVertexArray = (PFNGLBINDVERTEXARRAYOESPROC) GLUtils::getProcAddress("glBindVertexArrayOES");
+            deleteVertexArrays = (PFNGLDELETEVERTEXARRAYSOESPROC) GLUtils::getProcAddress("glDeleteVertexArraysOES");
+            nativeSupported = genVertexArrays && bindVertexArray && deleteVertexArrays;
+        }
+#endif
+        if (!nativeSupported) {
+            LOG_INFO(TAG, "OES_vertex_array_object not supported, vertex arrays will be emulated.");
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    bool VertexArray::isNativeSupported() {
+        return nativeSupported;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void VertexArray::build(GLuint vertexBuffer, GLuint indexBuffer, const std::vector<Attribute>& attributes) {
+        wipe();
+        mVertexBuffer = vertexBuffer;
+        mIndexBuffer = indexBuffer;
+        mContextRevision = contextRevision;
+        mAttributes = attributes;
+
+#ifdef GL_OES_vertex_array_object
+        if (nativeSupported) {
+            genVertexArrays(1, &mHandle);
+            bindVertexArray(mHandle);
+            glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+            for (const Attribute& attribute : mAttributes) {
+                glEnableVertexAttribArray(attribute.index);
+                glVertexAttribPointer(attribute.index,
+                                      attribute.count,
+                                      attribute.type,
+                                      attribute.normalized,
+                                      attribute.stride,
+                                      (GLvoid*) (U64) attribute.offset);
+            }
+            bindVertexArray(0);
+            // recorded in the vertex array: no need to replay them.
+            mAttributes.clear();
+        }
+#endif
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void VertexArray::bind() const {
+#ifdef GL_OES_vertex_array_object
+        if (mHandle != 0) {
+            bindVertexArray(mHandle);
+            return;
+        }
+#endif
+        glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+        for (const Attribute& attribute : mAttributes) {
+            glEnableVertexAttribArray(attribute.index);
+            glVertexAttribPointer(attribute.index,
+                                  attribute.count,
+                                  attribute.type,
+                                  attribute.normalized,
+                                  attribute.stride,
+                                  (GLvoid*) (U64) attribute.offset);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void VertexArray::unbind() const {
+#ifdef GL_OES_vertex_array_object
+        if (mHandle != 0) {
+            bindVertexArray(0);
+            return;
+        }
+#endif
+        for (const Attribute& attribute : mAttributes) {
+            glDisableVertexAttribArray(attribute.index);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    bool VertexArray::isValid(GLuint vertexBuffer, GLuint indexBuffer) const {
+        return mContextRevision == contextRevision
+               && mVertexBuffer == vertexBuffer
+               && mIndexBuffer == indexBuffer;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void VertexArray::wipe() {
+#ifdef GL_OES_vertex_array_object
+        // a vertex array from a previous context is already gone, and its handle may have been reused.
+        if (mHandle != 0 && mContextRevision == contextRevision) {
+            deleteVertexArrays(1, &mHandle);
+        }
+#endif
+        mHandle = 0;
+        mAttributes.clear();
+        mContextRevision = 0;
+    }
+}
@@ -42,7 +42,7 @@ namespace dma {
     void VertexBuffer::generateBuffer(U32 vertexSize, U32 sizeInByte) {
         mVertexSize = vertexSize;
         mSizeInByte = sizeInByte;
-        //Log::debug(TAG, "generating GL Buffer of size %d bytes...", mSizeInByte);
+        //LOG_DEBUG(TAG, "generating GL Buffer of size %d bytes...", mSizeInByte);
         glGenBuffers(1, &mHandle);
         glBindBuffer(GL_ARRAY_BUFFER, mHandle);
         glBufferData(GL_ARRAY_BUFFER, mSizeInByte, NULL, GL_STATIC_DRAW);
@@ -52,7 +52,7 @@ namespace dma {
 
     void VertexBuffer::writeData(U32 offset, U32 length, const void *source) {
         glBindBuffer(GL_ARRAY_BUFFER, mHandle);
-        //Log::info("offset=%d length=%d source=%p", offset, length, source);
+        //LOG_INFO("offset=%d length=%d source=%p", offset, length, source);
         glBufferSubData(GL_ARRAY_BUFFER, offset, length, source);
     }
 
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "resource/AssetPack.hpp"
+#include "utils/Utils.hpp"
+#include "utils/Log.hpp"
+#include "utils/ExceptionHandler.hpp"
+
+constexpr auto TAG = "AssetPack";
+
+namespace dma {
+
+    constexpr U32 AssetPack::VERSION;
+    constexpr U32 AssetPack::ALIGNMENT;
+
+    /* ================= ROUTINES ========================*/
+
+    static const char MAGIC[4] = {'A', 'R', 'P', 'K'};
+
+    //----------------------------------------------------------------------------------------------
+    static inline U32 align(U32 offset) {
+        return (offset + AssetPack::ALIGNMENT - 1) & ~(AssetPack::ALIGNMENT - 1);
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    AssetPack::AssetPack() :
+            mData(nullptr),
+            mSize(0),
+            mMapping(nullptr),
+            mMappingSize(0)
+    {}
+
+
+    //----------------------------------------------------------------------------------------------
+    AssetPack::~AssetPack() {
+        close();
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status AssetPack::open(const std::string& path) {
+        close();
+
+        Utils::countFileSyscall();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            Log::error(TAG, "Cannot open asset pack %s", path.c_str());
+            return throwException(TAG, ExceptionType::IO, "Cannot open asset pack " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            Log::error(TAG, "Invalid asset pack %s", path.c_str());
+            return throwException(TAG, ExceptionType::INVALID_FILE, "Invalid asset pack " + path);
+        }
+        Status status = open(fd, 0, (U64) info.st_size, path);
+        // the mapping remains valid once the file is closed.
+        ::close(fd);
+        return status;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status AssetPack::open(int fd, U64 offset, U64 length, const std::string& name) {
+        close();
+
+        if (length < sizeof(Header)) {
+            Log::error(TAG, "Invalid asset pack %s", name.c_str());
+            return throwException(TAG, ExceptionType::INVALID_FILE, "Invalid asset pack " + name);
+        }
+        // mmap offsets must be page-aligned: map from the start of the page holding the pack.
+        const U64 pageSize = (U64) sysconf(_SC_PAGESIZE);
+        const U64 delta = offset % pageSize;
+        void* mapping = mmap(nullptr, (size_t) (length + delta), PROT_READ, MAP_PRIVATE, fd, (off_t) (offset - delta));
+        if (mapping == MAP_FAILED) {
+            Log::error(TAG, "Cannot map asset pack %s", name.c_str());
+            return throwException(TAG, ExceptionType::IO, "Cannot map asset pack " + name);
+        }
+        mMapping = mapping;
+        mMappingSize = (size_t) (length + delta);
+        mData = (const BYTE*) mapping + delta;
+        mSize = (size_t) length;
+
+        // check the layout once, so that lookups do not have to.
+        const Header* header = (const Header*) mData;
+        bool valid = memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+                     && header->version == VERSION
+                     && sizeof(Header) + (size_t) header->entryCount * sizeof(Record) <= mSize
+                     && (size_t) header->namesOffset + header->namesSize <= mSize;
+        for (U32 i = 0; valid && i < header->entryCount; ++i) {
+            const Record& record = mRecords()[i];
+            valid = (size_t) record.nameOffset + record.nameLength <= header->namesSize
+                    && (size_t) record.dataOffset + record.dataSize <= mSize;
+        }
+        if (!valid) {
+            close();
+            Log::error(TAG, "Invalid asset pack %s", name.c_str());
+            return throwException(TAG, ExceptionType::INVALID_FILE, "Invalid asset pack " + name);
+        }
+
+        LOG_DEBUG(TAG, "Asset pack %s opened: %d files", name.c_str(), header->entryCount);
+        return STATUS_OK;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void AssetPack::close() {
+        if (mMapping != nullptr) {
+            munmap(mMapping, mMappingSize);
+            mMapping = nullptr;
+            mMappingSize = 0;
+            mData = nullptr;
+            mSize = 0;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    bool AssetPack::find(const std::string& name, Entry& entry) const {
+        if (!isOpen()) {
+            return false;
+        }
+        const Record* begin = mRecords();
+        const Record* end = begin + getEntryCount();
+        const Record* it = std::lower_bound(begin, end, name, [this](const Record& record, const std::string& key) {
+            return key.compare(0, std::string::npos, mName(record), record.nameLength) > 0;
+        });
+        if (it == end || name.compare(0, std::string::npos, mName(*it), it->nameLength) != 0) {
+            return false;
+        }
+        entry.data = mData + it->dataOffset;
+        entry.size = it->dataSize;
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    U32 AssetPack::getEntryCount() const {
+        return isOpen() ? ((const Header*) mData)->entryCount : 0;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    std::string AssetPack::getName(U32 i) const {
+        assert(i < getEntryCount());
+        const Record& record = mRecords()[i];
+        return std::string(mName(record), record.nameLength);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    AssetPack::Entry AssetPack::getEntry(U32 i) const {
+        assert(i < getEntryCount());
+        const Record& record = mRecords()[i];
+        Entry entry;
+        entry.data = mData + record.dataOffset;
+        entry.size = record.dataSize;
+        return entry;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status AssetPack::write(const std::string& path, const std::string& rootDir, std::vector<std::string> names) {
+        std::string root = rootDir;
+        Utils::addTrailingSlash(root);
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        Header header;
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.entryCount = (U32) names.size();
+        header.namesOffset = (U32) (sizeof(Header) + names.size() * sizeof(Record));
+        header.namesSize = 0;
+
+        std::vector<Record> records(names.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            records[i].nameOffset = header.namesSize;
+            records[i].nameLength = (U32) names[i].size();
+            header.namesSize += records[i].nameLength;
+        }
+
+        std::vector<std::vector<char>> payloads(names.size());
+        U32 offset = align(header.namesOffset + header.namesSize);
+        for (size_t i = 0; i < names.size(); ++i) {
+            std::ifstream is((root + names[i]).c_str(), std::ios::binary | std::ios::ate);
+            if (!is.is_open()) {
+                Log::error(TAG, "Cannot open file %s", (root + names[i]).c_str());
+                return throwException(TAG, ExceptionType::IO, "Cannot open file " + root + names[i]);
+            }
+            payloads[i].resize((size_t) is.tellg());
+            is.seekg(0);
+            is.read(payloads[i].data(), payloads[i].size());
+            records[i].dataOffset = offset;
+            records[i].dataSize = (U32) payloads[i].size();
+            offset = align(offset + records[i].dataSize);
+        }
+
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Log::error(TAG, "Cannot write asset pack %s", path.c_str());
+            return throwException(TAG, ExceptionType::IO, "Cannot write asset pack " + path);
+        }
+        out.write((const char*) &header, sizeof(header));
+        out.write((const char*) records.data(), records.size() * sizeof(Record));
+        for (const std::string& name : names) {
+            out.write(name.data(), name.size());
+        }
+        static const char padding[ALIGNMENT] = {0};
+        U32 position = header.namesOffset + header.namesSize;
+        for (size_t i = 0; i < names.size(); ++i) {
+            out.write(padding, records[i].dataOffset - position);
+            out.write(payloads[i].data(), payloads[i].size());
+            position = records[i].dataOffset + records[i].dataSize;
+        }
+        out.close();
+        if (!out) {
+            return throwException(TAG, ExceptionType::IO, "Cannot write asset pack " + path);
+        }
+        return STATUS_OK;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    const AssetPack::Record* AssetPack::mRecords() const {
+        return (const Record*) (mData + sizeof(Header));
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    const char* AssetPack::mName(const Record& record) const {
+        return (const char*) mData + ((const Header*) mData)->namesOffset + record.nameOffset;
+    }
+}
@@ -27,7 +27,9 @@ namespace dma {
 
     //------------------------------------------------------------------
     CubeMap::CubeMap() :
-            Texture()
+            Texture(),
+            mRetention(Retention::KEEP),
+            mSpillCache(nullptr)
     {
         for (U32 i = 0; i < 6; ++i) {
             mImages[i] = nullptr;
@@ -43,23 +45,17 @@ namespace dma {
 
     //------------------------------------------------------------------
     Status CubeMap::load(const std::string& dirName) {
-        std::vector<std::string> faces;
-        faces.push_back(dirName + "/right.png");
-        faces.push_back(dirName + "/left.png");
-        faces.push_back(dirName + "/top.png");
-        faces.push_back(dirName + "/bottom.png");
-        faces.push_back(dirName + "/back.png");
-        faces.push_back(dirName + "/front.png");
-
-        Log::trace(TAG, "Loading Cube Map %s ...", dirName.c_str());
+        LOG_TRACE(TAG, "Loading Cube Map %s ...", dirName.c_str());
 
         // Cache images
+        removeSpilled();
         mDeleteImages();
-        for (GLuint i = 0; i < faces.size(); i++) {
+        mDirName = dirName;
+        for (GLuint i = 0; i < 6; i++) {
 //            if (mImages[i] != nullptr) delete mImages[i];
             Image *img = new Image();
             mImages[i] = img;
-            Status status = img->loadAsPNG(faces[i], false);
+            Status status = img->loadAsPNG(mGetFaceName(i), false);
             if (status != STATUS_OK) {
                 return status;
             }
@@ -71,21 +67,89 @@ namespace dma {
             return STATUS_KO;
         }
 
-        Log::trace(TAG, "Cube Map %s loaded", dirName.c_str());
-        //TODO clear images if cache is off
+        LOG_TRACE(TAG, "Cube Map %s loaded", dirName.c_str());
+        mReleaseImages();
         return STATUS_OK;
     }
 
 
     //------------------------------------------------------------------
     Status CubeMap::refresh(const std::string &dirName) {
-        if (mImages[0] == nullptr) {
-            Log::trace(TAG, "Refreshing CubeMap %s from disk", dirName.c_str());
+        if (mImages[0] == nullptr && (dirName != mDirName || !mReadSpilled())) {
+            LOG_TRACE(TAG, "Refreshing CubeMap %s from disk", dirName.c_str());
             return load(dirName);
         } else {
-            Log::trace(TAG, "Refreshing CubeMap %s using cache", dirName.c_str());
-            return mLoadFromImages();
+            LOG_TRACE(TAG, "Refreshing CubeMap %s using cache", dirName.c_str());
+            Status status = mLoadFromImages();
+            mReleaseImages();
+            return status;
+        }
+    }
+
+
+    //------------------------------------------------------------------
+    void CubeMap::setRetention(Retention retention, SpillCache* spillCache) {
+        assert(retention != Retention::SPILL || spillCache != nullptr);
+        mRetention = retention;
+        mSpillCache = spillCache;
+        mReleaseImages();
+    }
+
+
+    //------------------------------------------------------------------
+    void CubeMap::removeSpilled() {
+        if (mSpillCache == nullptr || mDirName.empty()) {
+            return;
+        }
+        for (U32 i = 0; i < 6; ++i) {
+            mSpillCache->remove(mGetFaceName(i));
+        }
+    }
+
+
+    //------------------------------------------------------------------
+    U32 CubeMap::getCpuBytes() const {
+        U32 bytes = 0;
+        for (U32 i = 0; i < 6; ++i) {
+            if (mImages[i] != nullptr) {
+                bytes += mImages[i]->getSizeInBytes();
+            }
         }
+        return bytes;
+    }
+
+
+    //------------------------------------------------------------------
+    bool CubeMap::mReadSpilled() {
+        if (mSpillCache == nullptr) {
+            return false;
+        }
+        for (U32 i = 0; i < 6; ++i) {
+            mImages[i] = mSpillCache->readImage(mGetFaceName(i));
+            if (mImages[i] == nullptr) {
+                mDeleteImages();
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    //------------------------------------------------------------------
+    void CubeMap::mReleaseImages() {
+        if (mImages[0] == nullptr || mRetention == Retention::KEEP) {
+            return;
+        }
+        if (mRetention == Retention::SPILL) {
+            for (U32 i = 0; i < 6; ++i) {
+                const std::string face = mGetFaceName(i);
+                if (!mSpillCache->contains(face) && mSpillCache->writeImage(face, *mImages[i]) != STATUS_OK) {
+                    // better kept than lost.
+                    return;
+                }
+            }
+        }
+        mDeleteImages();
     }
 
 
@@ -100,6 +164,7 @@ namespace dma {
 
     //------------------------------------------------------------------
     Status CubeMap::mLoadFromImages() {
+        mGpuBytes = 0;
         glGenTextures(1, &mHandle);
         //glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, mHandle);
@@ -122,6 +187,7 @@ namespace dma {
                     (GLenum)img->getFormat(),
                     GL_UNSIGNED_BYTE,
                     img->getPixels());
+            mGpuBytes += computeGpuBytes(*img, false);
         }
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -130,7 +196,13 @@ namespace dma {
         //glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R_OES, GL_CLAMP_TO_EDGE);
         glBindTexture(GL_TEXTURE_CUBE_MAP, 0); //unbind texture
 
-        //TODO clear images if cache is off
         return STATUS_OK;
     }
+
+
+    //------------------------------------------------------------------
+    std::string CubeMap::mGetFaceName(U32 face) const {
+        static const char* FACES[] = {"right", "left", "top", "bottom", "back", "front"};
+        return mDirName + "/" + FACES[face] + ".png";
+    }
 }
@@ -33,7 +33,9 @@ constexpr auto TAG = "CubeMapManager";
 namespace dma {
 
     //-----------------------------------------------------------------------------------------------
-    CubeMapManager::CubeMapManager(const std::string& dir) {
+    CubeMapManager::CubeMapManager(const std::string& dir, SpillCache& spillCache) :
+            mSpillCache(spillCache),
+            mRetention(Retention::KEEP) {
         mDir = dir;
         Utils::addTrailingSlash(mDir);
     }
@@ -56,7 +58,7 @@ namespace dma {
             try {
                 mLoadCubeMap(cubemap, sid);
             } catch (std::runtime_error& e) {
-                Log::warn(TAG, "CubeMap %s doesn't exist, returning fallback instead", sid.c_str());
+                LOG_WARN(TAG, "CubeMap %s doesn't exist, returning fallback instead", sid.c_str());
                 assert(false); //TODO fallback
                 return nullptr;
             }
@@ -70,6 +72,7 @@ namespace dma {
     //----------------------------------------------------------------------------------------------
     void CubeMapManager::mLoadCubeMap(std::shared_ptr<CubeMap> cubeMap, const std::string &sid) {
         std::string directoryName = mDir + sid;
+        cubeMap->setRetention(mRetention, &mSpillCache);
         cubeMap->load(directoryName);
         cubeMap->setSID(sid);
     }
@@ -77,7 +80,7 @@ namespace dma {
 
     //----------------------------------------------------------------------------------------------
     void CubeMapManager::reload() {
-        Log::trace(TAG, "Reloading CubeMapManager...");
+        LOG_TRACE(TAG, "Reloading CubeMapManager...");
 
         for (auto& kv : mCubeMaps) {
             std::shared_ptr<CubeMap> cubemap = kv.second;
@@ -88,13 +91,13 @@ namespace dma {
             cubemap->setSID(sid);
         }
 
-        Log::trace(TAG, "CubeMapManager reloaded");
+        LOG_TRACE(TAG, "CubeMapManager reloaded");
     }
 
 
     //----------------------------------------------------------------------------------------------
     void CubeMapManager::refresh() {
-        Log::trace(TAG, "Refreshing CubeMapManager...");
+        LOG_TRACE(TAG, "Refreshing CubeMapManager...");
 
         for (auto& kv : mCubeMaps) {
             std::shared_ptr<CubeMap> cubemap = kv.second;
@@ -104,32 +107,32 @@ namespace dma {
             cubemap->refresh(dirName);
         }
 
-        Log::trace(TAG, "CubeMapManager refreshed");
+        LOG_TRACE(TAG, "CubeMapManager refreshed");
     }
 
 
     //----------------------------------------------------------------------------------------------
     void CubeMapManager::wipe() {
-        Log::trace(TAG, "Wiping CubeMapManager...");
+        LOG_TRACE(TAG, "Wiping CubeMapManager...");
 
         for (auto& kv : mCubeMaps) {
             kv.second->wipe();
         }
 
-        Log::trace(TAG, "CubeMapManager wiped");
+        LOG_TRACE(TAG, "CubeMapManager wiped");
     }
 
 
     //----------------------------------------------------------------------------------------------
     void CubeMapManager::unload() {
-        Log::trace(TAG, "Unloading CubeMapManager...");
+        LOG_TRACE(TAG, "Unloading CubeMapManager...");
 
         for (auto& kv : mCubeMaps) {
                 kv.second->wipe();
         }
         mCubeMaps.clear();
 
-        Log::trace(TAG, "CubeMapManager unloaded");
+        LOG_TRACE(TAG, "CubeMapManager unloaded");
     }
 
 
@@ -139,10 +142,30 @@ namespace dma {
         while (it != mCubeMaps.end()) {
             if (it->second.unique()) {
                 it->second->wipe();
+                it->second->removeSpilled();
                 it = mCubeMaps.erase(it);
             } else {
                 ++it;
             }
         }
     }
+
+
+    //----------------------------------------------------------------------------------------------
+    void CubeMapManager::setRetention(Retention retention) {
+        mRetention = retention;
+        for (auto& kv : mCubeMaps) {
+            kv.second->setRetention(retention, &mSpillCache);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    MemoryUsage CubeMapManager::getMemoryUsage() const {
+        MemoryUsage usage;
+        for (auto& kv : mCubeMaps) {
+            usage.add(kv.second->getCpuBytes(), kv.second->getGpuBytes());
+        }
+        return usage;
+    }
 } /* namespace dma */
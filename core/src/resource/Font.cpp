@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "rapidjson.h"
+#include "document.h"
+
+#include "resource/Font.hpp"
+#include "utils/GLUtils.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "Font";
+
+namespace dma {
+
+    /* ================= PUBLIC ========================*/
+
+    //------------------------------------------------------------------------
+    Font::Font() :
+            mSize(0.0f),
+            mRange(0.0f),
+            mLineHeight(0.0f),
+            mAscender(0.0f),
+            mHandle(0)
+    {}
+
+
+    //------------------------------------------------------------------------
+    Font::~Font() {
+        wipe();
+    }
+
+
+    //------------------------------------------------------------------------
+    U32 Font::getAtlasBytes() const {
+        return mImage.getSizeInBytes();
+    }
+
+
+    //------------------------------------------------------------------------
+    GLuint Font::getHandle() {
+        if (mHandle == 0 && mImage.getPixels() != nullptr) {
+            glGenTextures(1, &mHandle);
+            glBindTexture(GL_TEXTURE_2D, mHandle);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            // no mipmaps: the distance field is only sharp when linearly interpolated.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, mImage.getFormat(), mImage.getWidth(), mImage.getHeight(), 0,
+                         mImage.getFormat(), GL_UNSIGNED_BYTE, mImage.getPixels());
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+        return mHandle;
+    }
+
+
+    //------------------------------------------------------------------------
+    void Font::invalidate() {
+        mHandle = 0;
+    }
+
+
+    //------------------------------------------------------------------------
+    void Font::wipe() {
+        if (mHandle != 0 && GLUtils::hasGlContext()) {
+            glDeleteTextures(1, &mHandle);
+        }
+        mHandle = 0;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //------------------------------------------------------------------------
+    Status Font::mParse(const std::string& json) {
+        static const char* NUMBERS[] = {"size", "range", "lineHeight", "ascender", "width", "height"};
+        rapidjson::Document document;
+        document.Parse(json.c_str());
+        bool valid = !document.HasParseError() && document.IsObject()
+                     && document.HasMember("glyphs") && document["glyphs"].IsArray();
+        for (const char* member : NUMBERS) {
+            valid = valid && document.HasMember(member) && document[member].IsNumber();
+        }
+        if (!valid) {
+            Log::error(TAG, "Invalid font %s", mSID.c_str());
+            return STATUS_KO;
+        }
+        mSize = (F32) document["size"].GetDouble();
+        mRange = (F32) document["range"].GetDouble();
+        mLineHeight = (F32) document["lineHeight"].GetDouble();
+        mAscender = (F32) document["ascender"].GetDouble();
+        const F32 width = (F32) document["width"].GetDouble();
+        const F32 height = (F32) document["height"].GetDouble();
+        if (width != (F32) mImage.getWidth() || height != (F32) mImage.getHeight()) {
+            Log::error(TAG, "Font %s metrics do not match its atlas", mSID.c_str());
+            return STATUS_KO;
+        }
+
+        const rapidjson::Value& glyphs = document["glyphs"];
+        mGlyphs.clear();
+        for (rapidjson::SizeType i = 0; i < glyphs.Size(); ++i) {
+            const rapidjson::Value& g = glyphs[i];
+            bool validGlyph = g.IsArray() && g.Size() == 8;
+            for (rapidjson::SizeType j = 0; validGlyph && j < 8; ++j) {
+                validGlyph = g[j].IsNumber();
+            }
+            if (!validGlyph) {
+                Log::error(TAG, "Invalid glyph in font %s", mSID.c_str());
+                return STATUS_KO;
+            }
+            const F32 x = (F32) g[1].GetDouble();
+            const F32 y = (F32) g[2].GetDouble();
+            const F32 w = (F32) g[3].GetDouble();
+            const F32 h = (F32) g[4].GetDouble();
+            Glyph glyph;
+            // the atlas is stored bottom row first: v goes up from the bottom of the file.
+            glyph.uvMin = glm::vec2(x / width, (height - y - h) / height);
+            glyph.uvMax = glm::vec2((x + w) / width, (height - y) / height);
+            glyph.offset = glm::vec2((F32) g[5].GetDouble(), (F32) g[6].GetDouble() - h);
+            glyph.size = glm::vec2(w, h);
+            glyph.advance = (F32) g[7].GetDouble();
+            mGlyphs[(U32) g[0].GetUint()] = glyph;
+        }
+        return STATUS_OK;
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/FontManager.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "FontManager";
+
+namespace dma {
+
+    //-----------------------------------------------------------------
+    FontManager::FontManager(const std::string& dir, ResourceIndex& fileIndex) :
+            mFontDir(dir),
+            mFileIndex(fileIndex)
+    {}
+
+
+    //-----------------------------------------------------------------
+    FontManager::~FontManager() {
+    }
+
+
+    //-----------------------------------------------------------------
+    std::shared_ptr<Font> FontManager::acquire(const std::string& sid, Status* result) {
+        Sid key(sid);
+        auto it = mFonts.find(key);
+        if (it == mFonts.end()) {
+            std::shared_ptr<Font> font = std::make_shared<Font>();
+            *result = mLoad(*font, sid);
+            if (*result != STATUS_OK) {
+                LOG_WARN(TAG, "Font %s cannot be loaded, labels using it are not drawn", sid.c_str());
+                return nullptr;
+            }
+            it = mFonts.insert(std::make_pair(key, font)).first;
+        }
+        *result = STATUS_OK;
+        return it->second;
+    }
+
+
+    //-----------------------------------------------------------------
+    bool FontManager::hasResource(const std::string& sid) const {
+        return mFileIndex.exists(mFontDir + sid + ".json") && mFileIndex.exists(mFontDir + sid + ".png");
+    }
+
+
+    //-----------------------------------------------------------------
+    void FontManager::refresh() {
+        for (auto& kv : mFonts) {
+            kv.second->invalidate();
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    void FontManager::wipe() {
+        for (auto& kv : mFonts) {
+            kv.second->wipe();
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    void FontManager::unload() {
+        LOG_TRACE(TAG, "Unloading FontManager...");
+        wipe();
+        mFonts.clear();
+        LOG_TRACE(TAG, "FontManager unloaded");
+    }
+
+
+    //-----------------------------------------------------------------
+    void FontManager::update() {
+        auto it = mFonts.begin();
+        while (it != mFonts.end()) {
+            if (it->second.unique()) {
+                it->second->wipe();
+                it = mFonts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+
+    //-----------------------------------------------------------------
+    MemoryUsage FontManager::getMemoryUsage() const {
+        MemoryUsage usage;
+        for (auto& kv : mFonts) {
+            usage.add(kv.second->getAtlasBytes(), kv.second->getGpuBytes());
+        }
+        return usage;
+    }
+
+
+    //-----------------------------------------------------------------
+    Status FontManager::mLoad(Font& font, const std::string& sid) {
+        const std::string path = mFontDir + sid;
+        std::string json;
+        if (mFileIndex.read(path + ".json", json) != STATUS_OK) {
+            Log::error(TAG, "Font %s doesn't exist", sid.c_str());
+            return STATUS_KO;
+        }
+
+        // loaded bottom row first, as maps.
+        AssetPack::Entry entry;
+        Status status = mFileIndex.findPacked(path + ".png", entry) ?
+                        font.mImage.loadAsPNG(entry.data, entry.size, path + ".png", true) :
+                        font.mImage.loadAsPNG(path + ".png");
+        if (status != STATUS_OK) {
+            Log::error(TAG, "Unable to read the atlas of font %s", sid.c_str());
+            return status;
+        }
+        font.mSID = sid;
+        return font.mParse(json);
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/GeneratedMesh.hpp"
+
+namespace dma {
+
+    //------------------------------------------------------------------------------
+    GeneratedMesh::GeneratedMesh() :
+            Mesh()
+    {}
+
+
+    //------------------------------------------------------------------------------
+    GeneratedMesh::~GeneratedMesh() {
+
+    }
+
+
+    //------------------------------------------------------------------------------
+    void GeneratedMesh::upload() {
+        // recorded from the previous buffers, whose handles may be reused.
+        clearVertexArrays();
+        if (mVertexBuffer != nullptr) {
+            mVertexBuffer->wipe();
+        }
+        mVertexBuffer = std::make_shared<VertexBuffer>(mVertexSize, (U32) mVertexData.size());
+        mVertexBuffer->writeData(0, (U32) mVertexData.size(), mVertexData.data());
+
+        if (mIndexBuffer != nullptr) {
+            mIndexBuffer->wipe();
+        }
+        mIndexBuffer = std::make_shared<IndexBuffer>((U32) mIndexData.size());
+        mIndexBuffer->writeData(mIndexData.data());
+    }
+
+
+    //------------------------------------------------------------------------------
+    void GeneratedMesh::release() {
+        if (isUploaded()) {
+            wipe();
+            mVertexBuffer = nullptr;
+            mIndexBuffer = nullptr;
+        }
+    }
+}
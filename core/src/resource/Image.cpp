@@ -44,6 +44,23 @@ namespace dma {
     }
 
 
+    struct MemoryReader {
+        const BYTE* data;
+        U32 size;
+        U32 offset;
+    };
+
+    //---------------------------------------------------------------------
+    void boundedReadCallback(png_structp png, png_bytep data, png_size_t size) {
+        MemoryReader* reader = (MemoryReader*) png_get_io_ptr(png);
+        if (size > reader->size - reader->offset) {
+            png_error(png, "unexpected end of data");
+        }
+        memcpy(data, reader->data + reader->offset, size);
+        reader->offset += (U32) size;
+    }
+
+
     //---------------------------------------------------------------------
     inline void onPngError(FILE* file, const std::string& filename, const std::string& error) {
         fclose (file);
@@ -112,7 +129,7 @@ namespace dma {
 
     //---------------------------------------------------------------------
     void png_warning_fn (png_structp png_ptr, png_const_charp warning_msg) {
-        Log::warn(TAG, "png_error: %s (%s)", warning_msg, (char *)png_get_error_ptr (png_ptr));
+        LOG_WARN(TAG, "png_error: %s (%s)", warning_msg, (char *)png_get_error_ptr (png_ptr));
     }
 
 
@@ -182,10 +199,10 @@ namespace dma {
     }
 
 
-    U32 Image::getWidth(){ return mWidth;}
-    U32 Image::getHeight(){return mHeight;}
-    GLint Image::getFormat(){return mFormat;}
-    BYTE* Image::getPixels(){return mPixels;}
+    U32 Image::getWidth() const {return mWidth;}
+    U32 Image::getHeight() const {return mHeight;}
+    GLint Image::getFormat() const {return mFormat;}
+    BYTE* Image::getPixels() const {return mPixels;}
 
 
     //---------------------------------------------------------------------
@@ -235,10 +252,8 @@ namespace dma {
         png_infop info_ptr;
         png_byte magic[8];
 
-        // image parameters
-        int bit_depth, color_type;
-
         /* open texture data read / binary */
+        Utils::countFileSyscall();
         file = fopen(fname.c_str(), "rb");
 
         if (!file) {
@@ -291,6 +306,67 @@ namespace dma {
         /* tell libpng that we have already read the magic number */
         png_set_sig_bytes(png_ptr, sizeof (magic));
 
+        Status status = mReadPng(png_ptr, info_ptr, fname, reverse);
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(file);
+        return status;
+    }
+
+
+    //---------------------------------------------------------------------
+    Status Image::loadAsPNG(const BYTE* data, U32 size, const std::string& name, bool reverse) {
+        png_structp png_ptr;
+        png_infop info_ptr;
+
+        /* check for valid magic number */
+        if (size < 8 || !png_check_sig((png_bytep) data, 8)) {
+            Log::error(TAG, "%s is not a valid PNG file", name.c_str());
+            return throwException(TAG, ExceptionType::INVALID_FILE, (name + " is not a valid PNG file").c_str());
+        }
+
+        png_ptr = png_create_read_struct (PNG_LIBPNG_VER_STRING,
+                                          (png_voidp *) name.c_str(),
+                                          png_error_fn,               // error callback
+                                          png_warning_fn);            // warning callback
+        if (!png_ptr) {
+            Log::error(TAG, "error processing \"%s\" : cannot create data structure", name.c_str());
+            return throwException(TAG, ExceptionType::MEMORY, "cannot create data structure");
+        }
+
+        info_ptr = png_create_info_struct (png_ptr);
+        if (!info_ptr) {
+            png_destroy_read_struct (&png_ptr, NULL, NULL);
+            Log::error(TAG, "error processing \"%s\" : cannot read info", name.c_str());
+            return throwException(TAG, ExceptionType::INVALID_FILE, "cannot read info");
+        }
+
+        // initialize the setjmp for returning properly after a libpng error occurred
+        if (setjmp (png_jmpbuf (png_ptr))) {
+            png_destroy_read_struct (&png_ptr, &info_ptr, NULL);
+            Log::error(TAG, "error processing \"%s\" : unknown error", name.c_str());
+            return throwException(TAG, ExceptionType::UNKNOWN, "unknown error");
+        }
+
+        // read from memory, the whole file being mapped.
+        MemoryReader reader;
+        reader.data = data;
+        reader.size = size;
+        reader.offset = 8;
+        png_set_read_fn(png_ptr, &reader, boundedReadCallback);
+
+        /* tell libpng that we have already read the magic number */
+        png_set_sig_bytes(png_ptr, 8);
+
+        Status status = mReadPng(png_ptr, info_ptr, name, reverse);
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return status;
+    }
+
+
+    //---------------------------------------------------------------------
+    Status Image::mReadPng(png_struct* png_ptr, png_info* info_ptr, const std::string& fname, bool reverse) {
+        int bit_depth, color_type;
+
         /* read png info */
         png_read_info(png_ptr, info_ptr);
 
@@ -308,7 +384,7 @@ namespace dma {
                       &bit_depth, &color_type,
                       NULL, NULL, NULL);
 
-        Log::trace(TAG, "loading texture of size (%d, %d)", mWidth, mHeight);
+        LOG_TRACE(TAG, "loading texture of size (%d, %d)", mWidth, mHeight);
 
         if(!checkSizePowOf2(mWidth, mHeight)) {
 
@@ -358,10 +434,8 @@ namespace dma {
         /* read png data & fill data array */
         mReadPngData(png_ptr, mPixels, reverse);
 
-        /* finish decompression and release memory */
+        /* finish decompression */
         png_read_end(png_ptr, NULL);
-        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-        fclose(file);
 
         return STATUS_OK;
     }
@@ -16,14 +16,20 @@
 
 
 
+#include "glm/glm.hpp"
+
 #include "resource/Map.hpp"
 #include "utils/ExceptionHandler.hpp"
 
+#include <algorithm>
+#include <memory>
+
 constexpr auto TAG = "Map";
 
 namespace dma {
 
     static bool enableAnisotropy = false;
+    static GLfloat maxAnisotropy = 16.0f;
 
 
     //----------------------------------------------------------------------------------------------
@@ -37,7 +43,41 @@ namespace dma {
             enableAnisotropy = true;
         } else {
             enableAnisotropy = false;
-            Log::warn(TAG, "Anisotropic filering not supported on this platform.");
+            LOG_WARN(TAG, "Anisotropic filering not supported on this platform.");
+        }
+    }
+
+
+    //---------------------------------------------------------------------
+    /**
+     * Fills 'levels' with the 'size' bytes of the mipmap levels of the image, from level 1 down to 1x1,
+     * each texel averaging 2x2 texels of the previous level.
+     */
+    static void buildMipmaps(const Image& image, U32 size, std::vector<BYTE>& levels) {
+        const U32 bpp = image.getBytesPerPixel();
+        levels.resize(size);
+        const BYTE* src = image.getPixels();
+        BYTE* dst = levels.data();
+        U32 width = image.getWidth();
+        U32 height = image.getHeight();
+        while (width > 1 || height > 1) {
+            const U32 w = std::max(width / 2, 1u);
+            const U32 h = std::max(height / 2, 1u);
+            BYTE* level = dst;
+            for (U32 y = 0; y < h; ++y) {
+                const BYTE* row0 = src + std::min(2 * y, height - 1) * width * bpp;
+                const BYTE* row1 = src + std::min(2 * y + 1, height - 1) * width * bpp;
+                for (U32 x = 0; x < w; ++x) {
+                    const U32 x0 = std::min(2 * x, width - 1) * bpp;
+                    const U32 x1 = std::min(2 * x + 1, width - 1) * bpp;
+                    for (U32 c = 0; c < bpp; ++c) {
+                        *dst++ = (BYTE) ((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                    }
+                }
+            }
+            src = level;
+            width = w;
+            height = h;
         }
     }
 
@@ -45,7 +85,11 @@ namespace dma {
     //---------------------------------------------------------------------
     Map::Map() :
             Texture(),
-            mImage(nullptr)
+            mImage(nullptr),
+            mRestorePending(false),
+            mRetention(Retention::KEEP),
+            mSpillCache(nullptr),
+            mFileIndex(nullptr)
     {}
 
 
@@ -58,11 +102,38 @@ namespace dma {
     //---------------------------------------------------------------------
     Status Map::load(const std::string& filename) {
 
-        Log::trace(TAG, "Loading 2D texture %s ...", filename.c_str());
+        LOG_TRACE(TAG, "Loading 2D texture %s ...", filename.c_str());
+
+        // the file may have changed since it was spilled.
+        if (mSpillCache != nullptr) mSpillCache->remove(mFilename);
+        mFilename = filename;
+        mDeleteImage();
+        mImage = mReadImage();
+        if (mImage == nullptr) {
+            Log::error(TAG, "Unable to load map %s" , filename.c_str());
+            return STATUS_KO;
+        }
+        Status status = mLoadFromImage();
+        if (status != STATUS_OK) {
+            Log::error(TAG, "Unable to load map %s", filename.c_str());
+            return status;
+        }
+
+        LOG_TRACE(TAG, "2D texture %s loaded", filename.c_str());
+        return STATUS_OK;
+    }
+
+
+    //---------------------------------------------------------------------
+    Status Map::load(const BYTE* data, U32 size, const std::string& filename) {
+
+        LOG_TRACE(TAG, "Loading 2D texture %s from memory...", filename.c_str());
 
-        if (mImage != nullptr) delete mImage;
+        if (mSpillCache != nullptr) mSpillCache->remove(mFilename);
+        mFilename = filename;
+        mDeleteImage();
         mImage = new Image();
-        Status status = mImage->loadAsPNG(filename) ;
+        Status status = mImage->loadAsPNG(data, size, filename, true);
         if (status != STATUS_OK) {
             Log::error(TAG, "Unable to load map %s" , filename.c_str());
             return status;
@@ -73,19 +144,19 @@ namespace dma {
             return status;
         }
 
-        Log::trace(TAG, "2D texture %s loaded", filename.c_str());
-
-        //TODO delete mImage if cache is off
+        LOG_TRACE(TAG, "2D texture %s loaded", filename.c_str());
         return STATUS_OK;
     }
 
 
     //---------------------------------------------------------------------
     Status Map::load(const Image &image) {
-        Log::trace(TAG, "Loading 2D texture from Image");
-
+        LOG_TRACE(TAG, "Loading 2D texture from Image");
 
-        if (mImage != nullptr) delete mImage;
+        // kept from now on, see releaseImage().
+        if (mSpillCache != nullptr) mSpillCache->remove(mFilename);
+        mFilename.clear();
+        mDeleteImage();
         mImage = new Image(image);
 
         Status status = mLoadFromImage() ;
@@ -95,41 +166,106 @@ namespace dma {
             throwException(TAG, ExceptionType::UNKNOWN, "Unable to load map from image");
             return status;
         }
-        Log::trace(TAG, "2D texture loaded");
+        LOG_TRACE(TAG, "2D texture loaded");
         return STATUS_OK;
     }
 
 
     //---------------------------------------------------------------------
     Status Map::refresh(const std::string &filename) {
-        if (mImage == nullptr) {
-            Log::trace(TAG, "Refreshing Map %s from disk", filename.c_str());
+        if (mImage == nullptr && mFilename.empty()) {
+            LOG_TRACE(TAG, "Refreshing Map %s from disk", filename.c_str());
             return load(filename);
-        } else {
-            Log::trace(TAG, "Refreshing Map %s from cache", filename.c_str());
-            return mLoadFromImage();
         }
+        return refresh();
     }
 
 
     //---------------------------------------------------------------------
     Status Map::refresh() {
-        if (mImage == nullptr) {
+        if (restoreImage() == nullptr) {
             Log::error(TAG, "Refreshing Map that doesn't have cache");
             assert(!"Refreshing Map that doesn't have cache");
             return throwException(TAG, ExceptionType::UNKNOWN, "Refreshing Map that doesn't have cache");
-        } else {
-            Log::trace(TAG, "Refreshing Map %s from cache", getSID().c_str());
-            return mLoadFromImage();
         }
+        LOG_TRACE(TAG, "Refreshing Map %s from cache", getSID().c_str());
+        return mLoadFromImage();
+    }
+
+
+    //---------------------------------------------------------------------
+    void Map::setRetention(Retention retention, SpillCache* spillCache) {
+        assert(retention != Retention::SPILL || spillCache != nullptr);
+        mRetention = retention;
+        mSpillCache = spillCache;
+    }
+
+
+    //---------------------------------------------------------------------
+    Image* Map::restoreImage() {
+        if (mImage == nullptr && mSpillCache != nullptr && mSpillCache->contains(mFilename)) {
+            LOG_TRACE(TAG, "Reading map %s from the spill cache", mFilename.c_str());
+            mImage = mSpillCache->readImage(mFilename, &mMipmaps);
+        }
+        if (mImage == nullptr && !mFilename.empty()) {
+            LOG_TRACE(TAG, "Reading map %s again", mFilename.c_str());
+            mImage = mReadImage();
+        }
+        return mImage;
+    }
+
+
+    //---------------------------------------------------------------------
+    void Map::releaseImage() {
+        if (mImage == nullptr || mRetention == Retention::KEEP || mFilename.empty()) {
+            return;
+        }
+        if (mRetention == Retention::SPILL && !mSpillCache->contains(mFilename)
+            && mSpillCache->writeImage(mFilename, *mImage, &mMipmaps) != STATUS_OK) {
+            // better kept than lost.
+            return;
+        }
+        mDeleteImage();
+    }
+
+
+    //---------------------------------------------------------------------
+    void Map::setMaxAnisotropy(F32 anisotropy) {
+        maxAnisotropy = glm::max(anisotropy, 1.0f);
+    }
+
+
+    //---------------------------------------------------------------------
+    void Map::applyAnisotropy() {
+        if (mHandle == 0) {
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D, mHandle);
+        mSetupAnisotropy();
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+
+    //---------------------------------------------------------------------
+    U32 Map::getCpuBytes() const {
+        return mImage != nullptr ? mImage->getSizeInBytes() + (U32) mMipmaps.capacity() : 0;
+    }
+
+
+    //---------------------------------------------------------------------
+    void Map::invalidate() {
+        mHandle = 0;
+        mRestorePending = true;
     }
 
 
     //---------------------------------------------------------------------
     Status Map::mLoadFromImage() {
+        mRestorePending = false;
+
         /* generate texture */
         glGenTextures (1, &mHandle);
-        Log::trace(TAG, "(GL texture handle : %d)", mHandle);
+        LOG_TRACE(TAG, "(GL texture handle : %d)", mHandle);
         assert(mHandle);
         glBindTexture(GL_TEXTURE_2D, mHandle);
 
@@ -141,8 +277,8 @@ namespace dma {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
-//        Log::debug(TAG, "creating GL texture: ");
-//        Log::debug(TAG, "format = %d : ",mImage->getFormat());
+//        LOG_DEBUG(TAG, "creating GL texture: ");
+//        LOG_DEBUG(TAG, "format = %d : ",mImage->getFormat());
 
         /* upload texture data */
         GLint maxTextureSize;
@@ -150,29 +286,77 @@ namespace dma {
         assert((U32)maxTextureSize > mImage->getWidth() && "maxTextureSize");
         assert((U32)maxTextureSize > mImage->getHeight() && "maxTextureSize");
 
-        const int mipmapLevel = 0;
-        glTexImage2D (GL_TEXTURE_2D,
-                      mipmapLevel,
-                      mImage->getFormat(),
-                      mImage->getWidth(),
-                      mImage->getHeight(),
-                      0, //ES border must be 0
-                      (GLenum)mImage->getFormat(),
-                      GL_UNSIGNED_BYTE,
-                      mImage->getPixels());
+        // mipmaps are built once, and uploaded as is from then on.
+        mGpuBytes = computeGpuBytes(*mImage, true);
+        const U32 mipmapBytes = mGpuBytes - mImage->getSizeInBytes();
+        if (mMipmaps.size() != mipmapBytes) {
+            buildMipmaps(*mImage, mipmapBytes, mMipmaps);
+        }
+        // rows of the small levels are not 4 bytes aligned.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        const BYTE* pixels = mImage->getPixels();
+        const BYTE* next = mMipmaps.data();
+        U32 width = mImage->getWidth();
+        U32 height = mImage->getHeight();
+        for (int mipmapLevel = 0; ; ++mipmapLevel) {
+            glTexImage2D (GL_TEXTURE_2D,
+                          mipmapLevel,
+                          mImage->getFormat(),
+                          width,
+                          height,
+                          0, //ES border must be 0
+                          (GLenum)mImage->getFormat(),
+                          GL_UNSIGNED_BYTE,
+                          pixels);
+            if (width == 1 && height == 1) {
+                break;
+            }
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+            pixels = next;
+            next += width * height * mImage->getBytesPerPixel();
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        mSetupAnisotropy();
+        glBindTexture(GL_TEXTURE_2D, 0); //unbind texture
+
+        releaseImage();
+        return STATUS_OK;
+    }
+
+
+    //---------------------------------------------------------------------
+    Image* Map::mReadImage() const {
+        // decoding errors may throw.
+        std::unique_ptr<Image> image(new Image());
+        Status status;
+        AssetPack::Entry entry;
+        if (mFileIndex != nullptr && mFileIndex->findPacked(mFilename, entry)) {
+            status = image->loadAsPNG(entry.data, entry.size, mFilename, true);
+        } else {
+            status = image->loadAsPNG(mFilename);
+        }
+        return status == STATUS_OK ? image.release() : nullptr;
+    }
+
 
-        // Generate mipmaps, by the way.
-        glGenerateMipmap(GL_TEXTURE_2D);
+    //---------------------------------------------------------------------
+    void Map::mDeleteImage() {
+        delete mImage;
+        mImage = nullptr;
+        // releases the memory, unlike clear().
+        std::vector<BYTE>().swap(mMipmaps);
+    }
 
+
+    //---------------------------------------------------------------------
+    void Map::mSetupAnisotropy() {
         checkAnisotropyExt();
         if (enableAnisotropy) {
             GLfloat anisotropyMax;
             glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &anisotropyMax);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropyMax );
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, glm::min(anisotropyMax, maxAnisotropy));
         }
-        glBindTexture(GL_TEXTURE_2D, 0); //unbind texture
-
-        //TODO delete mImage if cache is off
-        return STATUS_OK;
     }
 }
@@ -16,7 +16,12 @@
 
 
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 #include "resource/MapManager.hpp"
+#include "common/Timer.hpp"
 
 #define TAG "MapManager"
 
@@ -26,7 +31,13 @@ namespace dma {
 
 
     //-----------------------------------------------------------------
-    MapManager::MapManager(const std::string& dir) {
+    MapManager::MapManager(const std::string& dir, ResourceIndex& fileIndex, SpillCache& spillCache) :
+            mTileDir("tiles/"),
+            mTileRevision(0),
+            mFileIndex(fileIndex),
+            mSpillCache(spillCache),
+            mRetention(Retention::KEEP)
+    {
         mMapDir = dir;
         Utils::addTrailingSlash(mMapDir);
     }
@@ -50,104 +61,232 @@ namespace dma {
         if (sid == FALLBACK_MAP_SID) {
             return mFallbackMap;
         }
-        if (mMaps.find(sid) == mMaps.end()) {
-            std::shared_ptr<Map> map = std::make_shared<Map>();
-            try {
-                mLoadMap(map, sid);
-            } catch (std::runtime_error& e) {
-                Log::warn(TAG, "Map %s doesn't exist, returning fallback instead", sid.c_str());
-                return mFallbackMap;
-            }
-            mMaps[sid] = map;
+        Handle<Map> handle = acquireHandle(sid);
+        if (handle.isNull()) {
+            return mFallbackMap;
+        }
+        return mMaps.getShared(handle);
+    }
+
+
+    //-----------------------------------------------------------------
+    Handle<Map> MapManager::acquireHandle(const std::string &sid) {
+        Sid key(sid);
+        auto it = mIndex.find(key);
+        if (it != mIndex.end()) {
+            return it->second;
         }
-        return mMaps[sid];
+        Handle<Map> handle = mAddMap(sid);
+        if (!handle.isNull()) {
+            mIndex[key] = handle;
+        }
+        return handle;
     }
 
 
     //-----------------------------------------------------------------
     bool MapManager::hasResource(const std::string &sid) const {
-        return Utils::fileExists(mMapDir + sid + ".png") || Utils::fileExists(mMapDir + sid + ".PNG");
+        return mFileIndex.exists(mMapDir + sid + ".png") || mFileIndex.exists(mMapDir + sid + ".PNG");
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::notifyAvailable(const std::string &sid) {
+        mFileIndex.add(mMapDir + sid + ".png");
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::setTileDir(const std::string& dir) {
+        if (dir == mTileDir) {
+            return;
+        }
+        mTileDir = dir;
+        // the maps of the previous dir stay in mMaps, until update() finds them unused.
+        mTileIndex.clear();
+        mTileFiles.clear();
+        mTileRevision = 0;
+    }
+
+
+    //-----------------------------------------------------------------
+    bool MapManager::hasTile(const geo::TileId& id) {
+        mScanTiles();
+        return mTileFiles.find(id.getKey()) != mTileFiles.end();
+    }
+
+
+    //-----------------------------------------------------------------
+    Handle<Map> MapManager::acquireTileHandle(const geo::TileId& id) {
+        U64 key = id.getKey();
+        auto it = mTileIndex.find(key);
+        if (it != mTileIndex.end()) {
+            return it->second;
+        }
+        if (!hasTile(id)) {
+            return Handle<Map>();
+        }
+        // tile paths are not interned: they would pile up in the Sid table as the camera moves.
+        Handle<Map> handle = mAddMap(mTileSid(id));
+        if (!handle.isNull()) {
+            mTileIndex[key] = handle;
+        }
+        return handle;
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::notifyTileAvailable(const geo::TileId& id) {
+        notifyAvailable(mTileSid(id));
+        mTileFiles.insert(id.getKey());
     }
 
 
     //-----------------------------------------------------------------
     void MapManager::reload() {
-        Log::trace(TAG, "Reloading MapManager...");
+        LOG_TRACE(TAG, "Reloading MapManager...");
 
         mFallbackMap->wipe();
         mLoadMap(mFallbackMap, FALLBACK_MAP_SID);
 
-        for (auto& kv : mMaps) {
-            const std::string& sid = kv.first;
-            auto map = kv.second;
+        mMaps.forEach([this](Handle<Map>, const std::shared_ptr<Map>& map) {
+            std::string filename = map->getFilename();
             map->wipe();
-            std::string filename = mMapDir + sid;
-            map->load(filename);
-        }
+            mReadMap(*map, filename);
+        });
 
-        Log::trace(TAG, "MapManager reloaded");
+        LOG_TRACE(TAG, "MapManager reloaded");
     }
 
 
     //-----------------------------------------------------------------
-    void MapManager::refresh() {
-        Log::trace(TAG, "Refreshing MapManager...");
+    void MapManager::refresh(bool deferred) {
+        LOG_TRACE(TAG, "Refreshing MapManager...");
 
         //mFallbackMap->wipe();
         mFallbackMap->refresh();
 
-        for (auto& kv : mMaps) {
-            const std::string& sid = kv.first;
-            auto map = kv.second;
+        mRestoreQueue.clear();
+        mMaps.forEach([this, deferred](Handle<Map>, const std::shared_ptr<Map>& map) {
             //map->wipe();
-            std::string filename = mMapDir + sid;
-            map->refresh(filename);
+            if (deferred) {
+                map->invalidate();
+                mRestoreQueue.push_back(map);
+            } else {
+                map->refresh(map->getFilename());
+            }
+        });
+
+        // the most shared maps are likely to be the most visible ones: restore them first.
+        // restore() pops from the back.
+        std::stable_sort(mRestoreQueue.begin(), mRestoreQueue.end(),
+                         [](const std::weak_ptr<Map>& a, const std::weak_ptr<Map>& b) {
+                             return a.use_count() < b.use_count();
+                         });
+
+        LOG_TRACE(TAG, "MapManager refreshed (%d maps deferred)", (int) mRestoreQueue.size());
+    }
+
+
+    //-----------------------------------------------------------------
+    U32 MapManager::restore(F32 budget) {
+        Timer timer;
+        timer.reset();
+        while (!mRestoreQueue.empty() && timer.liveDT() < budget) {
+            std::shared_ptr<Map> map = mRestoreQueue.back().lock();
+            mRestoreQueue.pop_back();
+            // may have already been refreshed on draw, or released.
+            if (map != nullptr && map->isRestorePending()) {
+                map->refresh();
+            }
+        }
+        return (U32) mRestoreQueue.size();
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::setMaxAnisotropy(F32 anisotropy) {
+        Map::setMaxAnisotropy(anisotropy);
+        mFallbackMap->applyAnisotropy();
+        mMaps.forEach([](Handle<Map>, const std::shared_ptr<Map>& map) {
+            map->applyAnisotropy();
+        });
+    }
+
+
+    //-----------------------------------------------------------------
+    void MapManager::setRetention(Retention retention) {
+        mRetention = retention;
+        if (mFallbackMap != nullptr) {
+            mFallbackMap->setRetention(retention, &mSpillCache);
+            mFallbackMap->releaseImage();
         }
+        mMaps.forEach([this, retention](Handle<Map>, const std::shared_ptr<Map>& map) {
+            map->setRetention(retention, &mSpillCache);
+            map->releaseImage();
+        });
+    }
 
-        Log::trace(TAG, "MapManager refreshed");
+
+    //-----------------------------------------------------------------
+    MemoryUsage MapManager::getMemoryUsage() const {
+        MemoryUsage usage;
+        usage.add(mFallbackMap->getCpuBytes(), mFallbackMap->getGpuBytes());
+        mMaps.forEach([&usage](Handle<Map>, const std::shared_ptr<Map>& map) {
+            usage.add(map->getCpuBytes(), map->getGpuBytes());
+        });
+        return usage;
     }
 
 
     //-----------------------------------------------------------------
     void MapManager::wipe() {
-        Log::trace(TAG, "Wiping MapManager...");
+        LOG_TRACE(TAG, "Wiping MapManager...");
 
         mFallbackMap->wipe();
 
-        for (auto& kv : mMaps) {
-            kv.second->wipe();
-        }
+        mMaps.forEach([](Handle<Map>, const std::shared_ptr<Map>& map) {
+            map->wipe();
+        });
 
-        Log::trace(TAG, "MapManager wiped");
+        LOG_TRACE(TAG, "MapManager wiped");
     }
 
 
     //-----------------------------------------------------------------
     void MapManager::unload() {
-        Log::trace(TAG, "Unloading MapManager...");
+        LOG_TRACE(TAG, "Unloading MapManager...");
 
         mFallbackMap->wipe();
         mFallbackMap = nullptr; //release reference count
 
-        for (auto& kv : mMaps) {
-            kv.second->wipe();
-        }
+        mMaps.forEach([](Handle<Map>, const std::shared_ptr<Map>& map) {
+            map->wipe();
+        });
         mMaps.clear();
+        mIndex.clear();
+        mTileIndex.clear();
+        mRestoreQueue.clear();
 
-        Log::trace(TAG, "MapManager unloaded");
+        LOG_TRACE(TAG, "MapManager unloaded");
     }
 
 
     //-----------------------------------------------------------------
     void MapManager::update() {
-        auto it = mMaps.begin();
-        while (it != mMaps.end()) {
-            if (it->second.unique()) {
-                it->second->wipe();
-                it = mMaps.erase(it);
-            } else {
-                ++it;
+        bool removed = false;
+        mMaps.forEach([this, &removed](Handle<Map> handle, const std::shared_ptr<Map>& map) {
+            if (map.unique()) {
+                map->wipe();
+                mSpillCache.remove(map->getFilename());
+                mMaps.remove(handle);
+                removed = true;
             }
+        });
+
+        if (removed) {
+            mEraseStale(mIndex);
+            mEraseStale(mTileIndex);
         }
     }
 
@@ -155,10 +294,60 @@ namespace dma {
     //----------------------------------------------------------------------------------------------
     void MapManager::mLoadMap(std::shared_ptr<Map> map, const std::string &sid) {
         std::string filename = mMapDir + sid + ".png";
-        if (!Utils::fileExists(filename)) {
+        if (!mFileIndex.exists(filename)) {
             Log::error(TAG, "2D texture %s doesn't exist", sid.c_str());
             throw std::runtime_error("2D texture " + sid + " doesn't exist");
         }
-        map->load(filename);
+        mReadMap(*map, filename);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Handle<Map> MapManager::mAddMap(const std::string& sid) {
+        std::shared_ptr<Map> map = std::make_shared<Map>();
+        try {
+            mLoadMap(map, sid);
+        } catch (std::runtime_error& e) {
+            LOG_WARN(TAG, "Map %s doesn't exist, returning fallback instead", sid.c_str());
+            return Handle<Map>();
+        }
+        return mMaps.add(map);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void MapManager::mScanTiles() {
+        // files changed elsewhere in the resource dir do not matter.
+        const U32 revision = mFileIndex.getRevision(mMapDir + mTileDir);
+        if (mTileRevision == revision) {
+            return;
+        }
+        mTileRevision = revision;
+        mTileFiles.clear();
+        mFileIndex.forEachFile(mMapDir + mTileDir, [this](const char* path) {
+            int x, y, z, length = 0;
+            if (sscanf(path, "%d/%d/%d%n", &z, &x, &y, &length) == 3
+                && (strcmp(path + length, ".png") == 0 || strcmp(path + length, ".PNG") == 0)) {
+                mTileFiles.insert(geo::TileId(x, y, z).getKey());
+            }
+        });
+        LOG_DEBUG(TAG, "%d tile maps indexed in %s", (int) mTileFiles.size(), mTileDir.c_str());
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    std::string MapManager::mTileSid(const geo::TileId& id) const {
+        char coords[48];
+        snprintf(coords, sizeof(coords), "%d/%d/%d", id.z, id.x, id.y);
+        return mTileDir + coords;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status MapManager::mReadMap(Map& map, const std::string& filename) {
+        // also read again by the map itself when restored.
+        map.setFileIndex(&mFileIndex);
+        map.setRetention(mRetention, &mSpillCache);
+        return map.load(filename);
     }
 }
@@ -20,9 +20,12 @@
 
 namespace dma {
 
+    constexpr int Material::DMA_MAX_PASS_COUNT;
+    U32 Material::sortKeyCount = 0;
+
     //---------------------------------------------------------------------
     Material::Material() :
-                    mPassCount(0), mBackToFront(false)
+                    mPassCount(0), mBackToFront(false), mSortKey(++sortKeyCount)
     {}
 
 
@@ -34,6 +37,7 @@ namespace dma {
             mPasses[i] = material.mPasses[i];
         }
         this->mBackToFront = material.mBackToFront;
+        this->mSortKey = ++sortKeyCount;
     }
 
 
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "resource/MaterialInstance.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "MaterialInstance";
+
+namespace dma {
+
+    /* ================= PUBLIC ========================*/
+
+    //---------------------------------------------------------------------
+    MaterialInstance::MaterialInstance(std::shared_ptr<Material> base) :
+            mBase(base)
+    {
+        assert(mBase != nullptr);
+    }
+
+
+    //---------------------------------------------------------------------
+    MaterialInstance::~MaterialInstance() {
+
+    }
+
+
+    //---------------------------------------------------------------------
+    const std::shared_ptr<Map>& MaterialInstance::getDiffuseMap(U8 i) const {
+        assert(i < getPassCount());
+        if (mOverrides[i].flags & DIFFUSE_MAP) {
+            return mOverrides[i].diffuseMap;
+        }
+        return mBase->getPass(i).getDiffuseMap();
+    }
+
+
+    //---------------------------------------------------------------------
+    void MaterialInstance::setDiffuseMap(std::shared_ptr<Map> diffuseMap, U8 i) {
+        assert(i < getPassCount());
+        assert(diffuseMap != nullptr);
+        Override& o = mOverrides[i];
+        o.diffuseMap = diffuseMap;
+        o.flags |= DIFFUSE_MAP;
+        mAddFunc(Pass::Func::DIFFUSE_MAP, i);
+        // same as Pass::setDiffuseMap
+        setDiffuseMapEnabled(true, i);
+    }
+
+
+    //---------------------------------------------------------------------
+    bool MaterialInstance::isDiffuseMapEnabled(U8 i) const {
+        assert(i < getPassCount());
+        if (mOverrides[i].flags & DIFFUSE_MAP_ENABLED) {
+            return mOverrides[i].diffuseMapEnabled;
+        }
+        return mBase->getPass(i).isDiffuseMapEnabled();
+    }
+
+
+    //---------------------------------------------------------------------
+    void MaterialInstance::setDiffuseMapEnabled(bool enabled, U8 i) {
+        assert(i < getPassCount());
+        mOverrides[i].diffuseMapEnabled = enabled;
+        mOverrides[i].flags |= DIFFUSE_MAP_ENABLED;
+    }
+
+
+    //---------------------------------------------------------------------
+    const glm::vec3& MaterialInstance::getDiffuseColor(U8 i) const {
+        assert(i < getPassCount());
+        if (mOverrides[i].flags & DIFFUSE_COLOR) {
+            return mOverrides[i].diffuseColor;
+        }
+        return mBase->getPass(i).getDiffuseColor();
+    }
+
+
+    //---------------------------------------------------------------------
+    void MaterialInstance::setDiffuseColor(const glm::vec3& diffuseColor, U8 i) {
+        assert(i < getPassCount());
+        Override& o = mOverrides[i];
+        o.diffuseColor = diffuseColor;
+        o.flags |= DIFFUSE_COLOR;
+        mAddFunc(Pass::Func::DIFFUSE_COLOR, i);
+    }
+
+
+    //---------------------------------------------------------------------
+    void MaterialInstance::setLightingMode(Pass::Func lightingMode, U8 i) {
+        assert(i < getPassCount());
+        switch (lightingMode) {
+            case Pass::LIGHTING_FLAT:
+                mRemoveFunc(Pass::Func::LIGHTING_SMOOTH, i);
+                break;
+            case Pass::LIGHTING_SMOOTH:
+                mRemoveFunc(Pass::Func::LIGHTING_FLAT, i);
+                break;
+            default:
+                LOG_WARN(TAG, "Wrong lighting mode. Has no effect");
+                assert(false);
+                return;
+        }
+        mAddFunc(lightingMode, i);
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //---------------------------------------------------------------------
+    void MaterialInstance::mAddFunc(Pass::Func func, U8 i) {
+        mOverrides[i].addedFuncFlags |= (1L << func);
+        mOverrides[i].removedFuncFlags &= ~(1L << func);
+    }
+
+
+    //---------------------------------------------------------------------
+    void MaterialInstance::mRemoveFunc(Pass::Func func, U8 i) {
+        mOverrides[i].removedFuncFlags |= (1L << func);
+        mOverrides[i].addedFuncFlags &= ~(1L << func);
+    }
+}
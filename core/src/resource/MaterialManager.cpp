@@ -48,14 +48,14 @@ namespace dma {
 
     //------------------------------------------------------------------------------
     Status MaterialManager::reload() {
-        Log::trace(TAG, "Reloading MaterialManager...");
+        LOG_TRACE(TAG, "Reloading MaterialManager...");
 
         mFallbackMaterial->reset();
         mLoad(mFallbackMaterial, FALLBACK_MATERIAL_SID);
 
-        for (auto& kv : mMaterials) {
-            const std::string& sid = kv.first;
-            auto material = kv.second;
+        for (auto& kv : mIndex) {
+            const std::string& sid = kv.first.str();
+            const std::shared_ptr<Material>& material = mMaterials.getShared(kv.second);
             if (material != nullptr) {
                 material->reset();
                 if (mLoad(material, sid) != STATUS_OK) {
@@ -65,7 +65,7 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "MaterialManager reloaded");
+        LOG_TRACE(TAG, "MaterialManager reloaded");
         return STATUS_OK;
     }
 
@@ -74,36 +74,39 @@ namespace dma {
     std::shared_ptr<Material> MaterialManager::acquire(const std::string& sid, Status* result) {
         //////////////////////////////////////////////////:
         // Check if material doesn't exist
-        if (mMaterials.find(sid) == mMaterials.end()) {
+        Sid key(sid);
+        auto it = mIndex.find(key);
+        if (it == mIndex.end()) {
             std::shared_ptr<Material> material = std::make_shared<Material>();
             *result = mLoad(material, sid);
             if (*result != STATUS_OK) {
-                Log::warn(TAG, "Material %s doesn't exist, returning fallback instead", sid.c_str());
+                LOG_WARN(TAG, "Material %s doesn't exist, returning fallback instead", sid.c_str());
                 return mFallbackMaterial;
             }
-            mMaterials[sid] = material;
+            it = mIndex.insert(std::make_pair(key, mMaterials.add(material))).first;
         }
         *result = STATUS_OK;
-        return mMaterials[sid];
+        return mMaterials.getShared(it->second);
     }
 
 
     //------------------------------------------------------------------------------
     void MaterialManager::unload() {
-        Log::trace(TAG, "Unloading MaterialManager...");
+        LOG_TRACE(TAG, "Unloading MaterialManager...");
         if (mFallbackMaterial != nullptr) {
             mFallbackMaterial = nullptr; //release reference count
         }
         mMaterials.clear();
-        Log::trace(TAG, "MaterialManager unloaded...");
+        mIndex.clear();
+        LOG_TRACE(TAG, "MaterialManager unloaded...");
     }
 
 
     //------------------------------------------------------------------------------
     bool MaterialManager::hasResource(const std::string & sid) const {
         const std::string& path = mLocalDir + sid;
-        Log::trace(TAG, "Checking if material %s.json exists", path.c_str());
-        return Utils::fileExists(path + ".json") || Utils::fileExists(path + ".JSON");
+        LOG_TRACE(TAG, "Checking if material %s.json exists", path.c_str());
+        return mFileIndex.exists(path + ".json") || mFileIndex.exists(path + ".JSON");
     }
 
 
@@ -112,9 +115,11 @@ namespace dma {
     //CONSTRUCTORS
     //------------------------------------------------------------------------------
     MaterialManager::MaterialManager(const std::string &localDir,
+                                     ResourceIndex& fileIndex,
                                      ShaderManager& shaderManager,
                                      MapManager&mapManager) :
             mLocalDir(localDir),
+            mFileIndex(fileIndex),
             mShaderManager(shaderManager),
             mMapManager(mapManager)
     {
@@ -124,14 +129,18 @@ namespace dma {
     //METHODS
 
     //------------------------------------------------------------------------------
-    Status MaterialManager::mLoad(std::shared_ptr<Material> material, const std::string& sid) const {
+    Status MaterialManager::mLoad(const std::shared_ptr<Material>& material, const std::string& sid) const {
 
-        Log::trace(TAG, "Loading material %s ...", sid.c_str());
+        LOG_TRACE(TAG, "Loading material %s ...", sid.c_str());
 
         std::string path = mLocalDir + sid + ".json";
 
         MaterialReader materialReader(path);
-        Status status = materialReader.parse();
+        std::string json;
+        Status status = mFileIndex.read(path, json);
+        if (status == STATUS_OK) {
+            status = materialReader.parse(json);
+        }
         if(status != STATUS_OK) {
             Log::error(TAG, "Error while parsing material %s", path.c_str());
             assert(!"Error while parsing material");
@@ -271,7 +280,7 @@ namespace dma {
 
             material->addPass(pass);
         }
-        Log::trace(TAG, "Material %s loaded", sid.c_str());
+        LOG_TRACE(TAG, "Material %s loaded", sid.c_str());
         return STATUS_OK;
     }
 
@@ -284,17 +293,18 @@ namespace dma {
 
 
     //------------------------------------------------------------------------------
-    std::shared_ptr<Material> MaterialManager::create(const std::string &sid, Status *result) {
-        return std::make_shared<Material>(*acquire(sid, result));
+    std::shared_ptr<MaterialInstance> MaterialManager::create(const std::string &sid, Status *result) {
+        return std::make_shared<MaterialInstance>(acquire(sid, result));
     }
 
 
     //------------------------------------------------------------------------------
     void MaterialManager::update() {
-        auto it = mMaterials.begin();
-        while (it != mMaterials.end()) {
-            if (it->second.unique()) {
-                it = mMaterials.erase(it);
+        auto it = mIndex.begin();
+        while (it != mIndex.end()) {
+            if (mMaterials.getShared(it->second).unique()) {
+                mMaterials.remove(it->second);
+                it = mIndex.erase(it);
             } else {
                 ++it;
             }
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "resource/MemoryReport.hpp"
+
+#include <algorithm>
+
+namespace dma {
+
+    const char* MemoryReport::CATEGORY_NAMES[] = {
+            "meshes", "maps", "cubemaps", "fonts", "vector tiles", "terrain", "shaders",
+            "sprite atlas", "HUD buffers", "label buffers", "billboard buffers"
+    };
+
+
+    //------------------------------------------------------------------------
+    inline void raisePeak(MemoryUsage& peak, const MemoryUsage& usage) {
+        peak.count = std::max(peak.count, usage.count);
+        peak.cpuBytes = std::max(peak.cpuBytes, usage.cpuBytes);
+        peak.gpuBytes = std::max(peak.gpuBytes, usage.gpuBytes);
+    }
+
+
+    //------------------------------------------------------------------------
+    void MemoryReport::set(Category category, const MemoryUsage& usage) {
+        mCurrent[category] = usage;
+        raisePeak(mPeaks[category], usage);
+        raisePeak(mPeakTotal, getTotal());
+    }
+
+
+    //------------------------------------------------------------------------
+    MemoryUsage MemoryReport::getTotal() const {
+        MemoryUsage total;
+        for (U8 i = 0; i < size; ++i) {
+            total += mCurrent[i];
+        }
+        return total;
+    }
+
+
+    //------------------------------------------------------------------------
+    const char* MemoryReport::getName(Category category) {
+        return CATEGORY_NAMES[category];
+    }
+}
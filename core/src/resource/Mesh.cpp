@@ -17,6 +17,7 @@
 
 
 #include "resource/Mesh.hpp"
+#include "resource/ShaderProgram.hpp"
 
 namespace dma {
 
@@ -28,7 +29,11 @@ namespace dma {
             mVertexSize(0),
             mVertexCount(0),
             mVertexBuffer(nullptr),
-            mIndexBuffer(nullptr)
+            mIndexBuffer(nullptr),
+            mQuantizedPositions(false),
+            mPositionDecode(1.0f),
+            mPositionScale(1.0f),
+            mBytesSaved(0)
     {}
 
 
@@ -45,18 +50,78 @@ namespace dma {
     }
 
 
+    //------------------------------------------------------------------------------
+    const VertexArray* Mesh::findVertexArray(const ShaderProgram& program, U32 funcFlags) const {
+        for (const VertexArrayEntry& entry : mVertexArrays) {
+            if (entry.program == &program && entry.funcFlags == funcFlags) {
+                if (entry.programRevision == program.getLinkRevision()
+                    && entry.vertexArray.isValid(mVertexBuffer->getHandle(), mIndexBuffer->getHandle())) {
+                    return &entry.vertexArray;
+                }
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+
+    //------------------------------------------------------------------------------
+    const VertexArray& Mesh::setVertexArray(const ShaderProgram& program, U32 funcFlags,
+                                            const std::vector<VertexArray::Attribute>& attributes) {
+        VertexArrayEntry* entry = nullptr;
+        for (VertexArrayEntry& e : mVertexArrays) {
+            if (e.program == &program && e.funcFlags == funcFlags) {
+                entry = &e;
+                break;
+            }
+        }
+        if (entry == nullptr) {
+            mVertexArrays.push_back(VertexArrayEntry());
+            entry = &mVertexArrays.back();
+            entry->program = &program;
+            entry->funcFlags = funcFlags;
+        }
+        entry->programRevision = program.getLinkRevision();
+        entry->vertexArray.build(mVertexBuffer->getHandle(), mIndexBuffer->getHandle(), attributes);
+        return entry->vertexArray;
+    }
+
+
+    //------------------------------------------------------------------------------
+    U32 Mesh::getGpuBytes() const {
+        U32 bytes = 0;
+        if (mVertexBuffer != nullptr && mVertexBuffer->getHandle() != 0) {
+            bytes += mVertexBuffer->getSizeInByte();
+        }
+        if (mIndexBuffer != nullptr && mIndexBuffer->getHandle() != 0) {
+            bytes += (U32) mIndexBuffer->getSizeInByte();
+        }
+        return bytes;
+    }
+
+
     //------------------------------------------------------------------------------
     void Mesh::wipe() {
+        clearVertexArrays();
         mVertexBuffer->wipe();
         mIndexBuffer->wipe();
     }
 
 
+    //------------------------------------------------------------------------------
+    void Mesh::clearVertexArrays() {
+        for (VertexArrayEntry& entry : mVertexArrays) {
+            entry.vertexArray.wipe();
+        }
+        mVertexArrays.clear();
+    }
+
+
     //------------------------------------------------------------------------------
     void Mesh::clearCache() {
-        positions.clear();
-        uvs.clear();
-        flatNormals.clear();
-        vertexIndices.clear();
+        mVertexData.clear();
+        mVertexData.shrink_to_fit();
+        mIndexData.clear();
+        mIndexData.shrink_to_fit();
     }
 }
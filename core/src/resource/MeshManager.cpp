@@ -20,9 +20,11 @@
 #include "utils/ObjReader.hpp"
 #include "utils/Log.hpp"
 #include "utils/ExceptionHandler.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 
 #include <set>
 #include <algorithm>
+#include <limits>
 #include <string.h>
 
 constexpr auto TAG = "MeshManager";
@@ -34,14 +36,56 @@ namespace dma {
     /* ================= ROUTINES ========================*/
 
     //----------------------------------------------------------------------------------------------
-    Status loadObj(const std::string& path,
+    /** vertex elements are aligned on 4 bytes. */
+    static inline U32 align(U32 size) {
+        return (size + 3u) & ~3u;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Writes [-1, 1] floats as normalized signed integers.
+     * OpenGL ES 2 decodes them as (2c + 1) / (2^b - 1).
+     */
+    template<typename T>
+    static void writeSnorm(BYTE* dst, const F32* src, U32 count) {
+        constexpr F32 range = (F32) std::numeric_limits<T>::max() - (F32) std::numeric_limits<T>::min();
+        for (U32 i = 0; i < count; ++i) {
+            F32 c = glm::round((glm::clamp(src[i], -1.0f, 1.0f) * range - 1.0f) * 0.5f);
+            T value = (T) glm::clamp(c, (F32) std::numeric_limits<T>::min(), (F32) std::numeric_limits<T>::max());
+            memcpy(dst + i * sizeof(T), &value, sizeof(T));
+        }
+    }
+
+    static inline void writeSnorm8(BYTE* dst, const F32* src, U32 count) {
+        writeSnorm<GLbyte>(dst, src, count);
+    }
+
+    static inline void writeSnorm16(BYTE* dst, const F32* src, U32 count) {
+        writeSnorm<GLshort>(dst, src, count);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Writes [0, 1] floats as normalized unsigned 16-bit integers.
+     */
+    static void writeUnorm16(BYTE* dst, const F32* src, U32 count) {
+        for (U32 i = 0; i < count; ++i) {
+            GLushort value = (GLushort) glm::round(glm::clamp(src[i], 0.0f, 1.0f) * 65535.0f);
+            memcpy(dst + i * sizeof(GLushort), &value, sizeof(GLushort));
+        }
+    }
+
+    //----------------------------------------------------------------------------------------------
+    Status loadObj(ObjReader& objReader,
+                   const std::string& path,
                    std::vector<glm::vec3>& positions,
                    std::vector<glm::vec2>& uvs,
                    std::vector<glm::vec3>& flatNormals,
                    std::vector<VertexIndices>& vertexIndices) {
         /////////////////////////////////////////////////////
-        //1. open obj file.
-        ObjReader objReader(path);
+        //1. check the obj file is open.
         if(!objReader.isOpen()) {
             Log::error(TAG, "Cannot open file %s", path.c_str());
             assert(!"Cannot open obj file");
@@ -204,33 +248,36 @@ namespace dma {
             return mFallbackMesh;
         }
 
-        if (mMeshes.find(sid) == mMeshes.end()) {
+        Sid key(sid);
+        auto it = mIndex.find(key);
+        if (it == mIndex.end()) {
             std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
             *result = mLoad(mesh, sid);
             if (*result != STATUS_OK) {
-                Log::warn(TAG, "Mesh %s doesn't exist, returning fallback instead", sid.c_str());
+                LOG_WARN(TAG, "Mesh %s doesn't exist, returning fallback instead", sid.c_str());
                 return mFallbackMesh;
             }
-            mMeshes[sid] = mesh;
+            it = mIndex.insert(std::make_pair(key, mMeshes.add(mesh))).first;
         }
         *result = STATUS_OK;
-        return mMeshes[sid];
+        return mMeshes.getShared(it->second);
     }
 
 
     //----------------------------------------------------------------------------------------------
     Status MeshManager::reload() {
-        Log::trace(TAG, "Reloading MeshManager...");
+        LOG_TRACE(TAG, "Reloading MeshManager...");
 
         mFallbackMesh->wipe();
         mLoad(mFallbackMesh, FALLBACK_MESH_SID);
 
-        for (auto& kv : mMeshes) {
-            const std::string& sid = kv.first;
-            auto mesh = kv.second;
+        for (auto& kv : mIndex) {
+            const std::string& sid = kv.first.str();
+            const std::shared_ptr<Mesh>& mesh = mMeshes.getShared(kv.second);
             if (mesh != nullptr) {
                 mesh->wipe();
                 mesh->clearCache();
+                mSpillCache.remove(mLocalDir + sid + ".obj");
                 if (mLoad(mesh, sid) != STATUS_OK) {
                     Log::error(TAG, "Error while refreshing mesh %s", sid.c_str());
                     assert(false);
@@ -239,21 +286,21 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "MeshManager reloaded");
+        LOG_TRACE(TAG, "MeshManager reloaded");
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------------------------
     Status MeshManager::refresh() {
-        Log::trace(TAG, "Refreshing MeshManager...");
+        LOG_TRACE(TAG, "Refreshing MeshManager...");
 
         //mFallbackMesh->wipe();
         mLoad(mFallbackMesh, FALLBACK_MESH_SID);
 
-        for (auto& kv : mMeshes) {
-            const std::string& sid = kv.first;
-            auto mesh = kv.second;
+        for (auto& kv : mIndex) {
+            const std::string& sid = kv.first.str();
+            const std::shared_ptr<Mesh>& mesh = mMeshes.getShared(kv.second);
             //mesh->wipe();
             if (mLoad(mesh, sid) != STATUS_OK) {
                 Log::error(TAG, "Error while refreshing mesh %s", sid.c_str());
@@ -262,47 +309,81 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "MeshManager refreshed");
+        LOG_TRACE(TAG, "MeshManager refreshed");
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------------------------
     void MeshManager::unload() {
-        Log::trace(TAG, "Unloading MeshManager...");
+        LOG_TRACE(TAG, "Unloading MeshManager...");
 
         assert(mFallbackMesh != nullptr);
         mFallbackMesh->wipe();
         mFallbackMesh = nullptr; //release reference count
 
-        for (auto& kv : mMeshes) {
-            const std::string& sid = kv.first;
-            auto mesh = kv.second;
+        for (auto& kv : mIndex) {
+            const std::string& sid = kv.first.str();
+            const std::shared_ptr<Mesh>& mesh = mMeshes.getShared(kv.second);
             assert(mesh != nullptr);
-            Log::trace(TAG, "Deleting Mesh %s", sid.c_str());
+            LOG_TRACE(TAG, "Deleting Mesh %s", sid.c_str());
             mesh->wipe();
         }
 
         mMeshes.clear();
+        mIndex.clear();
 
-        Log::trace(TAG, "MeshManager unloaded");
+        LOG_TRACE(TAG, "MeshManager unloaded");
     }
 
 
     //----------------------------------------------------------------------------------------------
     void MeshManager::wipe() {
-        Log::trace(TAG, "Wiping MeshManager...");
+        LOG_TRACE(TAG, "Wiping MeshManager...");
 
         assert(mFallbackMesh != nullptr);
         mFallbackMesh->wipe();
 
-        for (auto& kv : mMeshes) {
-            auto mesh = kv.second;
+        for (auto& kv : mIndex) {
+            Mesh* mesh = mMeshes.get(kv.second);
             assert(mesh != nullptr);
             mesh->wipe();
         }
 
-        Log::trace(TAG, "MeshManager wiped");
+        LOG_TRACE(TAG, "MeshManager wiped");
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    U32 MeshManager::getBytesSaved() const {
+        U32 bytesSaved = 0;
+        for (auto& kv : mIndex) {
+            bytesSaved += mMeshes.get(kv.second)->getBytesSaved();
+        }
+        return bytesSaved;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void MeshManager::setRetention(Retention retention) {
+        mRetention = retention;
+        if (mFallbackMesh != nullptr) {
+            mRelease(*mFallbackMesh, mLocalDir + FALLBACK_MESH_SID + ".obj");
+        }
+        for (auto& kv : mIndex) {
+            mRelease(*mMeshes.get(kv.second), mLocalDir + kv.first.str() + ".obj");
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    MemoryUsage MeshManager::getMemoryUsage() const {
+        MemoryUsage usage;
+        for (auto& kv : mIndex) {
+            const Mesh* mesh = mMeshes.get(kv.second);
+            usage.add(mesh->getCpuBytes(), mesh->getGpuBytes());
+        }
+        return usage;
     }
 
 
@@ -310,33 +391,47 @@ namespace dma {
     bool MeshManager::hasResource(const std::string & sid) const {
         //filename, deduced from SID
         const std::string& path = mLocalDir + sid;
-        Log::trace(TAG, "checking if mesh %s exists...", sid.c_str());
-        return Utils::fileExists(path + ".obj") || Utils::fileExists(path + ".OBJ");
+        LOG_TRACE(TAG, "checking if mesh %s exists...", sid.c_str());
+        return mFileIndex.exists(path + ".obj") || mFileIndex.exists(path + ".OBJ");
     }
 
     /* ================= PRIVATE ========================*/
 
 
     //----------------------------------------------------------------------------------------------
-    MeshManager::MeshManager(const std::string& localDir) :
-            mMeshes() {
+    MeshManager::MeshManager(const std::string& localDir, ResourceIndex& fileIndex, SpillCache& spillCache) :
+            mFileIndex(fileIndex),
+            mSpillCache(spillCache),
+            mQuantization(QUANTIZE_NONE),
+            mRetention(Retention::KEEP) {
         mLocalDir = localDir;
     }
 
 
     //--------------------------------------------------------------------
-    Status MeshManager::mLoad(std::shared_ptr<Mesh> mesh, const std::string& sid) const {
-        //try to load from the cache
+    Status MeshManager::mLoad(const std::shared_ptr<Mesh>& mesh, const std::string& sid) const {
+        const std::string path = mLocalDir + sid + ".obj";
+        Status status;
+        //try to load from the cache: data is already GPU ready, just upload it.
         if (mesh->hasCache()) {
-            return mLoad(mesh, sid,
-                         mesh->positions,
-                         mesh->uvs,
-                         mesh->flatNormals,
-                         mesh->vertexIndices);
-        }
+            LOG_TRACE(TAG, "Uploading mesh %s from cache", sid.c_str());
+            status = mUpload(mesh);
+        } else if (mReadSpilled(*mesh, path)) {
+            LOG_TRACE(TAG, "Uploading mesh %s from the spill cache", sid.c_str());
+            status = mUpload(mesh);
+        } else {
+            //otherwise load from the file
+            status = mRead(mesh, sid);
+        }
+        if (status == STATUS_OK) {
+            mRelease(*mesh, path);
+        }
+        return status;
+    }
 
-        //otherwise load from the file
 
+    //--------------------------------------------------------------------
+    Status MeshManager::mRead(const std::shared_ptr<Mesh>& mesh, const std::string& sid) const {
         // stores elements as they comes from .obj
         std::vector<glm::vec3> positions;
         std::vector<glm::vec2> uvs;
@@ -347,24 +442,70 @@ namespace dma {
         //filename, deduced from SID
         std::string path = mLocalDir + sid + ".obj";
 
-        //load positions uvs and their indices from the obj file
-        if (loadObj(path, positions, uvs, flatNormals, vertexIndices) != STATUS_OK) {
+        //load positions uvs and their indices from the obj file, packed or loose
+        Status status;
+        AssetPack::Entry entry;
+        if (mFileIndex.findPacked(path, entry)) {
+            ObjReader objReader(entry.data, entry.size);
+            status = loadObj(objReader, path, positions, uvs, flatNormals, vertexIndices);
+        } else {
+            ObjReader objReader(path);
+            status = loadObj(objReader, path, positions, uvs, flatNormals, vertexIndices);
+        }
+        if (status != STATUS_OK) {
             Log::error(TAG, "Unable to load obj %s", path.c_str());
             return STATUS_KO;
         }
 
-        //update the cache if any
-        mesh->positions = positions;
-        mesh->uvs = uvs;
-        mesh->flatNormals = flatNormals;
-        mesh->vertexIndices = vertexIndices;
-
         return mLoad(mesh, sid, positions, uvs, flatNormals, vertexIndices);
     }
 
 
     //--------------------------------------------------------------------
-    Status MeshManager::mLoad(std::shared_ptr<Mesh> mesh, const std::string &sid,
+    bool MeshManager::mReadSpilled(Mesh& mesh, const std::string& key) const {
+        std::vector<BYTE> data;
+        if (!mSpillCache.contains(key) || mSpillCache.read(key, data) != STATUS_OK) {
+            return false;
+        }
+        // vertex data size, vertex data, index data
+        U32 vertexBytes;
+        if (data.size() < sizeof(vertexBytes)) {
+            return false;
+        }
+        memcpy(&vertexBytes, data.data(), sizeof(vertexBytes));
+        const BYTE* vertices = data.data() + sizeof(vertexBytes);
+        if (data.size() - sizeof(vertexBytes) < vertexBytes) {
+            return false;
+        }
+        const U32 indexBytes = (U32) (data.size() - sizeof(vertexBytes) - vertexBytes);
+        mesh.mVertexData.assign(vertices, vertices + vertexBytes);
+        mesh.mIndexData.resize(indexBytes / sizeof(U16));
+        memcpy(mesh.mIndexData.data(), vertices + vertexBytes, mesh.mIndexData.size() * sizeof(U16));
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------
+    void MeshManager::mRelease(Mesh& mesh, const std::string& key) const {
+        if (mRetention == Retention::KEEP || !mesh.hasCache()) {
+            return;
+        }
+        if (mRetention == Retention::SPILL && !mSpillCache.contains(key)) {
+            const U32 vertexBytes = (U32) mesh.mVertexData.size();
+            const U32 indexBytes = (U32) (mesh.mIndexData.size() * sizeof(U16));
+            if (mSpillCache.write(key, {{&vertexBytes, sizeof(vertexBytes)},
+                                        {mesh.mVertexData.data(), vertexBytes},
+                                        {mesh.mIndexData.data(), indexBytes}}) != STATUS_OK) {
+                // better kept than lost.
+                return;
+            }
+        }
+        mesh.clearCache();
+    }
+
+
+    //--------------------------------------------------------------------
+    Status MeshManager::mLoad(const std::shared_ptr<Mesh>& mesh, const std::string &sid,
                               std::vector<glm::vec3> &positions,
                               std::vector<glm::vec2> &uvs,
                               std::vector<glm::vec3> &flatNormals,
@@ -373,12 +514,12 @@ namespace dma {
         bool hasUv, hasFlat, hasSmooth;
         hasUv = !uvs.empty();
         if (!hasUv) {
-            Log::trace(TAG, "no UV mapping found for mesh \"%s\"", sid.c_str());
+            LOG_TRACE(TAG, "no UV mapping found for mesh \"%s\"", sid.c_str());
         }
 
         hasFlat = !flatNormals.empty();
         if (!hasFlat) {
-            Log::trace(TAG, "no Flat normal mapping found for mesh \"%s\"", sid.c_str());
+            LOG_TRACE(TAG, "no Flat normal mapping found for mesh \"%s\"", sid.c_str());
         }
 
         // generates normals
@@ -429,94 +570,177 @@ namespace dma {
         U32 vertexSize = 0;
         U32 vertexCount = (U32) vertices.size();
 
+        bool quantizePositions = (mQuantization & QUANTIZE_POSITIONS) != 0;
+        bool quantizeNormals = (mQuantization & QUANTIZE_NORMALS) != 0;
+        bool quantizeUvs = (mQuantization & QUANTIZE_UVS) != 0 && hasUv;
+        for (U32 v = 0; v < vertexCount && quantizeUvs; ++v) {
+            const glm::vec2& uv = vertices[v].getUv();
+            quantizeUvs = uv.x >= 0.0f && uv.x <= 1.0f && uv.y >= 0.0f && uv.y <= 1.0f;
+        }
+        if (hasUv && (mQuantization & QUANTIZE_UVS) && !quantizeUvs) {
+            LOG_TRACE(TAG, "UVs of mesh \"%s\" out of [0, 1], kept as floats", sid.c_str());
+        }
+
         //Positions
-        VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, vertexSize);
-        vertexSize += positionElement.getSizeInByte();
+        if (quantizePositions) {
+            glm::vec3 min = vertices[0].getPosition();
+            glm::vec3 max = min;
+            for (const Vertex& vertex : vertices) {
+                min = glm::min(min, vertex.getPosition());
+                max = glm::max(max, vertex.getPosition());
+            }
+            glm::vec3 center = (min + max) * 0.5f;
+            glm::vec3 halfExtent = (max - min) * 0.5f;
+            // flat axis: any scale decodes it.
+            halfExtent = glm::max(halfExtent, glm::vec3(std::numeric_limits<F32>::epsilon()));
+            mesh->mPositionDecode = glm::translate(glm::mat4(1.0f), center) * glm::scale(glm::mat4(1.0f), halfExtent);
+            mesh->mPositionScale = 1.0f / halfExtent;
+        } else {
+            mesh->mPositionDecode = glm::mat4(1.0f);
+            mesh->mPositionScale = glm::vec3(1.0f);
+        }
+        mesh->mQuantizedPositions = quantizePositions;
+
+        VertexElement positionElement = quantizePositions ?
+            VertexElement(VertexElement::Semantic::POSITION, 3, GL_SHORT, vertexSize, true) :
+            VertexElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, vertexSize);
+        vertexSize += align(positionElement.getSizeInByte());
         mesh->addVertexElement(positionElement);
 
 
         //Normals
         if (hasFlat) {
-            VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT, vertexSize);
-            vertexSize += flatNormalElement.getSizeInByte();
+            VertexElement flatNormalElement = quantizeNormals ?
+                VertexElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_BYTE, vertexSize, true) :
+                VertexElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT, vertexSize);
+            vertexSize += align(flatNormalElement.getSizeInByte());
             mesh->addVertexElement(flatNormalElement);
         }
         if (hasSmooth) {
-            VertexElement smoothNormalElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, GL_FLOAT, vertexSize);
-            vertexSize += smoothNormalElement.getSizeInByte();
+            VertexElement smoothNormalElement = quantizeNormals ?
+                VertexElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, GL_BYTE, vertexSize, true) :
+                VertexElement(VertexElement::Semantic::SMOOTH_NORMAL, 3, GL_FLOAT, vertexSize);
+            vertexSize += align(smoothNormalElement.getSizeInByte());
             mesh->addVertexElement(smoothNormalElement);
         }
 
         // UVs
         if (hasUv) {
-            VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_FLOAT, vertexSize);
-            vertexSize += uvElement.getSizeInByte();
+            VertexElement uvElement = quantizeUvs ?
+                VertexElement(VertexElement::Semantic::UV, 2, GL_UNSIGNED_SHORT, vertexSize, true) :
+                VertexElement(VertexElement::Semantic::UV, 2, GL_FLOAT, vertexSize);
+            vertexSize += align(uvElement.getSizeInByte());
             mesh->addVertexElement(uvElement);
         }
 
         mesh->mVertexSize = vertexSize;
         mesh->mVertexCount = vertexCount;
-        //Log::debug(TAG, "vertexSize=%d vertexCount=%d", vertexSize, vertexCount);
-        //Log::debug(TAG, "indices=%d", indices.size());
+        //LOG_DEBUG(TAG, "vertexSize=%d vertexCount=%d", vertexSize, vertexCount);
+        //LOG_DEBUG(TAG, "indices=%d", indices.size());
 
-        BYTE* data = new BYTE[vertexSize * vertexCount];
-
-        /////////////////////////////////////////////////////////////////////////
-        // Generate vertex buffer
-        //delete mesh->mVertexBuffer;
-        if (mesh->mVertexBuffer != nullptr) {
-            mesh->mVertexBuffer->wipe();
+        // same layout, with 32-bit floats only.
+        U32 floatVertexSize = (U32) ((3 + (hasFlat ? 3 : 0) + (hasSmooth ? 3 : 0) + (hasUv ? 2 : 0)) * sizeof(GLfloat));
+        mesh->mBytesSaved = (floatVertexSize - vertexSize) * vertexCount;
+        if (mesh->mBytesSaved > 0) {
+            LOG_DEBUG(TAG, "Mesh %s quantized: %d bytes saved (%d bytes per vertex instead of %d)",
+                       sid.c_str(), mesh->mBytesSaved, vertexSize, floatVertexSize);
         }
-        mesh->mVertexBuffer = std::make_shared<VertexBuffer>(vertexSize, (U32) (vertexSize * vertexCount));
+
+        std::vector<BYTE>& data = mesh->mVertexData;
+        data.assign(vertexSize * vertexCount, 0);
 
         /////////////////////////////////////////////////////////////////////////
         // Fills data
+        glm::mat4 positionEncode = glm::inverse(mesh->mPositionDecode);
         for (U32 v = 0; v < vertexCount; ++v) {
+            BYTE* vertex = &data[v * vertexSize];
             if (mesh->hasVertexElement(VertexElement::Semantic::POSITION)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::POSITION);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getPosition()), ve.getSizeInByte());
+                const VertexElement& ve = mesh->getVertexElement(VertexElement::Semantic::POSITION);
+                if (quantizePositions) {
+                    glm::vec3 p = glm::vec3(positionEncode * glm::vec4(vertices[v].getPosition(), 1.0f));
+                    writeSnorm16(vertex + ve.getOffset(), &p[0], 3);
+                } else {
+                    memcpy(vertex + ve.getOffset(), &(vertices[v].getPosition()), ve.getSizeInByte());
+                }
             }
             if (mesh->hasVertexElement(VertexElement::Semantic::FLAT_NORMAL)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::FLAT_NORMAL);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getFlatNormal()), ve.getSizeInByte());
+                const VertexElement& ve = mesh->getVertexElement(VertexElement::Semantic::FLAT_NORMAL);
+                if (quantizeNormals) {
+                    writeSnorm8(vertex + ve.getOffset(), &(vertices[v].getFlatNormal()[0]), 3);
+                } else {
+                    memcpy(vertex + ve.getOffset(), &(vertices[v].getFlatNormal()), ve.getSizeInByte());
+                }
             }
             if (mesh->hasVertexElement(VertexElement::Semantic::SMOOTH_NORMAL)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getSmoothNormal()), ve.getSizeInByte());
+                const VertexElement& ve = mesh->getVertexElement(VertexElement::Semantic::SMOOTH_NORMAL);
+                if (quantizeNormals) {
+                    writeSnorm8(vertex + ve.getOffset(), &(vertices[v].getSmoothNormal()[0]), 3);
+                } else {
+                    memcpy(vertex + ve.getOffset(), &(vertices[v].getSmoothNormal()), ve.getSizeInByte());
+                }
             }
             if (mesh->hasVertexElement(VertexElement::Semantic::UV)) {
-                VertexElement ve = mesh->getVertexElement(VertexElement::Semantic::UV);
-                memcpy(&data[v * vertexSize + ve.getOffset()], &(vertices[v].getUv()), ve.getSizeInByte());
+                const VertexElement& ve = mesh->getVertexElement(VertexElement::Semantic::UV);
+                if (quantizeUvs) {
+                    writeUnorm16(vertex + ve.getOffset(), &(vertices[v].getUv()[0]), 2);
+                } else {
+                    memcpy(vertex + ve.getOffset(), &(vertices[v].getUv()), ve.getSizeInByte());
+                }
             }
         }
+        mesh->mIndexData.swap(indices);
 
         /////////////////////////////////////////////////////////////////////////
         // Uploads data to GPU
-        mesh->mVertexBuffer->writeData(0, vertexSize * vertexCount, data);
-        delete[] data;
+        if (mUpload(mesh) != STATUS_OK) {
+            return STATUS_KO;
+        }
+
+        mesh->mBoundingSphere = generateBoundingSphere(positions);
+
+        LOG_TRACE(TAG, "Mesh %s loaded", sid.c_str());
+        return STATUS_OK;
+    }
+
+
+    //--------------------------------------------------------------------
+    Status MeshManager::mUpload(const std::shared_ptr<Mesh>& mesh) const {
+        assert(mesh->hasCache());
 
+        // recorded from the previous buffers, whose handles may be reused.
+        mesh->clearVertexArrays();
 
-        //delete mesh->mIndexBuffer;
+        /////////////////////////////////////////////////////////////////////////
+        // Generate vertex buffer
+        if (mesh->mVertexBuffer != nullptr) {
+            mesh->mVertexBuffer->wipe();
+        }
+        U32 sizeInByte = (U32) mesh->mVertexData.size();
+        mesh->mVertexBuffer = std::make_shared<VertexBuffer>(mesh->mVertexSize, sizeInByte);
+        mesh->mVertexBuffer->writeData(0, sizeInByte, mesh->mVertexData.data());
+
+        /////////////////////////////////////////////////////////////////////////
+        // Generate index buffer
         if (mesh->mIndexBuffer != nullptr) {
             mesh->mIndexBuffer->wipe();
         }
-        mesh->mIndexBuffer = std::make_shared<IndexBuffer>((U32) indices.size());
-        mesh->mIndexBuffer->writeData(indices.data());
+        mesh->mIndexBuffer = std::make_shared<IndexBuffer>((U32) mesh->mIndexData.size());
+        mesh->mIndexBuffer->writeData(mesh->mIndexData.data());
 
-        mesh->mBoundingSphere = generateBoundingSphere(positions);
-
-        Log::trace(TAG, "Mesh %s loaded", sid.c_str());
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------------
     void MeshManager::update() {
-        auto it = mMeshes.begin();
-        while (it != mMeshes.end()) {
-            if (it->second.unique()) {
-                it->second->wipe();
-                it = mMeshes.erase(it);
+        auto it = mIndex.begin();
+        while (it != mIndex.end()) {
+            const std::shared_ptr<Mesh>& mesh = mMeshes.getShared(it->second);
+            if (mesh.unique()) {
+                mesh->wipe();
+                mSpillCache.remove(mLocalDir + it->first.str() + ".obj");
+                mMeshes.remove(it->second);
+                it = mIndex.erase(it);
             } else {
                 ++it;
             }
@@ -39,8 +39,8 @@ namespace dma {
         Mesh::mVertexBuffer = vertexBuffer;
         Mesh::mIndexBuffer = indexBuffer;
 
-        //            Log::debug(TAG, "VertexBuffer: %s", mVertexBuffer.toString().c_str());
-        //            Log::debug(TAG, "IndexBuffer: %s", mIndexBuffer.toString().c_str());
+        //            LOG_DEBUG(TAG, "VertexBuffer: %s", mVertexBuffer.toString().c_str());
+        //            LOG_DEBUG(TAG, "IndexBuffer: %s", mIndexBuffer.toString().c_str());
 
         U32 offset = 0;
         VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, offset);
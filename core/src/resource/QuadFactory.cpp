@@ -40,7 +40,7 @@ namespace dma {
 
     //--------------------------------------------------
     void QuadFactory::init() {
-        Log::trace(TAG, "Loading QuadFactory...");
+        LOG_TRACE(TAG, "Loading QuadFactory...");
 
         GLfloat positions[] = {-1.0f, -1.0f, 0.0f,  // bottom left corner
                                -1.0f,  1.0f, 0.0f,  // top left corner
@@ -83,11 +83,11 @@ namespace dma {
         mVertexSize = vertexSize;
 
         BYTE* data = new BYTE[vertexSize * vertexCount];
-        Log::debug(TAG, "vertexSize=%d, vertexCount=%d", vertexSize, vertexCount);
+        LOG_DEBUG(TAG, "vertexSize=%d, vertexCount=%d", vertexSize, vertexCount);
 
         /////////////////////////////////////////////////////////////////////////
         // Fills data
-        Log::debug(TAG, "%d, %d", positionElement.getSizeInByte(), positionElement.getOffset());
+        LOG_DEBUG(TAG, "%d, %d", positionElement.getSizeInByte(), positionElement.getOffset());
         for (U32 v = 0; v < vertexCount; ++v) {
             memcpy(&data[v * vertexSize + positionElement.getOffset()], &(positions[3*v]), positionElement.getSizeInByte());
             memcpy(&data[v * vertexSize + uvElement.getOffset()], &(uvs[2*v]), uvElement.getSizeInByte());
@@ -106,29 +106,29 @@ namespace dma {
         mIndexBuffer->generateBuffer(6);
         mIndexBuffer->writeData(indices);
 
-        Log::trace(TAG, "QuadFactory loaded");
+        LOG_TRACE(TAG, "QuadFactory loaded");
     }
 
 
     //--------------------------------------------------
     void QuadFactory::unload() {
-        Log::trace(TAG, "Unloading QuadFactory...");
+        LOG_TRACE(TAG, "Unloading QuadFactory...");
 
         mVertexBuffer->wipe();
         mIndexBuffer->wipe();
 
-        Log::trace(TAG, "QuadFactory unloaded");
+        LOG_TRACE(TAG, "QuadFactory unloaded");
     }
 
 
     //--------------------------------------------------
     void QuadFactory::wipe() {
-        Log::trace(TAG, "Wiping QuadFactory...");
+        LOG_TRACE(TAG, "Wiping QuadFactory...");
 
         mVertexBuffer->wipe();
         mIndexBuffer->wipe();
 
-        Log::trace(TAG, "QuadFactory wiped");
+        LOG_TRACE(TAG, "QuadFactory wiped");
     }
 
 
@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/inotify.h>
+#endif
+
+#include "resource/ResourceIndex.hpp"
+#include "utils/Utils.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "ResourceIndex";
+
+namespace dma {
+
+    constexpr char ResourceIndex::PACK_FILE[];
+
+#ifdef __linux__
+    static constexpr U32 WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+#endif
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    ResourceIndex::ResourceIndex(const std::string& rootDir) :
+            mRootDir(rootDir),
+            mInit(false),
+            mRevision(0),
+            mPackFd(-1),
+            mPackOffset(0),
+            mPackLength(0),
+            mWatchFd(-1)
+    {
+        Utils::addTrailingSlash(mRootDir);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    ResourceIndex::~ResourceIndex() {
+        setWatchEnabled(false);
+        setPackFile(-1, 0, 0);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::init() {
+        mFiles.clear();
+        mInit = false;
+        ++mRevision;
+        mPack.close();
+        if (mRootDir.empty()) {
+            return;
+        }
+        if (isWatchEnabled()) {
+            // watches are added back while scanning.
+            setWatchEnabled(false);
+            setWatchEnabled(true);
+        } else {
+            mScan("");
+            mInit = true;
+        }
+        LOG_DEBUG(TAG, "%d files indexed in %s", (int) mFiles.size(), mRootDir.c_str());
+
+        if (mPackFd >= 0) {
+            mPack.open(mPackFd, mPackOffset, mPackLength, PACK_FILE);
+        } else if (mFiles.find(PACK_FILE) != mFiles.end()) {
+            mPack.open(mRootDir + PACK_FILE);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::setPackFile(int fd, U64 offset, U64 length) {
+        if (mPackFd >= 0) {
+            close(mPackFd);
+        }
+        mPackFd = fd >= 0 ? dup(fd) : -1;
+        mPackOffset = offset;
+        mPackLength = length;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::ignore(const std::string& dir) {
+        std::string relative = dir;
+        Utils::addTrailingSlash(relative);
+        mIgnoredDirs.insert(relative);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    U32 ResourceIndex::getRevision(const std::string& dir) const {
+        std::string relative;
+        if (!mRelative(dir, relative)) {
+            return mRevision;
+        }
+        Utils::addTrailingSlash(relative);
+        auto it = mDirRevisions.find(relative);
+        // both only grow: so does their sum.
+        return mRevision + (it != mDirRevisions.end() ? it->second : 0);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::clear() {
+        mFiles.clear();
+        mInit = false;
+        ++mRevision;
+        mPack.close();
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    bool ResourceIndex::exists(const std::string& path) const {
+        std::string relative;
+        if (!mRelative(path, relative)) {
+            return Utils::fileExists(path);
+        }
+        AssetPack::Entry entry;
+        return mFiles.find(relative) != mFiles.end() || mPack.find(relative, entry);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    bool ResourceIndex::findPacked(const std::string& path, AssetPack::Entry& entry) const {
+        std::string relative;
+        if (!mPack.isOpen() || !mRelative(path, relative) || mFiles.find(relative) != mFiles.end()) {
+            return false;
+        }
+        return mPack.find(relative, entry);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status ResourceIndex::read(const std::string& path, std::string& buffer) const {
+        AssetPack::Entry entry;
+        if (findPacked(path, entry)) {
+            buffer.assign((const char*) entry.data, entry.size);
+            return STATUS_OK;
+        }
+        return Utils::bufferize(path, buffer);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::add(const std::string& path) {
+        std::string relative;
+        if (mRelative(path, relative)) {
+            mFiles.insert(relative);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::remove(const std::string& path) {
+        std::string relative;
+        if (mRelative(path, relative)) {
+            mFiles.erase(relative);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    bool ResourceIndex::refresh(const std::string& path) {
+        bool res = Utils::fileExists(path);
+        if (res) {
+            add(path);
+        } else {
+            remove(path);
+        }
+        return res;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::setWatchEnabled(bool enabled) {
+#ifdef __linux__
+        if (enabled == isWatchEnabled()) {
+            return;
+        }
+        if (!enabled) {
+            close(mWatchFd);
+            mWatchFd = -1;
+            mWatches.clear();
+            return;
+        }
+        mWatchFd = inotify_init();
+        if (mWatchFd < 0) {
+            LOG_WARN(TAG, "Cannot watch %s, resource index will only be updated by the engine", mRootDir.c_str());
+            return;
+        }
+        fcntl(mWatchFd, F_SETFL, fcntl(mWatchFd, F_GETFL) | O_NONBLOCK);
+        if (!mRootDir.empty()) {
+            // files written before the watches are set would be missed: scan again.
+            mFiles.clear();
+            mScan("");
+            mInit = true;
+            ++mRevision;
+        }
+#else
+        if (enabled) {
+            LOG_WARN(TAG, "Resource directory watches are not supported on this platform");
+        }
+#endif
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    U32 ResourceIndex::poll() {
+        U32 count = 0;
+#ifdef __linux__
+        if (!isWatchEnabled()) {
+            return 0;
+        }
+        char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+        bool overflow = false;
+        while (true) {
+            Utils::countFileSyscall();
+            ssize_t length = ::read(mWatchFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+            for (char* ptr = buffer; ptr < buffer + length; ) {
+                const struct inotify_event* event = (const struct inotify_event*) ptr;
+                ptr += sizeof(struct inotify_event) + event->len;
+                if (event->mask & IN_Q_OVERFLOW) {
+                    // not bound to a watch (wd is -1): events were dropped, and the index can't be trusted anymore.
+                    overflow = true;
+                    continue;
+                }
+                auto it = mWatches.find(event->wd);
+                if (it == mWatches.end()) {
+                    continue;
+                }
+                if (event->mask & (IN_DELETE_SELF | IN_IGNORED)) {
+                    mWatches.erase(it);
+                    continue;
+                }
+                if (event->len == 0) {
+                    continue;
+                }
+                std::string relative = it->second + event->name;
+                if ((event->mask & IN_ISDIR) && mIgnoredDirs.find(relative + "/") != mIgnoredDirs.end()) {
+                    continue;
+                }
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        mScan(relative + "/");
+                    } else {
+                        mRemoveDir(relative + "/");
+                    }
+                    mTouch(relative + "/");
+                    ++count;
+                } else if (event->mask & (IN_CREATE | IN_MOVED_TO) ? mFiles.insert(relative).second
+                                                                   : mFiles.erase(relative) > 0) {
+                    // files the engine wrote itself are indexed already: they change nothing.
+                    mTouch(relative);
+                    ++count;
+                }
+            }
+        }
+        if (overflow) {
+            LOG_WARN(TAG, "Watch events of %s were lost, scanning it again", mRootDir.c_str());
+            // directories still watched keep their watch descriptor.
+            mFiles.clear();
+            mScan("");
+            ++mRevision;
+            ++count;
+        }
+#endif
+        return count;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    bool ResourceIndex::mRelative(const std::string& path, std::string& relative) const {
+        if (!mInit || path.compare(0, mRootDir.size(), mRootDir) != 0) {
+            return false;
+        }
+        relative.assign(path, mRootDir.size(), std::string::npos);
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::mTouch(const std::string& path) {
+        ++mDirRevisions[std::string()];
+        for (size_t slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+            ++mDirRevisions[path.substr(0, slash + 1)];
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::mScan(const std::string& dir) {
+        if (mIgnoredDirs.find(dir) != mIgnoredDirs.end()) {
+            return;
+        }
+        std::string path = mRootDir + dir;
+        Utils::countFileSyscall();
+        DIR* handle = opendir(path.c_str());
+        if (!handle) {
+            return;
+        }
+        mWatch(dir);
+
+        std::vector<std::string> subDirs;
+        struct dirent* entry;
+        while (true) {
+            Utils::countFileSyscall();
+            if (!(entry = readdir(handle))) {
+                break;
+            }
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            bool isDir;
+            if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) {
+                isDir = entry->d_type == DT_DIR;
+            } else {
+                // some filesystems do not fill d_type.
+                isDir = Utils::dirExists((path + name).c_str());
+            }
+            if (isDir) {
+                subDirs.push_back(dir + name + "/");
+            } else {
+                mFiles.insert(dir + name);
+            }
+        }
+        closedir(handle);
+
+        for (const std::string& subDir : subDirs) {
+            mScan(subDir);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::mWatch(const std::string& dir) {
+#ifdef __linux__
+        if (!isWatchEnabled()) {
+            return;
+        }
+        Utils::countFileSyscall();
+        int wd = inotify_add_watch(mWatchFd, (mRootDir + dir).c_str(), WATCH_MASK);
+        if (wd < 0) {
+            LOG_WARN(TAG, "Cannot watch %s", (mRootDir + dir).c_str());
+            return;
+        }
+        mWatches[wd] = dir;
+#endif
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void ResourceIndex::mRemoveDir(const std::string& dir) {
+        for (auto it = mFiles.begin(); it != mFiles.end(); ) {
+            if (it->compare(0, dir.size(), dir) == 0) {
+                it = mFiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
@@ -20,28 +20,40 @@
 
 #define TAG "ResourceManager"
 
+/** spill cache directory, in the resource dir but out of its index */
+#define SPILL_DIR "cache/"
+
 namespace dma {
 
 
     // paths
     // MATERIAL = 0, MESH = 1, SHADER = 2, TEXTURE = 3, SCENE = 4, CUBEMAP = 5
     const char* ResourceManager::RESOURCE_PATHS [] = {
-            "shader", "mesh", "texture", "material", "geoscene", "texture/cubemap",  "texture/tiles"
+            "shader", "mesh", "texture", "material", "geoscene", "texture/cubemap",  "texture/tiles", "font", "style"
     };
 
 
+    constexpr char ResourceManager::ResourceIds::Font::DEFAULT[];
+
+
     /* ================= PUBLIC ========================*/
 
     //---------------------------------------------------------------------
     ResourceManager::ResourceManager(const std::string& resourceDir) :
         mResourceDir(resourceDir),
-        mShaderManager(mResourceDir + "shader/"),
-        mMeshManager(mResourceDir + "mesh/"),
-        mMapManager(mResourceDir + "texture/"),
-        mCubeMapManager(mResourceDir + "texture/cubemap/"),
-        mMaterialManager(mResourceDir + "material/", mShaderManager, mMapManager),
+        mRestoreMode(RestoreMode::IMMEDIATE),
+        mFileIndex(mResourceDir),
+        mSpillCache(mResourceDir + SPILL_DIR),
+        mShaderManager(mResourceDir + "shader/", mFileIndex),
+        mMeshManager(mResourceDir + "mesh/", mFileIndex, mSpillCache),
+        mMapManager(mResourceDir + "texture/", mFileIndex, mSpillCache),
+        mCubeMapManager(mResourceDir + "texture/cubemap/", mSpillCache),
+        mFontManager(mResourceDir + "font/", mFileIndex),
+        mMaterialManager(mResourceDir + "material/", mFileIndex, mShaderManager, mMapManager),
         mQuadFactory()
     {
+        // spilled entries are written & removed all along: they must not churn the index, nor its watches.
+        mFileIndex.ignore(SPILL_DIR);
         //mResourceManagers = new IResourceManager<void>*[RESOURCE_MANAGER_ARRAY_SIZE];
 //        mResourceManagers[ResourceType::MATERIAL] = (IResourceManager<void>*) mMaterialManager;
 //        mResourceManagers[ResourceType::MESH] = (IResourceManager<void>*) mMeshManager;
@@ -55,7 +67,7 @@ namespace dma {
 
     //---------------------------------------------------------------------
     ResourceManager::~ResourceManager() {
-        Log::trace(TAG, "DTOR ResourceManager...");
+        LOG_TRACE(TAG, "DTOR ResourceManager...");
 //        delete mShaderManager;
 //        delete mMeshManager;
 //        delete mTextureManager;
@@ -63,13 +75,16 @@ namespace dma {
 //        delete mQuadFactory;
 //        delete mSceneManager;
 //        delete mCubeMapManager;
-        Log::trace(TAG, "DTOR ResourceManager done");
+        LOG_TRACE(TAG, "DTOR ResourceManager done");
     }
 
 
     //---------------------------------------------------------------------
     Status ResourceManager::init() {
-        Log::trace(TAG, "Initializing ResourceManager...");
+        LOG_TRACE(TAG, "Initializing ResourceManager...");
+
+        mFileIndex.init();
+        mSpillCache.init();
 
         mShaderManager.init();
         mMeshManager.init();
@@ -87,73 +102,135 @@ namespace dma {
 //        }
 //        mQuadFactory->init();
 
-        Log::trace(TAG, "ResourceManager initialized");
+        LOG_TRACE(TAG, "ResourceManager initialized");
         return STATUS_OK;
     }
 
 
     //---------------------------------------------------------------------
     Status ResourceManager::refresh() {
-        Log::trace(TAG, "Refreshing ResourceManager...");
+        LOG_TRACE(TAG, "Refreshing ResourceManager...");
 
         if (mShaderManager.refresh() != STATUS_OK) return STATUS_KO;
-        mMapManager.refresh();
+        mMapManager.refresh(mRestoreMode == RestoreMode::PROGRESSIVE);
         mCubeMapManager.refresh();
+        mFontManager.refresh();
         if (mMeshManager.refresh() != STATUS_OK) return STATUS_KO;
         mQuadFactory.refresh();
-        Log::trace(TAG, "ResourceManager refreshed");
+        LOG_TRACE(TAG, "ResourceManager refreshed");
         return STATUS_OK;
     }
 
 
+    //---------------------------------------------------------------------
+    bool ResourceManager::restore(F32 budget) {
+        U32 pending = mMapManager.restore(budget);
+        if (pending == 0) {
+            LOG_TRACE(TAG, "All resources restored");
+        }
+        return pending > 0;
+    }
+
+
     //---------------------------------------------------------------------
     Status ResourceManager::reload() {
-        Log::trace(TAG, "Reloading ResourceManager...");
+        LOG_TRACE(TAG, "Reloading ResourceManager...");
+        mFileIndex.init();
         if (mShaderManager.reload() != STATUS_OK) return STATUS_KO;
         mMapManager.reload();
         mCubeMapManager.reload();
         if (mMeshManager.reload() != STATUS_OK) return STATUS_KO;
         if (mMaterialManager.reload() != STATUS_OK) return STATUS_KO;
         mQuadFactory.refresh();
-        Log::trace(TAG, "ResourceManager reloaded");
+        LOG_TRACE(TAG, "ResourceManager reloaded");
         return STATUS_OK;
     }
 
 
     //---------------------------------------------------------------------
     void ResourceManager::unload() {
-        Log::trace(TAG, "Unloading ResourceManager...");
+        LOG_TRACE(TAG, "Unloading ResourceManager...");
         wipe();
         mShaderManager.unload();
         mMeshManager.unload();
         mMapManager.unload();
         mCubeMapManager.unload();
+        mFontManager.unload();
         mMaterialManager.unload();
         mQuadFactory.unload();
-        Log::trace(TAG, "ResourceManager unloaded");
+        mSpillCache.clear();
+        LOG_TRACE(TAG, "ResourceManager unloaded");
     }
 
 
     //---------------------------------------------------------------------
     void ResourceManager::wipe() {
-        Log::trace(TAG, "Wiping ResourceManager...");
+        LOG_TRACE(TAG, "Wiping ResourceManager...");
         mShaderManager.wipe();
         mMeshManager.wipe();
         mMapManager.wipe();
         mCubeMapManager.wipe();
+        mFontManager.wipe();
         mQuadFactory.wipe();
-        Log::trace(TAG, "ResourceManager wiped");
+        LOG_TRACE(TAG, "ResourceManager wiped");
     }
 
 
     //---------------------------------------------------------------------
     void ResourceManager::update() {
-        Log::trace(TAG, "Updating ResourceManager...");
+        LOG_TRACE(TAG, "Updating ResourceManager...");
         mMaterialManager.update();
         mMeshManager.update();
         mMapManager.update();
         mCubeMapManager.update();
+        mFontManager.update();
         mShaderManager.update();
-        Log::trace(TAG, "ResourceManager updated");
+        sampleMemory();
+        LOG_TRACE(TAG, "ResourceManager updated");
+    }
+
+
+    //---------------------------------------------------------------------
+    void ResourceManager::setRetention(ResourceType type, Retention retention) {
+        switch (type) {
+            case MESH:
+                mMeshManager.setRetention(retention);
+                break;
+            case TEXTURE:
+                mMapManager.setRetention(retention);
+                break;
+            case CUBEMAP:
+                mCubeMapManager.setRetention(retention);
+                break;
+            default:
+                LOG_WARN(TAG, "No retention policy for resource type %d", (int) type);
+                break;
+        }
+    }
+
+
+    //---------------------------------------------------------------------
+    Retention ResourceManager::getRetention(ResourceType type) const {
+        switch (type) {
+            case MESH:
+                return mMeshManager.getRetention();
+            case TEXTURE:
+                return mMapManager.getRetention();
+            case CUBEMAP:
+                return mCubeMapManager.getRetention();
+            default:
+                return Retention::KEEP;
+        }
+    }
+
+
+    //---------------------------------------------------------------------
+    const MemoryReport& ResourceManager::sampleMemory() {
+        mMemoryReport.set(MemoryReport::MESH, mMeshManager.getMemoryUsage());
+        mMemoryReport.set(MemoryReport::MAP, mMapManager.getMemoryUsage());
+        mMemoryReport.set(MemoryReport::CUBEMAP, mCubeMapManager.getMemoryUsage());
+        mMemoryReport.set(MemoryReport::FONT, mFontManager.getMemoryUsage());
+        mMemoryReport.set(MemoryReport::SHADER, mShaderManager.getMemoryUsage());
+        return mMemoryReport;
     }
 }
@@ -59,9 +59,9 @@ namespace dma {
     /* ================= PUBLIC ========================*/
 
     ShaderManager::~ShaderManager() {
-//        Log::trace(TAG, "Destructing ShaderManager...");
+//        LOG_TRACE(TAG, "Destructing ShaderManager...");
 //        unload();
-//        Log::trace(TAG, "ShaderManager destructed");
+//        LOG_TRACE(TAG, "ShaderManager destructed");
     }
 
 
@@ -89,7 +89,7 @@ namespace dma {
             std::shared_ptr<ShaderProgram> shaderProgram = std::make_shared<ShaderProgram>();
             *result = mLoad(shaderProgram, sid);
             if (*result != STATUS_OK) {
-                Log::warn(TAG, "cannot load ShaderProgram %s, returning fallback instead", sid.c_str());
+                LOG_WARN(TAG, "cannot load ShaderProgram %s, returning fallback instead", sid.c_str());
                 //clear the cache and delete shader
                 return mFallbackShaderProgram;
             }
@@ -104,15 +104,15 @@ namespace dma {
     bool ShaderManager::hasResource(const std::string& sid) const {
 
         const std::string& path = mLocalDir + sid;
-        bool res = Utils::fileExists(path + ".v.glsl") || Utils::fileExists(path + ".v.GLSL");
-        res &=  (Utils::fileExists(path + ".f.glsl") || Utils::fileExists(path + ".f.glsl"));
+        bool res = mFileIndex.exists(path + ".v.glsl") || mFileIndex.exists(path + ".v.GLSL");
+        res &=  (mFileIndex.exists(path + ".f.glsl") || mFileIndex.exists(path + ".f.GLSL"));
         return res;
     }
 
 
     //----------------------------------------------------------------------------
     Status ShaderManager::reload() {
-        Log::trace(TAG, "Reloading ShaderManager...");
+        LOG_TRACE(TAG, "Reloading ShaderManager...");
 
         mFallbackShaderProgram->wipe();
         mFallbackShaderProgram->clearCache();
@@ -133,14 +133,14 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "ShaderManager reloaded");
+        LOG_TRACE(TAG, "ShaderManager reloaded");
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------
     Status ShaderManager::refresh() {
-        Log::trace(TAG, "Refreshing ShaderManager...");
+        LOG_TRACE(TAG, "Refreshing ShaderManager...");
 
         //mFallbackShaderProgram->wipe();
         mLoad(mFallbackShaderProgram, FALLBACK_SHADER_SID);
@@ -156,25 +156,38 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "ShaderManager refreshed");
+        LOG_TRACE(TAG, "ShaderManager refreshed");
         return STATUS_OK;
     }
 
 
+    //----------------------------------------------------------------------------
+    MemoryUsage ShaderManager::getMemoryUsage() const {
+        MemoryUsage usage;
+        if (mFallbackShaderProgram != nullptr) {
+            usage.add(mFallbackShaderProgram->getCpuBytes(), mFallbackShaderProgram->getGpuBytes());
+        }
+        for (auto& kv : mShaderPrograms) {
+            usage.add(kv.second->getCpuBytes(), kv.second->getGpuBytes());
+        }
+        return usage;
+    }
+
+
     //----------------------------------------------------------------------------
     void ShaderManager::unload() {
-        Log::trace(TAG, "Unloading ShaderManager...");
+        LOG_TRACE(TAG, "Unloading ShaderManager...");
 
         mFallbackShaderProgram = nullptr; //release reference count
         mShaderPrograms.clear();
 
-        Log::trace(TAG, "ShaderManager unloaded");
+        LOG_TRACE(TAG, "ShaderManager unloaded");
     }
 
 
     //----------------------------------------------------------------------------
     void ShaderManager::wipe() {
-        Log::trace(TAG, "Wiping ShaderManager...");
+        LOG_TRACE(TAG, "Wiping ShaderManager...");
 
         mFallbackShaderProgram->wipe();
 
@@ -185,14 +198,15 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "ShaderManager wiped");
+        LOG_TRACE(TAG, "ShaderManager wiped");
     }
 
     /* ================= PRIVATE ========================*/
 
     //----------------------------------------------------------------------------
-    ShaderManager::ShaderManager(const std::string& localDir) :
-            mShaderPrograms()
+    ShaderManager::ShaderManager(const std::string& localDir, ResourceIndex& fileIndex) :
+            mShaderPrograms(),
+            mFileIndex(fileIndex)
     {
         mLocalDir = localDir;
     }
@@ -200,7 +214,7 @@ namespace dma {
 
     //----------------------------------------------------------------------------
     Status ShaderManager::mLoad(std::shared_ptr<ShaderProgram> shaderProgram, const std::string &sid) const {
-        Log::trace(TAG, "Loading shader %s ...", sid.c_str());
+        LOG_TRACE(TAG, "Loading shader %s ...", sid.c_str());
 
         //try to load from the cache
         if (shaderProgram->hasCache()) {
@@ -212,9 +226,9 @@ namespace dma {
         std::string vertexSource;
         std::string fragmentSource;
         Status status;
-        status = Utils::bufferize(mLocalDir + sid + ".v.glsl", vertexSource);
+        status = mFileIndex.read(mLocalDir + sid + ".v.glsl", vertexSource);
         if(status == STATUS_OK) {
-            status = Utils::bufferize(mLocalDir + sid + ".f.glsl", fragmentSource);
+            status = mFileIndex.read(mLocalDir + sid + ".f.glsl", fragmentSource);
         }
 
         if(status != STATUS_OK) {
@@ -279,7 +293,7 @@ namespace dma {
             return status;
         }
 
-        Log::trace(TAG, "Shader %s loaded", sid.c_str());
+        LOG_TRACE(TAG, "Shader %s loaded", sid.c_str());
         return STATUS_OK;
     }
 
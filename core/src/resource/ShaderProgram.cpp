@@ -16,6 +16,10 @@
 
 
 
+#include <cstring>
+
+#include "glm/gtc/type_ptr.hpp"
+
 #include "resource/ShaderProgram.hpp"
 #include "utils/ExceptionHandler.hpp"
 
@@ -24,8 +28,11 @@ namespace dma {
 
     /* ================= STATIC VARIABLES ========================*/
     constexpr char ShaderProgram::TAG[];
+    U32 ShaderProgram::uniformUploadCount = 0;
+    U32 ShaderProgram::uniformSkipCount = 0;
+    U32 ShaderProgram::linkCount = 0;
 
-    const std::string ShaderProgram::attributeNames[] = { "a_position", "a_normal", "a_uv" };
+    const std::string ShaderProgram::attributeNames[] = { "a_position", "a_normal", "a_uv", "a_color" };
     const std::string ShaderProgram::uniformNames[] = {
             "u_MV",
             "u_MVP",
@@ -38,7 +45,12 @@ namespace dma {
             "u_light0.position",
             "u_light0.La",
             "u_light0.Ld",
-            "u_light0.Ls"
+            "u_light0.Ls",
+            "u_position_scale",
+            "u_position_decode",
+            "u_time",
+            "u_idle_bob",
+            "u_idle_axis"
     };
 
 
@@ -46,7 +58,8 @@ namespace dma {
 
     //------------------------------------------------------------------------------
     ShaderProgram::ShaderProgram() :
-            mHandle(0), mAttributeFlags(0L), mUniformFlags(0L){
+            mHandle(0), mLinkRevision(0), mAttributeFlags(0L), mUniformFlags(0L),
+            mUniformCacheFlags(0), mLightRevision(0), mBinaryBytes(0) {
     }
 
 
@@ -54,11 +67,63 @@ namespace dma {
     ShaderProgram::~ShaderProgram() {
     }
 
+
+    //------------------------------------------------------------------------------
+    void ShaderProgram::setUniform(UniformSem sem, GLint value) {
+        if (mCacheUniform(sem, &value, sizeof(value))) {
+            glUniform1i(mUniformLocations[sem], value);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void ShaderProgram::setUniform(UniformSem sem, GLfloat value) {
+        if (mCacheUniform(sem, &value, sizeof(value))) {
+            glUniform1f(mUniformLocations[sem], value);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void ShaderProgram::setUniform(UniformSem sem, const glm::vec3& value) {
+        if (mCacheUniform(sem, glm::value_ptr(value), sizeof(value))) {
+            glUniform3fv(mUniformLocations[sem], 1, glm::value_ptr(value));
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void ShaderProgram::setUniform(UniformSem sem, const glm::vec4& value) {
+        if (mCacheUniform(sem, glm::value_ptr(value), sizeof(value))) {
+            glUniform4fv(mUniformLocations[sem], 1, glm::value_ptr(value));
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void ShaderProgram::setUniform(UniformSem sem, const glm::mat3& value) {
+        if (mCacheUniform(sem, glm::value_ptr(value), sizeof(value))) {
+            glUniformMatrix3fv(mUniformLocations[sem], 1, GL_FALSE, glm::value_ptr(value));
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void ShaderProgram::setUniform(UniformSem sem, const glm::mat4& value) {
+        if (mCacheUniform(sem, glm::value_ptr(value), sizeof(value))) {
+            glUniformMatrix4fv(mUniformLocations[sem], 1, GL_FALSE, glm::value_ptr(value));
+        }
+    }
+
     /* ================= PRIVATE ========================*/
 
     //------------------------------------------------------------------------------
     ExceptionType ShaderProgram::mLink(GLuint vertexHandle, GLuint fragmentHandle) {
         GLint link_ok;
+        // a new program holds default values.
+        mUniformCacheFlags = 0;
+        mLightRevision = 0;
+        mLinkRevision = ++linkCount;
         mHandle = glCreateProgram();
         glAttachShader(mHandle, vertexHandle);
         glAttachShader(mHandle, fragmentHandle);
@@ -71,6 +136,13 @@ namespace dma {
             return ExceptionType::OPENGL;
         }
 
+        static const bool binaryLength = GLUtils::isGles3() || GLUtils::isExtSupported("GL_OES_get_program_binary");
+        GLint length = 0;
+        if (binaryLength) {
+            glGetProgramiv(mHandle, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+        }
+        mBinaryBytes = (U32) length;
+
         return ExceptionType::NO_EXCEPTION;
     }
 
@@ -115,13 +187,28 @@ namespace dma {
     }
 
 
+    //------------------------------------------------------------------------------
+    bool ShaderProgram::mCacheUniform(UniformSem sem, const void* value, size_t size) {
+        assert(size <= sizeof(mUniformValues[sem]));
+        if ((mUniformCacheFlags & (1u << sem)) && memcmp(mUniformValues[sem], value, size) == 0) {
+            ++uniformSkipCount;
+            return false;
+        }
+        memcpy(mUniformValues[sem], value, size);
+        mUniformCacheFlags |= (1u << sem);
+        ++uniformUploadCount;
+        return true;
+    }
+
+
     //------------------------------------------------------------------------------
     void ShaderProgram::wipe() {
         if (glIsProgram(mHandle)) {
-            Log::debug(TAG, "deleting shader program %d", mHandle);
+            LOG_DEBUG(TAG, "deleting shader program %d", mHandle);
             glDeleteProgram(mHandle);
         }
         mHandle = 0;
+        mUniformCacheFlags = 0;
     }
 
 }
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+#include "resource/SpillCache.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+constexpr auto TAG = "SpillCache";
+
+namespace dma {
+
+    /** deflate output is written by blocks of this size */
+    static constexpr U32 BLOCK_SIZE = 16 * 1024;
+
+    struct ImageHeader {
+        U32 width;
+        U32 height;
+        I32 format;
+    };
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    SpillCache::SpillCache(const std::string& dir) :
+            mDir(dir),
+            mNextFile(0),
+            mSizeInBytes(0)
+    {
+        Utils::addTrailingSlash(mDir);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    SpillCache::~SpillCache() {
+        clear();
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void SpillCache::init() {
+        clear();
+        if (!Utils::dirExists(mDir.c_str())) {
+            mkdir(mDir.c_str(), 0700);
+            return;
+        }
+        DIR* handle = opendir(mDir.c_str());
+        if (!handle) {
+            LOG_WARN(TAG, "Cannot open spill cache %s", mDir.c_str());
+            return;
+        }
+        // only the entries, as named by mPath(): anything else in there is not ours.
+        struct dirent* entry;
+        while ((entry = readdir(handle)) != nullptr) {
+            unsigned file;
+            int length = 0;
+            if (sscanf(entry->d_name, "%u.spill%n", &file, &length) == 1 && entry->d_name[length] == '\0') {
+                std::remove((mDir + entry->d_name).c_str());
+            }
+        }
+        closedir(handle);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void SpillCache::clear() {
+        for (auto& kv : mEntries) {
+            std::remove(mPath(kv.second.file).c_str());
+        }
+        mEntries.clear();
+        mSizeInBytes = 0;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status SpillCache::write(const std::string& key, std::initializer_list<Chunk> chunks) {
+        remove(key);
+        const U32 file = mNextFile++;
+        const std::string path = mPath(file);
+        FILE* out = fopen(path.c_str(), "wb");
+        if (out == nullptr) {
+            LOG_WARN(TAG, "Cannot write %s to the spill cache", key.c_str());
+            return STATUS_KO;
+        }
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) {
+            fclose(out);
+            std::remove(path.c_str());
+            return STATUS_KO;
+        }
+        BYTE block[BLOCK_SIZE];
+        U32 size = 0;
+        bool ok = true;
+        for (auto it = chunks.begin(); ok && it != chunks.end(); ++it) {
+            stream.next_in = (Bytef*) it->data;
+            stream.avail_in = it->size;
+            size += it->size;
+            const int flush = it + 1 == chunks.end() ? Z_FINISH : Z_NO_FLUSH;
+            do {
+                stream.next_out = block;
+                stream.avail_out = BLOCK_SIZE;
+                deflate(&stream, flush);
+                const U32 count = BLOCK_SIZE - stream.avail_out;
+                ok = fwrite(block, 1, count, out) == count;
+            } while (ok && stream.avail_out == 0);
+        }
+        const U32 storedSize = (U32) stream.total_out;
+        deflateEnd(&stream);
+        ok = fclose(out) == 0 && ok;
+        if (!ok) {
+            LOG_WARN(TAG, "Cannot write %s to the spill cache", key.c_str());
+            std::remove(path.c_str());
+            return STATUS_KO;
+        }
+
+        mEntries[key] = Entry{file, size, storedSize};
+        mSizeInBytes += storedSize;
+        LOG_TRACE(TAG, "%s spilled: %u bytes, %u on disk", key.c_str(), size, storedSize);
+        return STATUS_OK;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status SpillCache::read(const std::string& key, std::vector<BYTE>& data) const {
+        auto it = mEntries.find(key);
+        if (it == mEntries.end()) {
+            return STATUS_KO;
+        }
+        const Entry& entry = it->second;
+        std::vector<BYTE> stored;
+        if (Utils::bufferize(mPath(entry.file), stored) != STATUS_OK || stored.size() != entry.storedSize) {
+            Log::error(TAG, "Cannot read %s from the spill cache", key.c_str());
+            return STATUS_KO;
+        }
+        data.resize(entry.size);
+        uLongf size = entry.size;
+        if (uncompress(data.data(), &size, stored.data(), stored.size()) != Z_OK || size != entry.size) {
+            Log::error(TAG, "Spill cache entry %s is corrupted", key.c_str());
+            return STATUS_KO;
+        }
+        return STATUS_OK;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status SpillCache::writeImage(const std::string& key, const Image& image, const std::vector<BYTE>* extra) {
+        const ImageHeader header = {image.getWidth(), image.getHeight(), image.getFormat()};
+        return write(key, {{&header, sizeof(header)}, {image.getPixels(), image.getSizeInBytes()},
+                           {extra != nullptr ? extra->data() : nullptr, extra != nullptr ? (U32) extra->size() : 0}});
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Image* SpillCache::readImage(const std::string& key, std::vector<BYTE>* extra) const {
+        std::vector<BYTE> data;
+        if (read(key, data) != STATUS_OK || data.size() < sizeof(ImageHeader)) {
+            return nullptr;
+        }
+        ImageHeader header;
+        memcpy(&header, data.data(), sizeof(header));
+        Image* image = new Image(header.width, header.height, header.format, data.data() + sizeof(header));
+        if (extra != nullptr) {
+            const size_t offset = sizeof(header) + image->getSizeInBytes();
+            extra->assign(data.begin() + std::min(offset, data.size()), data.end());
+        }
+        return image;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void SpillCache::remove(const std::string& key) {
+        auto it = mEntries.find(key);
+        if (it != mEntries.end()) {
+            std::remove(mPath(it->second.file).c_str());
+            mSizeInBytes -= it->second.storedSize;
+            mEntries.erase(it);
+        }
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    std::string SpillCache::mPath(U32 file) const {
+        return mDir + to_string((int) file) + ".spill";
+    }
+}
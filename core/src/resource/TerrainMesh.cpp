@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstring>
+
+#include "resource/TerrainMesh.hpp"
+
+namespace dma {
+
+    //------------------------------------------------------------------------------
+    TerrainMesh::TerrainMesh(const std::string& sid, U32 segments, const std::vector<F32>& heights,
+                             F32 width, F32 height, F32 skirtDepth) :
+            GeneratedMesh(),
+            mSegments(segments)
+    {
+        mSID = sid;
+        VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, 0);
+        addVertexElement(positionElement);
+        VertexElement uvElement(VertexElement::Semantic::UV, 2, GL_FLOAT, positionElement.getSizeInByte());
+        addVertexElement(uvElement);
+        mVertexSize = positionElement.getSizeInByte() + uvElement.getSizeInByte();
+
+        const U32 side = segments + 1;
+        const U32 gridCount = side * side;
+        // the skirt doubles each border vertex.
+        mVertexCount = gridCount + 4 * segments;
+        std::vector<F32> vertices;
+        vertices.reserve(mVertexCount * 5);
+        auto addVertex = [&vertices, segments](U32 col, U32 row, F32 z) {
+            const F32 u = (F32) col / segments;
+            const F32 v = 1.0f - (F32) row / segments;
+            vertices.push_back(2.0f * u - 1.0f);
+            vertices.push_back(2.0f * v - 1.0f);
+            vertices.push_back(z);
+            vertices.push_back(u);
+            vertices.push_back(v);
+        };
+
+        F32 min = heights[0];
+        F32 max = heights[0];
+        for (U32 row = 0; row < side; ++row) {
+            for (U32 col = 0; col < side; ++col) {
+                const F32 z = heights[row * side + col];
+                min = std::min(min, z);
+                max = std::max(max, z);
+                addVertex(col, row, z);
+            }
+        }
+
+        mIndexData.reserve(6 * segments * segments + 24 * segments);
+        for (U32 row = 0; row < segments; ++row) {
+            for (U32 col = 0; col < segments; ++col) {
+                const U16 a = (U16) (row * side + col);
+                const U16 b = (U16) (a + 1);
+                const U16 c = (U16) (a + side);
+                const U16 d = (U16) (c + 1);
+                mIndexData.insert(mIndexData.end(), {a, c, b, b, c, d});
+            }
+        }
+
+        // skirt: the border, walked clockwise from the north-west corner, and a copy of it lowered.
+        std::vector<U16> border;
+        border.reserve(4 * segments + 1);
+        for (U32 col = 0; col < segments; ++col) {
+            border.push_back((U16) col);
+        }
+        for (U32 row = 0; row < segments; ++row) {
+            border.push_back((U16) (row * side + segments));
+        }
+        for (U32 col = segments; col > 0; --col) {
+            border.push_back((U16) (segments * side + col));
+        }
+        for (U32 row = segments; row > 0; --row) {
+            border.push_back((U16) (row * side));
+        }
+        for (U16 index : border) {
+            addVertex(index % side, index / side, heights[index] - skirtDepth);
+        }
+        const U32 count = (U32) border.size();
+        for (U32 i = 0; i < count; ++i) {
+            const U16 a = border[i];
+            const U16 b = border[(i + 1) % count];
+            const U16 c = (U16) (gridCount + i);
+            const U16 d = (U16) (gridCount + (i + 1) % count);
+            mIndexData.insert(mIndexData.end(), {a, c, b, b, c, d});
+        }
+
+        mVertexData.resize(vertices.size() * sizeof(F32));
+        memcpy(mVertexData.data(), vertices.data(), mVertexData.size());
+
+        // not scaled by the tile transform, unlike the center.
+        const F32 center = (min + max - skirtDepth) / 2.0f;
+        const F32 radius = glm::sqrt(width * width + height * height) / 2.0f + (max - min + skirtDepth) / 2.0f;
+        mBoundingSphere = BoundingSphere(0.0f, 0.0f, center, radius);
+    }
+
+
+    //------------------------------------------------------------------------------
+    TerrainMesh::~TerrainMesh() {
+
+    }
+}
@@ -18,6 +18,8 @@
 
 #include "resource/Texture.hpp"
 
+#include <algorithm>
+
 
 constexpr auto TAG = "Texture";
 
@@ -26,7 +28,8 @@ namespace dma {
 
     //----------------------------------------------------------------------
     Texture::Texture() :
-            mHandle(0)
+            mHandle(0),
+            mGpuBytes(0)
     {}
 
 
@@ -37,12 +40,31 @@ namespace dma {
 
     //----------------------------------------------------------------------
     void Texture::wipe() {
-        Log::trace(TAG, "Trying to delete texture handle %d", mHandle);
+        LOG_TRACE(TAG, "Trying to delete texture handle %d", mHandle);
         if (mHandle != 0 && glIsTexture(mHandle) == GL_TRUE) {
-            Log::trace(TAG, "Deleting texture handle %d", mHandle);
+            LOG_TRACE(TAG, "Deleting texture handle %d", mHandle);
             glDeleteTextures(1, &mHandle);
             mHandle = 0;
         }
     }
 
+
+    /* ================= PROTECTED ========================*/
+
+    //----------------------------------------------------------------------
+    U32 Texture::computeGpuBytes(const Image& image, bool mipmapped) {
+        if (image.getSizeInBytes() == 0) {
+            return 0;
+        }
+        U32 width = image.getWidth();
+        U32 height = image.getHeight();
+        U32 bytes = width * height * image.getBytesPerPixel();
+        while (mipmapped && (width > 1 || height > 1)) {
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+            bytes += width * height * image.getBytesPerPixel();
+        }
+        return bytes;
+    }
+
 } /* namespace dma */
@@ -72,7 +72,7 @@ namespace dma {
             std::shared_ptr<Map> map = std::make_shared<Map>();
             *result = mLoadMap(map, sid);
             if (*result != STATUS_OK) {
-                Log::warn(TAG, "Map %s doesn't exist, returning fallback instead", sid.c_str());
+                LOG_WARN(TAG, "Map %s doesn't exist, returning fallback instead", sid.c_str());
                 return mFallbackTexture;
             }
             mTextures[sid] = map;
@@ -85,7 +85,7 @@ namespace dma {
 
     //----------------------------------------------------------------------------------------------
     Status TextureManager::reload() {
-        Log::trace(TAG, "Reloading TextureManager...");
+        LOG_TRACE(TAG, "Reloading TextureManager...");
 
         if (mFallbackTexture != nullptr) {
             mFallbackTexture->wipe();
@@ -106,14 +106,14 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "TextureManager reloaded");
+        LOG_TRACE(TAG, "TextureManager reloaded");
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------------------------
     Status TextureManager::refresh() {
-        Log::trace(TAG, "Refreshing TextureManager...");
+        LOG_TRACE(TAG, "Refreshing TextureManager...");
 
         if (mFallbackTexture != nullptr) {
             mFallbackTexture->wipe();
@@ -134,14 +134,14 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "TextureManager refreshed");
+        LOG_TRACE(TAG, "TextureManager refreshed");
         return STATUS_OK;
     }
 
 
     //----------------------------------------------------------------------------------------------
     void TextureManager::unload() {
-        Log::trace(TAG, "Unloading TextureManager...");
+        LOG_TRACE(TAG, "Unloading TextureManager...");
 
         if (mFallbackTexture != nullptr) {
             mFallbackTexture->wipe();
@@ -155,13 +155,13 @@ namespace dma {
         }
         mTextures.clear();
 
-        Log::trace(TAG, "TextureManager unloaded");
+        LOG_TRACE(TAG, "TextureManager unloaded");
     }
 
 
     //----------------------------------------------------------------------------------------------
     void TextureManager::wipe() {
-        Log::trace(TAG, "Wiping TextureManager...");
+        LOG_TRACE(TAG, "Wiping TextureManager...");
 
         if (mFallbackTexture != nullptr) {
             mFallbackTexture->wipe();
@@ -173,7 +173,7 @@ namespace dma {
             }
         }
 
-        Log::trace(TAG, "TextureManager wiped");
+        LOG_TRACE(TAG, "TextureManager wiped");
     }
 
 
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cstring>
+
+#include "resource/VectorMesh.hpp"
+
+namespace dma {
+
+    //------------------------------------------------------------------------------
+    VectorMesh::VectorMesh(const std::string& sid, const F32* vertices, U32 vertexCount, std::vector<U16>&& indices) :
+            GeneratedMesh()
+    {
+        mSID = sid;
+        VertexElement positionElement(VertexElement::Semantic::POSITION, 3, GL_FLOAT, 0);
+        addVertexElement(positionElement);
+        VertexElement flatNormalElement(VertexElement::Semantic::FLAT_NORMAL, 3, GL_FLOAT,
+                                        positionElement.getSizeInByte());
+        addVertexElement(flatNormalElement);
+        mVertexSize = positionElement.getSizeInByte() + flatNormalElement.getSizeInByte();
+        mVertexCount = vertexCount;
+
+        mVertexData.resize(mVertexSize * vertexCount);
+        memcpy(mVertexData.data(), vertices, mVertexData.size());
+        mIndexData = std::move(indices);
+
+        if (vertexCount > 0) {
+            glm::vec3 min(vertices[0], vertices[1], vertices[2]);
+            glm::vec3 max = min;
+            for (U32 v = 1; v < vertexCount; ++v) {
+                const glm::vec3 position(vertices[6 * v], vertices[6 * v + 1], vertices[6 * v + 2]);
+                min = glm::min(min, position);
+                max = glm::max(max, position);
+            }
+            mBoundingSphere = BoundingSphere((min + max) / 2.0f, glm::length(max - min) / 2.0f);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    VectorMesh::~VectorMesh() {
+
+    }
+}
@@ -39,7 +39,7 @@ bool GLUtils::hasGlError(const std::string& tag, const std::string& op) {
         sprintf(errBuff, "0x%x", error);
         errorStr = errBuff;
         errorStr += " : " + getGlMessage(error);
-        Log::error(tag, "after %s glError(%s)\n", op.c_str(), errorStr.c_str());
+        Log::error(tag.c_str(), "after %s glError(%s)\n", op.c_str(), errorStr.c_str());
         throwException(tag, ExceptionType::OPENGL, NULL);
     }
     return hasError;
@@ -71,7 +71,7 @@ std::string GLUtils::getGlMessage(int errorCode) {
 
 void GLUtils::clearGlErrors() {
     for(GLint error = glGetError(); error; error = glGetError()) {
-        Log::warn(TAG, "discarding gl error %x", error);
+        LOG_WARN(TAG, "discarding gl error %x", error);
     }
 }
 
@@ -110,6 +110,13 @@ bool GLUtils::isExtSupported(const std::string& extension) {
     return 0;
 }
 
+bool GLUtils::isGles3() {
+    // "OpenGL ES <major>.<minor> <vendor-specific information>"
+    const char* version = (const char*) glGetString(GL_VERSION);
+    int major = 0;
+    return version != nullptr && sscanf(version, "OpenGL ES %d", &major) == 1 && major >= 3;
+}
+
 bool GLUtils::hasGlContext() {
     //check openGL version & context
     const GLubyte* renderer = glGetString(GL_RENDERER); // get renderer string
@@ -136,7 +143,7 @@ void GLUtils::printGlContext() {
     }
 
     if (!version) {
-        Log::trace(TAG, "no valid openGL context found!!");
+        LOG_TRACE(TAG, "no valid openGL context found!!");
         errors = true;
     }
 
@@ -144,13 +151,13 @@ void GLUtils::printGlContext() {
     if (errors) {
         assert(false);
     } else {
-        Log::trace(TAG, "Renderer: %s\n", renderer);
-        Log::trace(TAG, "Version: %s\n", version);
-        Log::trace(TAG, "Vendor: %s\n", vendor);
+        LOG_TRACE(TAG, "Renderer: %s\n", renderer);
+        LOG_TRACE(TAG, "Version: %s\n", version);
+        LOG_TRACE(TAG, "Vendor: %s\n", vendor);
         int length = strlen((char*)extensions);
         const int buffSize = 127;
         char buff [buffSize+1];
-        Log::trace(TAG, "Extensions: ");
+        LOG_TRACE(TAG, "Extensions: ");
 
         for(int i=0; i<length; i+=buffSize) {
             if(i>length) {
@@ -158,7 +165,7 @@ void GLUtils::printGlContext() {
             }
             strncpy(buff, &((char*)extensions)[i], buffSize);
             buff[buffSize] = '\0';
-            Log::trace(TAG, "%s", buff);
+            LOG_TRACE(TAG, "%s", buff);
 
         }
     }
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "utils/LogSink.hpp"
+
+namespace dma {
+
+    constexpr U32 LogSink::CAPACITY;
+    constexpr U32 LogSink::TAG_SIZE;
+    constexpr U32 LogSink::MESSAGE_SIZE;
+    constexpr U32 LogSink::REPEAT_INTERVAL;
+    constexpr U32 LogSink::IDLE_TIMEOUT;
+
+    constexpr U32 MASK = LogSink::CAPACITY - 1;
+    static_assert((LogSink::CAPACITY & MASK) == 0, "LogSink::CAPACITY must be a power of two");
+
+
+    //------------------------------------------------------------------------------
+    LogSink& LogSink::getInstance() {
+        // never deleted: messages may still be posted while static objects are destroyed.
+        static LogSink* instance = new LogSink();
+        return *instance;
+    }
+
+
+    //------------------------------------------------------------------------------
+    LogSink::LogSink() :
+            mHead(0),
+            mTail(0),
+            mWritten(0),
+            mDroppedCount(0),
+            mIdle(false),
+            mReportedDroppedCount(0),
+            mRepeatCount(0)
+    {
+        for (U32 i = 0; i < CAPACITY; ++i) {
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mLast.level = Log::LEVEL_INFO;
+        mLast.tag[0] = '\0';
+        mLast.message[0] = '\0';
+        mThread = std::thread(&LogSink::mLoop, this);
+        mThread.detach();
+        // the last messages are written before the process exits.
+        std::atexit([]() {
+            getInstance().flush();
+        });
+    }
+
+
+    //------------------------------------------------------------------------------
+    LogSink::~LogSink() {
+
+    }
+
+
+    //------------------------------------------------------------------------------
+    void LogSink::post(Log::Level level, const char* tag, const char* format, va_list args) {
+        U32 pos = mHead.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &mSlots[pos & MASK];
+            const I32 diff = (I32) (slot->sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // full: the slot was not written yet since the previous lap.
+                if (level == Log::LEVEL_ERROR) {
+                    char message[MESSAGE_SIZE];
+                    vsnprintf(message, MESSAGE_SIZE, format, args);
+                    Log::write(level, tag, message);
+                } else {
+                    mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+                }
+                return;
+            } else {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        strncpy(slot->tag, tag, TAG_SIZE - 1);
+        slot->tag[TAG_SIZE - 1] = '\0';
+        vsnprintf(slot->message, MESSAGE_SIZE, format, args);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        // pairs with the one of the log thread going idle: either it sees the message, or this sees it idle.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mIdle.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mLock);
+            mCondition.notify_one();
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void LogSink::flush() {
+        const U32 target = mHead.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mLock);
+        while ((I32) (target - mWritten.load(std::memory_order_acquire)) > 0) {
+            mCondition.notify_one();
+            // the log thread notifies under the lock, once done writing: no wake up is missed.
+            mFlushCondition.wait_for(lock, std::chrono::milliseconds(IDLE_TIMEOUT));
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void LogSink::mLoop() {
+        for (;;) {
+            bool written = false;
+            for (;;) {
+                Slot& slot = mSlots[mTail & MASK];
+                if (slot.sequence.load(std::memory_order_acquire) != mTail + 1) {
+                    break; // empty, or not filled yet
+                }
+                mWrite(slot, std::chrono::steady_clock::now());
+                slot.sequence.store(mTail + CAPACITY, std::memory_order_release);
+                ++mTail;
+                written = true;
+            }
+
+            const U64 droppedCount = mDroppedCount.load(std::memory_order_relaxed);
+            if (droppedCount != mReportedDroppedCount) {
+                char message[64];
+                snprintf(message, sizeof(message), "%llu messages dropped",
+                         (unsigned long long) (droppedCount - mReportedDroppedCount));
+                Log::write(Log::LEVEL_WARN, "LogSink", message);
+                mReportedDroppedCount = droppedCount;
+                written = true;
+            }
+            if (mRepeatCount > 0 && std::chrono::steady_clock::now() - mLastTime
+                                    >= std::chrono::milliseconds(REPEAT_INTERVAL)) {
+                mWriteRepeated();
+                written = true;
+            }
+            if (written) {
+                Log::sync();
+            }
+            mWritten.store(mTail, std::memory_order_release);
+
+            std::unique_lock<std::mutex> lock(mLock);
+            mFlushCondition.notify_all();
+            mIdle.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // checked again, as a message posted before the flag was set did not notify.
+            if (mSlots[mTail & MASK].sequence.load(std::memory_order_acquire) != mTail + 1) {
+                mCondition.wait_for(lock, std::chrono::milliseconds(IDLE_TIMEOUT));
+            }
+            mIdle.store(false, std::memory_order_relaxed);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    void LogSink::mWrite(const Slot& slot, std::chrono::steady_clock::time_point now) {
+        if (slot.level == mLast.level && strcmp(slot.tag, mLast.tag) == 0
+            && strcmp(slot.message, mLast.message) == 0
+            && now - mLastTime < std::chrono::milliseconds(REPEAT_INTERVAL)) {
+            ++mRepeatCount;
+            return;
+        }
+        mWriteRepeated();
+        Log::write(slot.level, slot.tag, slot.message);
+        mLast.level = slot.level;
+        memcpy(mLast.tag, slot.tag, TAG_SIZE);
+        memcpy(mLast.message, slot.message, MESSAGE_SIZE);
+        mLastTime = now;
+    }
+
+
+    //------------------------------------------------------------------------------
+    void LogSink::mWriteRepeated() {
+        if (mRepeatCount == 0) {
+            return;
+        }
+        char message[MESSAGE_SIZE + 32];
+        snprintf(message, sizeof(message), "%s (repeated %u times)", mLast.message, mRepeatCount);
+        Log::write(mLast.level, mLast.tag, message);
+        mRepeatCount = 0;
+        // the next identical message is counted again from now.
+        mLastTime = std::chrono::steady_clock::now();
+    }
+
+
+    /* ***
+     * Log
+     */
+
+    //------------------------------------------------------------------------------
+    void Log::flush() {
+        LogSink::getInstance().flush();
+    }
+
+
+    //------------------------------------------------------------------------------
+    U64 Log::getDroppedCount() {
+        return LogSink::getInstance().getDroppedCount();
+    }
+}
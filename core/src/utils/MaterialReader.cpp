@@ -66,7 +66,12 @@ namespace dma {
             assert(!"Unable to bufferize Material");
             return status;
         }
+        return parse(json);
+    }
+
 
+    //--------------------------------------------------------------------------------
+    Status MaterialReader::parse(const std::string& json) {
         ////////////////////////////////////////////////////////////////////////////
         // Create the DOM
         mDocument.Parse(json.c_str());
@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cstring>
+#include <zlib.h>
+
+#include "utils/MvtReader.hpp"
+#include "utils/Log.hpp"
+
+constexpr auto TAG = "MvtReader";
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    /**
+     * Minimal protobuf reader over a buffer. Any overrun clears 'ok' and stops reading.
+     */
+    struct PbfReader {
+        enum WireType {
+            VARINT = 0,
+            FIXED64 = 1,
+            BYTES = 2,
+            FIXED32 = 5
+        };
+
+        PbfReader(const BYTE* begin, const BYTE* end) :
+                pos(begin), end(end), ok(true)
+        {}
+
+        inline bool hasNext() const {
+            return ok && pos < end;
+        }
+
+        /**
+         * Reads the key of the next field.
+         */
+        inline bool next(U32& field, U32& wireType) {
+            if (!hasNext()) {
+                return false;
+            }
+            U64 key = varint();
+            field = (U32) (key >> 3);
+            wireType = (U32) (key & 0x7);
+            return ok;
+        }
+
+        inline U64 varint() {
+            U64 value = 0;
+            for (U32 shift = 0; shift < 64; shift += 7) {
+                if (pos >= end) {
+                    ok = false;
+                    return 0;
+                }
+                BYTE b = *pos++;
+                value |= (U64) (b & 0x7F) << shift;
+                if ((b & 0x80) == 0) {
+                    return value;
+                }
+            }
+            ok = false;
+            return 0;
+        }
+
+        inline static I64 zigzag(U64 value) {
+            return (I64) (value >> 1) ^ -(I64) (value & 1);
+        }
+
+        inline PbfReader message() {
+            U64 length = varint();
+            if (!ok || length > (U64) (end - pos)) {
+                ok = false;
+                return PbfReader(end, end);
+            }
+            PbfReader reader(pos, pos + length);
+            pos += length;
+            return reader;
+        }
+
+        inline std::string string() {
+            PbfReader bytes = message();
+            return std::string((const char*) bytes.pos, bytes.end - bytes.pos);
+        }
+
+        inline U32 fixed32() {
+            U32 value = 0;
+            if (mAdvance(4)) {
+                memcpy(&value, pos - 4, 4);
+            }
+            return value;
+        }
+
+        inline U64 fixed64() {
+            U64 value = 0;
+            if (mAdvance(8)) {
+                memcpy(&value, pos - 8, 8);
+            }
+            return value;
+        }
+
+        void skip(U32 wireType) {
+            switch (wireType) {
+                case VARINT:
+                    varint();
+                    break;
+                case FIXED64:
+                    mAdvance(8);
+                    break;
+                case BYTES:
+                    message();
+                    break;
+                case FIXED32:
+                    mAdvance(4);
+                    break;
+                default:
+                    ok = false;
+            }
+        }
+
+        const BYTE* pos;
+        const BYTE* end;
+        bool ok;
+
+    private:
+        inline bool mAdvance(U32 count) {
+            if ((U64) (end - pos) < count) {
+                ok = false;
+                return false;
+            }
+            pos += count;
+            return true;
+        }
+    };
+
+
+    // Tile, Layer, Feature & Value fields, see vector_tile.proto
+    constexpr U32 TILE_LAYERS = 3;
+    constexpr U32 LAYER_NAME = 1;
+    constexpr U32 LAYER_FEATURES = 2;
+    constexpr U32 LAYER_KEYS = 3;
+    constexpr U32 LAYER_VALUES = 4;
+    constexpr U32 LAYER_EXTENT = 5;
+    constexpr U32 FEATURE_ID = 1;
+    constexpr U32 FEATURE_TAGS = 2;
+    constexpr U32 FEATURE_TYPE = 3;
+    constexpr U32 FEATURE_GEOMETRY = 4;
+    constexpr U32 VALUE_STRING = 1;
+    constexpr U32 VALUE_FLOAT = 2;
+    constexpr U32 VALUE_DOUBLE = 3;
+    constexpr U32 VALUE_INT = 4;
+    constexpr U32 VALUE_UINT = 5;
+    constexpr U32 VALUE_SINT = 6;
+    constexpr U32 VALUE_BOOL = 7;
+
+    // geometry commands
+    constexpr U32 CMD_MOVE_TO = 1;
+    constexpr U32 CMD_LINE_TO = 2;
+    constexpr U32 CMD_CLOSE_PATH = 7;
+
+
+    //----------------------------------------------------------------------------------------------
+    static bool readValue(PbfReader reader, MvtReader::Value& value) {
+        U32 field, wireType;
+        while (reader.next(field, wireType)) {
+            switch (field) {
+                case VALUE_STRING:
+                    value.type = MvtReader::Value::STRING;
+                    value.string = reader.string();
+                    break;
+                case VALUE_FLOAT: {
+                    U32 bits = reader.fixed32();
+                    F32 f;
+                    memcpy(&f, &bits, sizeof(f));
+                    value.type = MvtReader::Value::NUMBER;
+                    value.number = f;
+                    break;
+                }
+                case VALUE_DOUBLE: {
+                    U64 bits = reader.fixed64();
+                    memcpy(&value.number, &bits, sizeof(value.number));
+                    value.type = MvtReader::Value::NUMBER;
+                    break;
+                }
+                case VALUE_INT:
+                    value.type = MvtReader::Value::NUMBER;
+                    value.number = (F64) (I64) reader.varint();
+                    break;
+                case VALUE_UINT:
+                    value.type = MvtReader::Value::NUMBER;
+                    value.number = (F64) reader.varint();
+                    break;
+                case VALUE_SINT:
+                    value.type = MvtReader::Value::NUMBER;
+                    value.number = (F64) PbfReader::zigzag(reader.varint());
+                    break;
+                case VALUE_BOOL:
+                    value.type = MvtReader::Value::BOOL;
+                    value.number = reader.varint() != 0 ? 1.0 : 0.0;
+                    break;
+                default:
+                    reader.skip(wireType);
+            }
+        }
+        return reader.ok;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static bool readGeometry(PbfReader reader, MvtReader::Feature& feature) {
+        I32 x = 0;
+        I32 y = 0;
+        while (reader.hasNext()) {
+            U32 command = (U32) reader.varint();
+            U32 id = command & 0x7;
+            U32 count = command >> 3;
+            if (id == CMD_MOVE_TO || id == CMD_LINE_TO) {
+                for (U32 i = 0; i < count && reader.ok; ++i) {
+                    x += (I32) PbfReader::zigzag(reader.varint());
+                    y += (I32) PbfReader::zigzag(reader.varint());
+                    // multi points are a single part.
+                    if (id == CMD_MOVE_TO && (feature.type != MvtReader::POINT || feature.parts.empty())) {
+                        feature.parts.push_back((U32) feature.points.size());
+                    }
+                    feature.points.push_back(glm::vec2((F32) x, (F32) y));
+                }
+            } else if (id == CMD_CLOSE_PATH) {
+                // rings are implicitly closed.
+            } else {
+                return false;
+            }
+        }
+        // a part must start with a MoveTo.
+        return reader.ok && (feature.parts.empty() ? feature.points.empty() : feature.parts[0] == 0);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static bool readFeature(PbfReader reader, MvtReader::Feature& feature) {
+        PbfReader geometry(nullptr, nullptr);
+        U32 field, wireType;
+        while (reader.next(field, wireType)) {
+            switch (field) {
+                case FEATURE_ID:
+                    feature.id = reader.varint();
+                    break;
+                case FEATURE_TAGS:
+                    if (wireType == PbfReader::BYTES) {
+                        PbfReader tags = reader.message();
+                        while (tags.hasNext()) {
+                            feature.tags.push_back((U32) tags.varint());
+                        }
+                        reader.ok &= tags.ok;
+                    } else {
+                        feature.tags.push_back((U32) reader.varint());
+                    }
+                    break;
+                case FEATURE_TYPE:
+                    feature.type = (MvtReader::GeomType) reader.varint();
+                    break;
+                case FEATURE_GEOMETRY:
+                    // the type may come after the geometry.
+                    geometry = reader.message();
+                    break;
+                default:
+                    reader.skip(wireType);
+            }
+        }
+        if (!reader.ok || (feature.tags.size() & 1) != 0) {
+            return false;
+        }
+        return geometry.pos == nullptr || readGeometry(geometry, feature);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static bool readLayer(PbfReader reader, MvtReader::Layer& layer) {
+        U32 field, wireType;
+        while (reader.next(field, wireType)) {
+            switch (field) {
+                case LAYER_NAME:
+                    layer.name = reader.string();
+                    break;
+                case LAYER_FEATURES:
+                    layer.features.emplace_back();
+                    if (!readFeature(reader.message(), layer.features.back())) {
+                        return false;
+                    }
+                    break;
+                case LAYER_KEYS:
+                    layer.keys.push_back(reader.string());
+                    break;
+                case LAYER_VALUES:
+                    layer.values.emplace_back();
+                    if (!readValue(reader.message(), layer.values.back())) {
+                        return false;
+                    }
+                    break;
+                case LAYER_EXTENT:
+                    layer.extent = (U32) reader.varint();
+                    break;
+                default:
+                    reader.skip(wireType);
+            }
+        }
+        if (!reader.ok || layer.extent == 0) {
+            return false;
+        }
+        // tags must point into the tables.
+        for (const MvtReader::Feature& feature : layer.features) {
+            for (size_t i = 0; i < feature.tags.size(); i += 2) {
+                if (feature.tags[i] >= layer.keys.size() || feature.tags[i + 1] >= layer.values.size()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static bool gunzip(const BYTE* data, U32 size, std::string& out) {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        // 16: gzip header
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+            return false;
+        }
+        stream.next_in = (Bytef*) data;
+        stream.avail_in = size;
+        out.resize(size * 4);
+        int res = Z_OK;
+        while (res == Z_OK) {
+            if (stream.total_out >= out.size()) {
+                out.resize(out.size() * 2);
+            }
+            stream.next_out = (Bytef*) &out[stream.total_out];
+            stream.avail_out = (uInt) (out.size() - stream.total_out);
+            res = inflate(&stream, Z_NO_FLUSH);
+        }
+        out.resize(stream.total_out);
+        inflateEnd(&stream);
+        return res == Z_STREAM_END;
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    const MvtReader::Value* MvtReader::Layer::getProperty(const Feature& feature, const std::string& key) const {
+        for (size_t i = 0; i < feature.tags.size(); i += 2) {
+            if (keys[feature.tags[i]] == key) {
+                return &values[feature.tags[i + 1]];
+            }
+        }
+        return nullptr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Status MvtReader::read(const BYTE* data, U32 size, std::vector<Layer>& layers) {
+        std::string inflated;
+        if (size >= 2 && data[0] == 0x1F && data[1] == 0x8B) {
+            if (!gunzip(data, size, inflated)) {
+                LOG_WARN(TAG, "Invalid gzipped tile");
+                return STATUS_KO;
+            }
+            data = (const BYTE*) inflated.data();
+            size = (U32) inflated.size();
+        }
+
+        PbfReader reader(data, data + size);
+        U32 field, wireType;
+        while (reader.next(field, wireType)) {
+            if (field == TILE_LAYERS) {
+                layers.emplace_back();
+                if (!readLayer(reader.message(), layers.back())) {
+                    LOG_WARN(TAG, "Invalid layer %s", layers.back().name.c_str());
+                    return STATUS_KO;
+                }
+            } else {
+                reader.skip(wireType);
+            }
+        }
+        if (!reader.ok) {
+            LOG_WARN(TAG, "Truncated tile");
+            return STATUS_KO;
+        }
+        return STATUS_OK;
+    }
+}
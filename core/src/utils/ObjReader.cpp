@@ -18,6 +18,7 @@
 
 #include "utils/ObjReader.hpp"
 #include "utils/Log.hpp"
+#include "utils/Utils.hpp"
 
 #include <sstream>
 #include <cassert>
@@ -26,26 +27,58 @@ constexpr auto TAG = "ObjReader";
 
 namespace dma {
 
+    /**
+     * Read-only stream buffer over memory, seekable as ObjReader needs it.
+     */
+    class MemoryBuffer : public std::streambuf {
+    public:
+        MemoryBuffer(const BYTE* data, U32 size) {
+            char* begin = (char*) data;
+            setg(begin, begin, begin + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override {
+            char* target = (dir == std::ios_base::beg ? eback() : dir == std::ios_base::cur ? gptr() : egptr()) + off;
+            if (target < eback() || target > egptr()) {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), target, egptr());
+            return pos_type(target - eback());
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
 
     ObjReader::ObjReader(const std::string& path) :
-                        mInputStream(path) {
+                        mFileStream(path),
+                        mInputStream(mFileStream.rdbuf()) {
+        Utils::countFileSyscall();
         //check that file exists
-        bool exists = mInputStream.is_open();
+        bool exists = mFileStream.is_open();
         if (!exists) {
-            Log::error(TAG, "file " + path + " doesn't exist.");
+            Log::error(TAG, "file %s doesn't exist.", path.c_str());
             assert(!"error while loading obj");
         }
     }
 
+    ObjReader::ObjReader(const BYTE* data, U32 size) :
+                        mMemoryBuffer(new MemoryBuffer(data, size)),
+                        mInputStream(mMemoryBuffer.get()) {
+    }
+
     ObjReader::~ObjReader() {
-        if(mInputStream.is_open()) {
-            mInputStream.close();
+        if(mFileStream.is_open()) {
+            mFileStream.close();
         }
     }
 
 
     bool ObjReader::isOpen() const {
-        return mInputStream.is_open();
+        return mMemoryBuffer != nullptr || mFileStream.is_open();
     }
 
     Status ObjReader::mGotoLabel(const std::string& label) {
@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <limits>
+
+#include "utils/Triangulator.hpp"
+
+namespace dma {
+
+    /* ================= ROUTINES ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static inline F64 area(const N* p, const N* q, const N* r) {
+        return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static inline bool equals(const N* a, const N* b) {
+        return a->x == b->x && a->y == b->y;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static inline int sign(F64 value) {
+        return value > 0.0 ? 1 : value < 0.0 ? -1 : 0;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    static inline bool pointInTriangle(F64 ax, F64 ay, F64 bx, F64 by, F64 cx, F64 cy, F64 px, F64 py) {
+        return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+               && (ax - px) * (by - py) >= (bx - px) * (ay - py)
+               && (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /** for collinear p, q, r: whether q lies on the segment pr. */
+    template <typename N>
+    static inline bool onSegment(const N* p, const N* q, const N* r) {
+        return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x)
+               && q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static bool intersects(const N* p1, const N* q1, const N* p2, const N* q2) {
+        int o1 = sign(area(p1, q1, p2));
+        int o2 = sign(area(p1, q1, q2));
+        int o3 = sign(area(p2, q2, p1));
+        int o4 = sign(area(p2, q2, q1));
+        return (o1 != o2 && o3 != o4)
+               || (o1 == 0 && onSegment(p1, p2, q1))
+               || (o2 == 0 && onSegment(p1, q2, q1))
+               || (o3 == 0 && onSegment(p2, p1, q2))
+               || (o4 == 0 && onSegment(p2, q1, q2));
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static bool intersectsPolygon(const N* a, const N* b) {
+        const N* p = a;
+        do {
+            if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i
+                && intersects(p, p->next, a, b)) {
+                return true;
+            }
+            p = p->next;
+        } while (p != a);
+        return false;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /** whether the diagonal ab is inside the polygon around a. */
+    template <typename N>
+    static inline bool locallyInside(const N* a, const N* b) {
+        return area(a->prev, a, a->next) < 0.0 ?
+               area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0 :
+               area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /** whether the middle of the diagonal ab is inside the polygon. */
+    template <typename N>
+    static bool middleInside(const N* a, const N* b) {
+        const N* p = a;
+        bool inside = false;
+        F64 px = (a->x + b->x) / 2.0;
+        F64 py = (a->y + b->y) / 2.0;
+        do {
+            if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y
+                && (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+                inside = !inside;
+            }
+            p = p->next;
+        } while (p != a);
+        return inside;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static bool isValidDiagonal(const N* a, const N* b) {
+        return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b)
+               && ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+                    && (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0))
+                   || (equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0));
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static bool isEar(const N* ear) {
+        const N* a = ear->prev;
+        const N* b = ear;
+        const N* c = ear->next;
+        if (area(a, b, c) >= 0.0) {
+            return false; // reflex
+        }
+        F64 x0 = std::min(a->x, std::min(b->x, c->x));
+        F64 y0 = std::min(a->y, std::min(b->y, c->y));
+        F64 x1 = std::max(a->x, std::max(b->x, c->x));
+        F64 y1 = std::max(a->y, std::max(b->y, c->y));
+        // no other vertex may be inside the ear.
+        for (const N* p = c->next; p != a; p = p->next) {
+            if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+                && pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y)
+                && area(p->prev, p, p->next) >= 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static void removeNode(N* p) {
+        p->next->prev = p->prev;
+        p->prev->next = p->next;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static N* leftmost(N* start) {
+        N* p = start;
+        N* result = start;
+        do {
+            if (p->x < result->x || (p->x == result->x && p->y < result->y)) {
+                result = p;
+            }
+            p = p->next;
+        } while (p != start);
+        return result;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    template <typename N>
+    static N* findHoleBridge(const N* hole, N* outerNode) {
+        // find a segment intersected by a ray from the hole's leftmost point to the left.
+        N* p = outerNode;
+        N* m = nullptr;
+        F64 hx = hole->x;
+        F64 hy = hole->y;
+        F64 qx = -std::numeric_limits<F64>::infinity();
+        do {
+            if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+                F64 x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+                if (x <= hx && x > qx) {
+                    qx = x;
+                    m = p->x < p->next->x ? p : p->next;
+                    if (x == hx) {
+                        return m; // the hole touches the outer segment
+                    }
+                }
+            }
+            p = p->next;
+        } while (p != outerNode);
+        if (m == nullptr) {
+            return nullptr;
+        }
+
+        // look for points inside the triangle (hole point, intersection, segment end point):
+        // the one with the smallest angle to the ray is the bridge end.
+        N* stop = m;
+        F64 mx = m->x;
+        F64 my = m->y;
+        F64 tanMin = std::numeric_limits<F64>::infinity();
+        p = m;
+        do {
+            if (hx >= p->x && p->x >= mx && hx != p->x
+                && pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+                F64 tan = std::abs(hy - p->y) / (hx - p->x);
+                if (locallyInside(p, hole)
+                    && (tan < tanMin || (tan == tanMin && (p->x > m->x
+                        || (p->x == m->x && area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0))))) {
+                    m = p;
+                    tanMin = tan;
+                }
+            }
+            p = p->next;
+        } while (p != stop);
+        return m;
+    }
+
+
+    /* ================= PUBLIC ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Triangulator() :
+            mTriangles(nullptr)
+    {}
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::~Triangulator() {
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void Triangulator::triangulate(const std::vector<glm::vec2>& points, const std::vector<U32>& rings,
+                                   std::vector<U32>& triangles) {
+        if (rings.empty()) {
+            return;
+        }
+        mNodes.clear();
+        mTriangles = &triangles;
+
+        U32 outerEnd = rings.size() > 1 ? rings[1] : (U32) points.size();
+        Node* outerNode = mLinkedList(points, rings[0], outerEnd, true);
+        if (outerNode == nullptr || outerNode->next == outerNode->prev) {
+            return;
+        }
+        if (rings.size() > 1) {
+            outerNode = mEliminateHoles(points, rings, outerNode);
+        }
+        mEarcutLinked(outerNode, 0);
+        mTriangles = nullptr;
+    }
+
+
+    /* ================= PRIVATE ========================*/
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mInsertNode(U32 i, const glm::vec2& point, Node* last) {
+        mNodes.push_back(Node{i, point.x, point.y, nullptr, nullptr, false});
+        Node* p = &mNodes.back();
+        if (last == nullptr) {
+            p->prev = p;
+            p->next = p;
+        } else {
+            p->next = last->next;
+            p->prev = last;
+            last->next->prev = p;
+            last->next = p;
+        }
+        return p;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mLinkedList(const std::vector<glm::vec2>& points, U32 begin, U32 end, bool clockwise) {
+        F64 sum = 0.0;
+        for (U32 i = begin, j = end - 1; i < end; j = i++) {
+            sum += ((F64) points[j].x - points[i].x) * ((F64) points[i].y + points[j].y);
+        }
+        Node* last = nullptr;
+        if (clockwise == (sum > 0.0)) {
+            for (U32 i = begin; i < end; ++i) {
+                last = mInsertNode(i, points[i], last);
+            }
+        } else {
+            for (U32 i = end; i-- > begin;) {
+                last = mInsertNode(i, points[i], last);
+            }
+        }
+        if (last != nullptr && equals(last, last->next)) {
+            removeNode(last);
+            last = last->next;
+        }
+        return last;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mFilterPoints(Node* start, Node* end) {
+        if (start == nullptr) {
+            return start;
+        }
+        if (end == nullptr) {
+            end = start;
+        }
+        // removes duplicate & collinear points.
+        Node* p = start;
+        bool again;
+        do {
+            again = false;
+            if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0)) {
+                removeNode(p);
+                p = end = p->prev;
+                if (p == p->next) {
+                    break;
+                }
+                again = true;
+            } else {
+                p = p->next;
+            }
+        } while (again || p != end);
+        return end;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void Triangulator::mEarcutLinked(Node* ear, int pass) {
+        if (ear == nullptr) {
+            return;
+        }
+        Node* stop = ear;
+        while (ear->prev != ear->next) {
+            Node* prev = ear->prev;
+            Node* next = ear->next;
+            if (isEar(ear)) {
+                mEmit(prev, ear, next);
+                removeNode(ear);
+                // skipping the next vertex leads to less sliver triangles.
+                ear = next->next;
+                stop = next->next;
+                continue;
+            }
+            ear = next;
+            if (ear == stop) {
+                // no ear found in a whole turn: try harder.
+                if (pass == 0) {
+                    mEarcutLinked(mFilterPoints(ear), 1);
+                } else if (pass == 1) {
+                    mEarcutLinked(mCureLocalIntersections(mFilterPoints(ear)), 2);
+                } else {
+                    mSplitEarcut(ear);
+                }
+                break;
+            }
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mCureLocalIntersections(Node* start) {
+        if (start == nullptr) {
+            return start;
+        }
+        Node* p = start;
+        do {
+            Node* a = p->prev;
+            Node* b = p->next->next;
+            if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+                mEmit(a, p, b);
+                removeNode(p);
+                removeNode(p->next);
+                p = start = b;
+            }
+            p = p->next;
+        } while (p != start);
+        return mFilterPoints(p);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void Triangulator::mSplitEarcut(Node* start) {
+        // look for a valid diagonal that divides the polygon into two.
+        Node* a = start;
+        do {
+            Node* b = a->next->next;
+            while (b != a->prev) {
+                if (a->i != b->i && isValidDiagonal(a, b)) {
+                    Node* c = mSplitPolygon(a, b);
+                    a = mFilterPoints(a, a->next);
+                    c = mFilterPoints(c, c->next);
+                    mEarcutLinked(a, 0);
+                    mEarcutLinked(c, 0);
+                    return;
+                }
+                b = b->next;
+            }
+            a = a->next;
+        } while (a != start);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mEliminateHoles(const std::vector<glm::vec2>& points, const std::vector<U32>& rings,
+                                            Node* outerNode) {
+        mHoles.clear();
+        for (size_t r = 1; r < rings.size(); ++r) {
+            U32 end = r + 1 < rings.size() ? rings[r + 1] : (U32) points.size();
+            Node* list = mLinkedList(points, rings[r], end, false);
+            if (list == nullptr) {
+                continue;
+            }
+            if (list == list->next) {
+                list->steiner = true;
+            }
+            mHoles.push_back(leftmost(list));
+        }
+        // from left to right, so that bridges do not cross the holes yet to process.
+        std::sort(mHoles.begin(), mHoles.end(), [](const Node* a, const Node* b) {
+            return a->x < b->x;
+        });
+        for (Node* hole : mHoles) {
+            outerNode = mEliminateHole(hole, outerNode);
+        }
+        return outerNode;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mEliminateHole(Node* hole, Node* outerNode) {
+        Node* bridge = findHoleBridge(hole, outerNode);
+        if (bridge == nullptr) {
+            return outerNode;
+        }
+        Node* bridgeReverse = mSplitPolygon(bridge, hole);
+        mFilterPoints(bridgeReverse, bridgeReverse->next);
+        return mFilterPoints(bridge, bridge->next);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    Triangulator::Node* Triangulator::mSplitPolygon(Node* a, Node* b) {
+        // links a to b with a diagonal; if they are on the same ring, splits it in two.
+        mNodes.push_back(Node{a->i, a->x, a->y, nullptr, nullptr, false});
+        Node* a2 = &mNodes.back();
+        mNodes.push_back(Node{b->i, b->x, b->y, nullptr, nullptr, false});
+        Node* b2 = &mNodes.back();
+        Node* an = a->next;
+        Node* bp = b->prev;
+
+        a->next = b;
+        b->prev = a;
+        a2->next = an;
+        an->prev = a2;
+        b2->next = a2;
+        a2->prev = b2;
+        bp->next = b2;
+        b2->prev = bp;
+        return b2;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    void Triangulator::mEmit(const Node* a, const Node* b, const Node* c) {
+        mTriangles->push_back(a->i);
+        mTriangles->push_back(b->i);
+        mTriangles->push_back(c->i);
+    }
+}
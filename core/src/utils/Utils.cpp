@@ -27,6 +27,8 @@ constexpr auto TAG = "Utils";
 
 namespace dma {
 
+    std::atomic<U32> Utils::fileSyscallCount(0);
+
     //--------------------------------------------------------------------------------------
     std::vector<std::string> &Utils::split(const std::string &s, char delim,
                                            std::vector<std::string> &elems) {
@@ -42,6 +44,7 @@ namespace dma {
     //---------------------------------------------------------------------------------
     bool Utils::dirExists(const char *path) {
         struct stat info;
+        countFileSyscall();
         if (stat(path, &info) != 0)
             return false;
         else return (info.st_mode & S_IFDIR) != 0;
@@ -50,6 +53,7 @@ namespace dma {
     //--------------------------------------------------------------------------------------
     bool Utils::fileExists(const std::string& path) {
         std::ifstream is;
+        countFileSyscall();
         is.open(path.c_str());
         bool res = is.is_open();
         is.close();
@@ -62,6 +66,7 @@ namespace dma {
     long Utils::getFileSize(const std::string& path) {
         long length;
         std::ifstream is;
+        countFileSyscall();
         is.open(path.c_str(), std::ios::ate);
         if (!is.is_open()) {
             Log::error(TAG, "Cannot open file %s", path.c_str());
@@ -76,7 +81,8 @@ namespace dma {
     Status Utils::bufferize(const std::string& path, std::string& buffer) {
         I64 length;
         std::ifstream is;
-        is.open(path.c_str(), std::ios::ate);
+        countFileSyscall();
+        is.open(path.c_str(), std::ios::ate | std::ios::binary);
         if (!is.is_open()) {
             Log::error(TAG, "Cannot open file %s", path.c_str());
             return throwException(TAG, ExceptionType::IO, ("Cannot open file " + path).c_str());
@@ -90,7 +96,7 @@ namespace dma {
         is.read(bufferTmp, length);
         is.close();
         bufferTmp[length] = '\0';
-        buffer.assign(bufferTmp);
+        buffer.assign(bufferTmp, (size_t) length);
         delete[] bufferTmp;
         return STATUS_OK;
     }
@@ -99,6 +105,7 @@ namespace dma {
     //--------------------------------------------------------------------------------------
     Status Utils::bufferize(const std::string& path, std::vector<BYTE>& buffer) {
         I64 length;
+        countFileSyscall();
         std::ifstream is(path.c_str(), std::ios::binary | std::ios::ate);
         if (!is.is_open()) {
             Log::error(TAG, "Cannot open file %s", path.c_str());
@@ -22,16 +22,16 @@ const std::string TestResource::Scene::invalid= "invalid";
 
 
 void testLog() {
-    Log::trace(LOG_TAG, "Hello %s %c", "world", '!');
-    Log::debug(LOG_TAG, "Hello %s %c", "world", '!');
-    Log::info(LOG_TAG, "Hello %s %c", "world", '!');
-    Log::warn(LOG_TAG, "Hello %s %c", "world", '!');
+    LOG_TRACE(LOG_TAG, "Hello %s %c", "world", '!');
+    LOG_DEBUG(LOG_TAG, "Hello %s %c", "world", '!');
+    LOG_INFO(LOG_TAG, "Hello %s %c", "world", '!');
+    LOG_WARN(LOG_TAG, "Hello %s %c", "world", '!');
     Log::error(LOG_TAG, "Hello %s %c", "world", '!');
 }
 
 void testObjReader() {
 
-    Log::info(LOG_TAG, "===== testing %s =====", "objReader");
+    LOG_INFO(LOG_TAG, "===== testing %s =====", "objReader");
 
     ObjReader objReader(TestResource::resFolder + "/mesh/cube.obj");
 
@@ -42,13 +42,13 @@ void testObjReader() {
     objReader.gotoPositions();
     glm::vec3 position;
     while(objReader.nextPosition(position)) {
-        Log::debug(LOG_TAG, "VERTEX: %f %f %f", position.x, position.y, position.z);
+        LOG_DEBUG(LOG_TAG, "VERTEX: %f %f %f", position.x, position.y, position.z);
     }
 
     objReader.gotoNormals();
     glm::vec3 normal;
     while(objReader.nextNormal(normal)) {
-        Log::debug(LOG_TAG, "NORMAL: %f %f %f", normal.x, normal.y, normal.z);
+        LOG_DEBUG(LOG_TAG, "NORMAL: %f %f %f", normal.x, normal.y, normal.z);
     }
 
 
@@ -56,7 +56,7 @@ void testObjReader() {
     objReader.gotoFaces();
     U16 face[3][3];
     while(objReader.nextFace(face)) {
-        Log::debug(LOG_TAG, "FACE: %d/%d/%d %d/%d/%d %d/%d/%d",
+        LOG_DEBUG(LOG_TAG, "FACE: %d/%d/%d %d/%d/%d %d/%d/%d",
                 face[0][0], face[0][1], face[0][2],
                 face[1][0], face[1][1], face[1][2],
                 face[2][0], face[2][1], face[2][2]);
@@ -66,27 +66,27 @@ void testObjReader() {
 
 
 void testMaterialReader() {
-    Log::trace(LOG_TAG, "Starting testMaterialReader");
+    LOG_TRACE(LOG_TAG, "Starting testMaterialReader");
     MaterialReader materialReader("res/material/test.json");
     materialReader.parse();
     std::string shader = materialReader.getShader();
     std::string diffuseMap = materialReader.getDiffuseMap();
-    Log::trace(LOG_TAG, "shader = %s | diffuseMap = %s", shader.c_str(), diffuseMap.c_str());
-    Log::trace(LOG_TAG, "testMaterialReader done");
+    LOG_TRACE(LOG_TAG, "shader = %s | diffuseMap = %s", shader.c_str(), diffuseMap.c_str());
+    LOG_TRACE(LOG_TAG, "testMaterialReader done");
 }
 
 
 
 void testEngineLifecycle() {
 
-    Log::trace(LOG_TAG, "===== testing %s =====", "EngineLifecycle");
+    LOG_TRACE(LOG_TAG, "===== testing %s =====", "EngineLifecycle");
 
     for(int i=0; i<2; ++i) {
         onInit();
         TimeoutCallback callback;
-        Log::info(LOG_TAG, "-----------------");
-        Log::info(LOG_TAG, "Blue window popped up? [Y]/n");
-        Log::info(LOG_TAG, "-----------------");
+        LOG_INFO(LOG_TAG, "-----------------");
+        LOG_INFO(LOG_TAG, "Blue window popped up? [Y]/n");
+        LOG_INFO(LOG_TAG, "-----------------");
         mainLoop(&callback);
         onDestroy();
     }
@@ -127,7 +127,7 @@ void testRotatingCubes() {
 
     for(bool destroyPoi : {false, true}) {
 
-        Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+        LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
 
 
         onInit();
@@ -156,12 +156,12 @@ void testRotatingCubes() {
 
         RotatingCubeCallback callback(mGeoEngine, &centerCube, &leftCube, &rightCube, &frontCube, &backCube);
 
-        Log::info(LOG_TAG, "-----------------");
-        Log::info(LOG_TAG, "View from top of the scene.");
-        Log::info(LOG_TAG, "Center cube should roll CCW");
-        Log::info(LOG_TAG, "Left cube should yaw CCW, right one way CW.");
-        Log::info(LOG_TAG, "5 cube? rotation ok? [Y]/n");
-        Log::info(LOG_TAG, "-----------------");
+        LOG_INFO(LOG_TAG, "-----------------");
+        LOG_INFO(LOG_TAG, "View from top of the scene.");
+        LOG_INFO(LOG_TAG, "Center cube should roll CCW");
+        LOG_INFO(LOG_TAG, "Left cube should yaw CCW, right one way CW.");
+        LOG_INFO(LOG_TAG, "5 cube? rotation ok? [Y]/n");
+        LOG_INFO(LOG_TAG, "-----------------");
 
         mainLoop(&callback);
         if(destroyPoi) {
@@ -178,7 +178,7 @@ void testRotatingCubes() {
         }
 
         onDestroy();
-        Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+        LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
     }
 }
 
@@ -201,19 +201,19 @@ void testSkybox() {
         }
     };
 
-    Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
     onInit();
     mGeoEngine->setSkyBoxEnabled(true);
 
     mFlyThroughCamera->pitch(90);
     SkyboxCallback callback(mGeoEngine);
 
-    Log::info(LOG_TAG, "-----------------");
-    Log::info(LOG_TAG, "skybox rotating CW ? [Y]/n");
-    Log::info(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "skybox rotating CW ? [Y]/n");
+    LOG_INFO(LOG_TAG, "-----------------");
     mainLoop(&callback);
     onDestroy();
-    Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
 
 }
 
@@ -253,7 +253,7 @@ void testSpawningCubes() {
     };
 
 
-    Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
 
     onInit();
     const double dist = 0.0001;
@@ -271,12 +271,12 @@ void testSpawningCubes() {
     Poi* pois[4] = {&leftCube, &rightCube, &frontCube, &backCube};
     SpawnCubeCallback callback(mGeoEngine, pois);
 
-    Log::info(LOG_TAG, "-----------------");
-    Log::info(LOG_TAG, "4 cube spawning? [Y]/n");
-    Log::info(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "4 cube spawning? [Y]/n");
+    LOG_INFO(LOG_TAG, "-----------------");
     mainLoop(&callback);
     onDestroy();
-    Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
 
 }
 
@@ -313,7 +313,7 @@ void testPositionningCube() {
     };
 
 
-    Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
 
     onInit();
     PoiFactory& factory = mGeoEngine->getPoiFactory();
@@ -325,18 +325,18 @@ void testPositionningCube() {
 
     PositionCubeCallback callback(mGeoEngine, &cube);
 
-    Log::info(LOG_TAG, "-----------------");
-    Log::info(LOG_TAG, "1 cube moving left to right ? [Y]/n");
-    Log::info(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "1 cube moving left to right ? [Y]/n");
+    LOG_INFO(LOG_TAG, "-----------------");
     mainLoop(&callback);
     onDestroy();
-    Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
 
 }
 
 void testLoadScene() {
     std::string testName = "testLoadScene";
-    Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
 
     onInit();
 
@@ -345,37 +345,37 @@ void testLoadScene() {
     const double* pos = mGeoCamera->getPosition();
     mGeoCamera->setPosition(pos[0], pos[1], 70);
 
-    Log::info(LOG_TAG, "-----------------");
-    Log::info(LOG_TAG, " scene with loaded with valid map ? [Y]/n");
-    Log::info(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, " scene with loaded with valid map ? [Y]/n");
+    LOG_INFO(LOG_TAG, "-----------------");
     mainLoop();
     onDestroy();
-    Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
 
 }
 
 void testLoadNullScene() {
     std::string testName = "testLoadNullScene";
-    Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
 
     onInit();
 
     mGeoEngine->loadGeoScene(TestResource::Scene::invalid);
 
-    Log::info(LOG_TAG, "-----------------");
-    Log::info(LOG_TAG, " scene with loaded with invalid map ? [Y]/n");
-    Log::info(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, " scene with loaded with invalid map ? [Y]/n");
+    LOG_INFO(LOG_TAG, "-----------------");
     mainLoop();
 
     onDestroy();
-    Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
 
 }
 
 
 void testFallbackMesh() {
     std::string testName = "testInvalidPoi";
-    Log::info(LOG_TAG, "===== testing %s =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s =====", testName.c_str());
 
     onInit();
 
@@ -385,12 +385,12 @@ void testFallbackMesh() {
     Poi& poi = mGeoEngine->getPoiFactory().createPoi("IDon'tExist", "IDon'tExist", "IDon'tExist", &result);
     ASSERTM("loading this poi should return an error.", result != STATUS_OK);
     mGeoEngine->addPoi(poi);
-    Log::info(LOG_TAG, "-----------------");
-    Log::info(LOG_TAG, " fallback mesh visible? [Y]/n");
-    Log::info(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, "-----------------");
+    LOG_INFO(LOG_TAG, " fallback mesh visible? [Y]/n");
+    LOG_INFO(LOG_TAG, "-----------------");
     mainLoop();
     onDestroy();
-    Log::info(LOG_TAG, "===== testing %s OK =====", testName.c_str());
+    LOG_INFO(LOG_TAG, "===== testing %s OK =====", testName.c_str());
 
 }
 
@@ -420,13 +420,13 @@ void runAllTests(int argc, char const *argv[]) {
 }
 
 int main(int argc, const char **argv) {
-    Log::info(LOG_TAG, "Starting tests...");
-    Log::info(LOG_TAG, "==============================");
+    LOG_INFO(LOG_TAG, "Starting tests...");
+    LOG_INFO(LOG_TAG, "==============================");
 
     runAllTests(argc, argv);
 
-    Log::info(LOG_TAG, "==============================");
-    Log::info(LOG_TAG, "tests finished");
+    LOG_INFO(LOG_TAG, "==============================");
+    LOG_INFO(LOG_TAG, "tests finished");
 
     return 0;
 }
@@ -119,20 +119,20 @@ cute::suite mCuteSuite;
 inline bool initGlfwContext() {
 
     //init GLFW
-    dma::Log::trace(LOG_TAG, "Initializing GLFW...");
+    LOG_TRACE(LOG_TAG, "Initializing GLFW...");
     if (!glfwInit()) {
         dma::Log::error(LOG_TAG, "Failed to initialize GLFW");
         return false;
     }
 
-    dma::Log::trace(LOG_TAG, "Creating window...");
+    LOG_TRACE(LOG_TAG, "Creating window...");
     mWindow = glfwCreateWindow(WIDTH, HEIGHT, WINDOW_TITLE, NULL, NULL);
     if (!mWindow) {
         dma::Log::error(LOG_TAG, "Failed to create window");
         glfwTerminate();
         return false;
     }
-    dma::Log::trace(LOG_TAG, "Window created");
+    LOG_TRACE(LOG_TAG, "Window created");
 
     glfwMakeContextCurrent(mWindow);
     glfwSwapInterval(1);
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "common/Timer.hpp"
+#include "animation/AnimationComponent.hpp"
+#include "animation/AnimationPool.hpp"
+#include "animation/RotationAnimation.hpp"
+#include "animation/TranslationAnimation.hpp"
+#include "engine/TransformComponent.hpp"
+#include "utils/Log.hpp"
+
+using namespace dma;
+
+#define TAG "AnimationBench"
+
+constexpr float FRAME_TIME = 1.0f / 30.0f;
+
+/**
+ * Animates POI transforms as GeoSceneManager does: a looping bob translation and a looping
+ * spin rotation per POI, restarted every 'refresh period' frames as on a tile change.
+ * Runs once with an AnimationComponent per POI and heap animations re-created on refresh,
+ * once with a shared AnimationPool refreshed in place, and reports the time per frame of each.
+ *
+ * usage: arpigl-bench-animation [poi count] [frames] [refresh period]
+ */
+
+//--------------------------------------------------------------------------------------------------
+static glm::vec3 poiPosition(U32 i) {
+    return glm::vec3((float) (i % 100) * 10.0f, 0.0f, (float) (i / 100) * 10.0f);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double runComponents(U32 count, U32 frames, U32 refreshPeriod) {
+    std::vector<TransformComponent> transforms(count);
+    std::vector<AnimationComponent*> components;
+    std::vector<TranslationAnimation*> translations(count, nullptr);
+    std::vector<RotationAnimation*> rotations(count, nullptr);
+    for (U32 i = 0; i < count; ++i) {
+        transforms[i].setPosition(poiPosition(i));
+        components.push_back(new AnimationComponent(transforms[i]));
+    }
+
+    Timer timer;
+    double start = timer.now();
+    for (U32 frame = 0; frame < frames; ++frame) {
+        if (frame % refreshPeriod == 0) {
+            for (U32 i = 0; i < count; ++i) {
+                if (translations[i] != nullptr) {
+                    components[i]->remove(translations[i]);
+                    delete translations[i];
+                    components[i]->remove(rotations[i]);
+                    delete rotations[i];
+                }
+                const glm::vec3 position = poiPosition(i);
+                translations[i] = new TranslationAnimation(transforms[i], position, position + glm::vec3(0.0f, 2.0f, 0.0f),
+                                                           3.0f, TranslationAnimation::Function::EASE, true, true);
+                components[i]->add(translations[i]);
+                rotations[i] = new RotationAnimation(transforms[i], 4.0f, true, 360.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+                components[i]->add(rotations[i]);
+            }
+        }
+        for (U32 i = 0; i < count; ++i) {
+            components[i]->update(FRAME_TIME);
+            transforms[i].update();
+        }
+    }
+    double elapsed = timer.now() - start;
+
+    for (U32 i = 0; i < count; ++i) {
+        delete translations[i];
+        delete rotations[i];
+        delete components[i];
+    }
+    return elapsed;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double runPool(U32 count, U32 frames, U32 refreshPeriod) {
+    std::vector<TransformComponent> transforms(count);
+    std::vector<AnimationPool::Track> translations(count);
+    std::vector<AnimationPool::Track> rotations(count);
+    AnimationPool pool;
+    pool.reserve(count);
+    for (U32 i = 0; i < count; ++i) {
+        transforms[i].setPosition(poiPosition(i));
+    }
+
+    Timer timer;
+    double start = timer.now();
+    for (U32 frame = 0; frame < frames; ++frame) {
+        if (frame % refreshPeriod == 0) {
+            for (U32 i = 0; i < count; ++i) {
+                const glm::vec3 position = poiPosition(i);
+                const glm::vec3 top = position + glm::vec3(0.0f, 2.0f, 0.0f);
+                if (!pool.refreshTranslation(translations[i], position, top, 3.0f)) {
+                    translations[i] = pool.addTranslation(transforms[i], position, top,
+                                                          3.0f, TranslationAnimation::Function::EASE, true, true);
+                }
+                if (!pool.isRunning(rotations[i])) {
+                    rotations[i] = pool.addRotation(transforms[i], 4.0f, true, 360.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+                }
+            }
+        }
+        pool.step(FRAME_TIME);
+        for (U32 i = 0; i < count; ++i) {
+            transforms[i].update();
+        }
+    }
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    U32 count = argc > 1 ? (U32) std::max(1, atoi(argv[1])) : 10000;
+    U32 frames = argc > 2 ? (U32) std::max(1, atoi(argv[2])) : 300;
+    U32 refreshPeriod = argc > 3 ? (U32) std::max(1, atoi(argv[3])) : 30;
+
+    double componentTime = runComponents(count, frames, refreshPeriod);
+    double poolTime = runPool(count, frames, refreshPeriod);
+
+    LOG_INFO(TAG, "%d POIs, %d frames, refreshed every %d frames", count, frames, refreshPeriod);
+    LOG_INFO(TAG, "animation components: %.3f ms/frame", componentTime * 1000.0 / frames);
+    LOG_INFO(TAG, "animation pool:       %.3f ms/frame", poolTime * 1000.0 / frames);
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/Timer.hpp"
+#include "resource/AssetPack.hpp"
+#include "resource/Image.hpp"
+#include "resource/ResourceIndex.hpp"
+#include "utils/ObjReader.hpp"
+#include "utils/Utils.hpp"
+
+using namespace dma;
+
+#define TAG "AssetPackBench"
+
+/**
+ * Startup benchmark: reads and decodes every packed resource, once from loose files,
+ * once from the memory-mapped asset pack, and reports the time and filesystem calls of each.
+ * Decoding is done as the managers do it, GL uploads excepted.
+ *
+ * usage: arpigl-bench-assets <resource dir> [pack] [iterations]
+ * The pack defaults to <resource dir>/arpigl.pack, see arpigl-pack.
+ * Files are in the page cache after the first iteration: the best time of all iterations is kept.
+ */
+
+//--------------------------------------------------------------------------------------------------
+static void decodeObj(ObjReader& reader) {
+    glm::vec3 v3;
+    glm::vec2 v2;
+    U16 face[3][3];
+    reader.gotoPositions();
+    while (reader.nextPosition(v3)) {}
+    reader.gotoUV();
+    while (reader.nextUV(v2)) {}
+    reader.gotoNormals();
+    while (reader.nextNormal(v3)) {}
+    reader.gotoFaces();
+    while (reader.nextFace(face)) {}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static bool endsWith(const std::string& name, const std::string& ext) {
+    return name.size() >= ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double loadLoose(const std::string& rootDir, const std::vector<std::string>& names) {
+    Timer timer;
+    double start = timer.now();
+    for (const std::string& name : names) {
+        std::string path = rootDir + name;
+        if (!Utils::fileExists(path)) {
+            continue;
+        }
+        if (endsWith(name, ".png")) {
+            Image image;
+            image.loadAsPNG(path, true);
+        } else if (endsWith(name, ".obj")) {
+            ObjReader reader(path);
+            decodeObj(reader);
+        } else {
+            std::string buffer;
+            Utils::bufferize(path, buffer);
+        }
+    }
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double loadPacked(const std::string& packPath, const std::vector<std::string>& names) {
+    Timer timer;
+    double start = timer.now();
+    AssetPack pack;
+    pack.open(packPath);
+    for (const std::string& name : names) {
+        AssetPack::Entry entry;
+        if (!pack.find(name, entry)) {
+            continue;
+        }
+        if (endsWith(name, ".png")) {
+            Image image;
+            image.loadAsPNG(entry.data, entry.size, name, true);
+        } else if (endsWith(name, ".obj")) {
+            ObjReader reader(entry.data, entry.size);
+            decodeObj(reader);
+        } else {
+            std::string buffer((const char*) entry.data, entry.size);
+        }
+    }
+    pack.close();
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        Log::error(TAG, "usage: %s <resource dir> [pack] [iterations]", argv[0]);
+        return 1;
+    }
+    std::string rootDir = argv[1];
+    Utils::addTrailingSlash(rootDir);
+    std::string packPath = argc > 2 ? argv[2] : rootDir + ResourceIndex::PACK_FILE;
+    int iterations = argc > 3 ? std::max(1, atoi(argv[3])) : 5;
+
+    AssetPack pack;
+    if (pack.open(packPath) != STATUS_OK) {
+        return 1;
+    }
+    std::vector<std::string> names;
+    for (U32 i = 0; i < pack.getEntryCount(); ++i) {
+        names.push_back(pack.getName(i));
+    }
+    pack.close();
+
+    double looseTime = 1.0e9, packedTime = 1.0e9;
+    U32 looseCalls = 0, packedCalls = 0;
+    for (int i = 0; i < iterations; ++i) {
+        Utils::resetFileSyscallCount();
+        looseTime = std::min(looseTime, loadLoose(rootDir, names));
+        looseCalls = Utils::getFileSyscallCount();
+
+        Utils::resetFileSyscallCount();
+        packedTime = std::min(packedTime, loadPacked(packPath, names));
+        packedCalls = Utils::getFileSyscallCount();
+    }
+
+    LOG_INFO(TAG, "%d files, best of %d iterations", (int) names.size(), iterations);
+    LOG_INFO(TAG, "loose files: %.3f ms, %d filesystem calls", looseTime * 1000.0, looseCalls);
+    LOG_INFO(TAG, "asset pack:  %.3f ms, %d filesystem calls", packedTime * 1000.0, packedCalls);
+    return 0;
+}
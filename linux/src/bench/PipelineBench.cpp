@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#define GLFW_INCLUDE_ES2
+#include <GLFW/glfw3.h>
+
+#include "common/Timer.hpp"
+#include "engine/geo/GeoEngine.hpp"
+#include "utils/Log.hpp"
+
+using namespace dma;
+using namespace dma::geo;
+
+#define TAG "PipelineBench"
+
+constexpr int WIDTH = 800;
+constexpr int HEIGHT = 600;
+
+/**
+ * Draws the same POI scene with the update and the draw run one after the other, then pipelined,
+ * and reports for each the time per frame and the latency measured by the frame governor.
+ * Every frame is drawn: idle frame skipping is off, and POIs are animated.
+ * Requires a display, as the GL context comes from a hidden GLFW window.
+ *
+ * usage: arpigl-bench-pipeline [poi count] [frames]
+ */
+
+//--------------------------------------------------------------------------------------------------
+static void addPois(GeoEngine& engine, U32 count) {
+    GeoSceneManager& sceneManager = engine.getGeoSceneManager();
+    for (U32 i = 0; i < count; ++i) {
+        std::shared_ptr<Poi> poi = engine.getPoiFactory().builder()
+                .sid("poi" + std::to_string(i))
+                .shape("pyramid")
+                .color(Color(0.4f, 0.2f, 0.7f))
+                .build();
+        poi->setPosition(45.784448 + (i / 100) * 0.0001, 4.854478 + (i % 100) * 0.0001, 6.0);
+        sceneManager.addPoi(poi);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static void run(GeoEngine& engine, GLFWwindow* window, U32 frames, bool pipelined) {
+    engine.setPipelinedEnabled(pipelined);
+    // warm up, so that the governor history only holds frames of this mode.
+    for (U32 frame = 0; frame < FrameGovernor::HISTORY_SIZE; ++frame) {
+        engine.step();
+        glfwSwapBuffers(window);
+    }
+
+    Timer timer;
+    double start = timer.now();
+    for (U32 frame = 0; frame < frames; ++frame) {
+        engine.step();
+        glfwSwapBuffers(window);
+    }
+    double frameTime = (timer.now() - start) / frames;
+
+    double latency = 0.0;
+    const std::deque<FrameGovernor::Sample>& history = engine.getFrameGovernor().getHistory();
+    for (const FrameGovernor::Sample& sample : history) {
+        latency += sample.latency;
+    }
+    latency /= std::max<size_t>(1, history.size());
+
+    LOG_INFO(TAG, "%s: %.3f ms/frame, %.3f ms latency", pipelined ? "pipelined " : "sequential",
+              frameTime * 1000.0, latency * 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    U32 count = argc > 1 ? (U32) std::max(1, atoi(argv[1])) : 2000;
+    U32 frames = argc > 2 ? (U32) std::max(1, atoi(argv[2])) : 600;
+
+    if (!glfwInit()) {
+        Log::error(TAG, "Failed to initialize GLFW");
+        return -1;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, TAG, NULL, NULL);
+    if (!window) {
+        Log::error(TAG, "Failed to create window");
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    // do not wait for vsync: the frame time is the one of the engine.
+    glfwSwapInterval(0);
+
+    {
+        GeoEngine engine("assets-test/arpigl");
+        if (!engine.init()) {
+            Log::error(TAG, "error while initializing engine...");
+            return -1;
+        }
+        engine.getGeoSceneManager().setTileNamespace("test-ns");
+        engine.getGeoSceneManager().placeCamera(LatLngAlt(45.784448, 4.854678, 50.0));
+        engine.setSurfaceSize(WIDTH, HEIGHT);
+        engine.setIdleFrameSkippingEnabled(false);
+        addPois(engine, count);
+
+        LOG_INFO(TAG, "%d POIs, %d frames", count, frames);
+        run(engine, window, frames, false);
+        run(engine, window, frames, true);
+        engine.unload();
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
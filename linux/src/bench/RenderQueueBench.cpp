@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <queue>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "common/FrameAllocator.hpp"
+#include "common/Timer.hpp"
+#include "rendering/RenderQueue.hpp"
+#include "utils/Log.hpp"
+
+using namespace dma;
+
+#define TAG "RenderQueueBench"
+
+/**
+ * Queues packages as RenderingEngine does every frame, while the camera moves: 1 in 10 packages
+ * is blended, and drawn back to front. Runs once with the former priority queues keyed by
+ * distance, once with render queues sorting squared distances from a frame allocator, and
+ * reports the time per frame and the heap allocations made once warmed up: the first frames
+ * size the queues & the allocator.
+ *
+ * usage: arpigl-bench-renderqueue [package count] [frames]
+ */
+
+constexpr U32 WARMUP_FRAMES = 2;
+
+static std::atomic<U32> sAllocationCount(0);
+
+//--------------------------------------------------------------------------------------------------
+void* operator new(size_t size) {
+    ++sAllocationCount;
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+struct Package {
+    glm::vec3 position;
+    U32 program;
+    bool blended;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+struct Entry {
+    F32 distance;
+    const Package* package;
+    U32 transforms;
+    bool operator<(const Entry& other) const {
+        return distance < other.distance;
+    }
+};
+
+
+//--------------------------------------------------------------------------------------------------
+static std::vector<Package> createPackages(U32 count) {
+    std::vector<Package> packages(count);
+    srand(42);
+    for (U32 i = 0; i < count; ++i) {
+        packages[i].position = glm::vec3((F32) (rand() % 2000) - 1000.0f, (F32) (rand() % 50),
+                                         (F32) (rand() % 2000) - 1000.0f);
+        packages[i].program = (U32) (rand() % 8);
+        packages[i].blended = i % 10 == 0;
+    }
+    return packages;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static glm::vec3 cameraPosition(U32 frame) {
+    return glm::vec3((F32) frame * 0.5f, 20.0f, (F32) frame * 0.25f);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double runPriorityQueues(const std::vector<Package>& packages, U32 frames, U32* allocations, U64* checksum) {
+    std::priority_queue<Entry> frontToBack;
+    std::priority_queue<Entry> backToFront;
+    Timer timer;
+    double start = 0.0;
+    for (U32 frame = 0; frame < frames; ++frame) {
+        if (frame == WARMUP_FRAMES) {
+            sAllocationCount = 0;
+            start = timer.now();
+        }
+        const glm::vec3 camera = cameraPosition(frame);
+        for (U32 i = 0; i < packages.size(); ++i) {
+            Entry e;
+            e.package = &packages[i];
+            e.transforms = i;
+            const F32 distance = glm::length(packages[i].position - camera);
+            if (packages[i].blended) {
+                e.distance = distance;
+                backToFront.push(e);
+            } else {
+                e.distance = -distance;
+                frontToBack.push(e);
+            }
+        }
+        while (!frontToBack.empty()) {
+            *checksum += frontToBack.top().transforms;
+            frontToBack.pop();
+        }
+        while (!backToFront.empty()) {
+            *checksum += backToFront.top().transforms;
+            backToFront.pop();
+        }
+    }
+    *allocations = sAllocationCount;
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double runRenderQueues(const std::vector<Package>& packages, U32 frames, U32* allocations, U64* checksum) {
+    FrameAllocator allocator;
+    RenderQueue frontToBack(RenderQueue::Order::FRONT_TO_BACK, allocator);
+    RenderQueue backToFront(RenderQueue::Order::BACK_TO_FRONT, allocator);
+    Timer timer;
+    double start = 0.0;
+    for (U32 frame = 0; frame < frames; ++frame) {
+        if (frame == WARMUP_FRAMES) {
+            sAllocationCount = 0;
+            start = timer.now();
+        }
+        const glm::vec3 camera = cameraPosition(frame);
+        for (U32 i = 0; i < packages.size(); ++i) {
+            // only compared, the address is never dereferenced.
+            RenderingPackage* package = (RenderingPackage*) &packages[i];
+            const glm::vec3 d = packages[i].position - camera;
+            const F32 distance2 = glm::dot(d, d);
+            if (packages[i].blended) {
+                backToFront.push(package, i, distance2, 0);
+            } else {
+                frontToBack.push(package, i, distance2, packages[i].program);
+            }
+        }
+        frontToBack.sort();
+        for (const RenderQueue::Entry& e : frontToBack) {
+            *checksum += e.transforms;
+        }
+        backToFront.sort();
+        for (const RenderQueue::Entry& e : backToFront) {
+            *checksum += e.transforms;
+        }
+        frontToBack.clear();
+        backToFront.clear();
+        allocator.reset();
+    }
+    *allocations = sAllocationCount;
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static bool isSorted(const std::vector<Package>& packages) {
+    FrameAllocator allocator;
+    RenderQueue frontToBack(RenderQueue::Order::FRONT_TO_BACK, allocator);
+    RenderQueue backToFront(RenderQueue::Order::BACK_TO_FRONT, allocator);
+    const glm::vec3 camera = cameraPosition(0);
+    std::vector<F32> distances(packages.size());
+    for (U32 i = 0; i < packages.size(); ++i) {
+        distances[i] = glm::length(packages[i].position - camera);
+        RenderingPackage* package = (RenderingPackage*) &packages[i];
+        const glm::vec3 d = packages[i].position - camera;
+        if (packages[i].blended) {
+            backToFront.push(package, i, glm::dot(d, d), 0);
+        } else {
+            frontToBack.push(package, i, glm::dot(d, d), packages[i].program);
+        }
+    }
+    frontToBack.sort();
+    backToFront.sort();
+    // 24 bits of squared distance: a relative precision of 2^-16 on distances.
+    const F32 tolerance = 1.0f + 1.0f / 32768.0f;
+    for (const RenderQueue::Entry* e = frontToBack.begin() + 1; e < frontToBack.end(); ++e) {
+        if (distances[e->transforms] * tolerance < distances[(e - 1)->transforms]) {
+            return false;
+        }
+    }
+    for (const RenderQueue::Entry* e = backToFront.begin() + 1; e < backToFront.end(); ++e) {
+        if (distances[e->transforms] > distances[(e - 1)->transforms]) {
+            return false;
+        }
+    }
+    frontToBack.clear();
+    backToFront.clear();
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    U32 count = argc > 1 ? (U32) std::max(2, atoi(argv[1])) : 50000;
+    U32 frames = argc > 2 ? (U32) std::max((int) WARMUP_FRAMES + 1, atoi(argv[2])) : 300;
+
+    const std::vector<Package> packages = createPackages(count);
+    if (!isSorted(packages)) {
+        Log::error(TAG, "render queues are not sorted");
+        return 1;
+    }
+
+    U32 heapAllocations, frameAllocations;
+    U64 heapChecksum = 0, frameChecksum = 0;
+    double heapTime = runPriorityQueues(packages, frames, &heapAllocations, &heapChecksum);
+    double frameTime = runRenderQueues(packages, frames, &frameAllocations, &frameChecksum);
+    if (heapChecksum != frameChecksum) {
+        Log::error(TAG, "queues did not draw the same packages");
+        return 1;
+    }
+
+    LOG_INFO(TAG, "%d packages, %d frames", count, frames);
+    LOG_INFO(TAG, "priority queues: %.3f ms/frame, %u allocations", heapTime * 1000.0 / (frames - WARMUP_FRAMES), heapAllocations);
+    LOG_INFO(TAG, "render queues:   %.3f ms/frame, %u allocations", frameTime * 1000.0 / (frames - WARMUP_FRAMES), frameAllocations);
+    return 0;
+}
@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "async/ThreadPool.hpp"
+#include "common/Timer.hpp"
+#include "engine/geo/VectorStyle.hpp"
+#include "engine/geo/VectorTileBuilder.hpp"
+#include "utils/MvtReader.hpp"
+#include "utils/Utils.hpp"
+#include "utils/Log.hpp"
+
+using namespace dma;
+using namespace dma::geo;
+
+#define TAG "VectorTileBench"
+
+constexpr int EXTENT = 4096;
+constexpr int BLOCK = 256;
+/** width & height of a z14 tile at 45°, in meters */
+constexpr float TILE_SIZE = 1730.0f;
+
+/**
+ * Decodes and tessellates a vector tile as TileMap does: the default tile is a synthetic downtown
+ * (streets every block, 16 buildings per block, parks, a river), or the given .mvt file.
+ * Reports the time per tile of the decoding alone and of decoding + tessellation on one thread,
+ * then the throughput of the worker pool.
+ *
+ * usage: arpigl-bench-vectortile [iterations] [thread count] [tile.mvt]
+ * If the given tile does not exist, the synthetic one is written there, e.g. to try it in the demo.
+ */
+
+const char* STYLE = R"({
+  "rules": [
+    {"type": "background", "color": [0.94, 0.93, 0.90]},
+    {"layer": "landuse", "type": "fill", "color": [0.91, 0.89, 0.86]},
+    {"layer": "park", "type": "fill", "order": 1, "color": [0.74, 0.86, 0.62]},
+    {"layer": "water", "type": "fill", "order": 2, "color": [0.62, 0.76, 0.88]},
+    {"layer": "transportation", "filter": {"class": ["service", "minor"]}, "type": "line", "order": 4, "width": 6},
+    {"layer": "transportation", "filter": {"class": ["primary"]}, "type": "line", "order": 6, "width": 14},
+    {"layer": "building", "type": "extrusion", "height": 12}
+  ]
+})";
+
+
+/* ================= SYNTHETIC TILE ========================*/
+
+/**
+ * Just enough of a protobuf encoder to write vector tiles.
+ */
+struct PbfWriter {
+    std::string data;
+
+    void varint(U64 value) {
+        while (value >= 0x80) {
+            data.push_back((char) ((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        data.push_back((char) value);
+    }
+
+    void key(U32 field, U32 wireType) {
+        varint((field << 3) | wireType);
+    }
+
+    void uint(U32 field, U64 value) {
+        key(field, 0);
+        varint(value);
+    }
+
+    void bytes(U32 field, const std::string& value) {
+        key(field, 2);
+        varint(value.size());
+        data.append(value);
+    }
+
+    void packed(U32 field, const std::vector<U32>& values) {
+        PbfWriter writer;
+        for (U32 value : values) {
+            writer.varint(value);
+        }
+        bytes(field, writer.data);
+    }
+};
+
+
+/**
+ * Geometry commands of one feature.
+ */
+struct GeometryWriter {
+    std::vector<U32> commands;
+    int x = 0;
+    int y = 0;
+
+    static U32 zigzag(int value) {
+        return (U32) ((value << 1) ^ (value >> 31));
+    }
+
+    void moveTo(int px, int py) {
+        commands.push_back(1 | (1 << 3));
+        commands.push_back(zigzag(px - x));
+        commands.push_back(zigzag(py - y));
+        x = px;
+        y = py;
+    }
+
+    void lineTo(const std::vector<glm::ivec2>& points) {
+        commands.push_back(2 | ((U32) points.size() << 3));
+        for (const glm::ivec2& point : points) {
+            commands.push_back(zigzag(point.x - x));
+            commands.push_back(zigzag(point.y - y));
+            x = point.x;
+            y = point.y;
+        }
+    }
+
+    void line(const std::vector<glm::ivec2>& points) {
+        moveTo(points[0].x, points[0].y);
+        lineTo(std::vector<glm::ivec2>(points.begin() + 1, points.end()));
+    }
+
+    /** exterior rings go clockwise, with y down; holes counterclockwise. */
+    void ring(const std::vector<glm::ivec2>& points) {
+        line(points);
+        commands.push_back(7 | (1 << 3));
+    }
+};
+
+
+struct LayerWriter {
+    std::string name;
+    std::vector<std::string> features;
+    std::map<std::string, U32> keys;
+    std::map<std::pair<int, std::string>, U32> values;
+    PbfWriter keyTable;
+    PbfWriter valueTable;
+
+    LayerWriter(const std::string& name) : name(name) {}
+
+    U32 keyIndex(const std::string& key) {
+        auto it = keys.find(key);
+        if (it == keys.end()) {
+            it = keys.emplace(key, (U32) keys.size()).first;
+            keyTable.bytes(3, key);
+        }
+        return it->second;
+    }
+
+    U32 valueIndex(const std::string& value) {
+        auto it = values.find(std::make_pair(1, value));
+        if (it == values.end()) {
+            it = values.emplace(std::make_pair(1, value), (U32) values.size()).first;
+            PbfWriter writer;
+            writer.bytes(1, value);
+            valueTable.bytes(4, writer.data);
+        }
+        return it->second;
+    }
+
+    U32 valueIndex(U32 value) {
+        auto it = values.find(std::make_pair(5, std::to_string(value)));
+        if (it == values.end()) {
+            it = values.emplace(std::make_pair(5, std::to_string(value)), (U32) values.size()).first;
+            PbfWriter writer;
+            writer.uint(5, value);
+            valueTable.bytes(4, writer.data);
+        }
+        return it->second;
+    }
+
+    void add(MvtReader::GeomType type, const GeometryWriter& geometry, const std::vector<U32>& tags) {
+        PbfWriter feature;
+        feature.uint(1, features.size() + 1);
+        if (!tags.empty()) {
+            feature.packed(2, tags);
+        }
+        feature.uint(3, type);
+        feature.packed(4, geometry.commands);
+        features.push_back(feature.data);
+    }
+
+    std::string write() const {
+        PbfWriter layer;
+        layer.uint(15, 2);
+        layer.bytes(1, name);
+        for (const std::string& feature : features) {
+            layer.bytes(2, feature);
+        }
+        layer.data.append(keyTable.data);
+        layer.data.append(valueTable.data);
+        layer.uint(5, EXTENT);
+        return layer.data;
+    }
+};
+
+
+//--------------------------------------------------------------------------------------------------
+static std::vector<glm::ivec2> rectangle(int x0, int y0, int x1, int y1) {
+    return {glm::ivec2(x0, y0), glm::ivec2(x1, y0), glm::ivec2(x1, y1), glm::ivec2(x0, y1)};
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static std::string synthesizeTile() {
+    U32 seed = 42;
+    auto random = [&seed](int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (int) ((seed >> 8) % (U32) range);
+    };
+
+    LayerWriter landuse("landuse");
+    LayerWriter park("park");
+    LayerWriter water("water");
+    LayerWriter transportation("transportation");
+    LayerWriter building("building");
+
+    for (int i = 0; i < 4; ++i) {
+        GeometryWriter geometry;
+        int x = (i % 2) * EXTENT / 2;
+        int y = (i / 2) * EXTENT / 2;
+        geometry.ring(rectangle(x, y, x + EXTENT / 2, y + EXTENT / 2));
+        landuse.add(MvtReader::POLYGON, geometry, {landuse.keyIndex("class"), landuse.valueIndex("residential")});
+    }
+
+    // a river across the tile, as a meandering polygon.
+    {
+        std::vector<glm::ivec2> ring;
+        for (int i = 0; i <= 32; ++i) {
+            int x = i * EXTENT / 32;
+            ring.push_back(glm::ivec2(x, 1800 + random(120)));
+        }
+        for (int i = 32; i >= 0; --i) {
+            int x = i * EXTENT / 32;
+            ring.push_back(glm::ivec2(x, 1960 + random(120)));
+        }
+        GeometryWriter geometry;
+        geometry.ring(ring);
+        water.add(MvtReader::POLYGON, geometry, {});
+    }
+
+    const int blocks = EXTENT / BLOCK;
+    for (int bx = 0; bx < blocks; ++bx) {
+        for (int by = 0; by < blocks; ++by) {
+            int x0 = bx * BLOCK + 24;
+            int y0 = by * BLOCK + 24;
+            if (y0 >= 1700 && y0 <= 2100) {
+                continue; // river
+            }
+            if ((bx * 7 + by * 3) % 11 == 0) {
+                // a park, with a pond
+                GeometryWriter geometry;
+                geometry.ring(rectangle(x0, y0, x0 + BLOCK - 48, y0 + BLOCK - 48));
+                std::vector<glm::ivec2> hole = rectangle(x0 + 80, y0 + 80, x0 + 128, y0 + 128);
+                std::reverse(hole.begin(), hole.end());
+                geometry.ring(hole);
+                park.add(MvtReader::POLYGON, geometry, {});
+                continue;
+            }
+            // 4 x 4 buildings, some of them L-shaped
+            for (int i = 0; i < 16; ++i) {
+                int x = x0 + (i % 4) * 52;
+                int y = y0 + (i / 4) * 52;
+                int w = 36 + random(12);
+                int h = 36 + random(12);
+                GeometryWriter geometry;
+                if (random(3) == 0) {
+                    geometry.ring({glm::ivec2(x, y), glm::ivec2(x + w, y), glm::ivec2(x + w, y + h / 2),
+                                   glm::ivec2(x + w / 2, y + h / 2), glm::ivec2(x + w / 2, y + h),
+                                   glm::ivec2(x, y + h)});
+                } else {
+                    geometry.ring(rectangle(x, y, x + w, y + h));
+                }
+                building.add(MvtReader::POLYGON, geometry,
+                             {building.keyIndex("render_height"), building.valueIndex((U32) (6 + random(40)))});
+            }
+        }
+    }
+
+    // streets, slightly bent
+    for (int i = 0; i <= blocks; ++i) {
+        const std::string kind = i % 4 == 0 ? "primary" : (i % 2 == 0 ? "minor" : "service");
+        for (int axis = 0; axis < 2; ++axis) {
+            std::vector<glm::ivec2> points;
+            for (int j = 0; j <= 8; ++j) {
+                int along = j * EXTENT / 8;
+                int across = i * BLOCK + random(9) - 4;
+                points.push_back(axis == 0 ? glm::ivec2(along, across) : glm::ivec2(across, along));
+            }
+            GeometryWriter geometry;
+            geometry.line(points);
+            transportation.add(MvtReader::LINESTRING, geometry,
+                               {transportation.keyIndex("class"), transportation.valueIndex(kind)});
+        }
+    }
+
+    PbfWriter tile;
+    for (const LayerWriter* layer : {&landuse, &park, &water, &transportation, &building}) {
+        tile.bytes(3, layer->write());
+    }
+    return tile.data;
+}
+
+
+/* ================= BENCHMARKS ========================*/
+
+//--------------------------------------------------------------------------------------------------
+static double runDecode(const std::string& tile, U32 iterations) {
+    Timer timer;
+    double start = timer.now();
+    for (U32 i = 0; i < iterations; ++i) {
+        std::vector<MvtReader::Layer> layers;
+        MvtReader::read((const BYTE*) tile.data(), (U32) tile.size(), layers);
+    }
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static void build(const std::string& tile, const VectorStyle& style, VectorTileBuilder::Stats* stats) {
+    std::vector<MvtReader::Layer> layers;
+    MvtReader::read((const BYTE*) tile.data(), (U32) tile.size(), layers);
+    std::vector<VectorTileBuilder::Bucket> buckets;
+    VectorTileBuilder builder(style);
+    builder.build(layers, TILE_SIZE, TILE_SIZE, buckets);
+    if (stats != nullptr) {
+        *stats = builder.getStats();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double runBuild(const std::string& tile, const VectorStyle& style, U32 iterations) {
+    Timer timer;
+    double start = timer.now();
+    for (U32 i = 0; i < iterations; ++i) {
+        build(tile, style, nullptr);
+    }
+    return timer.now() - start;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static double runPool(const std::string& tile, const VectorStyle& style, U32 iterations, U32 threadCount,
+                      U32& usedThreads) {
+    ThreadPool pool;
+    pool.start(threadCount);
+    usedThreads = pool.getThreadCount();
+    Timer timer;
+    double start = timer.now();
+    for (U32 i = 0; i < iterations; ++i) {
+        pool.post([&tile, &style]() {
+            build(tile, style, nullptr);
+        });
+    }
+    pool.wait();
+    double elapsed = timer.now() - start;
+    pool.stop();
+    return elapsed;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    U32 iterations = argc > 1 ? (U32) std::max(1, atoi(argv[1])) : 50;
+    U32 threadCount = argc > 2 ? (U32) std::max(0, atoi(argv[2])) : 0;
+
+    std::string tile;
+    if (argc > 3 && Utils::fileExists(argv[3])) {
+        if (Utils::bufferize(argv[3], tile) != STATUS_OK) {
+            Log::error(TAG, "Could not read %s", argv[3]);
+            return 1;
+        }
+    } else {
+        tile = synthesizeTile();
+        if (argc > 3) {
+            std::ofstream out(argv[3], std::ios::binary);
+            out.write(tile.data(), tile.size());
+            LOG_INFO(TAG, "Synthetic tile written to %s", argv[3]);
+        }
+    }
+
+    VectorStyle style;
+    if (style.parse(STYLE) != STATUS_OK) {
+        return 1;
+    }
+    std::vector<MvtReader::Layer> layers;
+    if (MvtReader::read((const BYTE*) tile.data(), (U32) tile.size(), layers) != STATUS_OK) {
+        Log::error(TAG, "Invalid vector tile");
+        return 1;
+    }
+    VectorTileBuilder::Stats stats;
+    build(tile, style, &stats);
+
+    double decodeTime = runDecode(tile, iterations);
+    double buildTime = runBuild(tile, style, iterations);
+    U32 usedThreads = 0;
+    double poolTime = runPool(tile, style, iterations, threadCount, usedThreads);
+
+    LOG_INFO(TAG, "tile: %d bytes, %d layers, %d features, %d vertices, %d triangles", (int) tile.size(),
+              (int) layers.size(), stats.featureCount, stats.vertexCount, stats.triangleCount);
+    LOG_INFO(TAG, "decode:              %.3f ms/tile", decodeTime * 1000.0 / iterations);
+    LOG_INFO(TAG, "decode + tessellate: %.3f ms/tile, %.1f tiles/s", buildTime * 1000.0 / iterations,
+              iterations / buildTime);
+    LOG_INFO(TAG, "worker pool (%d threads): %.1f tiles/s", usedThreads, iterations / poolTime);
+    return 0;
+}
@@ -0,0 +1,22 @@
+/*
+Copyright © 2015 by eBusiness Information
+All rights reserved. This source code or any portion thereof
+may not be reproduced or used in any manner whatsoever
+without the express written permission of eBusiness Information.
+*/
+
+#include "utils/GLUtils.hpp"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+/*
+ * The linux implementation of GLUtils::getProcAddress: entry points are resolved
+ * by GLFW, for the kind of context it created (GLX or EGL).
+ */
+
+namespace dma {
+
+    void* GLUtils::getProcAddress(const char* name) {
+        return (void*) glfwGetProcAddress(name);
+    }
+}
@@ -82,6 +82,72 @@ void mHandleEvents() {
         mGeoEngine.setSkyBoxEnabled(skybox_enabled);
         mGeoEngine.setSkyBox("SunSet");
     }
+    if (keys[GLFW_KEY_I]) {
+        GeoSceneManager& sceneManager = mGeoEngine.getGeoSceneManager();
+        sceneManager.setPoiShaderAnimationEnabled(!sceneManager.isPoiShaderAnimationEnabled());
+    }
+    if (keys[GLFW_KEY_P]) {
+        mGeoEngine.setPipelinedEnabled(!mGeoEngine.isPipelinedEnabled());
+    }
+    if (keys[GLFW_KEY_O]) {
+        GeoSceneManager& sceneManager = mGeoEngine.getGeoSceneManager();
+        sceneManager.setPoiClusteringEnabled(!sceneManager.isPoiClusteringEnabled());
+    }
+    if (keys[GLFW_KEY_B]) {
+        Scene& scene = mGeoEngine.getGeoSceneManager().getScene();
+        scene.setImpostorSize(scene.getImpostorSize() > 0.0f ? 0.0f : 24.0f);
+    }
+    if (keys[GLFW_KEY_L]) {
+        static bool labelCollision = true;
+        labelCollision = !labelCollision;
+        mGeoEngine.setLabelCollisionEnabled(labelCollision);
+        LabelSystem::Stats stats = mGeoEngine.getLabelStats();
+        LOG_INFO(TAG, "labels: %u drawn, %u dropped, %u draw calls. %u fonts, %u glyphs, atlases %u bytes, "
+                  "%u layouts %u bytes, buffers %u bytes", stats.drawnCount, stats.rejectedCount, stats.drawCalls,
+                  stats.fontCount, stats.glyphCount, stats.atlasBytes, stats.layoutCount, stats.layoutBytes,
+                  stats.bufferBytes);
+    }
+    if (keys[GLFW_KEY_V]) {
+        GeoSceneManager& sceneManager = mGeoEngine.getGeoSceneManager();
+        sceneManager.setVectorTilesEnabled(!sceneManager.isVectorTilesEnabled());
+        TileMap::VectorStats stats = mGeoEngine.getVectorTileStats();
+        LOG_INFO(TAG, "vector tiles: %u loaded, %u ready, %u meshes, %u vertices, %u triangles, %u bytes. "
+                  "%u built in %.3f s", stats.tileCount, stats.readyCount, stats.meshCount, stats.vertexCount,
+                  stats.triangleCount, stats.byteCount, stats.builtCount, stats.buildTime);
+    }
+    if (keys[GLFW_KEY_H]) {
+        GeoSceneManager& sceneManager = mGeoEngine.getGeoSceneManager();
+        sceneManager.setTerrainEnabled(!sceneManager.isTerrainEnabled());
+        TileMap::TerrainStats stats = mGeoEngine.getTerrainStats();
+        LOG_INFO(TAG, "terrain: %u elevation tiles, %u ready, %u meshes, %u vertices, %u triangles, %u bytes. "
+                  "%u built in %.3f s", stats.elevationCount, stats.readyCount, stats.meshCount, stats.vertexCount,
+                  stats.triangleCount, stats.byteCount, stats.builtCount, stats.buildTime);
+    }
+    if (keys[GLFW_KEY_M]) {
+        const MemoryReport report = mGeoEngine.getMemoryReport();
+        for (U8 i = 0; i < MemoryReport::size; ++i) {
+            const MemoryUsage& usage = report.get((MemoryReport::Category) i);
+            const MemoryUsage& peak = report.getPeak((MemoryReport::Category) i);
+            LOG_INFO(TAG, "memory, %s: %u, cpu %llu bytes, gpu %llu bytes (peaks %u, %llu, %llu)",
+                      MemoryReport::getName((MemoryReport::Category) i), usage.count,
+                      (unsigned long long) usage.cpuBytes, (unsigned long long) usage.gpuBytes, peak.count,
+                      (unsigned long long) peak.cpuBytes, (unsigned long long) peak.gpuBytes);
+        }
+        const MemoryUsage total = report.getTotal();
+        const MemoryUsage& peak = report.getPeakTotal();
+        LOG_INFO(TAG, "memory: cpu %llu bytes, gpu %llu bytes (peaks %llu, %llu)",
+                  (unsigned long long) total.cpuBytes, (unsigned long long) total.gpuBytes,
+                  (unsigned long long) peak.cpuBytes, (unsigned long long) peak.gpuBytes);
+    }
+    if (keys[GLFW_KEY_C]) {
+        // keep, drop, spill
+        static U8 retention = 0;
+        retention = (U8) ((retention + 1) % 3);
+        mGeoEngine.setRetention(ResourceManager::MESH, (Retention) retention);
+        mGeoEngine.setRetention(ResourceManager::TEXTURE, (Retention) retention);
+        mGeoEngine.setRetention(ResourceManager::CUBEMAP, (Retention) retention);
+        LOG_INFO(TAG, "retention: %s", retention == 0 ? "keep" : retention == 1 ? "drop" : "spill");
+    }
     if (keys[GLFW_KEY_J]) {
         mGeoEngine.getGeoSceneManager().placeCamera(LatLngAlt(80.221595, 2.0371413, 5.0f), 0.9f, TranslationAnimation::Function::EASE);
     }
@@ -135,7 +201,7 @@ void mouseCallback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
         double screenX, screenY;
         glfwGetCursorPos(mWindow, &screenX, &screenY);
-        mGeoEngine.getGeoSceneManager().pick((int) screenX, (int) screenY);
+        mGeoEngine.pick((int) screenX, (int) screenY);
     }
 }
 
@@ -147,7 +213,7 @@ void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
 
 inline bool mInitGlfwContext() {
     //init GLFW
-    Log::info(TAG, "Initializing GLFW...");
+    LOG_INFO(TAG, "Initializing GLFW...");
     if (!glfwInit()) {
         Log::error(TAG, "Failed to initialize GLFW");
         return false;
@@ -156,14 +222,14 @@ inline bool mInitGlfwContext() {
     //anti aliasing
     glfwWindowHint(GLFW_SAMPLES, 4);
 
-    Log::info(TAG, "Creating window...");
+    LOG_INFO(TAG, "Creating window...");
     mWindow = glfwCreateWindow(WIDTH, HEIGHT, WINDOW_TITLE, NULL, NULL);
     if (!mWindow) {
         Log::error(TAG, "Failed to create window");
         glfwTerminate();
         return false;
     }
-    Log::info(TAG, "Window created");
+    LOG_INFO(TAG, "Window created");
 
     glfwMakeContextCurrent(mWindow);
 
@@ -180,6 +246,7 @@ void windowSizeCallback(GLFWwindow* window, int width, int height) {
     mHeight = height;
     // set viewport size.
     mGeoEngine.setSurfaceSize(mWidth, mHeight);
+    mGeoEngine.setIdleFrameSkippingEnabled(true);
 }
 
 
@@ -212,6 +279,7 @@ int main(int argc, char** argv) {
             .shape("hydrant")
             .icon("hydrant-diffuse")
             .color(Color(0.2f, 0.4f, 0.7f))
+            .label("Hydrant")
             .build();
     poi1->setPosition(45.784448, 4.854978, 6.0);
     mGeoEngine.getGeoSceneManager().addPoi(poi1);
@@ -229,6 +297,7 @@ int main(int argc, char** argv) {
             .shape("note")
             .icon("b20")
             .color(Color(0.7f, 0.4f, 0.2f))
+            .label("Note")
             .build();
     poi3->setPosition(45.784648, 4.854978, 6.0);
     mGeoEngine.getGeoSceneManager().addPoi(poi3);
@@ -248,16 +317,16 @@ int main(int argc, char** argv) {
 
     /////////////////////////////////////////////////////////
     // Start main loop
-    Log::info(TAG, "Starting main loop...");
+    LOG_INFO(TAG, "Starting main loop...");
     mainLoop();
-    Log::info(TAG, "Main loop finished");
+    LOG_INFO(TAG, "Main loop finished");
 
     //mEngine.removePoi("poi3");
 
     mGeoEngine.unload();
 
 
-    Log::info(TAG, "Terminating...");
+    LOG_INFO(TAG, "Terminating...");
     glfwDestroyWindow(mWindow);
     glfwTerminate();
 
@@ -267,9 +336,12 @@ int main(int argc, char** argv) {
 
 void mainLoop() {
     while (!glfwWindowShouldClose(mWindow)) {
-        glfwSwapBuffers(mWindow);
         glfwPollEvents();
         mHandleEvents();
-        mGeoEngine.step();
+        // keep the last frame on screen when nothing changed.
+        if (mGeoEngine.step()) {
+            glfwSwapBuffers(mWindow);
+        }
     }
+    LOG_INFO(TAG, "%llu idle frames skipped", (unsigned long long) mGeoEngine.getSkippedFrameCount());
 }
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <png.h>
+
+#include "utils/Log.hpp"
+
+using namespace dma;
+
+#define TAG "FontGen"
+
+/** glyphs are rasterized this many times larger than the atlas, and their distance field downsampled */
+constexpr int UPSCALE = 8;
+/** spacing between glyphs in the atlas, in pixels */
+constexpr int SPACING = 1;
+constexpr int ATLAS_WIDTH = 512;
+constexpr double FAR = 1e20;
+
+struct Glyph {
+    unsigned code;
+    int x, y, width, height;
+    int bearingX, bearingY, advance;
+    std::vector<unsigned char> pixels;
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Squared euclidean distance transform of a sampled function, in one dimension.
+ * Felzenszwalb & Huttenlocher, Distance Transforms of Sampled Functions.
+ */
+static void distanceTransform(const double* f, double* d, int n, std::vector<int>& v, std::vector<double>& z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -FAR;
+    z[1] = FAR;
+    for (int q = 1; q < n; ++q) {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            --k;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FAR;
+    }
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < q) {
+            ++k;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Squared distance from each cell of the grid to the nearest cell that is 0. Done in place.
+ */
+static void distanceTransform(std::vector<double>& grid, int width, int height) {
+    const int n = std::max(width, height);
+    std::vector<double> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            f[y] = grid[y * width + x];
+        }
+        distanceTransform(f.data(), d.data(), height, v, z);
+        for (int y = 0; y < height; ++y) {
+            grid[y * width + x] = d[y];
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        distanceTransform(&grid[y * width], d.data(), width, v, z);
+        std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Renders the glyph at UPSCALE times the atlas size, and samples its signed distance field.
+ * 0.5 is the glyph outline, and the field spans 'range' atlas pixels on each side of it.
+ */
+static bool renderGlyph(FT_Face face, unsigned code, int range, Glyph& glyph) {
+    if (FT_Load_Char(face, code, FT_LOAD_RENDER) != 0) {
+        return false;
+    }
+    const FT_GlyphSlot slot = face->glyph;
+    const FT_Bitmap& bitmap = slot->bitmap;
+    glyph.code = code;
+    glyph.advance = (int) std::lround(slot->advance.x / 64.0 / UPSCALE);
+    if (bitmap.width == 0 || bitmap.rows == 0) {
+        glyph.width = glyph.height = glyph.bearingX = glyph.bearingY = 0;
+        return true;
+    }
+
+    // the glyph box is padded by the field range, and aligned on atlas pixels.
+    const int left = (int) std::floor((double) slot->bitmap_left / UPSCALE) - range;
+    const int top = (int) std::ceil((double) slot->bitmap_top / UPSCALE) + range;
+    const int right = (int) std::ceil((double) (slot->bitmap_left + (int) bitmap.width) / UPSCALE) + range;
+    const int bottom = (int) std::floor((double) (slot->bitmap_top - (int) bitmap.rows) / UPSCALE) - range;
+    glyph.bearingX = left;
+    glyph.bearingY = top;
+    glyph.width = right - left;
+    glyph.height = top - bottom;
+
+    const int width = glyph.width * UPSCALE;
+    const int height = glyph.height * UPSCALE;
+    const int offsetX = slot->bitmap_left - left * UPSCALE;
+    const int offsetY = top * UPSCALE - slot->bitmap_top;
+    std::vector<double> outside(width * height, FAR);
+    std::vector<double> inside(width * height, 0.0);
+    for (int y = 0; y < (int) bitmap.rows; ++y) {
+        for (int x = 0; x < (int) bitmap.width; ++x) {
+            if (bitmap.buffer[y * bitmap.pitch + x] >= 128) {
+                const int i = (y + offsetY) * width + x + offsetX;
+                outside[i] = 0.0;
+                inside[i] = FAR;
+            }
+        }
+    }
+    distanceTransform(outside, width, height);
+    distanceTransform(inside, width, height);
+
+    glyph.pixels.resize(glyph.width * glyph.height);
+    for (int y = 0; y < glyph.height; ++y) {
+        for (int x = 0; x < glyph.width; ++x) {
+            const int i = (y * UPSCALE + UPSCALE / 2) * width + x * UPSCALE + UPSCALE / 2;
+            const double distance = (std::sqrt(outside[i]) - std::sqrt(inside[i])) / UPSCALE;
+            const double value = 0.5 - distance / (2.0 * range);
+            glyph.pixels[y * glyph.width + x] = (unsigned char) std::lround(255.0 * std::min(1.0, std::max(0.0, value)));
+        }
+    }
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+static bool writePng(const std::string& path, const std::vector<unsigned char>& pixels, int width, int height) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png_create_info_struct(png);
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        fclose(file);
+        return false;
+    }
+    png_init_io(png, file);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_GRAY, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (int y = 0; y < height; ++y) {
+        png_write_row(png, (png_bytep) &pixels[y * width]);
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    fclose(file);
+    return true;
+}
+
+
+/**
+ * Generates the signed distance field glyph atlas of a font, for the engine labels.
+ *
+ * usage: arpigl-fontgen <font file> <output> [size] [range]
+ * Writes <output>.png, the atlas, and <output>.json, the glyph metrics. Fonts are looked up by the engine
+ * in the font/ directory of the resource dir.
+ * size is the em size glyphs are rasterized at, in pixels, and range the distance covered by the field
+ * on each side of the glyph outlines. Printable ASCII and Latin-1 characters are generated.
+ * Each glyph is written as [code, x, y, width, height, bearingX, bearingY, advance], in atlas pixels
+ * from the top left corner of the atlas. @see Font
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        Log::error(TAG, "usage: %s <font file> <output> [size] [range]", argv[0]);
+        return 1;
+    }
+    const std::string output = argv[2];
+    const int size = argc > 3 ? atoi(argv[3]) : 32;
+    const int range = argc > 4 ? atoi(argv[4]) : 4;
+    if (size <= 0 || range <= 0) {
+        Log::error(TAG, "size and range must be positive");
+        return 1;
+    }
+
+    FT_Library library;
+    FT_Face face;
+    if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, argv[1], 0, &face) != 0) {
+        Log::error(TAG, "Unable to load font %s", argv[1]);
+        return 1;
+    }
+    FT_Set_Pixel_Sizes(face, 0, size * UPSCALE);
+
+    std::vector<Glyph> glyphs;
+    for (unsigned code = 32; code < 256; ++code) {
+        if ((code >= 127 && code < 160) || FT_Get_Char_Index(face, code) == 0) {
+            continue;
+        }
+        Glyph glyph;
+        if (renderGlyph(face, code, range, glyph)) {
+            glyphs.push_back(std::move(glyph));
+        }
+    }
+
+    // shelf packing, tallest glyphs first.
+    std::vector<Glyph*> sorted;
+    for (Glyph& glyph : glyphs) {
+        sorted.push_back(&glyph);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Glyph* a, const Glyph* b) { return a->height > b->height; });
+    int x = SPACING, y = SPACING, shelfHeight = 0;
+    for (Glyph* glyph : sorted) {
+        if (x + glyph->width + SPACING > ATLAS_WIDTH) {
+            x = SPACING;
+            y += shelfHeight + SPACING;
+            shelfHeight = 0;
+        }
+        glyph->x = x;
+        glyph->y = y;
+        x += glyph->width + SPACING;
+        shelfHeight = std::max(shelfHeight, glyph->height);
+    }
+    int height = 1;
+    while (height < y + shelfHeight + SPACING) {
+        height *= 2;
+    }
+
+    std::vector<unsigned char> atlas(ATLAS_WIDTH * height, 0);
+    for (const Glyph& glyph : glyphs) {
+        for (int row = 0; row < glyph.height; ++row) {
+            std::copy(glyph.pixels.begin() + row * glyph.width, glyph.pixels.begin() + (row + 1) * glyph.width,
+                      atlas.begin() + (glyph.y + row) * ATLAS_WIDTH + glyph.x);
+        }
+    }
+    if (!writePng(output + ".png", atlas, ATLAS_WIDTH, height)) {
+        Log::error(TAG, "Unable to write %s.png", output.c_str());
+        return 1;
+    }
+
+    FILE* json = fopen((output + ".json").c_str(), "w");
+    if (json == nullptr) {
+        Log::error(TAG, "Unable to write %s.json", output.c_str());
+        return 1;
+    }
+    fprintf(json, "{\n");
+    fprintf(json, "  \"size\": %d,\n", size);
+    fprintf(json, "  \"range\": %d,\n", range);
+    fprintf(json, "  \"lineHeight\": %ld,\n", std::lround(face->size->metrics.height / 64.0 / UPSCALE));
+    fprintf(json, "  \"ascender\": %ld,\n", std::lround(face->size->metrics.ascender / 64.0 / UPSCALE));
+    fprintf(json, "  \"width\": %d,\n", ATLAS_WIDTH);
+    fprintf(json, "  \"height\": %d,\n", height);
+    fprintf(json, "  \"glyphs\": [\n");
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        const Glyph& g = glyphs[i];
+        fprintf(json, "    [%u, %d, %d, %d, %d, %d, %d, %d]%s\n", g.code, g.x, g.y, g.width, g.height,
+                g.bearingX, g.bearingY, g.advance, i + 1 < glyphs.size() ? "," : "");
+    }
+    fprintf(json, "  ]\n}\n");
+    fclose(json);
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+    LOG_INFO(TAG, "%d glyphs written in %s.png (%dx%d)", (int) glyphs.size(), output.c_str(), ATLAS_WIDTH, height);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015  eBusiness Information
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "resource/AssetPack.hpp"
+#include "resource/ResourceIndex.hpp"
+#include "utils/Utils.hpp"
+
+using namespace dma;
+
+#define TAG "Pack"
+
+/**
+ * Packs the resources of a resource dir in a single asset pack.
+ *
+ * usage: arpigl-pack <resource dir> [output]
+ * output defaults to <resource dir>/arpigl.pack, which is where the engine looks for it.
+ * Cubemaps and tiles are not packed: cubemaps are loaded from their own directory,
+ * and tiles are downloaded at runtime.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        Log::error(TAG, "usage: %s <resource dir> [output]", argv[0]);
+        return 1;
+    }
+    std::string rootDir = argv[1];
+    Utils::addTrailingSlash(rootDir);
+    std::string output = argc > 2 ? argv[2] : rootDir + ResourceIndex::PACK_FILE;
+
+    static const char* PACKED_DIRS[] = {"shader/", "mesh/", "material/", "texture/", "font/", "style/"};
+    static const char* SKIPPED_DIRS[] = {"texture/cubemap/", "texture/tiles/", "texture/elevation/"};
+
+    ResourceIndex index(rootDir);
+    index.init();
+    std::vector<std::string> names;
+    for (const std::string& name : index.getFiles()) {
+        bool packed = false;
+        for (const char* dir : PACKED_DIRS) {
+            packed |= name.compare(0, strlen(dir), dir) == 0;
+        }
+        for (const char* dir : SKIPPED_DIRS) {
+            packed &= name.compare(0, strlen(dir), dir) != 0;
+        }
+        if (packed) {
+            names.push_back(name);
+        }
+    }
+
+    if (AssetPack::write(output, rootDir, names) != STATUS_OK) {
+        Log::error(TAG, "Unable to write %s", output.c_str());
+        return 1;
+    }
+    LOG_INFO(TAG, "%d files packed in %s", (int) names.size(), output.c_str());
+    return 0;
+}
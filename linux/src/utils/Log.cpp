@@ -6,6 +6,7 @@ without the express written permission of eBusiness Information.
 */
 
 #include "utils/Log.hpp"
+#include "utils/LogSink.hpp"
 #include <cstdarg>
 #define LOG_COLOR
 
@@ -25,6 +26,7 @@ without the express written permission of eBusiness Information.
 #define ANSI_COLOR_BLUE    ""
 #define ANSI_COLOR_MAGENTA ""
 #define ANSI_COLOR_CYAN    ""
+#define ANSI_COLOR_GRAY    ""
 #define ANSI_COLOR_RESET   ""
 #endif
 
@@ -32,60 +34,74 @@ without the express written permission of eBusiness Information.
  * The linux implementation of the Log interface
  */
 
-#define BUFFER_SIZE 256
-
 namespace dma {
 
-
-    void Log::info(const std::string& tag, const std::string& message, ...) {
-        char buffer[BUFFER_SIZE];
+    void Log::error(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, BUFFER_SIZE, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_ERROR, tag, message, args);
         va_end(args);
-        std::cout << ANSI_COLOR_CYAN << "[INFO] " << tag << ": " << buffer << ANSI_COLOR_RESET << std::endl;
+        // the process may be about to crash.
+        LogSink::getInstance().flush();
     }
 
-    void Log::warn(const std::string& tag, const std::string& message, ...) {
-        char buffer[BUFFER_SIZE];
+#if LOG_LEVEL >= 1
+    void Log::warn(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, BUFFER_SIZE, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_WARN, tag, message, args);
         va_end(args);
-        std::cout << ANSI_COLOR_YELLOW << "[WARN] " << tag << ": " << buffer << ANSI_COLOR_RESET << std::endl;
-
     }
-    void Log::error(const std::string& tag, const std::string& message, ...) {
-        char buffer[BUFFER_SIZE];
+#endif
+
+#if LOG_LEVEL >= 2
+    void Log::info(const char* tag, const char* message, ...) {
         va_list args;
-        va_start (args, message);
-        vsnprintf(buffer, BUFFER_SIZE, message.c_str(), args);
-        va_end (args);
-        std::cerr << ANSI_COLOR_RED << "[ERROR] " << tag << ": " << buffer << ANSI_COLOR_RESET << std::endl;
+        va_start(args, message);
+        LogSink::getInstance().post(LEVEL_INFO, tag, message, args);
+        va_end(args);
     }
+#endif
 
-#ifdef DEBUG
-    void Log::debug(const std::string& tag, const std::string& message, ...) {
-        char buffer[BUFFER_SIZE];
+#if LOG_LEVEL >= 3
+    void Log::debug(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, BUFFER_SIZE, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_DEBUG, tag, message, args);
         va_end(args);
-        buffer[255] = '\0';
-        std::cout << ANSI_COLOR_GREEN << "[DEBUG] " << tag << ": " << buffer << ANSI_COLOR_RESET << std::endl;
     }
-#endif  //debug
-
-#ifdef TRACE
+#endif
 
-    void Log::trace(const std::string& tag, const std::string& message, ...) {
-        char buffer[BUFFER_SIZE];
+#if LOG_LEVEL >= 4
+    void Log::trace(const char* tag, const char* message, ...) {
         va_list args;
         va_start(args, message);
-        vsnprintf(buffer, BUFFER_SIZE, message.c_str(), args);
+        LogSink::getInstance().post(LEVEL_TRACE, tag, message, args);
         va_end(args);
-        std::cout << ANSI_COLOR_GRAY << "[TRACE] " << tag << ": " << buffer << ANSI_COLOR_RESET << std::endl;
     }
+#endif
 
-#endif  //trace
+    void Log::write(Level level, const char* tag, const char* message) {
+        switch (level) {
+            case LEVEL_ERROR:
+                std::cerr << ANSI_COLOR_RED << "[ERROR] " << tag << ": " << message << ANSI_COLOR_RESET << '\n';
+                break;
+            case LEVEL_WARN:
+                std::cout << ANSI_COLOR_YELLOW << "[WARN] " << tag << ": " << message << ANSI_COLOR_RESET << '\n';
+                break;
+            case LEVEL_INFO:
+                std::cout << ANSI_COLOR_CYAN << "[INFO] " << tag << ": " << message << ANSI_COLOR_RESET << '\n';
+                break;
+            case LEVEL_DEBUG:
+                std::cout << ANSI_COLOR_GREEN << "[DEBUG] " << tag << ": " << message << ANSI_COLOR_RESET << '\n';
+                break;
+            case LEVEL_TRACE:
+                std::cout << ANSI_COLOR_GRAY << "[TRACE] " << tag << ": " << message << ANSI_COLOR_RESET << '\n';
+                break;
+        }
+    }
+
+    void Log::sync() {
+        std::cout.flush();
+    }
 }